@@ -17,12 +17,15 @@
 
 // C++ includes
 
+#include <algorithm>
 #include <functional>
 #include <valarray>
 
 // Qt includes
 
+#include <QPair>
 #include <QTimer>
+#include <QVector>
 
 // Local includes
 
@@ -36,6 +39,7 @@
 #include "itemfiltersettings.h"
 #include "applicationsettings.h"
 #include "iteminfo.h"
+#include "iteminfolist.h"
 #include "tableview_columnfactory.h"
 #include "tableview_selection_model_syncer.h"
 
@@ -113,7 +117,8 @@ public:
         sortOrder          (Qt::AscendingOrder),
         sortRequired       (false),
         groupingMode       (GroupingShowSubItems),
-        outdated           (true)
+        outdated           (true),
+        fieldsBatchSize    (200)
     {
     }
 
@@ -125,6 +130,9 @@ public:
     bool                        sortRequired;
     GroupingMode                groupingMode;
     bool                        outdated;
+
+    /// The number of neighbouring rows whose metadata fields are loaded together.
+    const int                   fieldsBatchSize;
 };
 
 TableViewModel::TableViewModel(TableViewShared* const sharedObject, QObject* const parent)
@@ -1022,9 +1030,40 @@ TableViewModel::DatabaseFieldsHashRaw TableViewModel::itemDatabaseFieldsRaw(Tabl
 {
     const ItemInfo itemItemInfo = infoFromItem(item);
 
+    // The fields requested for painting or sorting are loaded for the rows around the item
+    // with a few queries, instead of one query per item. The ItemInfo cache keeps them, and
+    // drops the fields of the items changed later. New rows are loaded when they are shown.
+
+    if (!itemItemInfo.hasDatabaseFieldsRaw(requestedSet))
+    {
+        loadItemsDatabaseFieldsRaw(item, requestedSet);
+    }
+
     return itemItemInfo.getDatabaseFieldsRaw(requestedSet);
 }
 
+void TableViewModel::loadItemsDatabaseFieldsRaw(TableViewModel::Item* const item,
+                                                const DatabaseFields::Set& requestedSet)
+{
+    QList<Item*> batch;
+    const int row = item->parent ? item->parent->children.indexOf(item) : -1;
+
+    if (row < 0)
+    {
+        batch << item;
+    }
+    else
+    {
+        // The item is shown with its neighbours, the view being scrolled either way.
+
+        const QList<Item*>& siblings = item->parent->children;
+        const int first              = qBound(0, row - d->fieldsBatchSize / 2, qMax(0, siblings.count() - d->fieldsBatchSize));
+        batch                        = siblings.mid(first, d->fieldsBatchSize);
+    }
+
+    infosFromItems(batch).loadDatabaseFieldsRaw(requestedSet);
+}
+
 QVariant TableViewModel::itemDatabaseFieldRaw(TableViewModel::Item* const item,
                                               const DatabaseFields::Set& requestedField)
 {
@@ -1152,14 +1191,12 @@ public:
 
     bool operator()(const TableViewModel::Item* const itemA, const TableViewModel::Item* const itemB)
     {
-        const bool compareResult = m->lessThan(const_cast<Item*>(itemA), const_cast<Item*>(itemB));
-
         if (m->d->sortOrder == Qt::DescendingOrder)
         {
-            return !compareResult;
+            return m->lessThan(const_cast<Item*>(itemB), const_cast<Item*>(itemA));
         }
 
-        return compareResult;
+        return m->lessThan(const_cast<Item*>(itemA), const_cast<Item*>(itemB));
     }
 
 public:
@@ -1169,6 +1206,54 @@ public:
 
 QList<TableViewModel::Item*> TableViewModel::sortItems(const QList<TableViewModel::Item*>& itemList)
 {
+    if ((d->sortColumn >= 0) && (d->sortColumn < d->columnObjects.count()))
+    {
+        const TableViewColumn* const columnObject = d->columnObjects.at(d->sortColumn);
+
+        if (!columnObject->getColumnFlags().testFlag(TableViewColumn::ColumnCustomSorting))
+        {
+            // the displayed strings are the sort keys: compute them once per item,
+            // not twice per comparison.
+
+            typedef QPair<QString, Item*> SortKey;
+
+            QVector<SortKey> keys;
+            keys.reserve(itemList.count());
+
+            Q_FOREACH (Item* const item, itemList)
+            {
+                keys << SortKey(columnObject->data(item, Qt::DisplayRole).toString(), item);
+            }
+
+            const bool descending = (d->sortOrder == Qt::DescendingOrder);
+
+            std::sort(keys.begin(), keys.end(),
+                [descending](const SortKey& a, const SortKey& b)
+                {
+                    const SortKey& keyA = descending ? b : a;
+                    const SortKey& keyB = descending ? a : b;
+
+                    if ((keyA.first == keyB.first) || (keyA.first.isEmpty() && keyB.first.isEmpty()))
+                    {
+                        return (keyA.second->imageId < keyB.second->imageId);
+                    }
+
+                    return (keyA.first < keyB.first);
+                }
+            );
+
+            QList<Item*> sortedList;
+            sortedList.reserve(keys.count());
+
+            Q_FOREACH (const SortKey& key, keys)
+            {
+                sortedList << key.second;
+            }
+
+            return sortedList;
+        }
+    }
+
     QList<Item*> sortedList = itemList;
 
     std::sort(sortedList.begin(),
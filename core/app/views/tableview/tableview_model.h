@@ -24,6 +24,7 @@
 // Local includes
 
 #include "coredbchangesets.h"
+#include "digikam_export.h"
 #include "tableview_shared.h"
 
 class QMimeData;
@@ -42,7 +43,7 @@ class TableViewColumnDescription;
 class TableViewColumnFactory;
 class TableViewColumnProfile;
 
-class TableViewModel : public QAbstractItemModel
+class DIGIKAM_GUI_EXPORT TableViewModel : public QAbstractItemModel
 {
     Q_OBJECT
 
@@ -193,6 +194,11 @@ private:
     Item* createItemFromSourceIndex(const QModelIndex& imageFilterModelIndex);
     void addSourceModelIndex(const QModelIndex& imageModelIndex, const bool sendNotifications);
 
+    /**
+     * Loads the requested fields of the item and of the rows around it.
+     */
+    void loadItemsDatabaseFieldsRaw(Item* const item, const DatabaseFields::Set& requestedSet);
+
 private:
 
     TableViewShared* const s;
@@ -16,6 +16,10 @@
 #ifndef DIGIKAM_TABLE_VIEW_SHARED_H
 #define DIGIKAM_TABLE_VIEW_SHARED_H
 
+// Local includes
+
+#include "digikam_export.h"
+
 class QItemSelectionModel;
 
 namespace Digikam
@@ -32,7 +36,7 @@ class TableViewSelectionModelSyncer;
 class TableViewTreeView;
 class ThumbnailLoadThread;
 
-class TableViewShared
+class DIGIKAM_GUI_EXPORT TableViewShared
 {
 public:
 
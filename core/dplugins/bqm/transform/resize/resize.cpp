@@ -257,6 +257,19 @@ bool Resize::toolOperations()
     int length                  = settings()[QLatin1String("LengthCustom")].toInt();
     Private::WidthPreset preset = (Private::WidthPreset)(settings()[QLatin1String("LengthPreset")].toInt());
 
+    if (!useCustom)
+    {
+        length = d->presetLengthValue(preset);
+    }
+
+    // As first tool of the chain, only decode the file at the size needed.
+    // The final resize below gives the exact size with a high quality filter.
+
+    if (image().isNull() && (!useCustom || !usePercent))
+    {
+        setLoadingSizeHint(length);
+    }
+
     if (!loadToDImg())
     {
         return false;
@@ -264,11 +277,7 @@ bool Resize::toolOperations()
 
     int longest = qMax(image().width(), image().height());
 
-    if      (!useCustom)
-    {
-        length = d->presetLengthValue(preset);
-    }
-    else if (usePercent)
+    if (useCustom && usePercent)
     {
         length = (int)(longest * (double)length / 100.0);
     }
@@ -68,9 +68,29 @@ private:
     bool readHEICImageByID(struct heif_context* const heif_context,
                            heif_item_id image_id);
 
+    /**
+     * Find the smallest embedded thumbnail with a size of at least @p minimumSize,
+     * or the first one (the preview) if @p minimumSize is null.
+     */
+    bool findHEICThumbnail(struct heif_image_handle* const image_handle,
+                           int minimumSize,
+                           heif_item_id* const thumbnail_ID);
+
     bool readHEICImageByHandle(struct heif_image_handle* image_handle,
                                struct heif_image* heif_image, bool loadImageData);
 
+#if LIBHEIF_NUMERIC_VERSION >= 0x01120000
+
+    /**
+     * Decode a grid image tile by tile, using the global thread pool.
+     * Tiles are converted directly to the DImg buffer.
+     */
+    bool readHEICImageByTiles(struct heif_image_handle* const image_handle,
+                              struct heif_decoding_options* const decode_options,
+                              const struct heif_image_tiling& tiling);
+
+#endif
+
     /// Save operations
 
     bool saveHEICColorProfile(struct heif_image* const image);
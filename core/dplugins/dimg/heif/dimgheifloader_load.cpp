@@ -25,6 +25,13 @@
 #include <QByteArray>
 #include <QTextStream>
 #include <QDataStream>
+#include <QVector>
+#include <QScopedArrayPointer>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <qplatformdefs.h>
 
 // Local includes
@@ -33,6 +40,7 @@
 #include "digikam_config.h"
 #include "dimg.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 #include "metaengine.h"
 
 namespace Digikam
@@ -78,6 +86,155 @@ static heif_reader_grow_status heifQIODeviceDImgWait(int64_t target_size, void*
     return heif_reader_grow_status_size_reached;
 }
 
+/**
+ * Convert one row of decoded interleaved RGB(A) pixels to the DImg BGRA layout.
+ * With more than 8 bits by color, the values are shifted by @p colorMul to fill 16 bits.
+ */
+static void convertHEICRow(const uchar* const src, uchar* const dst, int width,
+                           bool sixteenBit, bool hasAlpha, int colorMul)
+{
+    if (!sixteenBit)   // 8 bits image.
+    {
+        DImgPixelConverter::toBGRA8(src, dst, width, hasAlpha ? 4 : 3,
+                                    DImgPixelConverter::RGBOrder, hasAlpha);
+    }
+    else                // 16 bits image.
+    {
+        DImgPixelConverter::toBGRA16(reinterpret_cast<const ushort*>(src), reinterpret_cast<ushort*>(dst), width,
+                                     hasAlpha ? 4 : 3, DImgPixelConverter::RGBOrder, hasAlpha, colorMul);
+    }
+}
+
+#if LIBHEIF_NUMERIC_VERSION >= 0x01120000
+
+/**
+ * The shared state of a grid image decoding: the tiles are taken in order by
+ * the workers, decoded and converted directly to the target DImg buffer.
+ */
+class HEICTilesJob
+{
+public:
+
+    HEICTilesJob()
+      : handle      (nullptr),
+        options     (nullptr),
+        chroma      (heif_chroma_interleaved_RGB),
+        colorDepth  (8),
+        colorMul    (0),
+        sixteenBit  (false),
+        hasAlpha    (false),
+        data        (nullptr),
+        nextTile    (0),
+        decodedTiles(0),
+        failed      (0)
+    {
+    }
+
+    struct heif_image_handle*     handle;
+    struct heif_decoding_options* options;
+    struct heif_image_tiling      tiling;
+    heif_chroma                   chroma;
+    int                           colorDepth;
+    int                           colorMul;
+    bool                          sixteenBit;
+    bool                          hasAlpha;
+    uchar*                        data;
+
+    QAtomicInt                    nextTile;
+    QAtomicInt                    decodedTiles;
+    QAtomicInt                    failed;
+};
+
+static struct heif_image* decodeHEICTile(HEICTilesJob* const job, int index)
+{
+    struct heif_image* tile = nullptr;
+    struct heif_error error = heif_image_handle_decode_image_tile(job->handle,
+                                                                  &tile,
+                                                                  heif_colorspace_RGB,
+                                                                  job->chroma,
+                                                                  job->options,
+                                                                  index % job->tiling.num_columns,
+                                                                  index / job->tiling.num_columns);
+
+    if (error.code != heif_error_Ok)
+    {
+        qCWarning(DIGIKAM_DIMG_LOG_HEIF) << "Cannot decode HEIF tile" << index << ":" << error.message;
+        heif_image_release(tile);
+
+        return nullptr;
+    }
+
+    return tile;
+}
+
+static bool writeHEICTile(HEICTilesJob* const job, struct heif_image* const tile, int index)
+{
+    const int x0         = (int)((index % job->tiling.num_columns) * job->tiling.tile_width);
+    const int y0         = (int)((index / job->tiling.num_columns) * job->tiling.tile_height);
+    const int width      = qMin(heif_image_get_width(tile,  heif_channel_interleaved), (int)job->tiling.image_width  - x0);
+    const int height     = qMin(heif_image_get_height(tile, heif_channel_interleaved), (int)job->tiling.image_height - y0);
+    const int bytesDepth = job->sixteenBit ? 8 : 4;
+    int stride           = 0;
+    const uint8_t* ptr   = heif_image_get_plane_readonly(tile, heif_channel_interleaved, &stride);
+
+    if (!ptr || (stride <= 0) || (width <= 0) || (height <= 0) ||
+        (heif_image_get_bits_per_pixel_range(tile, heif_channel_interleaved) != job->colorDepth))
+    {
+        qCWarning(DIGIKAM_DIMG_LOG_HEIF) << "HEIF tile" << index << "data pixels information not valid!";
+
+        return false;
+    }
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        convertHEICRow(ptr + (quint64)y * stride,
+                       job->data + ((quint64)(y0 + y) * job->tiling.image_width + x0) * bytesDepth,
+                       width, job->sixteenBit, job->hasAlpha, job->colorMul);
+    }
+
+    return true;
+}
+
+/**
+ * Decode and write tiles until all are processed, or until a worker fails.
+ * Return false if a tile cannot be decoded.
+ */
+static bool processHEICTile(HEICTilesJob* const job)
+{
+    const int count = (int)(job->tiling.num_columns * job->tiling.num_rows);
+    const int index = job->nextTile.fetchAndAddOrdered(1);
+
+    if ((index >= count) || job->failed.loadAcquire())
+    {
+        return false;
+    }
+
+    struct heif_image* const tile = decodeHEICTile(job, index);
+    bool ret                      = (tile && writeHEICTile(job, tile, index));
+
+    heif_image_release(tile);
+
+    if (!ret)
+    {
+        job->failed.storeRelease(1);
+
+        return false;
+    }
+
+    job->decodedTiles.ref();
+
+    return true;
+}
+
+static void processHEICTiles(HEICTilesJob* const job)
+{
+    while (processHEICTile(job))
+    {
+    }
+}
+
+#endif
+
 bool DImgHEIFLoader::load(const QString& filePath, DImgLoaderObserver* const observer)
 {
     m_observer = observer;
@@ -137,6 +294,14 @@ bool DImgHEIFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
 
     struct heif_context* const heif_context = heif_context_alloc();
 
+#if LIBHEIF_NUMERIC_VERSION >= 0x010d0000
+
+    // Grid images decoded as a whole use all cores to decode the tiles.
+
+    heif_context_set_max_decoding_threads(heif_context, QThread::idealThreadCount());
+
+#endif
+
     heif_reader reader;
     reader.reader_api_version = 1;
     reader.get_position       = heifQIODeviceDImgGetPosition;
@@ -283,12 +448,23 @@ bool DImgHEIFLoader::readHEICImageByID(struct heif_context* const heif_context,
         m_observer->progressInfo(0.2F);
     }
 
-    if (m_loadFlags & LoadPreview)
+    // Find out if we do the fast-track loading with reduced size,
+    // using the smallest embedded thumbnail large enough for the requested size.
+
+    int scaledLoadingSize = 0;
+    QVariant attribute    = imageGetAttribute(QLatin1String("scaledLoadingSize"));
+
+    if (attribute.isValid() && (m_loadFlags & LoadImageData))
+    {
+        scaledLoadingSize = attribute.toInt();
+    }
+
+    if ((m_loadFlags & LoadPreview) || (scaledLoadingSize > 0))
     {
         heif_item_id thumbnail_ID = 0;
-        int nThumbnails           = heif_image_handle_get_list_of_thumbnail_IDs(image_handle, &thumbnail_ID, 1);
+        int minimumSize           = (m_loadFlags & LoadPreview) ? 0 : scaledLoadingSize;
 
-        if (nThumbnails > 0)
+        if (findHEICThumbnail(image_handle, minimumSize, &thumbnail_ID))
         {
             struct heif_image_handle* thumbnail_handle = nullptr;
             error                                      = heif_image_handle_get_thumbnail(image_handle, thumbnail_ID, &thumbnail_handle);
@@ -320,7 +496,7 @@ bool DImgHEIFLoader::readHEICImageByID(struct heif_context* const heif_context,
             return ret;
         }
 
-        // Image has no preview, load image normally
+        // Image has no suitable preview, load image normally
 
         return readHEICImageByHandle(image_handle, heif_image, true);
     }
@@ -330,6 +506,71 @@ bool DImgHEIFLoader::readHEICImageByID(struct heif_context* const heif_context,
     return readHEICImageByHandle(image_handle, heif_image, (m_loadFlags & LoadImageData));
 }
 
+bool DImgHEIFLoader::findHEICThumbnail(struct heif_image_handle* const image_handle,
+                                       int minimumSize,
+                                       heif_item_id* const thumbnail_ID)
+{
+    int nThumbnails = heif_image_handle_get_number_of_thumbnails(image_handle);
+
+    if (nThumbnails <= 0)
+    {
+        return false;
+    }
+
+    QVector<heif_item_id> thumbnail_IDs(nThumbnails);
+    nThumbnails = heif_image_handle_get_list_of_thumbnail_IDs(image_handle, thumbnail_IDs.data(), nThumbnails);
+
+    if (nThumbnails <= 0)
+    {
+        return false;
+    }
+
+    if (minimumSize <= 0)
+    {
+        // The first thumbnail is the preview.
+
+        *thumbnail_ID = thumbnail_IDs.first();
+
+        return true;
+    }
+
+    int bestSize = 0;
+
+    for (int i = 0 ; i < nThumbnails ; ++i)
+    {
+        struct heif_image_handle* thumbnail_handle = nullptr;
+        struct heif_error error                    = heif_image_handle_get_thumbnail(image_handle,
+                                                                                     thumbnail_IDs.at(i),
+                                                                                     &thumbnail_handle);
+
+        if (error.code != heif_error_Ok)
+        {
+            continue;
+        }
+
+        int size = qMax(heif_image_handle_get_width(thumbnail_handle),
+                        heif_image_handle_get_height(thumbnail_handle));
+
+        heif_image_handle_release(thumbnail_handle);
+
+        if ((size >= minimumSize) && ((bestSize == 0) || (size < bestSize)))
+        {
+            *thumbnail_ID = thumbnail_IDs.at(i);
+            bestSize      = size;
+        }
+    }
+
+    if (bestSize > 0)
+    {
+        qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF thumbnail of size" << bestSize
+                                       << "used for scaled loading size" << minimumSize;
+
+        return true;
+    }
+
+    return false;
+}
+
 bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handle,
                                            struct heif_image* heif_image, bool loadImageData)
 {
@@ -363,6 +604,31 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
                                    << heif_image_handle_get_height(image_handle)
                                    << ")";
 
+#if LIBHEIF_NUMERIC_VERSION >= 0x01120000
+
+    // Grid images are decoded tile by tile in parallel, directly to the DImg buffer,
+    // except for reduced size loading which needs the full rows.
+
+    struct heif_image_tiling tiling;
+
+    if (loadImageData                                                                        &&
+        !m_hasAlpha                                                                          &&
+        (heif_image_handle_get_image_tiling(image_handle, 0, &tiling).code == heif_error_Ok) &&
+        ((tiling.num_columns * tiling.num_rows) > 1)                                         &&
+        (tiling.number_of_extra_dimensions == 0)                                             &&
+        (scaledLoadingFactor(tiling.image_width, tiling.image_height) == 1))
+    {
+        bool ret = readHEICImageByTiles(image_handle, decode_options, tiling);
+
+        heif_decoding_options_free(decode_options);
+        heif_image_release(heif_image);
+        heif_image_handle_release(image_handle);
+
+        return ret;
+    }
+
+#endif
+
     error = heif_decode_image(image_handle,
                               &heif_image,
                               heif_colorspace_RGB,
@@ -445,22 +711,36 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
         return false;
     }
 
+    // If no suitable thumbnail was found for a reduced size loading,
+    // converted rows are box-filtered to not allocate the full size image.
+
+    const QSize originalSize(imageWidth(), imageHeight());
+    const int   reduction    = scaledLoadingFactor(imageWidth(), imageHeight());
+    const int   scaledWidth  = (imageWidth()  + reduction - 1) / reduction;
+    const int   scaledHeight = (imageHeight() + reduction - 1) / reduction;
+    const int   bytesDepth   = m_sixteenBit ? 8 : 4;
+
+    QScopedArrayPointer<uchar> rowData;
+    QVector<quint64>           sums;
+
     if (loadImageData)
     {
         qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "Color multiplier:" << colorMul;
 
-        if (m_sixteenBit)
-        {
-            data = new_failureTolerant(imageWidth(), imageHeight(), 8); // 16 bits/color/pixel
-        }
-        else
+        data = new_failureTolerant(scaledWidth, scaledHeight, bytesDepth);
+
+        if (reduction > 1)
         {
-            data = new_failureTolerant(imageWidth(), imageHeight(), 4); // 8 bits/color/pixel
+            qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF loaded with reduced size 1 /" << reduction;
+
+            rowData.reset(new_failureTolerant(imageWidth(), 1, bytesDepth));
+            sums.fill(0, scaledWidth * 4);
         }
 
-        if (!data)
+        if (!data || ((reduction > 1) && !rowData))
         {
             qCWarning(DIGIKAM_DIMG_LOG_HEIF) << "Cannot allocate memory!";
+            delete [] data;
             loadingFailed();
             heif_image_release(heif_image);
             heif_image_handle_release(image_handle);
@@ -473,100 +753,230 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
             m_observer->progressInfo(0.4F);
         }
 
-        uchar* dst              = data;
-        unsigned short* dst16   = reinterpret_cast<unsigned short*>(data);
-        uchar* src              = nullptr;
-        unsigned short* src16   = nullptr;
-        unsigned int checkPoint = 0;
-
-        for (unsigned int y = 0 ; y < imageHeight() ; ++y)
+        if (reduction == 1)
         {
-            src   = reinterpret_cast<unsigned char*>(ptr + (y * stride));
-            src16 = reinterpret_cast<unsigned short*>(src);
+            // Full size rows are independent and converted in parallel, by bands of rows.
+            // The loading can be cancelled and the progress is reported between the bands.
+
+            const int  width       = imageWidth();
+            const int  height      = imageHeight();
+            const bool sixteenBit  = m_sixteenBit;
+            const bool hasAlpha    = m_hasAlpha;
+            const int  bands       = m_observer ? qBound(1, height / 10, 20) : 1;
+            const int  rowsPerBand = (height + bands - 1) / bands;
 
-            for (unsigned int x = 0 ; x < imageWidth() ; ++x)
+            for (int band = 0 ; band < height ; band += rowsPerBand)
             {
-                if (!m_sixteenBit)   // 8 bits image.
-                {
-                    // Blue
+                DImgPixelConverter::processRows(width, qMin(rowsPerBand, height - band),
+                    [ptr, stride, data, width, bytesDepth, sixteenBit, hasAlpha, colorMul, band](int begin, int end)
+                    {
+                        for (int y = band + begin ; y < band + end ; ++y)
+                        {
+                            convertHEICRow(ptr + (quint64)y * stride,
+                                           data + (quint64)y * (quint64)width * bytesDepth,
+                                           width, sixteenBit, hasAlpha, colorMul);
+                        }
+                    }
+                );
 
-                    dst[0] = src[2];
+                if (m_observer)
+                {
+                    if (!m_observer->continueQuery())
+                    {
+                        delete [] data;
+                        loadingFailed();
+                        heif_image_release(heif_image);
+                        heif_image_handle_release(image_handle);
 
-                    // Green
+                        return false;
+                    }
 
-                    dst[1] = src[1];
+                    m_observer->progressInfo(0.4F + (0.6F * (((float)qMin(band + rowsPerBand, height)) / ((float)height))));
+                }
+            }
+        }
+        else
+        {
+            unsigned int checkPoint = 0;
 
-                    // Red
+            for (unsigned int y = 0 ; y < imageHeight() ; ++y)
+            {
+                convertHEICRow(ptr + (quint64)y * stride, rowData.data(), imageWidth(), m_sixteenBit, m_hasAlpha, colorMul);
+                addRowToScaledBoxes(rowData.data(), imageWidth(), m_sixteenBit, reduction, sums.data());
 
-                    dst[2] = src[0];
+                if ((((y + 1) % reduction) == 0) || (y == (imageHeight() - 1)))
+                {
+                    writeScaledBoxesRow(sums.data(), imageWidth(), (y % reduction) + 1, m_sixteenBit, reduction,
+                                        data + (quint64)(y / reduction) * (quint64)scaledWidth * bytesDepth);
+                }
 
-                    // Alpha
+                if (m_observer && y >= checkPoint)
+                {
+                    checkPoint += granularity(m_observer, imageHeight(), 0.6F);
 
-                    if (m_hasAlpha)
-                    {
-                        dst[3] = src[3];
-                        src   += 4;
-                    }
-                    else
+                    if (!m_observer->continueQuery())
                     {
-                        dst[3] = 0xFF;
-                        src   += 3;
+                        delete [] data;
+                        loadingFailed();
+                        heif_image_release(heif_image);
+                        heif_image_handle_release(image_handle);
+
+                        return false;
                     }
 
-                    dst += 4;
+                    m_observer->progressInfo(0.4F + (0.6F * (((float)y) / ((float)imageHeight()))));
                 }
-                else                // 16 bits image.
-                {
-                    // Blue
+            }
+        }
+    }
+
+    if (loadImageData)
+    {
+        imageWidth()  = scaledWidth;
+        imageHeight() = scaledHeight;
+    }
 
-                    dst16[0] = (unsigned short)(src16[2] << colorMul);
+    imageData() = data;
+    imageSetAttribute(QLatin1String("format"),             QLatin1String("HEIF"));
+    imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
+    imageSetAttribute(QLatin1String("originalBitDepth"),   m_sixteenBit ? 16 : 8);
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
-                    // Green
+    if (m_observer)
+    {
+        m_observer->progressInfo(0.9F);
+    }
+
+    heif_image_release(heif_image);
+    heif_image_handle_release(image_handle);
+
+    return true;
+}
 
-                    dst16[1] = (unsigned short)(src16[1] << colorMul);
+#if LIBHEIF_NUMERIC_VERSION >= 0x01120000
 
-                    // Red
+bool DImgHEIFLoader::readHEICImageByTiles(struct heif_image_handle* const image_handle,
+                                          struct heif_decoding_options* const decode_options,
+                                          const struct heif_image_tiling& tiling)
+{
+    HEICTilesJob job;
+    job.handle     = image_handle;
+    job.options    = decode_options;
+    job.tiling     = tiling;
+    job.chroma     = heif_chroma_interleaved_RGB;
+    job.hasAlpha   = false;
 
-                    dst16[2] = (unsigned short)(src16[0] << colorMul);
+    const int count = (int)(tiling.num_columns * tiling.num_rows);
 
-                    // Alpha
+    qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF grid image decoded with" << tiling.num_columns << "x" << tiling.num_rows
+                                   << "tiles of size (" << tiling.tile_width << "x" << tiling.tile_height << ")";
 
-                    if (m_hasAlpha)
-                    {
-                        dst16[3] = (unsigned short)(src16[3] << colorMul);
-                        src16   += 4;
-                    }
-                    else
-                    {
-                        dst16[3] = 0xFFFF;
-                        src16   += 3;
-                    }
+    // The first tile gives the decoded color depth, needed to allocate the image.
 
-                        dst16 += 4;
-                }
-            }
+    struct heif_image* const firstTile = decodeHEICTile(&job, 0);
 
-            if (m_observer && y >= checkPoint)
-            {
-                checkPoint += granularity(m_observer, y, 0.8F);
+    if (!firstTile)
+    {
+        loadingFailed();
 
-                if (!m_observer->continueQuery())
-                {
-                    loadingFailed();
-                    heif_image_release(heif_image);
-                    heif_image_handle_release(image_handle);
+        return false;
+    }
 
-                    return false;
-                }
+    job.colorDepth = heif_image_get_bits_per_pixel_range(firstTile, heif_channel_interleaved);
 
-                m_observer->progressInfo(0.4F + (0.8F * (((float)y) / ((float)imageHeight()))));
+    if      (job.colorDepth == 8)
+    {
+        m_sixteenBit = false;
+    }
+    else if ((job.colorDepth > 8) && (job.colorDepth <= 16))
+    {
+        m_sixteenBit = true;
+        job.colorMul = 16 - job.colorDepth;
+    }
+    else
+    {
+        qCWarning(DIGIKAM_DIMG_LOG_HEIF) << "Color bits depth: " << job.colorDepth << ": not supported!";
+        heif_image_release(firstTile);
+        loadingFailed();
+
+        return false;
+    }
+
+    job.sixteenBit = m_sixteenBit;
+    job.data       = new_failureTolerant(tiling.image_width, tiling.image_height, m_sixteenBit ? 8 : 4);
+
+    if (!job.data)
+    {
+        qCWarning(DIGIKAM_DIMG_LOG_HEIF) << "Cannot allocate memory!";
+        heif_image_release(firstTile);
+        loadingFailed();
+
+        return false;
+    }
+
+    bool ret = writeHEICTile(&job, firstTile, 0);
+    heif_image_release(firstTile);
+
+    if (!ret)
+    {
+        delete [] job.data;
+        loadingFailed();
+
+        return false;
+    }
+
+    job.nextTile.storeRelease(1);
+    job.decodedTiles.storeRelease(1);
+
+    if (m_observer)
+    {
+        m_observer->progressInfo(0.3F);
+    }
+
+    // The loader thread takes part in the decoding, so the job completes
+    // even if the global thread pool is busy. It is also the only one
+    // to use the observer.
+
+    const int helpers = qBound(0, QThreadPool::globalInstance()->maxThreadCount() - 1, count - 2);
+    QList<QFuture<void> > tasks;
+
+    for (int i = 0 ; i < helpers ; ++i)
+    {
+        tasks.append(QtConcurrent::run(processHEICTiles, &job));
+    }
+
+    while (processHEICTile(&job))
+    {
+        if (m_observer)
+        {
+            if (!m_observer->continueQuery())
+            {
+                job.failed.storeRelease(1);
+                break;
             }
+
+            m_observer->progressInfo(0.3F + (0.6F * ((float)job.decodedTiles.loadAcquire() / (float)count)));
         }
     }
 
-    imageData() = data;
+    Q_FOREACH (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+
+    if (job.failed.loadAcquire() || (job.decodedTiles.loadAcquire() != count))
+    {
+        delete [] job.data;
+        loadingFailed();
+
+        return false;
+    }
+
+    imageWidth()  = tiling.image_width;
+    imageHeight() = tiling.image_height;
+    imageData()   = job.data;
     imageSetAttribute(QLatin1String("format"),             QLatin1String("HEIF"));
-    imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
+    imageSetAttribute(QLatin1String("originalColorModel"), DImg::RGB);
     imageSetAttribute(QLatin1String("originalBitDepth"),   m_sixteenBit ? 16 : 8);
     imageSetAttribute(QLatin1String("originalSize"),       QSize(imageWidth(), imageHeight()));
 
@@ -575,10 +985,9 @@ bool DImgHEIFLoader::readHEICImageByHandle(struct heif_image_handle* image_handl
         m_observer->progressInfo(0.9F);
     }
 
-    heif_image_release(heif_image);
-    heif_image_handle_release(image_handle);
-
     return true;
 }
 
+#endif
+
 } // namespace Digikam
@@ -31,6 +31,7 @@
 #include "digikam_debug.h"
 #include "dimg.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 #include "metaengine.h"
 
 // libx265 includes
@@ -270,137 +271,66 @@ bool DImgHEIFLoader::save(const QString& filePath, DImgLoaderObserver* const obs
     qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF data container:" << data;
     qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF bytes per line:" << stride;
 
-    uint checkpoint           = 0;
-    unsigned char r           = 0;
-    unsigned char g           = 0;
-    unsigned char b           = 0;
-    unsigned char a           = 0;
-    unsigned char* src        = nullptr;
-    unsigned char* dst        = nullptr;
-    unsigned short r16        = 0;
-    unsigned short g16        = 0;
-    unsigned short b16        = 0;
-    unsigned short a16        = 0;
-    unsigned short* src16     = nullptr;
-    unsigned short* dst16     = nullptr;
-    int div16                 = 16 - maxOutputBitsDepth;
-    int mul8                  = maxOutputBitsDepth - 8;
-    int nbOutputBytesPerColor = (maxOutputBitsDepth > 8) ? (imageHasAlpha() ? 4 * 2 : 3 * 2)  // output data stored on 16 bits
-                                                         : (imageHasAlpha() ? 4     : 3    ); // output data stored on 8 bits
+    const int div16           = 16 - maxOutputBitsDepth;
+    const int mul8            = maxOutputBitsDepth - 8;
+    const int channels        = imageHasAlpha() ? 4 : 3;
+    int nbOutputBytesPerColor = (maxOutputBitsDepth > 8) ? channels * 2   // output data stored on 16 bits
+                                                         : channels;      // output data stored on 8 bits
 
     qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF output bytes per color:" << nbOutputBytesPerColor;
     qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF 16 to 8 bits coeff.   :" << div16;
     qCDebug(DIGIKAM_DIMG_LOG_HEIF) << "HEIF 8 to 16 bits coeff.   :" << mul8;
 
-    for (unsigned int y = 0 ; y < imageHeight() ; ++y)
-    {
-        src   = &imageData()[(y * imageWidth()) * imageBytesDepth()];
-        src16 = reinterpret_cast<unsigned short*>(src);
-        dst   = reinterpret_cast<unsigned char*>(data + (y * stride));
-        dst16 = reinterpret_cast<unsigned short*>(dst);
-
-        for (unsigned int x = 0 ; x < imageWidth() ; ++x)
-        {
-            if (imageSixteenBit())          // 16 bits source image.
-            {
-                b16 = src16[0];
-                g16 = src16[1];
-                r16 = src16[2];
+    const uchar* const srcData = imageData();
+    const int          width   = imageWidth();
+    const int          height  = imageHeight();
+    const int          depth   = imageBytesDepth();
+    const bool         src16   = imageSixteenBit();
 
-                if (imageHasAlpha())
-                {
-                    a16 = src16[3];
-                }
-
-                if (maxOutputBitsDepth > 8) // From 16 bits to 10 bits or more.
-                {
-                    dst16[0] = (unsigned short)(r16 >> div16);
-                    dst16[1] = (unsigned short)(g16 >> div16);
-                    dst16[2] = (unsigned short)(b16 >> div16);
+    // The rows are converted in parallel by chunks, the observer being checked between chunks.
 
-                    if (imageHasAlpha())
-                    {
-                        dst16[3] = (unsigned short)(a16 >> div16);
-                        dst16   += 4;
-                    }
-                    else
-                    {
-                        dst16 += 3;
-                    }
-                }
-                else                        // From 16 bits to 8 bits.
-                {
-                    dst[0] = (unsigned char)(r16 >> div16);
-                    dst[1] = (unsigned char)(g16 >> div16);
-                    dst[2] = (unsigned char)(b16 >> div16);
+    const int chunk            = m_observer ? granularity(m_observer, height, 0.8F) : height;
 
-                    if (imageHasAlpha())
-                    {
-                        dst[3] = (unsigned char)(a16 >> div16);
-                        dst   += 4;
-                    }
-                    else
-                    {
-                        dst += 3;
-                    }
-                }
+    for (int first = 0 ; first < height ; first += chunk)
+    {
+        const int rows = qMin(chunk, height - first);
 
-                src16 += 4;
-            }
-            else                            // 8 bits source image.
+        DImgPixelConverter::processRows(width, rows,
+            [srcData, data, stride, width, depth, src16, channels, maxOutputBitsDepth, div16, mul8, first](int begin, int end)
             {
-                b = src[0];
-                g = src[1];
-                r = src[2];
-
-                if (imageHasAlpha())
-                {
-                    a = src[3];
-                }
-
-                if (maxOutputBitsDepth > 8) // From 8 bits to 10 bits or more.
+                for (int y = first + begin ; y < first + end ; ++y)
                 {
-                    dst16[0] = (unsigned short)(r << mul8);
-                    dst16[1] = (unsigned short)(g << mul8);
-                    dst16[2] = (unsigned short)(b << mul8);
+                    const uchar* const src = srcData + (quint64)y * width * depth;
+                    uchar* const dst       = data    + (quint64)y * stride;
 
-                    if (imageHasAlpha())
+                    if      (src16 && (maxOutputBitsDepth > 8))     // From 16 bits to 10 bits or more.
                     {
-                        dst16[3] = (unsigned short)(a << mul8);
-                        dst16   += 4;
+                        DImgPixelConverter::fromBGRA16(reinterpret_cast<const ushort*>(src), reinterpret_cast<ushort*>(dst),
+                                                       width, channels, DImgPixelConverter::RGBOrder, div16);
                     }
-                    else
+                    else if (src16)                                 // From 16 bits to 8 bits.
                     {
-                        dst16 += 3;
+                        DImgPixelConverter::fromBGRA16To8(reinterpret_cast<const ushort*>(src), dst,
+                                                          width, channels, DImgPixelConverter::RGBOrder);
                     }
-                }
-                else                        // From 8 bits to 8 bits.
-                {
-                    dst[0] = r;
-                    dst[1] = g;
-                    dst[2] = b;
-
-                    if (imageHasAlpha())
+                    else if (maxOutputBitsDepth > 8)                // From 8 bits to 10 bits or more.
                     {
-                        dst[3] = a;
-                        dst   += 4;
+                        DImgPixelConverter::fromBGRA8To16(src, reinterpret_cast<ushort*>(dst),
+                                                          width, channels, DImgPixelConverter::RGBOrder, mul8);
                     }
-                    else
+                    else                                            // From 8 bits to 8 bits.
                     {
-                        dst += 3;
+                        DImgPixelConverter::fromBGRA8(src, dst, width, channels, DImgPixelConverter::RGBOrder);
                     }
                 }
-
-                src += 4;
             }
-        }
+        );
 
-        if (m_observer && (y == (unsigned int)checkpoint))
+        if (m_observer)
         {
-            checkpoint += granularity(m_observer, imageHeight(), 0.8F);
-
             if (!m_observer->continueQuery())
             {
+                heif_image_release(image);
                 heif_encoder_release(encoder);
                 heif_context_free(ctx);
 
@@ -409,10 +339,11 @@ bool DImgHEIFLoader::save(const QString& filePath, DImgLoaderObserver* const obs
                 heif_deinit();
 
 #endif
+
                 return false;
             }
 
-            m_observer->progressInfo(0.1F + (0.8F * (((float)y) / ((float)imageHeight()))));
+            m_observer->progressInfo(0.1F + (0.8F * (((float)(first + rows)) / ((float)height))));
         }
     }
 
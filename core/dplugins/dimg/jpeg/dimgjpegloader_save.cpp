@@ -34,6 +34,7 @@ extern "C"
 #include "digikam_debug.h"
 #include "digikam_config.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 
 #ifdef Q_OS_WIN
 #   include "jpegwin.h"
@@ -254,84 +255,40 @@ bool DImgJPEGLoader::save(const QString& filePath, DImgLoaderObserver* const obs
     // Write Image data.
 
     uchar* line       = new uchar[w * 3];
-    uchar* dstPtr     = nullptr;
     uint   checkPoint = 0;
     cleanupData->setLine(line);
 
-    if (!imageSixteenBit())     // 8 bits image.
+    for (uint j = 0; j < h; ++j)
     {
 
-        uchar* srcPtr = data;
-
-        for (uint j = 0; j < h; ++j)
+        if (observer && j == checkPoint)
         {
+            checkPoint += granularity(observer, h, 0.8F);
 
-            if (observer && j == checkPoint)
+            if (!observer->continueQuery())
             {
-                checkPoint += granularity(observer, h, 0.8F);
-
-                if (!observer->continueQuery())
-                {
-                    jpeg_destroy_compress(&cinfo);
-                    delete cleanupData;
-                    return false;
-                }
-
-                // use 0-20% for pseudo-progress, now fill 20-100%
-                observer->progressInfo(0.2F + (0.8F * (((float)j) / ((float)h))));
+                jpeg_destroy_compress(&cinfo);
+                delete cleanupData;
+                return false;
             }
 
-            dstPtr = line;
-
-            for (uint i = 0; i < w; ++i)
-            {
-                dstPtr[2] = srcPtr[0];  // Blue
-                dstPtr[1] = srcPtr[1];  // Green
-                dstPtr[0] = srcPtr[2];  // Red
+            // use 0-20% for pseudo-progress, now fill 20-100%
+            observer->progressInfo(0.2F + (0.8F * (((float)j) / ((float)h))));
+        }
 
-                srcPtr   += 4;
-                dstPtr   += 3;
-            }
+        const uchar* const srcPtr = data + (quint64)j * w * imageBytesDepth();
 
-            jpeg_write_scanlines(&cinfo, &line, 1);
+        if (!imageSixteenBit())     // 8 bits image.
+        {
+            DImgPixelConverter::fromBGRA8(srcPtr, line, w, 3, DImgPixelConverter::RGBOrder);
         }
-    }
-    else
-    {
-        unsigned short* srcPtr = reinterpret_cast<unsigned short*>(data);
-
-        for (uint j = 0; j < h; ++j)
+        else                        // 16 bits image.
         {
-
-            if (observer && j == checkPoint)
-            {
-                checkPoint += granularity(observer, h, 0.8F);
-
-                if (!observer->continueQuery())
-                {
-                    jpeg_destroy_compress(&cinfo);
-                    delete cleanupData;
-                    return false;
-                }
-
-                // use 0-20% for pseudo-progress, now fill 20-100%
-                observer->progressInfo(0.2F + (0.8F * (((float)j) / ((float)h))));
-            }
-
-            dstPtr = line;
-
-            for (uint i = 0; i < w; ++i)
-            {
-                dstPtr[2] = (srcPtr[0] * 255UL) / 65535UL;  // Blue
-                dstPtr[1] = (srcPtr[1] * 255UL) / 65535UL;  // Green
-                dstPtr[0] = (srcPtr[2] * 255UL) / 65535UL;  // Red
-
-                srcPtr   += 4;
-                dstPtr   += 3;
-            }
-
-            jpeg_write_scanlines(&cinfo, &line, 1);
+            DImgPixelConverter::fromBGRA16To8(reinterpret_cast<const ushort*>(srcPtr), line, w,
+                                              3, DImgPixelConverter::RGBOrder);
         }
+
+        jpeg_write_scanlines(&cinfo, &line, 1);
     }
 
     cleanupData->deleteLine();
@@ -20,6 +20,7 @@
 #include <QByteArray>
 #include <QTextStream>
 #include <QScopedPointer>
+#include <QVector>
 
 // Local includes
 
@@ -368,23 +369,38 @@ bool DImgJPEG2000Loader::load(const QString& filePath, DImgLoaderObserver* const
         }
     }
 
+    // -------------------------------------------------------------------
+    // Find out if we do the fast-track loading with reduced size.
+    // JasPer do not support resolution level reduction and always decodes
+    // the full image, but converted rows are box-filtered to the reduced
+    // size to not allocate the full size image.
+
+    const QSize originalSize(imageWidth(), imageHeight());
+    const int   reduction    = scaledLoadingFactor(imageWidth(), imageHeight());
+    const int   scaledWidth  = (imageWidth()  + reduction - 1) / reduction;
+    const int   scaledHeight = (imageHeight() + reduction - 1) / reduction;
+    const int   bytesDepth   = m_sixteenBit ? 8 : 4;
+
     // -------------------------------------------------------------------
     // Get image data.
 
     QScopedArrayPointer<uchar> data;
+    QScopedArrayPointer<uchar> rowData;
+    QVector<quint64>           sums;
 
     if (m_loadFlags & LoadImageData)
     {
-        if (m_sixteenBit)          // 16 bits image.
-        {
-            data.reset(new_failureTolerant(imageWidth(), imageHeight(), 8));
-        }
-        else
+        data.reset(new_failureTolerant(scaledWidth, scaledHeight, bytesDepth));
+
+        if (reduction > 1)
         {
-            data.reset(new_failureTolerant(imageWidth(), imageHeight(), 4));
+            qCDebug(DIGIKAM_DIMG_LOG_JP2K) << "JPEG2000 loaded with reduced size 1 /" << reduction;
+
+            rowData.reset(new_failureTolerant(imageWidth(), 1, bytesDepth));
+            sums.fill(0, scaledWidth * 4);
         }
 
-        if (!data)
+        if (!data || ((reduction > 1) && !rowData))
         {
             qCWarning(DIGIKAM_DIMG_LOG_JP2K) << "Error decoding JPEG2000 image data : Memory Allocation Failed";
             jas_image_destroy(jp2_image);
@@ -406,6 +422,14 @@ bool DImgJPEG2000Loader::load(const QString& filePath, DImgLoaderObserver* const
 
         for (y = 0 ; y < (long)imageHeight() ; ++y)
         {
+            if (reduction > 1)
+            {
+                // Convert the row in a temporary buffer before box-filtering.
+
+                dst   = rowData.data();
+                dst16 = reinterpret_cast<unsigned short*>(rowData.data());
+            }
+
             for (i = 0 ; i < (long)number_components ; ++i)
             {
                 int ret = jas_image_readcmpt(jp2_image, (short)components[i], 0,
@@ -539,6 +563,17 @@ bool DImgJPEG2000Loader::load(const QString& filePath, DImgLoaderObserver* const
                 }
             }
 
+            if (reduction > 1)
+            {
+                addRowToScaledBoxes(rowData.data(), imageWidth(), m_sixteenBit, reduction, sums.data());
+
+                if ((((y + 1) % reduction) == 0) || (y == ((long)imageHeight() - 1)))
+                {
+                    writeScaledBoxesRow(sums.data(), imageWidth(), (y % reduction) + 1, m_sixteenBit, reduction,
+                                        data.data() + (quint64)(y / reduction) * (quint64)scaledWidth * bytesDepth);
+                }
+            }
+
             // Use 0-10% and 90-100% for pseudo-progress
 
             if (observer && y >= (long)checkPoint)
@@ -619,10 +654,16 @@ bool DImgJPEG2000Loader::load(const QString& filePath, DImgLoaderObserver* const
         observer->progressInfo(1.0F);
     }
 
+    if (m_loadFlags & LoadImageData)
+    {
+        imageWidth()  = scaledWidth;
+        imageHeight() = scaledHeight;
+    }
+
     imageData() = data.take();
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   maximum_component_depth);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(imageWidth(), imageHeight()));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     jas_image_destroy(jp2_image);
 
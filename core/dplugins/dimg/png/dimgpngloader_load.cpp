@@ -43,6 +43,7 @@ extern "C"
 #include "digikam_config.h"
 #include "digikam_version.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 
 // libPNG includes
 
@@ -173,6 +174,8 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         CleanupData()
           : data (nullptr),
             lines(nullptr),
+            row  (nullptr),
+            sums (nullptr),
             file (nullptr),
             cmod (0)
         {
@@ -182,6 +185,7 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         {
             delete [] data;
             freeLines();
+            freeRowBuffers();
 
             if (file)
             {
@@ -199,6 +203,12 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
             lines = l;
         }
 
+        void setRowBuffers(uchar* const r, quint64* const s)
+        {
+            row  = r;
+            sums = s;
+        }
+
         void setFile(FILE* const f)
         {
             file = f;
@@ -209,6 +219,11 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
             size = s;
         }
 
+        void setOriginalSize(const QSize& s)
+        {
+            originalSize = s;
+        }
+
         void setColorModel(int c)
         {
             cmod = c;
@@ -229,14 +244,33 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
             lines = nullptr;
         }
 
+        void freeRowBuffers()
+        {
+            if (row)
+            {
+                free(row);
+            }
+
+            if (sums)
+            {
+                free(sums);
+            }
+
+            row  = nullptr;
+            sums = nullptr;
+        }
+
     public:
 
-        uchar*  data;
-        uchar** lines;
-        FILE*   file;
+        uchar*   data;
+        uchar**  lines;
+        uchar*   row;
+        quint64* sums;
+        FILE*    file;
 
-        QSize  size;
-        int    cmod;
+        QSize    size;
+        QSize    originalSize;
+        int      cmod;
     };
 
     CleanupData* const cleanupData = new CleanupData;
@@ -281,7 +315,7 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
         imageSetAttribute(QLatin1String("format"),             QLatin1String("PNG"));
         imageSetAttribute(QLatin1String("originalColorModel"), cleanupData->cmod);
         imageSetAttribute(QLatin1String("originalBitDepth"),   m_sixteenBit ? 16 : 8);
-        imageSetAttribute(QLatin1String("originalSize"),       cleanupData->size);
+        imageSetAttribute(QLatin1String("originalSize"),       cleanupData->originalSize);
 
         cleanupData->takeData();
         delete cleanupData;
@@ -326,6 +360,16 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
     width  = (int)w32;
     height = (int)h32;
 
+    QSize originalSize(width, height);
+
+    // -------------------------------------------------------------------
+    // Find out if we do the fast-track loading with reduced size.
+    // Non-interlaced images are decoded row by row and box-filtered
+    // to the reduced size, without allocating the full size image.
+    // Interlaced images need all passes on the full size buffer.
+
+    int scale = (interlace_type == PNG_INTERLACE_NONE) ? scaledLoadingFactor(width, height) : 1;
+
     int colorModel = DImg::COLORMODELUNKNOWN;
     m_sixteenBit   = (bit_depth == 16);
 
@@ -368,7 +412,9 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
     }
 
     cleanupData->setColorModel(colorModel);
-    cleanupData->setSize(QSize(width, height));
+    cleanupData->setOriginalSize(originalSize);
+    cleanupData->setSize(QSize((width  + scale - 1) / scale,
+                               (height + scale - 1) / scale));
 
     uchar* data  = nullptr;
 
@@ -530,6 +576,13 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
 
         //png_set_swap_alpha(png_ptr);
 
+        if ((scale > 1) && m_sixteenBit && (QSysInfo::ByteOrder == QSysInfo::LittleEndian))
+        {
+            // Samples must be in host order for box-filtering.
+
+            png_set_swap(png_ptr);
+        }
+
         if (observer)
         {
             observer->progressInfo(0.1F);
@@ -544,51 +597,31 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
 
         png_read_update_info(png_ptr, info_ptr);
 
-        if (m_sixteenBit)
-        {
-            data = new_failureTolerant(width, height, 8); // 16 bits/color/pixel
-        }
-        else
+        if (scale > 1)
         {
-            data = new_failureTolerant(width, height, 4); // 8 bits/color/pixel
-        }
+            qCDebug(DIGIKAM_DIMG_LOG_PNG) << "PNG loaded with reduced size 1 /" << scale;
 
-        cleanupData->setData(data);
+            const int bytesDepth = m_sixteenBit ? 8 : 4;
+            const int scaledW    = cleanupData->size.width();
+            const int scaledH    = cleanupData->size.height();
 
-        uchar** lines = nullptr;
-        (void)lines;    // to prevent cppcheck warnings.
-        lines         = (uchar**)malloc(height * sizeof(uchar*));
-        cleanupData->setLines(lines);
+            data                 = new_failureTolerant(scaledW, scaledH, bytesDepth);
+            cleanupData->setData(data);
 
-        if (!data || !lines)
-        {
-            qCDebug(DIGIKAM_DIMG_LOG_PNG) << "Cannot allocate memory to load PNG image data.";
-            png_read_end(png_ptr, info_ptr);
-            png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp) nullptr);
-            delete cleanupData;
-            loadingFailed();
-            return false;
-        }
+            uchar*   row         = (uchar*)malloc((size_t)width * bytesDepth);
+            quint64* sums        = (quint64*)calloc((size_t)scaledW * 4, sizeof(quint64));
+            cleanupData->setRowBuffers(row, sums);
 
-        for (int i = 0 ; i < height ; ++i)
-        {
-            if (m_sixteenBit)
-            {
-                lines[i] = data + ((quint64)i * (quint64)width * 8);
-            }
-            else
+            if (!data || !row || !sums)
             {
-                lines[i] = data + ((quint64)i * (quint64)width * 4);
+                qCDebug(DIGIKAM_DIMG_LOG_PNG) << "Cannot allocate memory to load PNG image data.";
+                png_read_end(png_ptr, info_ptr);
+                png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp) nullptr);
+                delete cleanupData;
+                loadingFailed();
+                return false;
             }
-        }
 
-        // The easy way to read the whole image
-        // png_read_image(png_ptr, lines);
-        // The other way to read images is row by row. Necessary for observer.
-        // Now we need to deal with interlacing.
-
-        for (int pass = 0 ; pass < number_passes ; ++pass)
-        {
             int checkPoint = 0;
 
             for (int y = 0 ; y < height ; ++y)
@@ -609,35 +642,116 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
                     observer->progressInfo(0.1F + (0.7F * (((float)y) / ((float)height))));
                 }
 
-                png_read_rows(png_ptr, lines + y, nullptr, 1);
+                png_read_rows(png_ptr, &row, nullptr, 1);
+
+                addRowToScaledBoxes(row, width, m_sixteenBit, scale, sums);
+
+                // Write the destination row when the vertical boxes are complete.
+
+                if ((((y + 1) % scale) == 0) || (y == (height - 1)))
+                {
+                    writeScaledBoxesRow(sums, width, (y % scale) + 1, m_sixteenBit, scale,
+                                        data + (quint64)(y / scale) * (quint64)scaledW * bytesDepth);
+                }
             }
-        }
 
-        cleanupData->freeLines();
+            cleanupData->freeRowBuffers();
 
-        if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+            width  = scaledW;
+            height = scaledH;
+        }
+        else
         {
-            // Swap bytes in 16 bits/color/pixel for DImg
-
             if (m_sixteenBit)
             {
-                uchar ptr[8];   // One pixel to swap
+                data = new_failureTolerant(width, height, 8); // 16 bits/color/pixel
+            }
+            else
+            {
+                data = new_failureTolerant(width, height, 4); // 8 bits/color/pixel
+            }
+
+            cleanupData->setData(data);
+
+            uchar** lines = nullptr;
+            (void)lines;    // to prevent cppcheck warnings.
+            lines         = (uchar**)malloc(height * sizeof(uchar*));
+            cleanupData->setLines(lines);
+
+            if (!data || !lines)
+            {
+                qCDebug(DIGIKAM_DIMG_LOG_PNG) << "Cannot allocate memory to load PNG image data.";
+                png_read_end(png_ptr, info_ptr);
+                png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp) nullptr);
+                delete cleanupData;
+                loadingFailed();
+                return false;
+            }
 
-                for (uint p = 0 ; p < (uint)width * height * 8 ; p += 8)
+            for (int i = 0 ; i < height ; ++i)
+            {
+                if (m_sixteenBit)
                 {
-                    memcpy(&ptr[0], &data[p], 8);   // Current pixel
-
-                    data[  p  ] = ptr[1]; // Blue
-                    data[p + 1] = ptr[0];
-                    data[p + 2] = ptr[3]; // Green
-                    data[p + 3] = ptr[2];
-                    data[p + 4] = ptr[5]; // Red
-                    data[p + 5] = ptr[4];
-                    data[p + 6] = ptr[7]; // Alpha
-                    data[p + 7] = ptr[6];
+                    lines[i] = data + ((quint64)i * (quint64)width * 8);
+                }
+                else
+                {
+                    lines[i] = data + ((quint64)i * (quint64)width * 4);
+                }
+            }
+
+            // The easy way to read the whole image
+            // png_read_image(png_ptr, lines);
+            // The other way to read images is row by row. Necessary for observer.
+            // Now we need to deal with interlacing.
+
+            for (int pass = 0 ; pass < number_passes ; ++pass)
+            {
+                int checkPoint = 0;
+
+                for (int y = 0 ; y < height ; ++y)
+                {
+                    if (observer && y == checkPoint)
+                    {
+                        checkPoint += granularity(observer, height, 0.7F);
+
+                        if (!observer->continueQuery())
+                        {
+                            png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp) nullptr);
+                            delete cleanupData;
+                            loadingFailed();
+                            return false;
+                        }
+
+                        // use 10% - 80% for progress while reading rows
+                        observer->progressInfo(0.1F + (0.7F * (((float)y) / ((float)height))));
+                    }
+
+                    png_read_rows(png_ptr, lines + y, nullptr, 1);
+                }
+            }
+
+            cleanupData->freeLines();
+
+            if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+            {
+                // Swap bytes in 16 bits/color/pixel for DImg
+
+                if (m_sixteenBit)
+                {
+                    ushort* const data16 = reinterpret_cast<ushort*>(data);
+                    const qint64  rowLen = (qint64)width * 4;
+
+                    DImgPixelConverter::processRows(width, height,
+                        [data16, rowLen](int begin, int end)
+                        {
+                            DImgPixelConverter::swapBytes16(data16 + begin * rowLen, (end - begin) * rowLen);
+                        }
+                    );
                 }
             }
         }
+
     }
 
     if (observer)
@@ -736,7 +850,7 @@ bool DImgPNGLoader::load(const QString& filePath, DImgLoaderObserver* const obse
     imageSetAttribute(QLatin1String("format"),             QLatin1String("PNG"));
     imageSetAttribute(QLatin1String("originalColorModel"), colorModel);
     imageSetAttribute(QLatin1String("originalBitDepth"),   bit_depth);
-    imageSetAttribute(QLatin1String("originalSize"),       QSize(width, height));
+    imageSetAttribute(QLatin1String("originalSize"),       originalSize);
 
     return true;
 }
@@ -41,6 +41,7 @@ extern "C"
 #include "digikam_config.h"
 #include "digikam_version.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 
 // libPNG includes
 
@@ -68,7 +69,7 @@ bool DImgPNGLoader::save(const QString& filePath, DImgLoaderObserver* const obse
 {
     png_structp    png_ptr;
     png_infop      info_ptr;
-    uint           x, y, j;
+    uint           y;
     png_bytep      row_ptr;
     png_color_8    sig_bit;
     FILE*          f           = nullptr;
@@ -341,7 +342,8 @@ bool DImgPNGLoader::save(const QString& filePath, DImgLoaderObserver* const obse
     png_set_packing(png_ptr);
     ptr = imageData();
 
-    uint checkPoint = 0;
+    const int channels = imageHasAlpha() ? 4 : 3;
+    uint checkPoint    = 0;
 
     for (y = 0 ; y < imageHeight() ; ++y)
     {
@@ -361,62 +363,22 @@ bool DImgPNGLoader::save(const QString& filePath, DImgLoaderObserver* const obse
             observer->progressInfo(0.2F + (0.8F * (((float)y) / ((float)imageHeight()))));
         }
 
-        j = 0;
+        // PNG rows are written as BGR or BGRA, with big endian 16 bits values.
 
-        if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+        if (imageSixteenBit())
         {
-            for (x = 0 ; x < imageWidth()*imageBytesDepth() ; x += imageBytesDepth())
+            DImgPixelConverter::fromBGRA16(reinterpret_cast<const ushort*>(ptr),
+                                           reinterpret_cast<ushort*>(data),
+                                           imageWidth(), channels, DImgPixelConverter::BGROrder);
+
+            if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
             {
-                if (imageSixteenBit())
-                {
-                    if (imageHasAlpha())
-                    {
-                        data[j++] = ptr[x + 1]; // Blue
-                        data[j++] = ptr[  x  ];
-                        data[j++] = ptr[x + 3]; // Green
-                        data[j++] = ptr[x + 2];
-                        data[j++] = ptr[x + 5]; // Red
-                        data[j++] = ptr[x + 4];
-                        data[j++] = ptr[x + 7]; // Alpha
-                        data[j++] = ptr[x + 6];
-                    }
-                    else
-                    {
-                        data[j++] = ptr[x + 1]; // Blue
-                        data[j++] = ptr[  x  ];
-                        data[j++] = ptr[x + 3]; // Green
-                        data[j++] = ptr[x + 2];
-                        data[j++] = ptr[x + 5]; // Red
-                        data[j++] = ptr[x + 4];
-                    }
-                }
-                else
-                {
-                    if (imageHasAlpha())
-                    {
-                        data[j++] = ptr[  x  ]; // Blue
-                        data[j++] = ptr[x + 1]; // Green
-                        data[j++] = ptr[x + 2]; // Red
-                        data[j++] = ptr[x + 3]; // Alpha
-                    }
-                    else
-                    {
-                        data[j++] = ptr[  x  ]; // Blue
-                        data[j++] = ptr[x + 1]; // Green
-                        data[j++] = ptr[x + 2]; // Red
-                    }
-                }
+                DImgPixelConverter::swapBytes16(reinterpret_cast<ushort*>(data), (qint64)imageWidth() * channels);
             }
         }
         else
         {
-            int bytes = (imageSixteenBit() ? 2 : 1) * (imageHasAlpha() ? 4 : 3);
-
-            for (x = 0 ; x < imageWidth()*imageBytesDepth() ; x += imageBytesDepth())
-            {
-                memcpy(data + j, ptr + x, bytes);
-                j += bytes;
-            }
+            DImgPixelConverter::fromBGRA8(ptr, data, imageWidth(), channels, DImgPixelConverter::BGROrder);
         }
 
         row_ptr = (png_bytep) data;
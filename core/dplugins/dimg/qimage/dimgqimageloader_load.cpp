@@ -26,6 +26,7 @@
 
 #include "digikam_debug.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 
 namespace DigikamQImageDImgPlugin
 {
@@ -120,7 +121,7 @@ bool DImgQImageLoader::load(const QString& filePath, DImgLoaderObserver* const o
         qCDebug(DIGIKAM_DIMG_LOG_QIMAGE) << filePath << "is a 8 bits per color per pixels QImage";
 
         m_hasAlpha    = (image.hasAlphaChannel() && (readFormat != "psd"));
-        target        = image.convertToFormat(QImage::Format_ARGB32);
+        target        = image.convertToFormat(QImage::Format_RGBA8888);
         w             = target.width();
         h             = target.height();
         data          = new_failureTolerant(w, h, 4);
@@ -132,19 +133,18 @@ bool DImgQImageLoader::load(const QString& filePath, DImgLoaderObserver* const o
             return false;
         }
 
-        const QRgb* sptr = reinterpret_cast<const QRgb*>(target.constBits());
-        uchar*      dptr = data;
-
-        for (uint i = 0 ; i < w * h ; ++i)
-        {
-            dptr[0] = qBlue(*sptr);
-            dptr[1] = qGreen(*sptr);
-            dptr[2] = qRed(*sptr);
-            dptr[3] = m_hasAlpha ? qAlpha(*sptr) : 255;
-
-            dptr   += 4;
-            sptr++;
-        }
+        const bool hasAlpha = m_hasAlpha;
+
+        DImgPixelConverter::processRows(w, h,
+            [&target, data, w, hasAlpha](int begin, int end)
+            {
+                for (int y = begin ; y < end ; ++y)
+                {
+                    DImgPixelConverter::toBGRA8(target.constScanLine(y), data + (quint64)y * w * 4, w,
+                                                4, DImgPixelConverter::RGBOrder, hasAlpha);
+                }
+            }
+        );
     }
     else
     {
@@ -163,19 +163,21 @@ bool DImgQImageLoader::load(const QString& filePath, DImgLoaderObserver* const o
             return false;
         }
 
-        const QRgba64* sptr = reinterpret_cast<const QRgba64*>(target.constBits());
-        ushort*        dptr = reinterpret_cast<ushort*>(data);
-
-        for (uint i = 0 ; i < w * h ; ++i)
-        {
-            dptr[0] = (*sptr).blue();
-            dptr[1] = (*sptr).green();
-            dptr[2] = (*sptr).red();
-            dptr[3] = m_hasAlpha ? (*sptr).alpha() : 65535;
-
-            dptr   += 4;
-            sptr++;
-        }
+        // QRgba64 values are stored as red, green, blue and alpha 16 bits values in memory.
+
+        const bool hasAlpha = m_hasAlpha;
+
+        DImgPixelConverter::processRows(w, h,
+            [&target, data, w, hasAlpha](int begin, int end)
+            {
+                for (int y = begin ; y < end ; ++y)
+                {
+                    DImgPixelConverter::toBGRA16(reinterpret_cast<const ushort*>(target.constScanLine(y)),
+                                                 reinterpret_cast<ushort*>(data + (quint64)y * w * 8), w,
+                                                 4, DImgPixelConverter::RGBOrder, hasAlpha);
+                }
+            }
+        );
     }
 
     if (m_loadFlags & LoadICCData)
@@ -35,6 +35,7 @@ extern "C"
 #include "digikam_debug.h"
 #include "digikam_config.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 #include "dimgtiffloader.h"     //krazy:exclude=includes
 
 namespace DigikamTIFFDImgPlugin
@@ -372,26 +373,24 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
                 else if ((samples_per_pixel == 3) &&
                          (planar_config == PLANARCONFIG_CONTIG))
                 {
-                    for (int i = 0 ; i < (bytesRead / 6) ; ++i)
+                    if (sample_format == SAMPLEFORMAT_IEEEFP)
                     {
-                        p = dataPtr;
-
-                        if (sample_format == SAMPLEFORMAT_IEEEFP)
+                        for (int i = 0 ; i < (bytesRead / 6) ; ++i)
                         {
+                            p = dataPtr;
+
                             p[2] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
                             p[1] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
                             p[0] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
                             p[3] = 0xFFFF;
-                        }
-                        else
-                        {
-                            p[2] = *stripPtr++;
-                            p[1] = *stripPtr++;
-                            p[0] = *stripPtr++;
-                            p[3] = 0xFFFF;
-                        }
 
-                        dataPtr += 4;
+                            dataPtr += 4;
+                        }
+                    }
+                    else
+                    {
+                        DImgPixelConverter::toBGRA16(stripPtr, dataPtr, bytesRead / 6, 3,
+                                                     DImgPixelConverter::RGBOrder, false);
                     }
 
                     offset += bytesRead / 6 * 8;
@@ -474,26 +473,24 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
                 else if ((samples_per_pixel == 4) &&
                          (planar_config == PLANARCONFIG_CONTIG))
                 {
-                    for (int i = 0 ; i < (bytesRead / 8) ; ++i)
+                    if (sample_format == SAMPLEFORMAT_IEEEFP)
                     {
-                        p = dataPtr;
-
-                        if (sample_format == SAMPLEFORMAT_IEEEFP)
+                        for (int i = 0 ; i < (bytesRead / 8) ; ++i)
                         {
+                            p = dataPtr;
+
                             p[2] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
                             p[1] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
                             p[0] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
                             p[3] = (ushort)qBound(0.0F, (*reinterpret_cast<qfloat16*>(stripPtr++)) * 65535.0F, 65535.0F);
-                        }
-                        else
-                        {
-                            p[2] = *stripPtr++;
-                            p[1] = *stripPtr++;
-                            p[0] = *stripPtr++;
-                            p[3] = *stripPtr++;
-                        }
 
-                        dataPtr += 4;
+                            dataPtr += 4;
+                        }
+                    }
+                    else
+                    {
+                        DImgPixelConverter::toBGRA16(stripPtr, dataPtr, bytesRead / 8, 4,
+                                                     DImgPixelConverter::RGBOrder, true);
                     }
 
                     offset += bytesRead;
@@ -906,20 +903,16 @@ bool DImgTIFFLoader::load(const QString& filePath, DImgLoaderObserver* const obs
 
                 uchar* stripPtr = (uchar*)(strip.data());
                 uchar* dataPtr  = (uchar*)(data.data() + offset);
-                uchar* p        = nullptr;
 
                 // Reverse red and blue
 
-                for (int i = 0 ; i < pixelsRead ; ++i)
+                for (uint i = 0 ; i < rows_to_read ; ++i)
                 {
-                    p        = dataPtr;
-
-                    p[2]     = *stripPtr++;
-                    p[1]     = *stripPtr++;
-                    p[0]     = *stripPtr++;
-                    p[3]     = *stripPtr++;
+                    DImgPixelConverter::toBGRA8(stripPtr, dataPtr, img.width, 4,
+                                                DImgPixelConverter::RGBOrder, true);
 
-                    dataPtr += 4;
+                    stripPtr += (quint64)img.width * 4;
+                    dataPtr  += (quint64)img.width * 4;
                 }
 
                 offset += pixelsRead * 4;
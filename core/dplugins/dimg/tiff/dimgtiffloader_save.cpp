@@ -34,6 +34,7 @@ extern "C"
 #include "digikam_debug.h"
 #include "digikam_config.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 #include "dimgtiffloader.h"     //krazy:exclude=includes
 
 namespace DigikamTIFFDImgPlugin
@@ -195,23 +196,9 @@ bool DImgTIFFLoader::save(const QString& filePath, DImgLoaderObserver* const obs
         observer->progressInfo(0.1F);
     }
 
-    uchar*  pixel        = nullptr;
-    uint16* pixel16      = nullptr;
-    double  alpha_factor = 0;
-    uint32  x            = 0;
-    uint32  y            = 0;
-    uint8   r8           = 0;
-    uint8   g8           = 0;
-    uint8   b8           = 0;
-    uint8   a8           = 0;
-    uint16  r16          = 0;
-    uint16  g16          = 0;
-    uint16  b16          = 0;
-    uint16  a16          = 0;
-    int     i            = 0;
-
-    uint8* buf    = (uint8*)_TIFFmalloc(TIFFScanlineSize(tif));
-    uint16* buf16 = nullptr;
+    uint32    y        = 0;
+    const int channels = imageHasAlpha() ? 4 : 3;
+    uint8*    buf      = (uint8*)_TIFFmalloc(TIFFScanlineSize(tif));
 
     if (!buf)
     {
@@ -239,71 +226,33 @@ bool DImgTIFFLoader::save(const QString& filePath, DImgLoaderObserver* const obs
             observer->progressInfo(0.1F + (0.8F * (((float)y) / ((float)h))));
         }
 
-        i = 0;
+        const uchar* const pixel = &data[(quint64)y * w * imageBytesDepth()];
 
-        for (x = 0 ; x < w ; ++x)
+        if (imageSixteenBit())          // 16 bits image.
         {
-            pixel = &data[((y * w) + x) * imageBytesDepth()];
+            // This might be endian dependent
+
+            uint16* const buf16 = reinterpret_cast<uint16*>(buf);
+
+            DImgPixelConverter::fromBGRA16(reinterpret_cast<const ushort*>(pixel), buf16, w,
+                                           channels, DImgPixelConverter::RGBOrder);
 
-            if (imageSixteenBit())          // 16 bits image.
+            if (imageHasAlpha())
             {
-                pixel16 = reinterpret_cast<ushort*>(pixel);
-                b16 = pixel16[0];
-                g16 = pixel16[1];
-                r16 = pixel16[2];
-
-                if (imageHasAlpha())
-                {
-                    // TIFF makes you pre-multiply the RGB components by alpha
-
-                    a16          = pixel16[3];
-                    alpha_factor = ((double)a16 / 65535.0);
-                    r16          = (uint16)(r16 * alpha_factor);
-                    g16          = (uint16)(g16 * alpha_factor);
-                    b16          = (uint16)(b16 * alpha_factor);
-                }
-
-                // This might be endian dependent
-
-                buf16    = reinterpret_cast<ushort*>(buf+i);
-                *buf16++ = r16;
-                *buf16++ = g16;
-                *buf16++ = b16;
-                i       += 6;
-
-                if (imageHasAlpha())
-                {
-                    *buf16++ = a16;
-                    i       += 2;
-                }
+                // TIFF makes you pre-multiply the RGB components by alpha
+
+                DImgPixelConverter::premultiplyAlpha16(buf16, w);
             }
-            else                            // 8 bits image.
+        }
+        else                            // 8 bits image.
+        {
+            DImgPixelConverter::fromBGRA8(pixel, buf, w, channels, DImgPixelConverter::RGBOrder);
+
+            if (imageHasAlpha())
             {
-                b8 = (uint8)pixel[0];
-                g8 = (uint8)pixel[1];
-                r8 = (uint8)pixel[2];
-
-                if (imageHasAlpha())
-                {
-                    // TIFF makes you pre-multiply the RGB components by alpha
-
-                    a8           = (uint8)(pixel[3]);
-                    alpha_factor = ((double)a8 / 255.0);
-                    r8           = (uint8)(r8 * alpha_factor);
-                    g8           = (uint8)(g8 * alpha_factor);
-                    b8           = (uint8)(b8 * alpha_factor);
-                }
-
-                // This might be endian dependent
-
-                buf[i++] = r8;
-                buf[i++] = g8;
-                buf[i++] = b8;
-
-                if (imageHasAlpha())
-                {
-                    buf[i++] = a8;
-                }
+                // TIFF makes you pre-multiply the RGB components by alpha
+
+                DImgPixelConverter::premultiplyAlpha8(buf, w);
             }
         }
 
@@ -335,8 +284,6 @@ bool DImgTIFFLoader::save(const QString& filePath, DImgLoaderObserver* const obs
     TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE,   8);
     TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP,    TIFFDefaultStripSize(tif, 0));
 
-    uchar* pixelThumb = nullptr;
-    uchar* dataThumb  = thumb.bits();
     uint8* bufThumb   = (uint8*) _TIFFmalloc(TIFFScanlineSize(tif));
 
     if (!bufThumb)
@@ -348,17 +295,10 @@ bool DImgTIFFLoader::save(const QString& filePath, DImgLoaderObserver* const obs
 
     for (y = 0 ; y < uint32(thumb.height()) ; ++y)
     {
-        i = 0;
-
-        for (x = 0 ; x < uint32(thumb.width()) ; ++x)
-        {
-            pixelThumb    = &dataThumb[((y * thumb.width()) + x) * 4];
+        // This might be endian dependent
 
-            // This might be endian dependent
-            bufThumb[i++] = (uint8)pixelThumb[2];
-            bufThumb[i++] = (uint8)pixelThumb[1];
-            bufThumb[i++] = (uint8)pixelThumb[0];
-        }
+        DImgPixelConverter::fromBGRA8(thumb.constScanLine(y), bufThumb, thumb.width(),
+                                      3, DImgPixelConverter::RGBOrder);
 
         if (!TIFFWriteScanline(tif, bufThumb, y, 0))
         {
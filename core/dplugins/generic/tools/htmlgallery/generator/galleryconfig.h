@@ -113,6 +113,9 @@ public:
     void setImageSelectionTitle(const QString&);
     QString imageSelectionTitle() const;
 
+    void setIncrementalExport(bool);
+    bool incrementalExport() const;
+
 protected:
 
     QString    m_theme;
@@ -129,6 +132,7 @@ protected:
     QUrl       m_destUrl;
     int        m_openInBrowser;
     QString    m_imageSelectionTitle; // Gallery title to use for GalleryInfo::ImageGetOption::IMAGES selection.
+    bool       m_incrementalExport;   // Only regenerate items which changed since the last export.
 };
 
 } // namespace DigikamGenericHtmlGalleryPlugin
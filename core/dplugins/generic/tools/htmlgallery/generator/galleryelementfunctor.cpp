@@ -36,7 +36,9 @@
 #include "galleryinfo.h"
 #include "gallerygenerator.h"
 #include "galleryelement.h"
+#include "galleryexportcache.h"
 #include "metaengine_rotation.h"
+#include "dimg.h"
 #include "drawdecoder.h"
 #include "drawinfo.h"
 
@@ -77,11 +79,22 @@ static QImage generateThumbnail(const QImage& fullImage, int size, bool square)
 
 GalleryElementFunctor::GalleryElementFunctor(GalleryGenerator* const generator,
                                              GalleryInfo* const info,
-                                             const QString& destDir)
+                                             const QString& destDir,
+                                             GalleryExportCache* const cache)
     : m_generator(generator),
       m_info     (info),
-      m_destDir  (destDir)
+      m_destDir  (destDir),
+      m_cache    (cache)
 {
+    if (m_cache)
+    {
+        // Reserve the names used by the previous export, for new items to not overwrite them.
+
+        Q_FOREACH (const QString& name, m_cache->baseFileNames())
+        {
+            m_uniqueNameHelper.makeNameUnique(name);
+        }
+    }
 }
 
 GalleryElementFunctor::~GalleryElementFunctor()
@@ -90,13 +103,30 @@ GalleryElementFunctor::~GalleryElementFunctor()
 
 void GalleryElementFunctor::operator()(GalleryElement& element)
 {
+    // Check if the item can be taken as well from a previous export.
+
+    if (m_cache && m_cache->restore(element))
+    {
+        return;
+    }
+
     // Load image
 
     QString    path = element.m_path;
     QImage     originalImage;
+    QSize      originalSize;
     QString    imageFormat;
     QByteArray imageData;
 
+    // The original file data are only needed if they are copied as-is to the gallery.
+
+    bool needImageData = (m_info->useOriginalImageAsFullImage() || m_info->copyOriginalImage());
+
+    // When full images are resized, a reduced version of the original is enough.
+
+    int  scaledSize    = (!m_info->useOriginalImageAsFullImage() && m_info->fullResize()) ? m_info->fullSize()
+                                                                                          : 0;
+
     // Check if RAW file.
 
     if (DRawDecoder::isRawFile(QUrl::fromLocalFile(path)))
@@ -106,6 +136,8 @@ void GalleryElementFunctor::operator()(GalleryElement& element)
             emitWarning(i18n("Error loading RAW image '%1'", QDir::toNativeSeparators(path)));
             return;
         }
+
+        originalSize = originalImage.size();
     }
     else
     {
@@ -126,13 +158,40 @@ void GalleryElementFunctor::operator()(GalleryElement& element)
             return;
         }
 
-        imageData = imageFile.readAll();
+        if (needImageData)
+        {
+            imageData = imageFile.readAll();
+        }
+
         imageFile.close();
 
-        if (!originalImage.loadFromData(imageData))
+        if (scaledSize > 0)
         {
-            emitWarning(i18n("Error loading image '%1'", QDir::toNativeSeparators(path)));
-            return;
+            // Only read the image dimensions from the header.
+
+            originalSize = QImageReader(path).size();
+
+            if (!loadScaledImage(path, scaledSize, originalImage))
+            {
+                emitWarning(i18n("Error loading image '%1'", QDir::toNativeSeparators(path)));
+                return;
+            }
+        }
+        else
+        {
+            bool loaded = needImageData ? originalImage.loadFromData(imageData)
+                                        : originalImage.load(path);
+
+            if (!loaded)
+            {
+                emitWarning(i18n("Error loading image '%1'", QDir::toNativeSeparators(path)));
+                return;
+            }
+        }
+
+        if (!originalSize.isValid())
+        {
+            originalSize = originalImage.size();
         }
     }
 
@@ -159,8 +218,15 @@ void GalleryElementFunctor::operator()(GalleryElement& element)
 
     // Save images
 
-    QString baseFileName = GalleryGenerator::webifyFileName(element.m_title);
-    baseFileName         = m_uniqueNameHelper.makeNameUnique(baseFileName);
+    // Reuse the name from the previous export, to overwrite the outdated files.
+
+    QString baseFileName = m_cache ? m_cache->baseFileName(path) : QString();
+
+    if (baseFileName.isEmpty())
+    {
+        baseFileName = GalleryGenerator::webifyFileName(element.m_title);
+        baseFileName = m_uniqueNameHelper.makeNameUnique(baseFileName);
+    }
 
     // Save full
 
@@ -204,7 +270,7 @@ void GalleryElementFunctor::operator()(GalleryElement& element)
         }
 
         element.m_originalFileName = originalFileName;
-        element.m_originalSize     = originalImage.size();
+        element.m_originalSize     = originalSize;
     }
 
     // Save thumbnail
@@ -495,6 +561,41 @@ void GalleryElementFunctor::operator()(GalleryElement& element)
     {
         element.m_exifGPSLongitude = unavailable;
     }
+
+    if (m_cache)
+    {
+        m_cache->store(element, baseFileName);
+    }
+}
+
+bool GalleryElementFunctor::loadScaledImage(const QString& path, int size, QImage& image)
+{
+    // First, try the preview embedded in the file if it is large enough.
+
+    QScopedPointer<DMetadata> meta(new DMetadata);
+    QImage preview;
+
+    if (meta->load(path) && meta->getItemPreview(preview) &&
+        (qMax(preview.width(), preview.height()) >= size))
+    {
+        image = preview;
+
+        return true;
+    }
+
+    // Else use the DImg loaders, which decode JPEG and PGF at a reduced size in the DCT domain.
+
+    DImg img;
+    img.setAttribute(QLatin1String("scaledLoadingSize"), size);
+
+    if (!img.load(path, false, false, false, false))
+    {
+        return false;
+    }
+
+    image = img.copyQImage();
+
+    return !image.isNull();
 }
 
 bool GalleryElementFunctor::writeDataToFile(const QByteArray& data, const QString& destPath)
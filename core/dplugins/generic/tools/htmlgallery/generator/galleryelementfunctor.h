@@ -16,6 +16,10 @@
 #ifndef DIGIKAM_GALLERY_ELEMENT_FUNCTOR_H
 #define DIGIKAM_GALLERY_ELEMENT_FUNCTOR_H
 
+// Qt includes
+
+#include <QImage>
+
 // Local includes
 
 #include "gallerynamehelper.h"
@@ -26,11 +30,14 @@ namespace DigikamGenericHtmlGalleryPlugin
 class GalleryInfo;
 class GalleryGenerator;
 class GalleryElement;
+class GalleryExportCache;
 
 /**
  * This functor generates images (full and thumbnail) for an url and returns an
  * GalleryElement initialized to fill the xml writer.
  * It is used as an argument to QtConcurrent::mapped().
+ * If an export cache is passed, items unchanged since the previous export are
+ * not generated again.
  */
 class GalleryElementFunctor
 {
@@ -42,13 +49,15 @@ public:
 
     explicit GalleryElementFunctor(GalleryGenerator* const generator,
                                    GalleryInfo* const info,
-                                   const QString& destDir);
+                                   const QString& destDir,
+                                   GalleryExportCache* const cache = nullptr);
     ~GalleryElementFunctor();
 
     void operator()(GalleryElement& element);
 
 private:
 
+    bool loadScaledImage(const QString& path, int size, QImage& image);
     bool writeDataToFile(const QByteArray& data, const QString& destPath);
     void emitWarning(const QString& msg);
 
@@ -56,10 +65,11 @@ private:
 
     // NOTE: Do not use a d private internal container here.
 
-    GalleryGenerator* m_generator;
-    GalleryInfo*      m_info;
-    QString           m_destDir;
-    GalleryNameHelper m_uniqueNameHelper;
+    GalleryGenerator*   m_generator;
+    GalleryInfo*        m_info;
+    QString             m_destDir;
+    GalleryNameHelper   m_uniqueNameHelper;
+    GalleryExportCache* m_cache;
 };
 
 } // namespace DigikamGenericHtmlGalleryPlugin
@@ -0,0 +1,416 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a tool to generate HTML image galleries
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "galleryexportcache.h"
+
+// Qt includes
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "galleryelement.h"
+#include "galleryinfo.h"
+
+namespace DigikamGenericHtmlGalleryPlugin
+{
+
+class Q_DECL_HIDDEN GalleryExportCache::Private
+{
+public:
+
+    class Entry
+    {
+    public:
+
+        Entry()
+          : fileSize    (0),
+            lastModified(0),
+            orientation (0),
+            seen        (false)
+        {
+        }
+
+        qint64  fileSize;
+        qint64  lastModified;
+        int     orientation;
+        bool    seen;
+
+        QString baseFileName;
+        QString fullFileName;
+        QSize   fullSize;
+        QString thumbnailFileName;
+        QSize   thumbnailSize;
+        QString originalFileName;
+        QSize   originalSize;
+
+        /// Exif and GPS values, in the same order as GalleryElement members.
+        QStringList exif;
+    };
+
+public:
+
+    explicit Private()
+      : info(nullptr)
+    {
+    }
+
+    /**
+     * The settings which have an impact on the generated files.
+     * If one of them change, the previous export cannot be reused.
+     */
+    QString settingsKey() const
+    {
+        QStringList values;
+        values << QString::number(info->useOriginalImageAsFullImage())
+               << QString::number(info->fullResize())
+               << QString::number(info->fullSize())
+               << info->fullFormatString()
+               << QString::number(info->fullQuality())
+               << QString::number(info->copyOriginalImage())
+               << QString::number(info->thumbnailSize())
+               << info->thumbnailFormatString()
+               << QString::number(info->thumbnailQuality())
+               << QString::number(info->thumbnailSquare());
+
+        return values.join(QLatin1Char(';'));
+    }
+
+    bool filesExist(const Entry& entry) const
+    {
+        if (!QFileInfo::exists(destDir + QLatin1Char('/') + entry.fullFileName) ||
+            !QFileInfo::exists(destDir + QLatin1Char('/') + entry.thumbnailFileName))
+        {
+            return false;
+        }
+
+        if (!entry.originalFileName.isEmpty() &&
+            !QFileInfo::exists(destDir + QLatin1Char('/') + entry.originalFileName))
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    static QStringList exifValues(const GalleryElement& element)
+    {
+        return QStringList() << element.m_exifImageMake
+                             << element.m_exifItemModel
+                             << element.m_exifImageOrientation
+                             << element.m_exifImageXResolution
+                             << element.m_exifImageYResolution
+                             << element.m_exifImageResolutionUnit
+                             << element.m_exifImageDateTime
+                             << element.m_exifImageYCbCrPositioning
+                             << element.m_exifPhotoExposureTime
+                             << element.m_exifPhotoFNumber
+                             << element.m_exifPhotoExposureProgram
+                             << element.m_exifPhotoISOSpeedRatings
+                             << element.m_exifPhotoShutterSpeedValue
+                             << element.m_exifPhotoApertureValue
+                             << element.m_exifPhotoFocalLength
+                             << element.m_exifGPSLatitude
+                             << element.m_exifGPSLongitude
+                             << element.m_exifGPSAltitude;
+    }
+
+    static bool setExifValues(GalleryElement& element, const QStringList& values)
+    {
+        if (values.count() != 18)
+        {
+            return false;
+        }
+
+        int i                                = 0;
+        element.m_exifImageMake              = values.at(i++);
+        element.m_exifItemModel              = values.at(i++);
+        element.m_exifImageOrientation       = values.at(i++);
+        element.m_exifImageXResolution       = values.at(i++);
+        element.m_exifImageYResolution       = values.at(i++);
+        element.m_exifImageResolutionUnit    = values.at(i++);
+        element.m_exifImageDateTime          = values.at(i++);
+        element.m_exifImageYCbCrPositioning  = values.at(i++);
+        element.m_exifPhotoExposureTime      = values.at(i++);
+        element.m_exifPhotoFNumber           = values.at(i++);
+        element.m_exifPhotoExposureProgram   = values.at(i++);
+        element.m_exifPhotoISOSpeedRatings   = values.at(i++);
+        element.m_exifPhotoShutterSpeedValue = values.at(i++);
+        element.m_exifPhotoApertureValue     = values.at(i++);
+        element.m_exifPhotoFocalLength       = values.at(i++);
+        element.m_exifGPSLatitude            = values.at(i++);
+        element.m_exifGPSLongitude           = values.at(i++);
+        element.m_exifGPSAltitude            = values.at(i++);
+
+        return true;
+    }
+
+public:
+
+    static const quint32    magic   = 0x44474743; // "DGGC"
+    static const qint32     version = 1;
+
+    GalleryInfo*            info;
+    QString                 destDir;
+    QString                 cacheFile;
+
+    QHash<QString, Entry>   entries;
+    mutable QMutex          mutex;
+};
+
+GalleryExportCache::GalleryExportCache(GalleryInfo* const info, const QString& destDir)
+    : d(new Private)
+{
+    d->info      = info;
+    d->destDir   = destDir;
+    d->cacheFile = destDir + QLatin1String("/.digikam-gallery.cache");
+}
+
+GalleryExportCache::~GalleryExportCache()
+{
+    delete d;
+}
+
+bool GalleryExportCache::load()
+{
+    d->entries.clear();
+
+    QFile file(d->cacheFile);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic   = 0;
+    qint32  version = 0;
+    QString settingsKey;
+
+    stream >> magic >> version >> settingsKey;
+
+    if ((magic != Private::magic) || (version != Private::version))
+    {
+        qCDebug(DIGIKAM_DPLUGIN_GENERIC_LOG) << "Gallery cache file is not compatible:" << d->cacheFile;
+        return false;
+    }
+
+    if (settingsKey != d->settingsKey())
+    {
+        qCDebug(DIGIKAM_DPLUGIN_GENERIC_LOG) << "Image settings changed since last export, regenerate all items";
+        return false;
+    }
+
+    qint32 count = 0;
+    stream >> count;
+
+    for (int i = 0 ; (i < count) && (stream.status() == QDataStream::Ok) ; ++i)
+    {
+        QString         path;
+        Private::Entry  entry;
+
+        stream >> path
+               >> entry.fileSize
+               >> entry.lastModified
+               >> entry.orientation
+               >> entry.baseFileName
+               >> entry.fullFileName
+               >> entry.fullSize
+               >> entry.thumbnailFileName
+               >> entry.thumbnailSize
+               >> entry.originalFileName
+               >> entry.originalSize
+               >> entry.exif;
+
+        d->entries.insert(path, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        qCWarning(DIGIKAM_DPLUGIN_GENERIC_LOG) << "Gallery cache file is corrupted:" << d->cacheFile;
+        d->entries.clear();
+
+        return false;
+    }
+
+    qCDebug(DIGIKAM_DPLUGIN_GENERIC_LOG) << "Gallery cache loaded with" << d->entries.count() << "items";
+
+    return true;
+}
+
+bool GalleryExportCache::save()
+{
+    QMutexLocker lock(&d->mutex);
+
+    QSaveFile file(d->cacheFile);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(DIGIKAM_DPLUGIN_GENERIC_LOG) << "Cannot write gallery cache file:" << d->cacheFile;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    stream << Private::magic << Private::version << d->settingsKey();
+    stream << (qint32)d->entries.count();
+
+    QHash<QString, Private::Entry>::const_iterator it;
+
+    for (it = d->entries.constBegin() ; it != d->entries.constEnd() ; ++it)
+    {
+        const Private::Entry& entry = it.value();
+
+        stream << it.key()
+               << entry.fileSize
+               << entry.lastModified
+               << entry.orientation
+               << entry.baseFileName
+               << entry.fullFileName
+               << entry.fullSize
+               << entry.thumbnailFileName
+               << entry.thumbnailSize
+               << entry.originalFileName
+               << entry.originalSize
+               << entry.exif;
+    }
+
+    return file.commit();
+}
+
+bool GalleryExportCache::restore(GalleryElement& element) const
+{
+    QFileInfo fileInfo(element.m_path);
+
+    QMutexLocker lock(&d->mutex);
+
+    QHash<QString, Private::Entry>::iterator it = d->entries.find(element.m_path);
+
+    if (it == d->entries.end())
+    {
+        return false;
+    }
+
+    Private::Entry& entry = it.value();
+
+    // The entry is still part of the gallery, even if it must be regenerated.
+
+    entry.seen            = true;
+
+    if ((entry.fileSize     != fileInfo.size())                             ||
+        (entry.lastModified != fileInfo.lastModified().toMSecsSinceEpoch()) ||
+        (entry.orientation  != (int)element.m_orientation)                  ||
+        !d->filesExist(entry)                                               ||
+        !Private::setExifValues(element, entry.exif))
+    {
+        return false;
+    }
+
+    element.m_fullFileName      = entry.fullFileName;
+    element.m_fullSize          = entry.fullSize;
+    element.m_thumbnailFileName = entry.thumbnailFileName;
+    element.m_thumbnailSize     = entry.thumbnailSize;
+    element.m_originalFileName  = entry.originalFileName;
+    element.m_originalSize      = entry.originalSize;
+    element.m_valid             = true;
+
+    return true;
+}
+
+void GalleryExportCache::store(const GalleryElement& element, const QString& baseFileName)
+{
+    QFileInfo fileInfo(element.m_path);
+
+    Private::Entry entry;
+    entry.fileSize          = fileInfo.size();
+    entry.lastModified      = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.orientation       = (int)element.m_orientation;
+    entry.seen              = true;
+    entry.baseFileName      = baseFileName;
+    entry.fullFileName      = element.m_fullFileName;
+    entry.fullSize          = element.m_fullSize;
+    entry.thumbnailFileName = element.m_thumbnailFileName;
+    entry.thumbnailSize     = element.m_thumbnailSize;
+    entry.originalFileName  = element.m_originalFileName;
+    entry.originalSize      = element.m_originalSize;
+    entry.exif              = Private::exifValues(element);
+
+    QMutexLocker lock(&d->mutex);
+
+    d->entries.insert(element.m_path, entry);
+}
+
+QString GalleryExportCache::baseFileName(const QString& path) const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->entries.value(path).baseFileName;
+}
+
+QStringList GalleryExportCache::baseFileNames() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    QStringList names;
+
+    Q_FOREACH (const Private::Entry& entry, d->entries)
+    {
+        names << entry.baseFileName;
+    }
+
+    return names;
+}
+
+void GalleryExportCache::removeStaleFiles()
+{
+    QMutexLocker lock(&d->mutex);
+
+    QHash<QString, Private::Entry>::iterator it = d->entries.begin();
+
+    while (it != d->entries.end())
+    {
+        if (it.value().seen)
+        {
+            ++it;
+            continue;
+        }
+
+        const Private::Entry& entry = it.value();
+
+        qCDebug(DIGIKAM_DPLUGIN_GENERIC_LOG) << "Remove files from previous export of" << it.key();
+
+        QFile::remove(d->destDir + QLatin1Char('/') + entry.fullFileName);
+        QFile::remove(d->destDir + QLatin1Char('/') + entry.thumbnailFileName);
+
+        if (!entry.originalFileName.isEmpty())
+        {
+            QFile::remove(d->destDir + QLatin1Char('/') + entry.originalFileName);
+        }
+
+        it = d->entries.erase(it);
+    }
+}
+
+} // namespace DigikamGenericHtmlGalleryPlugin
@@ -0,0 +1,96 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a tool to generate HTML image galleries
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_GALLERY_EXPORT_CACHE_H
+#define DIGIKAM_GALLERY_EXPORT_CACHE_H
+
+// Qt includes
+
+#include <QString>
+#include <QStringList>
+
+namespace DigikamGenericHtmlGalleryPlugin
+{
+
+class GalleryInfo;
+class GalleryElement;
+
+/**
+ * This class records, in a collection output folder, the state of the source files
+ * used to generate the gallery images: file size, modification time and orientation,
+ * plus the properties of the generated files. It is used for incremental export,
+ * to skip items which did not change since the previous run with the same image settings.
+ * Lookup and update methods are thread-safe, as they are called from QtConcurrent::map().
+ */
+class GalleryExportCache
+{
+public:
+
+    explicit GalleryExportCache(GalleryInfo* const info, const QString& destDir);
+    ~GalleryExportCache();
+
+    /**
+     * Read the cache file from the output folder. If the file do not exist, or was written
+     * with different image settings, the cache is empty and all items will be regenerated.
+     */
+    bool load();
+
+    /**
+     * Write the cache file to the output folder.
+     */
+    bool save();
+
+    /**
+     * Return true if the source file of @p element did not change since the last export
+     * and all generated files still exist. In this case, the generated files properties are
+     * restored in @p element.
+     */
+    bool restore(GalleryElement& element) const;
+
+    /**
+     * Record the current state of the source file of @p element, generated as @p baseFileName.
+     */
+    void store(const GalleryElement& element, const QString& baseFileName);
+
+    /**
+     * Return the base file name used by the last export for the source file @p path,
+     * or a null string if the file was not exported previously.
+     */
+    QString baseFileName(const QString& path) const;
+
+    /**
+     * Return all base file names recorded by the last export.
+     */
+    QStringList baseFileNames() const;
+
+    /**
+     * Remove the generated files of items which are not part of the gallery anymore.
+     */
+    void removeStaleFiles();
+
+private:
+
+    // Disable
+    GalleryExportCache(const GalleryExportCache&)            = delete;
+    GalleryExportCache& operator=(const GalleryExportCache&) = delete;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace DigikamGenericHtmlGalleryPlugin
+
+#endif // DIGIKAM_GALLERY_EXPORT_CACHE_H
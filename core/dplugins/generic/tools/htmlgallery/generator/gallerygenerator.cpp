@@ -27,6 +27,7 @@
 #include <QList>
 #include <QTemporaryFile>
 #include <QSharedPointer>
+#include <QScopedPointer>
 
 // KDE includes
 
@@ -46,6 +47,7 @@
 #include "abstractthemeparameter.h"
 #include "galleryelement.h"
 #include "galleryelementfunctor.h"
+#include "galleryexportcache.h"
 #include "galleryinfo.h"
 #include "gallerytheme.h"
 #include "galleryxmlutils.h"
@@ -273,10 +275,20 @@ public:
             imageElementList << element;
         }
 
+        // Load the state of the previous export to the same folder
+
+        QScopedPointer<GalleryExportCache> cache;
+
+        if (info->incrementalExport())
+        {
+            cache.reset(new GalleryExportCache(info, destDir));
+            cache->load();
+        }
+
         // Generate images
 
         logInfo(i18nc("@info", "Generating files for \"%1\"", title));
-        GalleryElementFunctor functor(that, info, destDir);
+        GalleryElementFunctor functor(that, info, destDir, cache.data());
         QFuture<void> future = QtConcurrent::map(imageElementList, functor);
         QFutureWatcher<void> watcher;
         watcher.setFuture(future);
@@ -294,10 +306,28 @@ public:
             {
                 future.cancel();
                 future.waitForFinished();
+
+                // Keep the items already generated for the next run.
+
+                if (cache)
+                {
+                    cache->save();
+                }
+
                 return false;
             }
         }
 
+        if (cache)
+        {
+            cache->removeStaleFiles();
+
+            if (!cache->save())
+            {
+                logWarning(i18nc("@info", "Could not save the incremental export state for \"%1\"", title));
+            }
+        }
+
         // Generate xml
 
         Q_FOREACH (const GalleryElement& element, imageElementList)
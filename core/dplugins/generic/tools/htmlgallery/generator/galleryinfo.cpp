@@ -125,6 +125,8 @@ QDebug operator<<(QDebug dbg, const GalleryInfo& t)
                   << t.openInBrowser();
     dbg.nospace() << "GalleryInfo::ImageSelectionTitle: "
                   << t.imageSelectionTitle();
+    dbg.nospace() << "GalleryInfo::IncrementalExport: "
+                  << t.incrementalExport();
     return dbg.space();
 }
 
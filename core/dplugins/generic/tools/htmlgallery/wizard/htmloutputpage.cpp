@@ -23,6 +23,7 @@
 #include <QApplication>
 #include <QStyle>
 #include <QComboBox>
+#include <QCheckBox>
 #include <QGridLayout>
 
 // KDE includes
@@ -47,7 +48,8 @@ public:
       : destUrl             (nullptr),
         openInBrowser       (nullptr),
         titleLabel          (nullptr),
-        imageSelectionTitle (nullptr)
+        imageSelectionTitle (nullptr),
+        incrementalExport   (nullptr)
     {
     }
 
@@ -55,6 +57,7 @@ public:
     QComboBox*     openInBrowser;
     QLabel*        titleLabel;
     DTextEdit*     imageSelectionTitle;
+    QCheckBox*     incrementalExport;
 };
 
 HTMLOutputPage::HTMLOutputPage(QWizard* const dialog, const QString& title)
@@ -101,6 +104,15 @@ HTMLOutputPage::HTMLOutputPage(QWizard* const dialog, const QString& title)
 
     // --------------------
 
+    d->incrementalExport       = new QCheckBox(main);
+    d->incrementalExport->setText(i18nc("@option:check", "Only regenerate images changed since the last export"));
+    d->incrementalExport->setWhatsThis(i18nc("@info", "If this option is enabled, the source file properties are "
+                                                      "recorded in the destination folder, and images which did not "
+                                                      "change since the previous export to the same folder with the "
+                                                      "same image settings are not generated again."));
+
+    // --------------------
+
     QGridLayout* const grid = new QGridLayout(main);
     grid->setSpacing(qMin(QApplication::style()->pixelMetric(QStyle::PM_LayoutHorizontalSpacing),
                           QApplication::style()->pixelMetric(QStyle::PM_LayoutVerticalSpacing)));
@@ -110,7 +122,8 @@ HTMLOutputPage::HTMLOutputPage(QWizard* const dialog, const QString& title)
     grid->addWidget(d->destUrl,             1, 1, 1, 1);
     grid->addWidget(browserLabel,           2, 0, 1, 1);
     grid->addWidget(d->openInBrowser,       2, 1, 1, 1);
-    grid->setRowStretch(3, 10);
+    grid->addWidget(d->incrementalExport,   3, 0, 1, 2);
+    grid->setRowStretch(4, 10);
 
     // --------------------
 
@@ -146,6 +159,7 @@ void HTMLOutputPage::initializePage()
     d->destUrl->setFileDlgPath(info->destUrl().toLocalFile());
     d->openInBrowser->setCurrentIndex(info->openInBrowser());
     d->imageSelectionTitle->setText(info->imageSelectionTitle());
+    d->incrementalExport->setChecked(info->incrementalExport());
 
     d->titleLabel->setVisible(info->m_getOption == GalleryInfo::IMAGES);
     d->imageSelectionTitle->setVisible(info->m_getOption == GalleryInfo::IMAGES);
@@ -175,6 +189,7 @@ bool HTMLOutputPage::validatePage()
     info->setDestUrl(QUrl::fromLocalFile(d->destUrl->fileDlgPath()));
     info->setOpenInBrowser(d->openInBrowser->currentIndex());
     info->setImageSelectionTitle(d->imageSelectionTitle->text());
+    info->setIncrementalExport(d->incrementalExport->isChecked());
 
     return true;
 }
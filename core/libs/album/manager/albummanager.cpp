@@ -41,6 +41,9 @@ AlbumManager::AlbumManager()
     qRegisterMetaType<QMap<int,int>>("QMap<int,int>");
     qRegisterMetaType<QHash<int,int>>("QHash<int,int>");
     qRegisterMetaType<QMap<QString,QHash<int,int> >>("QMap<QString,QHash<int,int> >");
+    qRegisterMetaType<QList<AlbumInfo>>("QList<AlbumInfo>");
+    qRegisterMetaType<QList<TagInfo>>("QList<TagInfo>");
+    qRegisterMetaType<QList<SearchInfo>>("QList<SearchInfo>");
 
     internalInstance = this;
     d->albumWatch    = new AlbumWatch(this);
@@ -118,6 +121,8 @@ void AlbumManager::cleanUp()
 {
     // This is what we prefer to do before Application destruction
 
+    saveAlbumTreeSnapshot();
+
     if (d->dateListJob)
     {
         d->dateListJob->cancel();
@@ -141,6 +146,12 @@ void AlbumManager::cleanUp()
         d->personListJob->cancel();
         d->personListJob = nullptr;
     }
+
+    if (d->albumTreeJob)
+    {
+        d->albumTreeJob->cancel();
+        d->albumTreeJob = nullptr;
+    }
 }
 
 void AlbumManager::startScan()
@@ -185,9 +196,12 @@ void AlbumManager::startScan()
     connect(CollectionManager::instance(), SIGNAL(locationPropertiesChanged(CollectionLocation)),
             this, SLOT(slotCollectionLocationPropertiesChanged(CollectionLocation)));
 
-    // reload albums
+    // reload albums, from the snapshot of the last session if it is up to date
 
-    refresh();
+    if (!loadAlbumTreeSnapshot())
+    {
+        refresh();
+    }
 
     // listen to album database changes
 
@@ -266,40 +280,14 @@ void AlbumManager::slotImagesDeleted(const QList<qlonglong>& imageIds)
 {
     qCDebug(DIGIKAM_GENERAL_LOG) << "Got image deletion notification from ItemViewUtilities for " << imageIds.size() << " images.";
 
-    QSet<SAlbum*> sAlbumsToUpdate;
-    QSet<qlonglong> deletedImages(imageIds.begin(), imageIds.end());
-
-    QList<SAlbum*> sAlbums = findSAlbumsBySearchType(DatabaseSearch::DuplicatesSearch);
-
-    Q_FOREACH (SAlbum* const sAlbum, sAlbums)
-    {
-        // Read the search query XML and save the image ids
+    // The deleted images are removed from the groups of duplicates,
+    // and the groups left with one item only are removed.
 
-        SearchXmlReader reader(sAlbum->query());
-        SearchXml::Element element;
-        QSet<qlonglong> images;
-
-        while ((element = reader.readNext()) != SearchXml::End)
-        {
-            if ((element == SearchXml::Field) && (reader.fieldName().compare(QLatin1String("imageid")) == 0))
-            {
-                const auto list = reader.valueToLongLongList();
-                images = QSet<qlonglong>(list.begin(), list.end());
-            }
-        }
-
-        // If the deleted images are part of the SAlbum,
-        // mark the album as ready for deletion and the images as ready for rescan.
-
-        if (images.intersects(deletedImages))
-        {
-            sAlbumsToUpdate.insert(sAlbum);
-        }
-    }
+    const QHash<qlonglong, qlonglong> modifiedGroups = SimilarityDbAccess().db()->removeFromDuplicatesGroups(imageIds);
 
-    if (!sAlbumsToUpdate.isEmpty())
+    if (!modifiedGroups.isEmpty())
     {
-        Q_EMIT signalUpdateDuplicatesAlbums(sAlbumsToUpdate.values(), deletedImages.values());
+        Q_EMIT signalUpdateDuplicatesGroups(modifiedGroups, imageIds);
     }
 }
 
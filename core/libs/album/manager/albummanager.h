@@ -20,6 +20,7 @@
 // Qt includes
 
 #include <QList>
+#include <QHash>
 #include <QObject>
 #include <QString>
 #include <QMap>
@@ -101,10 +102,43 @@ public:
     bool isShowingOnlyAvailableAlbums() const;
     void setShowOnlyAvailableAlbums(bool onlyAvailable);
 
+private:
+
+    /**
+     * Builds the album trees and sets the items counts from the snapshot of the
+     * last session, if it is up to date with the database. The albums are then
+     * read again from the database in the background. Returns false if there is
+     * no usable snapshot.
+     */
+    bool loadAlbumTreeSnapshot();
+
+    /**
+     * Writes the snapshot of the album trees and of the items counts that are
+     * up to date with the database, for the next start.
+     */
+    void saveAlbumTreeSnapshot();
+
 private Q_SLOTS:
 
     void slotImagesDeleted(const QList<qlonglong>& imageIds);
 
+    /**
+     * Reads the albums and the items counts from the database after the
+     * album trees were built from the snapshot. If the database did not
+     * change since the snapshot, only the items counts are read.
+     */
+    void slotReconcileAlbumTreeSnapshot();
+
+    /**
+     * Updates the album trees with the albums, tags and searches read in the
+     * background by the job started to reconcile the snapshot.
+     */
+    void slotAlbumTreeJobData(qlonglong counter,
+                              const QList<AlbumInfo>& albums,
+                              const QList<TagInfo>& tags,
+                              const QList<SearchInfo>& searches);
+    void slotAlbumTreeJobResult();
+
     // -----------------------------------------------------------------------------
 
     /**
@@ -478,6 +512,12 @@ private:
     void insertPAlbum(PAlbum* album, PAlbum* parent);
     void removePAlbum(PAlbum* album);
 
+    /**
+     * Creates the PAlbums of the albums which haven't already been created,
+     * and removes the PAlbums of the albums not in the list.
+     */
+    void updatePAlbums(QList<AlbumInfo> currentAlbums);
+
 private Q_SLOTS:
 
     /**
@@ -682,6 +722,11 @@ private:
     void insertTAlbum(TAlbum* album, TAlbum* parent);
     void removeTAlbum(TAlbum* album);
 
+    /**
+     * Creates the TAlbums of the tags which haven't already been created.
+     */
+    void updateTAlbums(TagInfo::List tList);
+
 private Q_SLOTS:
 
     /**
@@ -777,6 +822,14 @@ public:
      */
     bool deleteSAlbum(SAlbum* album);
 
+private:
+
+    /**
+     * Creates the SAlbums of the searches which haven't already been created,
+     * updates the changed ones and removes the SAlbums of the searches not in the list.
+     */
+    void updateSAlbums(const QList<SearchInfo>& currentSearches);
+
 private Q_SLOTS:
 
     /**
@@ -790,7 +843,12 @@ private Q_SLOTS:
 
 Q_SIGNALS:
 
-    void signalUpdateDuplicatesAlbums(const QList<SAlbum*>& modifiedAlbums,
+    /**
+     * Emitted when deleted images were removed from the groups of the last duplicates search.
+     * The references of the modified groups are mapped to their new reference, or to -1 if
+     * the group was removed.
+     */
+    void signalUpdateDuplicatesGroups(const QHash<qlonglong, qlonglong>& modifiedGroups,
                                       const QList<qlonglong>& deletedImages);
     void signalSearchUpdated(SAlbum* album);
 
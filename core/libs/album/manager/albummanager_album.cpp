@@ -138,7 +138,8 @@ void AlbumManager::slotAlbumsJobData(const QHash<int, int>& albumsStatHash)
         return;
     }
 
-    d->pAlbumsCount = albumsStatHash;
+    d->pAlbumsCount       = albumsStatHash;
+    d->albumsCountChanges = (sender() == d->albumListJob) ? d->albumsCountJobChanges : -1;
 
     Q_EMIT signalPAlbumsDirty(albumsStatHash);
 }
@@ -220,6 +221,10 @@ void AlbumManager::getAlbumItemsCount()
         d->albumListJob = nullptr;
     }
 
+    // The counts are read after the counter: they are up to date at least at this counter.
+
+    d->albumsCountJobChanges = d->albumTreeChangeCounter();
+
     AlbumsDBJobInfo jInfo;
     jInfo.setFoldersJob();
     d->albumListJob = DBJobsManager::instance()->startAlbumsJobThread(jInfo);
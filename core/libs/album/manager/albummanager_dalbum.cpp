@@ -29,6 +29,8 @@ void AlbumManager::scanDAlbums()
         d->dateListJob = nullptr;
     }
 
+    d->datesCountJobChanges = d->albumTreeChangeCounter();
+
     DatesDBJobInfo jInfo;
     jInfo.setFoldersJob();
     d->dateListJob = DBJobsManager::instance()->startDatesJobThread(jInfo);
@@ -106,6 +108,9 @@ void AlbumManager::slotDatesJobData(const QHash<QDateTime, int>& datesStatHash)
         return;
     }
 
+    d->datesCount        = datesStatHash;
+    d->datesCountChanges = (sender() == d->dateListJob) ? d->datesCountJobChanges : -1;
+
     // insert all the DAlbums into a qmap for quick access
 
     QMap<QDate, DAlbum*> mAlbumMap;
@@ -61,6 +61,7 @@ AlbumManager::Private::Private()
       dateListJob             (nullptr),
       tagListJob              (nullptr),
       personListJob           (nullptr),
+      albumTreeJob            (nullptr),
       albumWatch              (nullptr),
       rootPAlbum              (nullptr),
       rootTAlbum              (nullptr),
@@ -74,7 +75,14 @@ AlbumManager::Private::Private()
       scanDAlbumsTimer        (nullptr),
       updatePAlbumsTimer      (nullptr),
       albumItemCountTimer     (nullptr),
-      tagItemCountTimer       (nullptr)
+      tagItemCountTimer       (nullptr),
+      albumsCountJobChanges   (-1),
+      tagsCountJobChanges     (-1),
+      datesCountJobChanges    (-1),
+      albumsCountChanges      (-1),
+      tagsCountChanges        (-1),
+      datesCountChanges       (-1),
+      snapshotChanges         (-1)
 {
 }
 
@@ -90,6 +98,11 @@ QString AlbumManager::Private::labelForAlbumRootAlbum(const CollectionLocation&
     return label;
 }
 
+qlonglong AlbumManager::Private::albumTreeChangeCounter() const
+{
+    return CoreDbAccess().db()->getAlbumTreeChangeCounter();
+}
+
 // -----------------------------------------------------------------------------------
 
 ChangingDB::ChangingDB(AlbumManager::Private* const dd)
@@ -105,6 +105,7 @@ extern "C"
 #include "dbjobinfo.h"
 #include "dbjobsmanager.h"
 #include "dbjobsthread.h"
+#include "albumtreesnapshot.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
 
@@ -154,6 +155,7 @@ public:
     DatesDBJobsThread*          dateListJob;
     TagsDBJobsThread*           tagListJob;
     TagsDBJobsThread*           personListJob;
+    AlbumsDBJobsThread*         albumTreeJob;
 
 
     AlbumWatch*                 albumWatch;
@@ -193,9 +195,31 @@ public:
     QHash<int, int>             uAlbumsCount;
     QList<int>                  toUpdatedFaces;
 
+    /// The last dates counts, to write in the snapshot of the album trees
+    QHash<QDateTime, int>       datesCount;
+
+    /**
+     * The counters of the album trees changes read when the counts jobs were
+     * started, and when the jobs whose counts are kept were started.
+     */
+    qlonglong                   albumsCountJobChanges;
+    qlonglong                   tagsCountJobChanges;
+    qlonglong                   datesCountJobChanges;
+    qlonglong                   albumsCountChanges;
+    qlonglong                   tagsCountChanges;
+    qlonglong                   datesCountChanges;
+
+    /// The counter of the album trees changes when the snapshot was written
+    qlonglong                   snapshotChanges;
+
 public:
 
     QString labelForAlbumRootAlbum(const CollectionLocation& location);
+
+    /**
+     * The counter of the album trees changes of the database, -1 if there is none.
+     */
+    qlonglong albumTreeChangeCounter() const;
 };
 
 // -----------------------------------------------------------------------------------
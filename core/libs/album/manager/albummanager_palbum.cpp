@@ -23,6 +23,15 @@ void AlbumManager::scanPAlbums()
 {
     d->scanPAlbumsTimer->stop();
 
+    // scan db and get a list of all albums
+
+    updatePAlbums(CoreDbAccess().db()->scanAlbums());
+
+    getAlbumItemsCount();
+}
+
+void AlbumManager::updatePAlbums(QList<AlbumInfo> currentAlbums)
+{
     // first insert all the current normal PAlbums into a map for quick lookup
 
     QHash<int, PAlbum*> oldAlbums;
@@ -35,10 +44,6 @@ void AlbumManager::scanPAlbums()
         ++it;
     }
 
-    // scan db and get a list of all albums
-
-    QList<AlbumInfo> currentAlbums = CoreDbAccess().db()->scanAlbums();
-
     // sort by relative path so that parents are created before children
 
     std::sort(currentAlbums.begin(), currentAlbums.end());
@@ -185,8 +190,6 @@ void AlbumManager::scanPAlbums()
     {
         Q_EMIT signalAlbumsUpdated(Album::PHYSICAL);
     }
-
-    getAlbumItemsCount();
 }
 
 void AlbumManager::updateChangedPAlbums()
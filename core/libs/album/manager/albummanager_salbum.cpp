@@ -43,7 +43,13 @@ void AlbumManager::scanSAlbums()
 {
     d->scanSAlbumsTimer->stop();
 
-    // list SAlbums directly from the db
+    // scan db and get a list of all albums
+
+    updateSAlbums(CoreDbAccess().db()->scanSearches());
+}
+
+void AlbumManager::updateSAlbums(const QList<SearchInfo>& currentSearches)
+{
     // first insert all the current SAlbums into a map for quick lookup
 
     QMap<int, SAlbum*> oldSearches;
@@ -57,9 +63,6 @@ void AlbumManager::scanSAlbums()
         ++it;
     }
 
-    // scan db and get a list of all albums
-
-    QList<SearchInfo> currentSearches = CoreDbAccess().db()->scanSearches();
     QList<SearchInfo> newSearches;
 
     // go through all the Albums and see which ones are already present
@@ -0,0 +1,243 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Albums manager interface - album trees snapshot helpers.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "albummanager_p.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+
+namespace Digikam
+{
+
+/// Delay before reading the albums from the database, once the main window is shown.
+static const int SNAPSHOT_RECONCILIATION_DELAY = 2000;
+
+bool AlbumManager::loadAlbumTreeSnapshot()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QUuid     uuid;
+    qlonglong counter = -1;
+
+    {
+        CoreDbAccess access;
+        counter = access.db()->getAlbumTreeChangeCounter();
+
+        if (counter == -1)
+        {
+            return false;
+        }
+
+        uuid    = access.db()->databaseUuid();
+    }
+
+    AlbumTreeSnapshot snapshot;
+
+    if (!snapshot.load(AlbumTreeSnapshot::filePath(uuid)))
+    {
+        return false;
+    }
+
+    if ((snapshot.databaseUuid != uuid) || (snapshot.changeCounter != counter))
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Album tree snapshot: the database changed since the snapshot was written";
+
+        return false;
+    }
+
+    d->snapshotChanges = counter;
+
+    updatePAlbums(snapshot.albums);
+    updateTAlbums(snapshot.tags);
+    updateSAlbums(snapshot.searches);
+
+    // The counts are set as if they were sent by the jobs.
+
+    if (ApplicationSettings::instance()->getShowFolderTreeViewItemsCount())
+    {
+        if (snapshot.hasAlbumsCount)
+        {
+            slotAlbumsJobData(snapshot.albumsCount);
+            d->albumsCountChanges = counter;
+        }
+
+        if (snapshot.hasTagsCount)
+        {
+            slotTagsJobData(snapshot.tagsCount);
+            d->tagsCountChanges = counter;
+        }
+    }
+
+    if (snapshot.hasDatesCount)
+    {
+        slotDatesJobData(snapshot.datesCount);
+        d->datesCountChanges = counter;
+
+        Q_EMIT signalAllDAlbumsLoaded();
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Album tree snapshot:" << snapshot.albums.count() << "albums,"
+                                 << snapshot.tags.count() << "tags and" << snapshot.searches.count()
+                                 << "searches loaded in" << timer.elapsed() << "ms";
+
+    // The face counts are not in the snapshot, and what the counter does not
+    // see is caught when the albums are read from the database.
+
+    QTimer::singleShot(SNAPSHOT_RECONCILIATION_DELAY, this, SLOT(slotReconcileAlbumTreeSnapshot()));
+
+    return true;
+}
+
+void AlbumManager::slotReconcileAlbumTreeSnapshot()
+{
+    if (!d->rootPAlbum)
+    {
+        return;
+    }
+
+    if (d->albumTreeChangeCounter() == d->snapshotChanges)
+    {
+        // The album trees did not change since the snapshot: only the counts are read again.
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Album tree snapshot: database unchanged, reading the items counts";
+
+        prepareItemCounts();
+
+        return;
+    }
+
+    if (d->albumTreeJob)
+    {
+        d->albumTreeJob->cancel();
+        d->albumTreeJob = nullptr;
+    }
+
+    AlbumsDBJobInfo jInfo;
+    jInfo.setAlbumTreeJob();
+    d->albumTreeJob = DBJobsManager::instance()->startAlbumsJobThread(jInfo);
+
+    connect(d->albumTreeJob, SIGNAL(finished()),
+            this, SLOT(slotAlbumTreeJobResult()));
+
+    connect(d->albumTreeJob, SIGNAL(albumTreeData(qlonglong,QList<AlbumInfo>,QList<TagInfo>,QList<SearchInfo>)),
+            this, SLOT(slotAlbumTreeJobData(qlonglong,QList<AlbumInfo>,QList<TagInfo>,QList<SearchInfo>)));
+}
+
+void AlbumManager::slotAlbumTreeJobData(qlonglong counter,
+                                        const QList<AlbumInfo>& albums,
+                                        const QList<TagInfo>& tags,
+                                        const QList<SearchInfo>& searches)
+{
+    if (!d->rootPAlbum || (sender() != d->albumTreeJob))
+    {
+        return;
+    }
+
+    if (counter != d->albumTreeChangeCounter())
+    {
+        // The albums changed while they were read: they are read again,
+        // not to replace a tree updated in between with an older one.
+
+        d->snapshotChanges = -1;
+
+        QTimer::singleShot(0, this, SLOT(slotReconcileAlbumTreeSnapshot()));
+
+        return;
+    }
+
+    d->snapshotChanges = counter;
+
+    updatePAlbums(albums);
+    updateTAlbums(tags);
+    updateSAlbums(searches);
+
+    prepareItemCounts();
+}
+
+void AlbumManager::slotAlbumTreeJobResult()
+{
+    if (!d->albumTreeJob || (sender() != d->albumTreeJob))
+    {
+        return;
+    }
+
+    if (d->albumTreeJob->hasErrors())
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Failed to read the album trees"
+                                       << d->albumTreeJob->errorsList().first();
+    }
+
+    d->albumTreeJob = nullptr;
+}
+
+void AlbumManager::saveAlbumTreeSnapshot()
+{
+    if (!d->rootPAlbum)
+    {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    AlbumTreeSnapshot snapshot;
+
+    {
+        // The database cannot change while it is locked here.
+
+        CoreDbAccess access;
+        snapshot.changeCounter = access.db()->getAlbumTreeChangeCounter();
+
+        if (snapshot.changeCounter == -1)
+        {
+            return;
+        }
+
+        snapshot.databaseUuid  = access.db()->databaseUuid();
+        snapshot.albums        = access.db()->scanAlbums();
+        snapshot.tags          = access.db()->scanTags();
+        snapshot.searches      = access.db()->scanSearches();
+    }
+
+    // The counts are only written if nothing changed since their jobs were started.
+
+    snapshot.hasAlbumsCount = (d->albumsCountChanges == snapshot.changeCounter);
+    snapshot.hasTagsCount   = (d->tagsCountChanges   == snapshot.changeCounter);
+    snapshot.hasDatesCount  = (d->datesCountChanges  == snapshot.changeCounter);
+
+    if (snapshot.hasAlbumsCount)
+    {
+        snapshot.albumsCount = d->pAlbumsCount;
+    }
+
+    if (snapshot.hasTagsCount)
+    {
+        snapshot.tagsCount   = d->tAlbumsCount;
+    }
+
+    if (snapshot.hasDatesCount)
+    {
+        snapshot.datesCount  = d->datesCount;
+    }
+
+    if (snapshot.save(AlbumTreeSnapshot::filePath(snapshot.databaseUuid)))
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Album tree snapshot: written at change" << snapshot.changeCounter
+                                     << "in" << timer.elapsed() << "ms";
+    }
+}
+
+} // namespace Digikam
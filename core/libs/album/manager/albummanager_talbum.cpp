@@ -23,7 +23,15 @@ void AlbumManager::scanTAlbums()
 {
     d->scanTAlbumsTimer->stop();
 
-    // list TAlbums directly from the db
+    // Retrieve the list of tags from the database
+
+    updateTAlbums(CoreDbAccess().db()->scanTags());
+
+    getTagItemsCount();
+}
+
+void AlbumManager::updateTAlbums(TagInfo::List tList)
+{
     // first insert all the current TAlbums into a map for quick lookup
 
     typedef QMap<int, TAlbum*> TagMap;
@@ -40,10 +48,6 @@ void AlbumManager::scanTAlbums()
         ++it;
     }
 
-    // Retrieve the list of tags from the database
-
-    TagInfo::List tList = CoreDbAccess().db()->scanTags();
-
     // sort the list. needed because we want the tags can be read in any order,
     // but we want to make sure that we are ensure to find the parent TAlbum
     // for a new TAlbum
@@ -167,8 +171,6 @@ void AlbumManager::scanTAlbums()
     {
         Q_EMIT signalAlbumsUpdated(Album::TAG);
     }
-
-    getTagItemsCount();
 }
 
 void AlbumManager::getTagItemsCount()
@@ -193,6 +195,8 @@ void AlbumManager::tagItemsCount()
         d->tagListJob = nullptr;
     }
 
+    d->tagsCountJobChanges = d->albumTreeChangeCounter();
+
     TagsDBJobInfo jInfo;
     jInfo.setFoldersJob();
 
@@ -987,7 +991,9 @@ void AlbumManager::slotTagsJobData(const QHash<int, int>& tagsStatHash)
         return;
     }
 
-    d->tAlbumsCount = tagsStatHash;
+    d->tAlbumsCount     = tagsStatHash;
+    d->tagsCountChanges = (sender() == d->tagListJob) ? d->tagsCountJobChanges : -1;
+
     Q_EMIT signalTAlbumsDirty(tagsStatHash);
 }
 
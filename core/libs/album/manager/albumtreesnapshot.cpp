@@ -0,0 +1,219 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : binary snapshot of the album trees and their items counts
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "albumtreesnapshot.h"
+
+// Qt includes
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+const quint32 SNAPSHOT_MAGIC   = 0x644B5453; // "dKTS"
+const quint32 SNAPSHOT_VERSION = 1;
+
+void writeSnapshot(QDataStream& out, const AlbumTreeSnapshot& snapshot)
+{
+    out << SNAPSHOT_MAGIC << SNAPSHOT_VERSION;
+    out << snapshot.databaseUuid << snapshot.changeCounter;
+
+    out << (quint32)snapshot.albums.size();
+
+    Q_FOREACH (const AlbumInfo& info, snapshot.albums)
+    {
+        out << (qint32)info.id << (qint32)info.albumRootId << info.relativePath
+            << info.caption << info.category << info.date << info.iconId;
+    }
+
+    out << (quint32)snapshot.tags.size();
+
+    Q_FOREACH (const TagInfo& info, snapshot.tags)
+    {
+        out << (qint32)info.id << (qint32)info.pid << info.name << info.icon << info.iconId;
+    }
+
+    out << (quint32)snapshot.searches.size();
+
+    Q_FOREACH (const SearchInfo& info, snapshot.searches)
+    {
+        out << (qint32)info.id << info.name << (qint32)info.type << info.query;
+    }
+
+    out << snapshot.hasAlbumsCount << snapshot.albumsCount;
+    out << snapshot.hasTagsCount   << snapshot.tagsCount;
+    out << snapshot.hasDatesCount  << snapshot.datesCount;
+}
+
+bool readSnapshot(QDataStream& in, AlbumTreeSnapshot& snapshot)
+{
+    quint32 magic   = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+
+    if ((magic != SNAPSHOT_MAGIC) || (version != SNAPSHOT_VERSION))
+    {
+        return false;
+    }
+
+    in >> snapshot.databaseUuid >> snapshot.changeCounter;
+
+    quint32 count = 0;
+    qint32  id    = 0;
+    qint32  other = 0;
+    in >> count;
+
+    for (quint32 i = 0 ; (i < count) && (in.status() == QDataStream::Ok) ; ++i)
+    {
+        AlbumInfo info;
+        in >> id >> other >> info.relativePath >> info.caption
+           >> info.category >> info.date >> info.iconId;
+        info.id          = id;
+        info.albumRootId = other;
+        snapshot.albums << info;
+    }
+
+    in >> count;
+
+    for (quint32 i = 0 ; (i < count) && (in.status() == QDataStream::Ok) ; ++i)
+    {
+        TagInfo info;
+        in >> id >> other >> info.name >> info.icon >> info.iconId;
+        info.id  = id;
+        info.pid = other;
+        snapshot.tags << info;
+    }
+
+    in >> count;
+
+    for (quint32 i = 0 ; (i < count) && (in.status() == QDataStream::Ok) ; ++i)
+    {
+        SearchInfo info;
+        in >> id >> info.name >> other >> info.query;
+        info.id   = id;
+        info.type = (DatabaseSearch::Type)other;
+        snapshot.searches << info;
+    }
+
+    in >> snapshot.hasAlbumsCount >> snapshot.albumsCount;
+    in >> snapshot.hasTagsCount   >> snapshot.tagsCount;
+    in >> snapshot.hasDatesCount  >> snapshot.datesCount;
+
+    return (in.status() == QDataStream::Ok);
+}
+
+} // namespace
+
+AlbumTreeSnapshot::AlbumTreeSnapshot()
+    : changeCounter (-1),
+      hasAlbumsCount(false),
+      hasTagsCount  (false),
+      hasDatesCount (false)
+{
+}
+
+void AlbumTreeSnapshot::clear()
+{
+    *this = AlbumTreeSnapshot();
+}
+
+QString AlbumTreeSnapshot::filePath(const QUuid& databaseUuid)
+{
+    return (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+            QLatin1String("/albumtree-")                                    +
+            databaseUuid.toString(QUuid::WithoutBraces)                     +
+            QLatin1String(".snapshot"));
+}
+
+bool AlbumTreeSnapshot::load(const QString& filePath)
+{
+    clear();
+
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly) || (file.size() == 0))
+    {
+        return false;
+    }
+
+    // The strings are copied out of the mapped file while it is read.
+
+    uchar* const data = file.map(0, file.size());
+    bool ok           = false;
+
+    if (data)
+    {
+        const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), (int)file.size());
+        QDataStream in(bytes);
+        in.setVersion(QDataStream::Qt_5_14);
+        ok = readSnapshot(in, *this);
+        file.unmap(data);
+    }
+    else
+    {
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_5_14);
+        ok = readSnapshot(in, *this);
+    }
+
+    if (!ok)
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Album tree snapshot: cannot read" << filePath;
+        clear();
+    }
+
+    return ok;
+}
+
+bool AlbumTreeSnapshot::save(const QString& filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Album tree snapshot: cannot write" << filePath;
+
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_14);
+    writeSnapshot(out, *this);
+
+    if ((out.status() != QDataStream::Ok) || !file.commit())
+    {
+        qCWarning(DIGIKAM_GENERAL_LOG) << "Album tree snapshot: cannot write" << filePath;
+
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Digikam
@@ -0,0 +1,87 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : binary snapshot of the album trees and their items counts
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ALBUM_TREE_SNAPSHOT_H
+#define DIGIKAM_ALBUM_TREE_SNAPSHOT_H
+
+// Qt includes
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QUuid>
+
+// Local includes
+
+#include "coredbalbuminfo.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * The physical albums, tags and searches read from a database, with the items
+ * counts of the albums, tags and dates, as written to a file at the end of a
+ * session to build the album trees at the next start without reading the database.
+ *
+ * The snapshot is only valid for the database of the uuid, while its counter
+ * of the album trees changes is equal to the one of the snapshot.
+ */
+class DIGIKAM_GUI_EXPORT AlbumTreeSnapshot
+{
+public:
+
+    AlbumTreeSnapshot();
+
+    /**
+     * Reads the snapshot from the file. The file is mapped in memory.
+     * Returns false if the file does not exist, is not a snapshot of this
+     * version, or is truncated. The snapshot is then cleared.
+     */
+    bool load(const QString& filePath);
+
+    /**
+     * Writes the snapshot to the file, which is only replaced when all is written.
+     */
+    bool save(const QString& filePath) const;
+
+    void clear();
+
+    /**
+     * The file of the snapshot of a database, in the cache directory.
+     */
+    static QString filePath(const QUuid& databaseUuid);
+
+public:
+
+    QUuid                   databaseUuid;
+    qlonglong               changeCounter;
+
+    AlbumInfo::List         albums;
+    TagInfo::List           tags;
+    SearchInfo::List        searches;
+
+    /// The counts are only valid when they were read at the counter of the snapshot.
+    bool                    hasAlbumsCount;
+    bool                    hasTagsCount;
+    bool                    hasDatesCount;
+
+    QHash<int, int>         albumsCount;
+    QHash<int, int>         tagsCount;
+    QHash<QDateTime, int>   datesCount;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_ALBUM_TREE_SNAPSHOT_H
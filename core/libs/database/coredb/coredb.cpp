@@ -41,8 +41,11 @@ class Q_DECL_HIDDEN CoreDB::Private
 public:
 
     explicit Private()
-      : db               (nullptr),
-        uniqueHashVersion(-1)
+      : db                    (nullptr),
+        uniqueHashVersion     (-1),
+        textSearchIndexVersion(-1),
+        imageDateCountsVersion(-1),
+        albumTreeChangesVersion(-1)
     {
     }
 
@@ -53,6 +56,9 @@ public:
     QList<int>           recentlyAssignedTags;
 
     int                  uniqueHashVersion;
+    int                  textSearchIndexVersion;
+    int                  imageDateCountsVersion;
+    int                  albumTreeChangesVersion;
 
 public:
 
@@ -410,6 +416,25 @@ QList<TagShortInfo> CoreDB::getTagShortInfos() const
     return tagList;
 }
 
+TagShortInfo CoreDB::getTagShortInfo(int tagId) const
+{
+    QList<QVariant> values;
+
+    d->db->execSql(QString::fromUtf8("SELECT id, pid, name FROM Tags WHERE id=?;"),
+                   tagId, &values);
+
+    TagShortInfo info;
+
+    if (values.size() == 3)
+    {
+        info.id   = values.at(0).toInt();
+        info.pid  = values.at(1).toInt();
+        info.name = values.at(2).toString();
+    }
+
+    return info;
+}
+
 int CoreDB::addAlbum(int albumRootId, const QString& relativePath,
                      const QString& caption,
                      const QDate& date, const QString& collection) const
@@ -1043,6 +1068,94 @@ void CoreDB::setUniqueHashVersion(int version)
     setSetting(QLatin1String("uniqueHashVersion"), QString::number(d->uniqueHashVersion));
 }
 
+int CoreDB::getTextSearchIndexVersion() const
+{
+    if (d->textSearchIndexVersion == -1)
+    {
+        d->textSearchIndexVersion = getSetting(QLatin1String("textSearchIndexVersion")).toInt();
+    }
+
+    return d->textSearchIndexVersion;
+}
+
+void CoreDB::setTextSearchIndexVersion(int version)
+{
+    d->textSearchIndexVersion = version;
+    setSetting(QLatin1String("textSearchIndexVersion"), QString::number(d->textSearchIndexVersion));
+}
+
+bool CoreDB::hasTextSearchIndex() const
+{
+    // The setting can be copied with the database to MySQL, which has no such index.
+
+    return ((d->db->databaseType() == BdEngineBackend::DbType::SQLite) &&
+            (getTextSearchIndexVersion() > 0));
+}
+
+int CoreDB::getImageDateCountsVersion() const
+{
+    if (d->imageDateCountsVersion == -1)
+    {
+        d->imageDateCountsVersion = getSetting(QLatin1String("imageDateCountsVersion")).toInt();
+    }
+
+    return d->imageDateCountsVersion;
+}
+
+void CoreDB::setImageDateCountsVersion(int version)
+{
+    d->imageDateCountsVersion = version;
+    setSetting(QLatin1String("imageDateCountsVersion"), QString::number(d->imageDateCountsVersion));
+}
+
+bool CoreDB::hasImageDateCounts() const
+{
+    return ((d->db->databaseType() == BdEngineBackend::DbType::SQLite) &&
+            (getImageDateCountsVersion() > 0));
+}
+
+int CoreDB::getAlbumTreeChangesVersion() const
+{
+    if (d->albumTreeChangesVersion == -1)
+    {
+        d->albumTreeChangesVersion = getSetting(QLatin1String("albumTreeChangesVersion")).toInt();
+    }
+
+    return d->albumTreeChangesVersion;
+}
+
+void CoreDB::setAlbumTreeChangesVersion(int version)
+{
+    d->albumTreeChangesVersion = version;
+    setSetting(QLatin1String("albumTreeChangesVersion"), QString::number(d->albumTreeChangesVersion));
+}
+
+bool CoreDB::hasAlbumTreeChanges() const
+{
+    return ((d->db->databaseType() == BdEngineBackend::DbType::SQLite) &&
+            (getAlbumTreeChangesVersion() > 0));
+}
+
+qlonglong CoreDB::getAlbumTreeChangeCounter() const
+{
+    if (!hasAlbumTreeChanges())
+    {
+        return -1;
+    }
+
+    QList<QVariant> values;
+
+    d->db->execSql(QString::fromUtf8("SELECT counter FROM AlbumTreeChanges WHERE id=1;"),
+                   &values);
+
+    if (values.isEmpty())
+    {
+        return -1;
+    }
+
+    return values.first().toLongLong();
+}
+
 qlonglong CoreDB::getImageId(int albumID, const QString& name) const
 {
     QList<QVariant> values;
@@ -1233,6 +1346,17 @@ QVector<QList<int> > CoreDB::getItemsTagIDs(const QList<qlonglong>& imageIds) co
     return results;
 }
 
+QVariantList CoreDB::getAllItemsTagIDs() const
+{
+    QVariantList values;
+
+    d->db->execSql(QString::fromUtf8("SELECT imageid, tagid FROM ImageTags "
+                                     "ORDER BY imageid, tagid;"),
+                   &values);
+
+    return values;
+}
+
 QList<ImageTagProperty> CoreDB::getImageTagProperties(qlonglong imageId, int tagId) const
 {
     QList<QVariant> values;
@@ -1561,6 +1685,77 @@ QVariantList CoreDB::getVideoMetadata(qlonglong imageID, DatabaseFields::VideoMe
     return values;
 }
 
+QHash<qlonglong, QVariantList> CoreDB::getImagesMetadata(const QList<qlonglong>& imageIds,
+                                                         DatabaseFields::ImageMetadata fields) const
+{
+    if (fields == DatabaseFields::ImageMetadataNone)
+    {
+        return QHash<qlonglong, QVariantList>();
+    }
+
+    return getItemsFields(QLatin1String("ImageMetadata"), imageMetadataFieldList(fields), imageIds);
+}
+
+QHash<qlonglong, QVariantList> CoreDB::getVideosMetadata(const QList<qlonglong>& imageIds,
+                                                         DatabaseFields::VideoMetadata fields) const
+{
+    if (fields == DatabaseFields::VideoMetadataNone)
+    {
+        return QHash<qlonglong, QVariantList>();
+    }
+
+    return getItemsFields(QLatin1String("VideoMetadata"), videoMetadataFieldList(fields), imageIds);
+}
+
+QHash<qlonglong, QVariantList> CoreDB::getItemsFields(const QString& table,
+                                                      const QStringList& fieldNames,
+                                                      const QList<qlonglong>& imageIds) const
+{
+    // The number of bound values of a query is limited by the database engines.
+
+    const int batchSize = 500;
+
+    QHash<qlonglong, QVariantList> results;
+    results.reserve(imageIds.size());
+
+    for (int begin = 0 ; begin < imageIds.size() ; begin += batchSize)
+    {
+        const int count = qMin(batchSize, imageIds.size() - begin);
+
+        QString query(QString::fromUtf8("SELECT imageid, "));
+        query += fieldNames.join(QString::fromUtf8(", "));
+        query += QString::fromUtf8(" FROM ") + table + QString::fromUtf8(" WHERE imageid IN (");
+        addBoundValuePlaceholders(query, count);
+        query += QString::fromUtf8(");");
+
+        QVariantList boundValues;
+        boundValues.reserve(count);
+
+        for (int i = begin ; i < (begin + count) ; ++i)
+        {
+            boundValues << imageIds.at(i);
+        }
+
+        QVariantList values;
+        d->db->execSql(query, boundValues, &values);
+
+        for (QVariantList::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+        {
+            const qlonglong imageId = it->toLongLong();
+            ++it;
+
+            QVariantList& fieldValues = results[imageId];
+
+            for (int i = 0 ; (i < fieldNames.size()) && (it != values.constEnd()) ; ++i, ++it)
+            {
+                fieldValues << *it;
+            }
+        }
+    }
+
+    return results;
+}
+
 QVariantList CoreDB::getItemPosition(qlonglong imageID, DatabaseFields::ItemPositions fields) const
 {
     QVariantList values;
@@ -3289,6 +3484,60 @@ QVariantList CoreDB::getAllCreationDates() const
     return values;
 }
 
+QHash<QDate, int> CoreDB::getCreationDateCounts() const
+{
+    QVariantList values;
+
+    if      (hasImageDateCounts())
+    {
+        d->db->execSql(QString::fromUtf8("SELECT day, count FROM ImageDateCounts;"),
+                       &values);
+    }
+    else if (d->db->databaseType() == BdEngineBackend::DbType::SQLite)
+    {
+        d->db->execSql(QString::fromUtf8("SELECT substr(creationDate, 1, 10), COUNT(*) FROM ImageInformation "
+                                         "INNER JOIN Images ON Images.id=ImageInformation.imageid "
+                                         " WHERE Images.status=1 AND creationDate IS NOT NULL "
+                                         " GROUP BY substr(creationDate, 1, 10);"),
+                       &values);
+    }
+    else
+    {
+        d->db->execSql(QString::fromUtf8("SELECT DATE(creationDate), COUNT(*) FROM ImageInformation "
+                                         "INNER JOIN Images ON Images.id=ImageInformation.imageid "
+                                         " WHERE Images.status=1 AND creationDate IS NOT NULL "
+                                         " GROUP BY DATE(creationDate);"),
+                       &values);
+    }
+
+    QHash<QDate, int> counts;
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        QDate date;
+
+        if (it->type() == QVariant::String)
+        {
+            date = QDate::fromString(it->toString().left(10), Qt::ISODate);
+        }
+        else
+        {
+            date = it->toDate();
+        }
+
+        ++it;
+        const int count = it->toInt();
+        ++it;
+
+        if (date.isValid() && (count > 0))
+        {
+            counts[date] += count;
+        }
+    }
+
+    return counts;
+}
+
 QList<qlonglong> CoreDB::getObsoleteItemIds() const
 {
    QList<QVariant> values;
@@ -3991,6 +4240,61 @@ QList<qlonglong> CoreDB::getAllItems() const
     return items;
 }
 
+QVariantList CoreDB::getAllItemsAttributes() const
+{
+    QVariantList values;
+
+    d->db->execSql(QString::fromUtf8("SELECT Images.id, Images.modificationDate, Images.fileSize, "
+                                     "ImageInformation.rating, ImageInformation.creationDate "
+                                     "FROM Images "
+                                     "LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
+                                     "WHERE Images.status=1;"),
+                   &values);
+
+    // Convert date times to QDateTime, they come as QString
+
+    for (int i = 0 ; (i + 4) < values.size() ; i += 5)
+    {
+        values[i + 1] = values.at(i + 1).toDateTime();
+        values[i + 4] = values.at(i + 4).toDateTime();
+    }
+
+    return values;
+}
+
+QVector<QVariantList> CoreDB::getItemsAttributes(const QList<qlonglong>& imageIds) const
+{
+    if (imageIds.isEmpty())
+    {
+        return QVector<QVariantList>();
+    }
+
+    QVector<QVariantList> results(imageIds.size());
+    DbEngineSqlQuery query = d->db->prepareQuery(QString::fromUtf8("SELECT Images.modificationDate, Images.fileSize, "
+                                                                   "ImageInformation.rating, ImageInformation.creationDate "
+                                                                   "FROM Images "
+                                                                   "LEFT JOIN ImageInformation ON Images.id=ImageInformation.imageid "
+                                                                   "WHERE Images.id=?;"));
+
+    for (int i = 0 ; i < imageIds.size() ; ++i)
+    {
+        QVariantList& values = results[i];
+        d->db->execSql(query, imageIds[i], &values);
+
+        if (values.size() == 4)
+        {
+            values[0] = values.at(0).toDateTime();
+            values[3] = values.at(3).toDateTime();
+        }
+        else
+        {
+            values.clear();
+        }
+    }
+
+    return results;
+}
+
 QHash<qlonglong, QPair<int, int> > CoreDB::getAllItemsWithAlbum() const
 {
     QList<QVariant> values;
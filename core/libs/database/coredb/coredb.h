@@ -124,6 +124,46 @@ public:
 
     bool isUniqueHashV2()                                                                                           const;
 
+    /**
+     * Returns the version of the text search index of this database, 0 if it has none.
+     * With the index, the searches of a part of the file names and comments do
+     * not scan the tables. The value is cached.
+     */
+    int getTextSearchIndexVersion()                                                                                 const;
+
+    void setTextSearchIndexVersion(int version);
+
+    bool hasTextSearchIndex()                                                                                       const;
+
+    /**
+     * Returns the version of the table of the visible items counted by day of
+     * creation, 0 if the database has none. The table is kept up to date by
+     * triggers. The value is cached.
+     */
+    int getImageDateCountsVersion()                                                                                 const;
+
+    void setImageDateCountsVersion(int version);
+
+    bool hasImageDateCounts()                                                                                       const;
+
+    /**
+     * Returns the version of the counter of the changes to the albums, tags,
+     * searches and their items, 0 if the database has none. The counter is
+     * incremented by triggers. The value is cached.
+     */
+    int getAlbumTreeChangesVersion()                                                                                const;
+
+    void setAlbumTreeChangesVersion(int version);
+
+    bool hasAlbumTreeChanges()                                                                                      const;
+
+    /**
+     * Returns the counter of the changes to the albums, tags, searches and their
+     * items, or -1 if the database has no such counter. Two equal values mean
+     * that the album trees and their items counts did not change in between.
+     */
+    qlonglong getAlbumTreeChangeCounter()                                                                           const;
+
     // ----------- AlbumRoot operations -----------
 
     /**
@@ -211,6 +251,12 @@ public:
      */
     QList<TagShortInfo> getTagShortInfos()                                                                          const;
 
+    /**
+     * Returns the parent id and the name of the tag,
+     * or a null info if the tag does not exist.
+     */
+    TagShortInfo getTagShortInfo(int tagId)                                                                         const;
+
     // ----------- Operations on PAlbums -----------
 
     /**
@@ -668,6 +714,19 @@ public:
      */
     QHash<qlonglong, QPair<int, int> > getAllItemsWithAlbum()                                                       const;
 
+    /**
+     * Returns the values used to filter and sort the visible items, as a flat list of
+     * id, modificationDate, fileSize, rating and creationDate for each item.
+     * Dates are converted to QDateTime.
+     */
+    QVariantList getAllItemsAttributes()                                                                            const;
+
+    /**
+     * For a list of items, return modificationDate, fileSize, rating and creationDate.
+     * The list for an item is empty if the item does not exist.
+     */
+    QVector<QVariantList> getItemsAttributes(const QList<qlonglong>& imageIds)                                      const;
+
     /**
      * Returns the id of the item with the given filename in
      * the album with the given id.
@@ -732,6 +791,13 @@ public:
      */
     QVariantList getAllCreationDates()                                                                              const;
 
+    /**
+     * Returns the number of visible items by day of creation. The counts are
+     * read from the table of the dates counts when the database has one, or
+     * are computed by the database server.
+     */
+    QHash<QDate, int> getCreationDateCounts()                                                                       const;
+
     /**
      * Get obsolete item Ids.
      */
@@ -901,6 +967,13 @@ public:
     QVariantList getImageMetadata(qlonglong imageID,
                                   DatabaseFields::ImageMetadata metadataFields = DatabaseFields::ImageMetadataAll) const;
 
+    /**
+     * Read the image metadata of several items, with one query for each 500 items.
+     * Returns the values of each item which has image metadata, as getImageMetadata().
+     */
+    QHash<qlonglong, QVariantList> getImagesMetadata(const QList<qlonglong>& imageIds,
+                                                     DatabaseFields::ImageMetadata metadataFields = DatabaseFields::ImageMetadataAll) const;
+
     /**
      * Add (or replace) the VideoMetadata of the specified item.
      * If there is already an entry, it will be discarded.
@@ -932,6 +1005,12 @@ public:
     QVariantList getVideoMetadata(qlonglong imageID,
                                   DatabaseFields::VideoMetadata metadataFields = DatabaseFields::VideoMetadataAll)  const;
 
+    /**
+     * Read the video metadata of several items. Parameters as for getImagesMetadata().
+     */
+    QHash<qlonglong, QVariantList> getVideosMetadata(const QList<qlonglong>& imageIds,
+                                                     DatabaseFields::VideoMetadata metadataFields = DatabaseFields::VideoMetadataAll) const;
+
     /**
      * Add (or replace) the ItemPosition of the specified item.
      * If there is already an entry, it will be discarded.
@@ -1267,6 +1346,12 @@ public:
      */
     QVector<QList<int> > getItemsTagIDs(const QList<qlonglong>& imageIds)                                           const;
 
+    /**
+     * Returns the image id and tag id pairs of all items, as a flat list,
+     * sorted by image id and tag id.
+     */
+    QVariantList getAllItemsTagIDs()                                                                                const;
+
     /**
      * Get the properties for the given image/tag pair.
      * If the tagID is -1, returns the ImageTagProperties for all tagIds of the given image.
@@ -1455,6 +1540,10 @@ protected:
     QVector<QList<qlonglong> > getRelatedImages(QList<qlonglong> ids, bool fromOrTo,
                                                 DatabaseRelation::Type type, bool boolean)                          const;
 
+    QHash<qlonglong, QVariantList> getItemsFields(const QString& table,
+                                                  const QStringList& fieldNames,
+                                                  const QList<qlonglong>& imageIds)                                 const;
+
 private:
 
     // Disable
@@ -261,6 +261,7 @@ void CoreDbAccess::setParameters(const DbEngineParameters& parameters, Applicati
 
     d->databaseWatch->sendDatabaseChanged();
     ItemInfoStatic::cache()->invalidate();
+    ItemInfoStatic::attributesStore()->invalidate();
     TagsCache::instance()->invalidate();
     d->databaseWatch->setDatabaseIdentifier(QString());
     CollectionManager::instance()->clearLocations();
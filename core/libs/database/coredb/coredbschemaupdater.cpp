@@ -67,6 +67,23 @@ bool CoreDbSchemaUpdater::isUniqueHashUpToDate()
     return (CoreDbAccess().db()->getUniqueHashVersion() >= uniqueHashVersion());
 }
 
+int CoreDbSchemaUpdater::textSearchIndexVersion()
+{
+    return 1;
+}
+
+int CoreDbSchemaUpdater::imageDateCountsVersion()
+{
+    return 1;
+}
+
+int CoreDbSchemaUpdater::albumTreeChangesVersion()
+{
+    // Version 2 only counts the changes of the items visible in the album trees.
+
+    return 2;
+}
+
 // --------------------------------------------------------------------------------------
 
 class Q_DECL_HIDDEN CoreDbSchemaUpdater::Private
@@ -146,6 +163,9 @@ bool CoreDbSchemaUpdater::update()
     }
 
     updateFilterSettings();
+    updateTextSearchIndex();
+    updateImageDateCounts();
+    updateAlbumTreeChanges();
 
     if (d->observer)
     {
@@ -625,6 +645,82 @@ bool CoreDbSchemaUpdater::createTriggers()
     return d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateTriggers")));
 }
 
+bool CoreDbSchemaUpdater::updateTextSearchIndex()
+{
+    // The text search index is optional: it needs the FTS5 module and the trigram
+    // tokenizer of SQLite. Without it, the text searches scan the tables.
+
+    if (!d->parameters.isSQLite() ||
+        (d->albumDB->getTextSearchIndexVersion() >= textSearchIndexVersion()))
+    {
+        return true;
+    }
+
+    qCDebug(DIGIKAM_COREDB_LOG) << "Core database: creating the text search index";
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateTextSearchIndex"))))
+    {
+        qCWarning(DIGIKAM_COREDB_LOG) << "Core database: cannot create the text search index."
+                                      << "The SQLite library may not support FTS5 with trigrams.";
+
+        return false;
+    }
+
+    d->albumDB->setTextSearchIndexVersion(textSearchIndexVersion());
+
+    return true;
+}
+
+bool CoreDbSchemaUpdater::updateImageDateCounts()
+{
+    // With MySQL, the items deleted by the foreign keys cascades do not fire
+    // the triggers: the dates are counted by the server on each request.
+
+    if (!d->parameters.isSQLite() ||
+        (d->albumDB->getImageDateCountsVersion() >= imageDateCountsVersion()))
+    {
+        return true;
+    }
+
+    qCDebug(DIGIKAM_COREDB_LOG) << "Core database: creating the table of the dates counts";
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateImageDateCounts"))))
+    {
+        qCWarning(DIGIKAM_COREDB_LOG) << "Core database: cannot create the table of the dates counts";
+
+        return false;
+    }
+
+    d->albumDB->setImageDateCountsVersion(imageDateCountsVersion());
+
+    return true;
+}
+
+bool CoreDbSchemaUpdater::updateAlbumTreeChanges()
+{
+    // With MySQL, the items deleted by the foreign keys cascades do not fire
+    // the triggers: there is no counter, and the albums are always read.
+
+    if (!d->parameters.isSQLite() ||
+        (d->albumDB->getAlbumTreeChangesVersion() >= albumTreeChangesVersion()))
+    {
+        return true;
+    }
+
+    qCDebug(DIGIKAM_COREDB_LOG) << "Core database: creating the counter of the album trees changes";
+
+    if (!d->backend->execDBAction(d->backend->getDBAction(QLatin1String("CreateAlbumTreeChanges"))))
+    {
+        qCWarning(DIGIKAM_COREDB_LOG) << "Core database: cannot create the counter of the album trees changes";
+
+        return false;
+    }
+
+    d->albumDB->setAlbumTreeChangesVersion(albumTreeChangesVersion());
+
+    return true;
+}
+
 bool CoreDbSchemaUpdater::updateUniqueHash()
 {
     if (isUniqueHashUpToDate())
@@ -42,6 +42,9 @@ public:
     static int  filterSettingsVersion();
     static int  uniqueHashVersion();
     static bool isUniqueHashUpToDate();
+    static int  textSearchIndexVersion();
+    static int  imageDateCountsVersion();
+    static int  albumTreeChangesVersion();
 
 public:
 
@@ -72,6 +75,9 @@ private:
     bool createTables();
     bool createIndices();
     bool createTriggers();
+    bool updateTextSearchIndex();
+    bool updateImageDateCounts();
+    bool updateAlbumTreeChanges();
     bool copyV3toV4(const QString& digikam3DBPath, const QString& currentDBPath);
     bool performUpdateToVersion(const QString& actionName, int newVersion, int newRequiredVersion);
     bool updateToVersion(int targetVersion);
@@ -51,7 +51,26 @@ AlbumsJob::~AlbumsJob()
 
 void AlbumsJob::run()
 {
-    if (m_jobInfo.isFoldersJob())
+    if      (m_jobInfo.isAlbumTreeJob())
+    {
+        qlonglong         counter = -1;
+        QList<AlbumInfo>  albums;
+        QList<TagInfo>    tags;
+        QList<SearchInfo> searches;
+
+        {
+            // The database cannot change between the reads while it is locked here.
+
+            CoreDbAccess access;
+            counter  = access.db()->getAlbumTreeChangeCounter();
+            albums   = access.db()->scanAlbums();
+            tags     = access.db()->scanTags();
+            searches = access.db()->scanSearches();
+        }
+
+        Q_EMIT albumTreeData(counter, albums, tags, searches);
+    }
+    else if (m_jobInfo.isFoldersJob())
     {
         const QHash<int, int>& albumNumberHash = CoreDbAccess().db()->getNumberOfImagesInAlbums();
 
@@ -89,33 +108,16 @@ void DatesJob::run()
 {
     if (m_jobInfo.isFoldersJob())
     {
-        const QVariantList& values = CoreDbAccess().db()->getAllCreationDates();
+        // The dates views only use the days: the items are counted by day in the database.
+
+        const QHash<QDate, int> counts = CoreDbAccess().db()->getCreationDateCounts();
 
         QHash<QDateTime, int> dateNumberHash;
-        QHash<QDateTime, int>::iterator it;
+        dateNumberHash.reserve(counts.size());
 
-        Q_FOREACH (const QVariant& value, values)
+        for (QHash<QDate, int>::const_iterator it = counts.constBegin() ; it != counts.constEnd() ; ++it)
         {
-            if (!value.isNull())
-            {
-                QDateTime dateTime = value.toDateTime();
-
-                if (!dateTime.isValid())
-                {
-                    continue;
-                }
-
-                it = dateNumberHash.find(dateTime);
-
-                if (it == dateNumberHash.end())
-                {
-                    dateNumberHash.insert(dateTime, 1);
-                }
-                else
-                {
-                    it.value()++;
-                }
-            }
+            dateNumberHash.insert(QDateTime(it.key(), QTime(0, 0, 0)), it.value());
         }
 
         Q_EMIT foldersData(dateNumberHash);
@@ -18,6 +18,7 @@
 // Local includes
 
 #include "dbjobinfo.h"
+#include "coredbalbuminfo.h"
 #include "itemlisterrecord.h"
 #include "duplicatesprogressobserver.h"
 #include "actionthreadbase.h"
@@ -67,6 +68,11 @@ Q_SIGNALS:
 
     void foldersData(const QHash<int, int>&);
 
+    /**
+     * The albums, tags and searches, read at the given counter of the album trees changes.
+     */
+    void albumTreeData(qlonglong, const QList<AlbumInfo>&, const QList<TagInfo>&, const QList<SearchInfo>&);
+
 private:
 
     AlbumsDBJobInfo m_jobInfo;
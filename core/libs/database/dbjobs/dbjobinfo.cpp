@@ -58,7 +58,8 @@ bool DBJobInfo::isRecursive() const
 
 AlbumsDBJobInfo::AlbumsDBJobInfo()
     : DBJobInfo    (),
-      m_albumRootId(-1)
+      m_albumRootId(-1),
+      m_albumTree  (false)
 {
 }
 
@@ -82,6 +83,16 @@ QString AlbumsDBJobInfo::album()
     return m_album;
 }
 
+void AlbumsDBJobInfo::setAlbumTreeJob()
+{
+    m_albumTree = true;
+}
+
+bool AlbumsDBJobInfo::isAlbumTreeJob() const
+{
+    return m_albumTree;
+}
+
 // ---------------------------------------------
 
 TagsDBJobInfo::TagsDBJobInfo()
@@ -188,6 +199,7 @@ SearchesDBJobInfo::SearchesDBJobInfo(QList<int>&& searchIds)
     : DBJobInfo                 (),
       m_duplicates              (false),
       m_albumUpdate             (false),
+      m_nearDuplicatesSearch    (false),
       m_searchResultRestriction (0),
       m_searchIds               (std::move(searchIds)),
       m_minThreshold            (0.4),
@@ -202,6 +214,7 @@ SearchesDBJobInfo::SearchesDBJobInfo(QSet<qlonglong>&& imageIds,
     : DBJobInfo                 (),
       m_duplicates              (true),
       m_albumUpdate             (isAlbumUpdate),
+      m_nearDuplicatesSearch    (false),
       m_searchResultRestriction (0),
       m_imageIds                (std::move(imageIds)),
       m_minThreshold            (0.4),
@@ -231,6 +244,16 @@ int SearchesDBJobInfo::searchResultRestriction() const
     return m_searchResultRestriction;
 }
 
+void SearchesDBJobInfo::setNearDuplicatesSearch(bool b)
+{
+    m_nearDuplicatesSearch = b;
+}
+
+bool SearchesDBJobInfo::isNearDuplicatesSearch() const
+{
+    return m_nearDuplicatesSearch;
+}
+
 const QList<int>& SearchesDBJobInfo::searchIds() const
 {
     return m_searchIds;
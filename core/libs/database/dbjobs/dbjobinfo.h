@@ -67,10 +67,17 @@ public:
     void setAlbum(const QString& album);
     QString album();
 
+    /**
+     * Read the albums, tags and searches of the album trees.
+     */
+    void setAlbumTreeJob();
+    bool isAlbumTreeJob()           const;
+
 private:
 
     int     m_albumRootId;
     QString m_album;
+    bool    m_albumTree;
 };
 
 // ---------------------------------------------
@@ -159,10 +166,14 @@ public:
     void setSearchResultRestriction(int type);
     int searchResultRestriction()                          const;
 
+    void setNearDuplicatesSearch(bool b);
+    bool isNearDuplicatesSearch()                          const;
+
 public:
 
     bool                         m_duplicates;
     bool                         m_albumUpdate;
+    bool                         m_nearDuplicatesSearch;
     int                          m_searchResultRestriction;
     QList<int>                   m_searchIds;
     QSet<qlonglong>              m_imageIds;
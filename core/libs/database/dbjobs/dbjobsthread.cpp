@@ -29,6 +29,10 @@ DBJobsThread::DBJobsThread(QObject* const parent)
     : ActionThreadBase(parent)
 {
     setObjectName(QLatin1String("DBJobsThread"));
+
+    // The views wait for the results of the database jobs.
+
+    setPriorityClass(ThreadManager::Interactive);
 }
 
 DBJobsThread::~DBJobsThread()
@@ -76,7 +80,12 @@ void AlbumsDBJobsThread::albumsListing(const AlbumsDBJobInfo& info)
 
     connectFinishAndErrorSignals(j);
 
-    if (info.isFoldersJob())
+    if      (info.isAlbumTreeJob())
+    {
+        connect(j, SIGNAL(albumTreeData(qlonglong,QList<AlbumInfo>,QList<TagInfo>,QList<SearchInfo>)),
+                this, SIGNAL(albumTreeData(qlonglong,QList<AlbumInfo>,QList<TagInfo>,QList<SearchInfo>)));
+    }
+    else if (info.isFoldersJob())
     {
         connect(j, SIGNAL(foldersData(QHash<int,int>)),
                 this, SIGNAL(foldersData(QHash<int,int>)));
@@ -220,13 +229,22 @@ void SearchesDBJobsThread::searchesListing(const SearchesDBJobInfo& info)
 
     if (info.isDuplicatesJob())
     {
+        // The duplicates search is a long scan of the collection: it runs on the background
+        // threads, so the album, tag, date and GPS listings keep the interactive ones.
+
+        setPriorityClass(ThreadManager::Background);
+
         m_results.clear();
+        m_resultsImages.clear();
         m_haarIface.reset(new HaarIface(info.imageIds()));
+        m_haarIface->setNearDuplicatesSearch(info.isNearDuplicatesSearch());
         m_isAlbumUpdate    = info.isAlbumUpdate();
         m_processedImages  = 0;
         m_totalImages2Scan = info.imageIds().count();
 
-        const int threadsCount         = (m_totalImages2Scan < 200) ? 1 : qMax(1, maximumNumberOfThreads());
+        const int maxThreads           = qMin(maximumNumberOfThreads(),
+                                              ThreadManager::instance()->maximumJobThreads(ThreadManager::Background));
+        const int threadsCount         = (m_totalImages2Scan < 200) ? 1 : qMax(1, maxThreads);
         const int images2ScanPerThread = m_totalImages2Scan / threadsCount;
 
         QSet<qlonglong>::const_iterator begin = info.imageIds().constBegin();
@@ -280,25 +298,20 @@ void SearchesDBJobsThread::slotImageProcessed()
 
 void SearchesDBJobsThread::slotDuplicatesResults(const HaarIface::DuplicatesResultsMap& incoming)
 {
-    auto searchResults = [&](qlonglong imageId) -> HaarIface::DuplicatesResultsMap::iterator
+    // A group is only kept if its reference is not already in a group found by another job.
+
+    for (auto it = incoming.constBegin() ; it != incoming.constEnd() ; ++it)
     {
-        for (auto it = m_results.begin() ; it != m_results.end() ; ++it)
+        if (!m_resultsImages.contains(it.key()))
         {
-            if ((imageId == it.key()) || (it->second.contains(imageId)))
+            m_results.insert(it.key(), it.value());
+            m_resultsImages.insert(it.key());
+
+            for (const qlonglong& imageId : it->second)
             {
-                return it;
+                m_resultsImages.insert(imageId);
             }
         }
-
-        return m_results.end();
-    };
-
-    for (const auto& referenceImage : incoming.keys())
-    {
-        if (searchResults(referenceImage) == m_results.end())
-        {
-            m_results.insert(referenceImage, incoming.value(referenceImage));
-        }
     }
 
     if (m_processedImages != m_totalImages2Scan)
@@ -306,7 +319,7 @@ void SearchesDBJobsThread::slotDuplicatesResults(const HaarIface::DuplicatesResu
         return;
     }
 
-    HaarIface::rebuildDuplicatesAlbums(m_results, m_isAlbumUpdate);
+    HaarIface::rebuildDuplicatesGroups(m_results, m_isAlbumUpdate);
 
     Q_EMIT finished();
 }
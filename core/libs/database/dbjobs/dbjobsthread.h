@@ -98,6 +98,7 @@ Q_SIGNALS:
 
     void foldersData(const QHash<int, int>&);
     void faceFoldersData(const QMap<QString, QHash<int, int> >&);
+    void albumTreeData(qlonglong, const QList<AlbumInfo>&, const QList<TagInfo>&, const QList<SearchInfo>&);
 };
 
 // ---------------------------------------------
@@ -173,6 +174,7 @@ Q_SIGNALS:
 
 private:
     HaarIface::DuplicatesResultsMap m_results;
+    QSet<qlonglong>                 m_resultsImages;    ///< The references and items of all groups in m_results.
     QScopedPointer<HaarIface>       m_haarIface;
     bool                            m_isAlbumUpdate;
     int                             m_processedImages;
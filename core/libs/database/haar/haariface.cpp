@@ -55,6 +55,16 @@ void HaarIface::setAlbumRootsToSearch(const QSet<int>& albumRootIds)
     d->setAlbumRootsToSearch(albumRootIds);
 }
 
+void HaarIface::setNearDuplicatesSearch(bool enabled)
+{
+    d->setNearDuplicatesSearch(enabled);
+}
+
+bool HaarIface::isNearDuplicatesSearch() const
+{
+    return d->isNearDuplicatesSearch();
+}
+
 int HaarIface::preferredSize()
 {
     return Haar::NumberOfPixels;
@@ -124,6 +134,10 @@ bool HaarIface::indexImage(qlonglong imageid, const DImg& image)
 
 bool HaarIface::indexImage(qlonglong imageid)
 {
+    // The perceptual hash is computed on the pixels, before they are transformed.
+
+    const quint64 hash = PerceptualHash::compute(d->imageData());
+
     Haar::Calculator haar;
     haar.transform(d->imageData());
 
@@ -143,6 +157,8 @@ bool HaarIface::indexImage(qlonglong imageid)
                                                                   " (imageid, modificationDate, uniqueHash, matrix) "
                                                                   " VALUES(?, ?, ?, ?);"),
                                                 imageid, info.modDateTime(), info.uniqueHash(), array);
+
+        SimilarityDbAccess().db()->setPerceptualHash(imageid, hash);
     }
 
     return true;
@@ -163,6 +179,13 @@ QString HaarIface::signatureAsText(const QImage& image)
     return QString::fromUtf8(array.toBase64());
 }
 
+quint64 HaarIface::perceptualHash(const DImg& image)
+{
+    d->setImageDataFromImage(image);
+
+    return PerceptualHash::compute(d->imageData());
+}
+
 QPair<double, QMap<qlonglong, double> > HaarIface::bestMatchesForImageWithThreshold(const QString& imagePath,
                                                                                     double requiredPercentage,
                                                                                     double maximumPercentage,
@@ -487,6 +510,27 @@ QMap<qlonglong, double> HaarIface::searchDatabase(Haar::SignatureData* const que
         d->rebuildSignatureCache();
     }
 
+    // With the near duplicates search, only the images with a close perceptual hash are scored.
+
+    QList<qlonglong> candidates;
+
+    if ((originalImageId != -1) && d->nearDuplicatesCandidates(originalImageId, candidates))
+    {
+        for (const qlonglong& imageId : qAsConst(candidates))
+        {
+            auto it = d->signatureCache()->constFind(imageId);
+
+            if ((it != d->signatureCache()->constEnd()) &&
+                fulfillsRestrictions(imageId, d->albumCache()->value(imageId), originalImageId,
+                                     originalAlbumId, targetAlbums, searchResultRestriction))
+            {
+                scores[imageId] = calculateScore(*querySig, it.value(), weights, queryMaps);
+            }
+        }
+
+        return scores;
+    }
+
     for (auto it = d->signatureCache()->constBegin() ; it != d->signatureCache()->constEnd() ; ++it)
     {
         // If the image is the original one or
@@ -598,66 +642,33 @@ void HaarIface::getBestAndWorstPossibleScore(Haar::SignatureData* const sig,
 }
 
 
-QMap<QString, QString> HaarIface::writeSAlbumQueries(const DuplicatesResultsMap& searchResults)
+void HaarIface::rebuildDuplicatesGroups(const DuplicatesResultsMap& results, bool isAlbumUpdate)
 {
-    // Build search XML from the results. Store list of ids of similar images.
-
-    QMap<QString, QString> queries;
+    QList<DuplicatesGroup> groups;
+    groups.reserve(results.size());
 
-    for (auto it = searchResults.constBegin() ; it != searchResults.constEnd() ; ++it)
+    for (auto it = results.constBegin() ; it != results.constEnd() ; ++it)
     {
-        SearchXmlWriter writer;
-        writer.writeGroup();
-        writer.writeField(QLatin1String("imageid"), SearchXml::OneOf);
-        writer.writeValue(it->second);
-        writer.finishField();
-
-        // Add the average similarity as field
-
-        writer.writeField(QLatin1String("noeffect_avgsim"), SearchXml::Equal);
-        writer.writeValue(it->first * 100);
-        writer.finishField();
-        writer.finishGroup();
-        writer.finish();
-
-        // Use the id of the first duplicate as name of the search
-
-        queries.insert(QString::number(it.key()), writer.xml());
+        DuplicatesGroup group;
+        group.reference  = it.key();
+        group.similarity = it->first;
+        group.items      = it->second;
+        groups << group;
     }
 
-    return queries;
-}
-
-void HaarIface::rebuildDuplicatesAlbums(const DuplicatesResultsMap& results, bool isAlbumUpdate)
-{
-    // Build search XML from the results. Store list of ids of similar images.
-
-    QMap<QString, QString> queries = writeSAlbumQueries(results);
+    // Write all groups at once to the similarity database.
 
-    // Write the new search albums to the database.
+    SimilarityDbAccess().db()->setDuplicatesGroups(groups, isAlbumUpdate);
 
-    CoreDbAccess access;
-    CoreDbTransaction transaction(&access);
-
-    // Full rebuild: delete all old searches.
+    // Full rebuild: delete the search albums of the groups written by the previous versions,
+    // and the current duplicates search which shows the items of the selected groups.
 
     if (!isAlbumUpdate)
     {
-        access.db()->deleteSearches(DatabaseSearch::DuplicatesSearch);
+        CoreDbAccess().db()->deleteSearches(DatabaseSearch::DuplicatesSearch);
     }
 
-    // Create new groups, or update existing searches.
-
-    for (QMap<QString, QString>::const_iterator it = queries.constBegin() ;
-         it != queries.constEnd() ; ++it)
-    {
-        if (isAlbumUpdate)
-        {
-            access.db()->deleteSearch(it.key().toInt());
-        }
-
-        access.db()->addSearch(DatabaseSearch::DuplicatesSearch, it.key(), it.value());
-    }
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Duplicates search:" << groups.size() << "groups written";
 }
 
 QSet<qlonglong> HaarIface::imagesFromAlbumsAndTags(const QList<int>& albums2Scan,
@@ -161,6 +161,12 @@ public:
      */
     QString signatureAsText(const QImage& image);
 
+    /**
+     * Calculates the perceptual hash of the image, as stored in the DB by indexImage(),
+     * without storing it. Can be used to check that two images are near duplicates.
+     */
+    quint64 perceptualHash(const DImg& image);
+
     /**
      * Checks whether the image with the given imageId fulfills all restrictions given in
      * targetAlbums and in respect to searchResultRestriction.
@@ -207,10 +213,11 @@ public:
                                                    AlbumTagRelation relation);
 
     /**
-     * This method rebuilds the given SAlbums using the given results.
+     * This method writes the given results to the duplicates groups of the similarity database.
      * @param results Map of duplicates images found over a list of images.
+     * @param isAlbumUpdate If false, the groups of the previous search are removed.
      */
-    static void rebuildDuplicatesAlbums(const DuplicatesResultsMap& results, bool isAlbumUpdate);
+    static void rebuildDuplicatesGroups(const DuplicatesResultsMap& results, bool isAlbumUpdate);
 
     /**
      * Retrieve the Haar signature from database using image id.
@@ -225,6 +232,16 @@ public:
     void setAlbumRootsToSearch(const QList<int>& albumRootIds);
     void setAlbumRootsToSearch(const QSet<int>& albumRootIds);
 
+    /**
+     * Enable the near duplicates search: the images are first looked up by their
+     * perceptual hash, and the Haar signatures are only compared for the images
+     * with a close hash. Images without perceptual hash are always compared.
+     * This must be set before starting the searches, as the hashes index is
+     * built here and shared by all searches.
+     */
+    void setNearDuplicatesSearch(bool enabled);
+    bool isNearDuplicatesSearch() const;
+
     /**
      * This method loads a QImage from the given filename.
      * @param filename the name of the file (path)
@@ -236,12 +253,6 @@ private:
 
     bool   indexImage(qlonglong imageid);
 
-    /**
-     * This method writes the search results to the SearchXml structure.
-     * @param searchResults The results to write as XML.
-     */
-    static QMap<QString, QString> writeSAlbumQueries(const DuplicatesResultsMap& searchResults);
-
     QMultiMap<double, qlonglong> bestMatches(Haar::SignatureData* const data,
                                              int numberOfResults,
                                              const QList<int>& targetAlbums,
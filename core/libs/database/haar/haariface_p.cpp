@@ -93,7 +93,8 @@ const QString HaarIface::Private::signatureQuery = QString::fromUtf8("SELECT ima
 const Haar::WeightBin HaarIface::Private::weightBin;
 
 HaarIface::Private::Private()
-    : m_data(new Haar::ImageData)
+    : m_data                (new Haar::ImageData),
+      m_nearDuplicatesSearch(false)
 {
 }
 
@@ -171,6 +172,82 @@ void HaarIface::Private::rebuildSignatureCache(const QSet<qlonglong>& imageIds)
             albCache[imageid] = albumid;
         }
     }
+
+    if (m_nearDuplicatesSearch)
+    {
+        rebuildPerceptualHashTree();
+    }
+}
+
+void HaarIface::Private::rebuildPerceptualHashTree()
+{
+    m_perceptualHashTree.clear();
+    m_unhashedImages.clear();
+    m_perceptualHashes.clear();
+
+    if (m_signatureCache.isNull())
+    {
+        return;
+    }
+
+    const QHash<qlonglong, quint64> hashes = SimilarityDbAccess().db()->getPerceptualHashes();
+
+    for (auto it = m_signatureCache->constBegin() ; it != m_signatureCache->constEnd() ; ++it)
+    {
+        auto hash = hashes.constFind(it.key());
+
+        if (hash == hashes.constEnd())
+        {
+            // Fingerprints computed before the perceptual hashes were introduced.
+
+            m_unhashedImages << it.key();
+        }
+        else
+        {
+            m_perceptualHashes.insert(it.key(), hash.value());
+            m_perceptualHashTree.insert(hash.value(), it.key());
+        }
+    }
+
+    qCDebug(DIGIKAM_DATABASE_LOG) << "Perceptual hash tree:" << m_perceptualHashTree.count()
+                                  << "images indexed," << m_unhashedImages.count()
+                                  << "images without hash";
+}
+
+void HaarIface::Private::setNearDuplicatesSearch(bool enabled)
+{
+    m_nearDuplicatesSearch = enabled;
+
+    if (m_nearDuplicatesSearch)
+    {
+        rebuildPerceptualHashTree();
+    }
+    else
+    {
+        m_perceptualHashTree.clear();
+        m_unhashedImages.clear();
+        m_perceptualHashes.clear();
+    }
+}
+
+bool HaarIface::Private::isNearDuplicatesSearch() const
+{
+    return m_nearDuplicatesSearch;
+}
+
+bool HaarIface::Private::nearDuplicatesCandidates(qlonglong imageId, QList<qlonglong>& candidates) const
+{
+    auto hash = m_perceptualHashes.constFind(imageId);
+
+    if (!m_nearDuplicatesSearch || (hash == m_perceptualHashes.constEnd()))
+    {
+        return false;
+    }
+
+    candidates  = m_perceptualHashTree.find(hash.value(), PerceptualHash::NearDuplicatesDistance);
+    candidates << m_unhashedImages;
+
+    return true;
 }
 
 bool HaarIface::Private::hasSignatureCache() const
@@ -35,6 +35,7 @@
 #include <QImage>
 #include <QImageReader>
 #include <QMap>
+#include <QHash>
 
 // Local includes
 
@@ -50,6 +51,7 @@
 #include "dbenginesqlquery.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
+#include "perceptualhash.h"
 
 using namespace std;
 
@@ -101,6 +103,7 @@ public:
 public:
 
     void rebuildSignatureCache(const QSet<qlonglong>& imageIds = {});
+    void rebuildPerceptualHashTree();
     bool hasSignatureCache()              const;
 
     bool retrieveSignatureFromCache(qlonglong imageId, Haar::SignatureData& data);
@@ -115,6 +118,20 @@ public:
     void setAlbumRootsToSearch(const QSet<int>& albumRootIds);
     const QSet<int>& albumRootsToSearch() const;
 
+    /**
+     * The perceptual hashes of the images of the signature cache are indexed in a BK-tree
+     * when the near duplicates search is enabled. The index is only read by the searches.
+     */
+    void setNearDuplicatesSearch(bool enabled);
+    bool isNearDuplicatesSearch()         const;
+
+    /**
+     * Returns the images of the signature cache which are near duplicates candidates of
+     * the given image: the images with a close perceptual hash and the images without hash.
+     * Returns false if the image has no perceptual hash, and all images must be compared.
+     */
+    bool nearDuplicatesCandidates(qlonglong imageId, QList<qlonglong>& candidates) const;
+
 public:
 
     const static QString            signatureQuery;
@@ -128,6 +145,11 @@ private:
     QScopedPointer<Haar::ImageData> m_data;
 
     QSet<int>                       m_albumRootsToSearch;
+
+    bool                            m_nearDuplicatesSearch;
+    QHash<qlonglong, quint64>       m_perceptualHashes;
+    QList<qlonglong>                m_unhashedImages;
+    PerceptualHashTree              m_perceptualHashTree;
 };
 
 } // namespace Digikam
@@ -0,0 +1,198 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Perceptual hash of an image and BK-tree index
+ *               used to pre-filter the duplicates search.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "perceptualhash.h"
+
+// Qt includes
+
+#include <QtAlgorithms>
+
+namespace Digikam
+{
+
+namespace PerceptualHash
+{
+
+quint64 compute(const Haar::ImageData* const data)
+{
+    const int gridWidth  = 9;
+    const int gridHeight = 8;
+
+    double cells[gridHeight][gridWidth];
+
+    // Average the luminance over each cell of the grid. The cells do not
+    // have the same width, as the image width is not a multiple of 9.
+
+    for (int row = 0 ; row < gridHeight ; ++row)
+    {
+        const int y0 = (row       * Haar::NumberOfPixels) / gridHeight;
+        const int y1 = ((row + 1) * Haar::NumberOfPixels) / gridHeight;
+
+        for (int col = 0 ; col < gridWidth ; ++col)
+        {
+            const int x0 = (col       * Haar::NumberOfPixels) / gridWidth;
+            const int x1 = ((col + 1) * Haar::NumberOfPixels) / gridWidth;
+            double sum   = 0.0;
+
+            for (int y = y0 ; y < y1 ; ++y)
+            {
+                for (int x = x0 ; x < x1 ; ++x)
+                {
+                    const int i = y * Haar::NumberOfPixels + x;
+                    sum        += 0.299 * data->data1[i] + 0.587 * data->data2[i] + 0.114 * data->data3[i];
+                }
+            }
+
+            cells[row][col] = sum / ((y1 - y0) * (x1 - x0));
+        }
+    }
+
+    quint64 hash = 0;
+    int bit      = 0;
+
+    for (int row = 0 ; row < gridHeight ; ++row)
+    {
+        for (int col = 0 ; col < (gridWidth - 1) ; ++col)
+        {
+            if (cells[row][col] > cells[row][col + 1])
+            {
+                hash |= (Q_UINT64_C(1) << bit);
+            }
+
+            ++bit;
+        }
+    }
+
+    return hash;
+}
+
+int hammingDistance(quint64 hash1, quint64 hash2)
+{
+    return (int)qPopulationCount(hash1 ^ hash2);
+}
+
+} // namespace PerceptualHash
+
+// --------------------------------------------------------------------------
+
+void PerceptualHashTree::insert(quint64 hash, qlonglong imageId)
+{
+    ++m_count;
+
+    if (m_nodes.empty())
+    {
+        m_nodes.emplace_back(hash);
+        m_nodes.back().imageIds << imageId;
+
+        return;
+    }
+
+    int index = 0;
+
+    Q_FOREVER
+    {
+        const int distance = PerceptualHash::hammingDistance(m_nodes[index].hash, hash);
+
+        if (distance == 0)
+        {
+            m_nodes[index].imageIds << imageId;
+
+            return;
+        }
+
+        int child = -1;
+
+        for (const QPair<int, int>& pair : m_nodes[index].children)
+        {
+            if (pair.first == distance)
+            {
+                child = pair.second;
+                break;
+            }
+        }
+
+        if (child == -1)
+        {
+            // The node is added before the reference to its parent is taken,
+            // as the vector may be reallocated.
+
+            const int newIndex = (int)m_nodes.size();
+            m_nodes.emplace_back(hash);
+            m_nodes.back().imageIds << imageId;
+            m_nodes[index].children.push_back(qMakePair(distance, newIndex));
+
+            return;
+        }
+
+        index = child;
+    }
+}
+
+QList<qlonglong> PerceptualHashTree::find(quint64 hash, int maxDistance) const
+{
+    QList<qlonglong> results;
+
+    if (m_nodes.empty())
+    {
+        return results;
+    }
+
+    // By the triangle inequality, only the children whose distance to their
+    // parent is within maxDistance of the query distance can hold a match.
+
+    std::vector<int> pending;
+    pending.push_back(0);
+
+    while (!pending.empty())
+    {
+        const Node& node = m_nodes[pending.back()];
+        pending.pop_back();
+
+        const int distance = PerceptualHash::hammingDistance(node.hash, hash);
+
+        if (distance <= maxDistance)
+        {
+            results << node.imageIds;
+        }
+
+        for (const QPair<int, int>& pair : node.children)
+        {
+            if (qAbs(pair.first - distance) <= maxDistance)
+            {
+                pending.push_back(pair.second);
+            }
+        }
+    }
+
+    return results;
+}
+
+int PerceptualHashTree::count() const
+{
+    return m_count;
+}
+
+bool PerceptualHashTree::isEmpty() const
+{
+    return (m_count == 0);
+}
+
+void PerceptualHashTree::clear()
+{
+    m_nodes.clear();
+    m_count = 0;
+}
+
+} // namespace Digikam
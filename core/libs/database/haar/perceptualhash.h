@@ -0,0 +1,110 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Perceptual hash of an image and BK-tree index
+ *               used to pre-filter the duplicates search.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_PERCEPTUAL_HASH_H
+#define DIGIKAM_PERCEPTUAL_HASH_H
+
+// C++ includes
+
+#include <vector>
+
+// Qt includes
+
+#include <QtGlobal>
+#include <QList>
+#include <QPair>
+
+// Local includes
+
+#include "haar.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+namespace PerceptualHash
+{
+
+/**
+ * The maximum Hamming distance between the hashes of two images for them
+ * to be considered as near duplicates candidates.
+ */
+enum { NearDuplicatesDistance = 10 };
+
+/**
+ * Computes the 64 bits difference hash (dHash) of the image data, before
+ * the Haar transform: the luminance is averaged on a grid of 9x8 cells, and
+ * each bit tells if a cell is brighter than its right neighbour.
+ * The hash survives re-encoding, resizing and small color changes.
+ */
+DIGIKAM_DATABASE_EXPORT quint64 compute(const Haar::ImageData* const data);
+
+/**
+ * Returns the number of bits which differ between the two hashes.
+ */
+DIGIKAM_DATABASE_EXPORT int hammingDistance(quint64 hash1, quint64 hash2);
+
+} // namespace PerceptualHash
+
+// --------------------------------------------------------------------------
+
+/**
+ * A BK-tree of perceptual hashes, to find all images whose hash is in a given
+ * Hamming distance of a query hash without comparing it to all hashes.
+ */
+class DIGIKAM_DATABASE_EXPORT PerceptualHashTree
+{
+public:
+
+    PerceptualHashTree() = default;
+
+    void insert(quint64 hash, qlonglong imageId);
+
+    /**
+     * Returns the ids of the images whose hash is at most maxDistance bits away from hash.
+     */
+    QList<qlonglong> find(quint64 hash, int maxDistance) const;
+
+    int  count()   const;
+    bool isEmpty() const;
+    void clear();
+
+private:
+
+    class Node
+    {
+    public:
+
+        explicit Node(quint64 h)
+            : hash(h)
+        {
+        }
+
+    public:
+
+        quint64                      hash;
+        QList<qlonglong>             imageIds;  ///< Images with exactly this hash.
+        std::vector<QPair<int, int>> children;  ///< Pairs of distance and index of the child node.
+    };
+
+private:
+
+    std::vector<Node> m_nodes;
+    int               m_count = 0;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_PERCEPTUAL_HASH_H
@@ -0,0 +1,706 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Columnar store of item attributes used to filter and sort
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "itemattributesstore.h"
+
+// C++ includes
+
+#include <algorithm>
+#include <limits>
+
+// Qt includes
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QSharedData>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "digikam_globals.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "iteminfo.h"
+#include "iteminfodata.h"
+#include "tagscache.h"
+
+namespace Digikam
+{
+
+/**
+ * Ids above this value are not stored, their values are read from the ItemInfo.
+ * This bounds the size of the id-indexed arrays.
+ */
+static const qlonglong maxStoredId = (1 << 24);
+
+class Q_DECL_HIDDEN ItemAttributesSnapshot::Private : public QSharedData
+{
+public:
+
+    explicit Private()
+      : unusedTags(0)
+    {
+    }
+
+    bool isStored(qlonglong id) const
+    {
+        return ((id > 0) && (id < loaded.size()) && loaded.at(id));
+    }
+
+    bool isCurrent(qlonglong id) const
+    {
+        return (isStored(id) && (changed.isEmpty() || !changed.contains(id)));
+    }
+
+    void resize(qlonglong maxId)
+    {
+        const int size = (int)(maxId + 1);
+
+        if (size <= loaded.size())
+        {
+            return;
+        }
+
+        loaded.resize(size);
+        rating.resize(size);
+        pickLabel.resize(size);
+        colorLabel.resize(size);
+        creationDay.resize(size);
+        creationDate.resize(size);
+        modificationDate.resize(size);
+        fileSize.resize(size);
+        tagOffset.resize(size);
+        tagCount.resize(size);
+    }
+
+    /**
+     * Set the values from CoreDB::getItemsAttributes() or CoreDB::getAllItemsAttributes().
+     */
+    void setAttributes(qlonglong id, const QVariant& modDate, const QVariant& size,
+                       const QVariant& rate, const QVariant& creation)
+    {
+        const QDateTime creationDateTime = creation.toDateTime();
+        const QDate     day              = creationDateTime.date();
+
+        loaded[id]           = true;
+        rating[id]           = (qint8)(rate.isNull() ? -1 : rate.toInt());
+        creationDate[id]     = dateTimeToKey(creationDateTime);
+        creationDay[id]      = day.isValid() ? (qint32)day.toJulianDay() : 0;
+        modificationDate[id] = dateTimeToKey(modDate.toDateTime());
+        fileSize[id]         = size.toLongLong();
+    }
+
+    /**
+     * Append the sorted tags span of an item. The previous span becomes unused.
+     */
+    void setTags(qlonglong id, QList<int> ids)
+    {
+        std::sort(ids.begin(), ids.end());
+
+        unusedTags   += tagCount.at(id);
+        tagOffset[id] = tags.size();
+        tagCount[id]  = ids.size();
+
+        Q_FOREACH (int tagId, ids)
+        {
+            tags << tagId;
+        }
+    }
+
+    void setLabels(qlonglong id, const QVector<int>& pickTags, const QVector<int>& colorTags)
+    {
+        pickLabel[id]  = NoPickLabel;
+        colorLabel[id] = NoColorLabel;
+
+        const int* const begin = tags.constData() + tagOffset.at(id);
+        const int* const end   = begin + tagCount.at(id);
+
+        for (const int* it = begin ; it != end ; ++it)
+        {
+            const int pick  = pickTags.indexOf(*it);
+            const int color = colorTags.indexOf(*it);
+
+            if ((pick >= FirstPickLabel) && (pick <= LastPickLabel) && (pickLabel.at(id) == NoPickLabel))
+            {
+                pickLabel[id] = (qint8)pick;
+            }
+
+            if ((color >= FirstColorLabel) && (color <= LastColorLabel) && (colorLabel.at(id) == NoColorLabel))
+            {
+                colorLabel[id] = (qint8)color;
+            }
+        }
+    }
+
+    /**
+     * Rewrite the tags array when more than half of it is made of unused spans.
+     */
+    void compactTags()
+    {
+        if (unusedTags < (tags.size() / 2))
+        {
+            return;
+        }
+
+        QVector<int> compacted;
+        compacted.reserve(tags.size() - unusedTags);
+
+        for (int id = 0 ; id < loaded.size() ; ++id)
+        {
+            const int offset = tagOffset.at(id);
+            tagOffset[id]    = compacted.size();
+
+            for (int i = 0 ; i < tagCount.at(id) ; ++i)
+            {
+                compacted << tags.at(offset + i);
+            }
+        }
+
+        tags       = compacted;
+        unusedTags = 0;
+    }
+
+public:
+
+    QVector<bool>    loaded;
+    QVector<qint8>   rating;
+    QVector<qint8>   pickLabel;
+    QVector<qint8>   colorLabel;
+    QVector<qint32>  creationDay;
+    QVector<qint64>  creationDate;
+    QVector<qint64>  modificationDate;
+    QVector<qint64>  fileSize;
+
+    /// The tags of an item are tags[tagOffset[id]] to tags[tagOffset[id] + tagCount[id] - 1].
+    QVector<int>     tagOffset;
+    QVector<int>     tagCount;
+    QVector<int>     tags;
+    int              unusedTags;
+
+    /// Items which changed since their values were loaded.
+    QSet<qlonglong>  changed;
+};
+
+// ------------------------------------------------------------------------------------------------
+
+ItemAttributesSnapshot::Tags::Tags()
+    : m_begin(nullptr),
+      m_count(0)
+{
+}
+
+bool ItemAttributesSnapshot::Tags::contains(int tagId) const
+{
+    return std::binary_search(begin(), end(), tagId);
+}
+
+bool ItemAttributesSnapshot::Tags::isEmpty() const
+{
+    return (count() == 0);
+}
+
+int ItemAttributesSnapshot::Tags::count() const
+{
+    return (m_begin ? m_count : m_owned.size());
+}
+
+QList<int> ItemAttributesSnapshot::Tags::toList() const
+{
+    QList<int> list;
+    list.reserve(count());
+
+    for (const int* it = begin() ; it != end() ; ++it)
+    {
+        list << *it;
+    }
+
+    return list;
+}
+
+const int* ItemAttributesSnapshot::Tags::begin() const
+{
+    return (m_begin ? m_begin : m_owned.constData());
+}
+
+const int* ItemAttributesSnapshot::Tags::end() const
+{
+    return (begin() + count());
+}
+
+// ------------------------------------------------------------------------------------------------
+
+ItemAttributesSnapshot::ItemAttributesSnapshot()
+{
+}
+
+ItemAttributesSnapshot::ItemAttributesSnapshot(const ItemAttributesSnapshot& other)
+    : d(other.d)
+{
+}
+
+ItemAttributesSnapshot::~ItemAttributesSnapshot()
+{
+}
+
+ItemAttributesSnapshot& ItemAttributesSnapshot::operator=(const ItemAttributesSnapshot& other)
+{
+    d = other.d;
+
+    return *this;
+}
+
+bool ItemAttributesSnapshot::isNull() const
+{
+    return !d;
+}
+
+bool ItemAttributesSnapshot::contains(qlonglong id) const
+{
+    return (d && d->isCurrent(id));
+}
+
+int ItemAttributesSnapshot::rating(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        return d->rating.at(id);
+    }
+
+    return info.rating();
+}
+
+int ItemAttributesSnapshot::pickLabel(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        return d->pickLabel.at(id);
+    }
+
+    return info.pickLabel();
+}
+
+int ItemAttributesSnapshot::colorLabel(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        return d->colorLabel.at(id);
+    }
+
+    return info.colorLabel();
+}
+
+ItemAttributesSnapshot::Tags ItemAttributesSnapshot::tagIds(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+    Tags            tags;
+
+    if (contains(id))
+    {
+        tags.m_count = d->tagCount.at(id);
+
+        if (tags.m_count)
+        {
+            tags.m_begin = d->tags.constData() + d->tagOffset.at(id);
+        }
+
+        return tags;
+    }
+
+    const QList<int> ids = info.tagIds();
+    tags.m_owned.reserve(ids.size());
+
+    Q_FOREACH (int tagId, ids)
+    {
+        tags.m_owned << tagId;
+    }
+
+    std::sort(tags.m_owned.begin(), tags.m_owned.end());
+
+    return tags;
+}
+
+qint64 ItemAttributesSnapshot::creationDate(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        return d->creationDate.at(id);
+    }
+
+    return dateTimeToKey(info.dateTime());
+}
+
+qint64 ItemAttributesSnapshot::modificationDate(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        return d->modificationDate.at(id);
+    }
+
+    return dateTimeToKey(info.modDateTime());
+}
+
+QDate ItemAttributesSnapshot::creationDay(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        const qint32 day = d->creationDay.at(id);
+
+        return (day ? QDate::fromJulianDay(day) : QDate());
+    }
+
+    return info.dateTime().date();
+}
+
+qlonglong ItemAttributesSnapshot::fileSize(const ItemInfo& info) const
+{
+    const qlonglong id = info.id();
+
+    if (contains(id))
+    {
+        return d->fileSize.at(id);
+    }
+
+    return info.fileSize();
+}
+
+qint64 ItemAttributesSnapshot::dateTimeToKey(const QDateTime& dateTime)
+{
+    if (!dateTime.isValid())
+    {
+        return std::numeric_limits<qint64>::min();
+    }
+
+    return dateTime.toMSecsSinceEpoch();
+}
+
+// ------------------------------------------------------------------------------------------------
+
+ItemAttributesStore::ItemAttributesStore()
+    : m_loading   (false),
+      m_generation(0)
+{
+    CoreDbWatch* const dbwatch = CoreDbAccess::databaseWatch();
+
+    connect(dbwatch, SIGNAL(imageChange(ImageChangeset)),
+            this, SLOT(slotImageChanged(ImageChangeset)),
+            Qt::DirectConnection);
+
+    connect(dbwatch, SIGNAL(imageTagChange(ImageTagChangeset)),
+            this, SLOT(slotImageTagChanged(ImageTagChangeset)),
+            Qt::DirectConnection);
+
+    connect(dbwatch, SIGNAL(collectionImageChange(CollectionImageChangeset)),
+            this, SLOT(slotCollectionImageChanged(CollectionImageChangeset)),
+            Qt::DirectConnection);
+}
+
+ItemAttributesStore::~ItemAttributesStore()
+{
+}
+
+ItemAttributesStore* ItemAttributesStore::instance()
+{
+    return ItemInfoStatic::attributesStore();
+}
+
+ItemAttributesSnapshot ItemAttributesStore::snapshot() const
+{
+    QMutexLocker lock(&m_mutex);
+
+    return m_current;
+}
+
+ItemAttributesSnapshot ItemAttributesStore::snapshot(const QList<qlonglong>& ids)
+{
+    ItemAttributesSnapshot current = snapshot();
+    QList<qlonglong>       missing;
+
+    if (!current.isNull())
+    {
+        Q_FOREACH (const qlonglong& id, ids)
+        {
+            if (!current.contains(id) && (id > 0) && (id < maxStoredId))
+            {
+                missing << id;
+            }
+        }
+
+        if (missing.isEmpty())
+        {
+            return current;
+        }
+    }
+
+    // Only one thread loads from the database, the others wait and use its result.
+
+    QMutexLocker loadLock(&m_loadMutex);
+
+    current = snapshot();
+
+    if (!current.isNull())
+    {
+        QList<qlonglong> stillMissing;
+
+        Q_FOREACH (const qlonglong& id, missing)
+        {
+            if (!current.contains(id))
+            {
+                stillMissing << id;
+            }
+        }
+
+        if (stillMissing.isEmpty())
+        {
+            return current;
+        }
+
+        missing = stillMissing;
+    }
+
+    int generation;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_loading    = true;
+        generation   = m_generation;
+        m_changedWhileLoading.clear();
+    }
+
+    const bool            fullLoad = current.isNull();
+    QVariantList          allValues;
+    QVariantList          allTags;
+    QVector<QVariantList> values;
+    QVector<QList<int> >  tags;
+
+    if (fullLoad)
+    {
+        CoreDbAccess access;
+        allValues = access.db()->getAllItemsAttributes();
+        allTags   = access.db()->getAllItemsTagIDs();
+    }
+    else
+    {
+        CoreDbAccess access;
+        values = access.db()->getItemsAttributes(missing);
+        tags   = access.db()->getItemsTagIDs(missing);
+    }
+
+    const QVector<int> pickTags  = TagsCache::instance()->pickLabelTags();
+    const QVector<int> colorTags = TagsCache::instance()->colorLabelTags();
+
+    QMutexLocker lock(&m_mutex);
+    m_loading = false;
+
+    if (generation != m_generation)
+    {
+        // The database changed while loading.
+
+        return m_current;
+    }
+
+    ItemAttributesSnapshot updated;
+
+    if (fullLoad)
+    {
+        updated.d          = new ItemAttributesSnapshot::Private;
+        qlonglong maxId    = 0;
+
+        for (int i = 0 ; (i + 4) < allValues.size() ; i += 5)
+        {
+            maxId = qMax(maxId, allValues.at(i).toLongLong());
+        }
+
+        updated.d->resize(qMin(maxId, maxStoredId - 1));
+
+        for (int i = 0 ; (i + 4) < allValues.size() ; i += 5)
+        {
+            const qlonglong id = allValues.at(i).toLongLong();
+
+            if ((id > 0) && (id < maxStoredId))
+            {
+                updated.d->setAttributes(id, allValues.at(i + 1), allValues.at(i + 2),
+                                         allValues.at(i + 3), allValues.at(i + 4));
+            }
+        }
+
+        // The pairs come sorted by image id and tag id: each item gets one contiguous span.
+
+        ItemAttributesSnapshot::Private* const data = updated.d.data();
+        data->tags.reserve(allTags.size() / 2);
+
+        for (int i = 0 ; (i + 1) < allTags.size() ; i += 2)
+        {
+            const qlonglong id = allTags.at(i).toLongLong();
+
+            if (!data->isStored(id))
+            {
+                continue;
+            }
+
+            if (data->tagCount.at(id) == 0)
+            {
+                data->tagOffset[id] = data->tags.size();
+            }
+
+            data->tags << allTags.at(i + 1).toInt();
+            ++data->tagCount[id];
+        }
+
+        for (int id = 1 ; id < data->loaded.size() ; ++id)
+        {
+            if (data->loaded.at(id))
+            {
+                data->setLabels(id, pickTags, colorTags);
+            }
+        }
+
+        qCDebug(DIGIKAM_DATABASE_LOG) << "Item attributes store loaded with" << allValues.size() / 5 << "items";
+    }
+    else
+    {
+        updated = m_current;
+
+        if (updated.isNull())
+        {
+            updated.d = new ItemAttributesSnapshot::Private;
+        }
+
+        ItemAttributesSnapshot::Private* const data = updated.d.data();
+
+        for (int i = 0 ; i < missing.size() ; ++i)
+        {
+            const qlonglong id = missing.at(i);
+
+            if (values.at(i).isEmpty())
+            {
+                continue;
+            }
+
+            data->resize(id);
+            data->setAttributes(id, values.at(i).at(0), values.at(i).at(1),
+                                values.at(i).at(2), values.at(i).at(3));
+            data->setTags(id, tags.at(i));
+            data->setLabels(id, pickTags, colorTags);
+            data->changed.remove(id);
+        }
+
+        data->compactTags();
+    }
+
+    // The values of the items which changed while loading may be outdated.
+
+    Q_FOREACH (const qlonglong& id, m_changedWhileLoading)
+    {
+        if (updated.d->isStored(id))
+        {
+            updated.d->changed.insert(id);
+        }
+    }
+
+    m_changedWhileLoading.clear();
+    m_current = updated;
+
+    return updated;
+}
+
+void ItemAttributesStore::invalidate()
+{
+    QMutexLocker lock(&m_mutex);
+
+    m_current = ItemAttributesSnapshot();
+    ++m_generation;
+}
+
+void ItemAttributesStore::markChanged(const QList<qlonglong>& ids)
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (m_loading)
+    {
+        Q_FOREACH (const qlonglong& id, ids)
+        {
+            m_changedWhileLoading.insert(id);
+        }
+    }
+
+    if (m_current.isNull())
+    {
+        return;
+    }
+
+    QList<qlonglong> stored;
+
+    Q_FOREACH (const qlonglong& id, ids)
+    {
+        if (m_current.contains(id))
+        {
+            stored << id;
+        }
+    }
+
+    if (stored.isEmpty())
+    {
+        return;
+    }
+
+    // Detaching copies the private data, but the arrays are implicitly shared:
+    // only the set of changed items is really copied.
+
+    Q_FOREACH (const qlonglong& id, stored)
+    {
+        m_current.d->changed.insert(id);
+    }
+}
+
+void ItemAttributesStore::slotImageChanged(const ImageChangeset& changeset)
+{
+    DatabaseFields::Set changes = changeset.changes();
+
+    if ((changes & DatabaseFields::Rating)           ||
+        (changes & DatabaseFields::CreationDate)     ||
+        (changes & DatabaseFields::ModificationDate) ||
+        (changes & DatabaseFields::FileSize))
+    {
+        markChanged(changeset.ids());
+    }
+}
+
+void ItemAttributesStore::slotImageTagChanged(const ImageTagChangeset& changeset)
+{
+    if (changeset.propertiesWereChanged())
+    {
+        return;
+    }
+
+    markChanged(changeset.ids());
+}
+
+void ItemAttributesStore::slotCollectionImageChanged(const CollectionImageChangeset& changeset)
+{
+    markChanged(changeset.ids());
+}
+
+} // namespace Digikam
@@ -0,0 +1,185 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Columnar store of item attributes used to filter and sort
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ITEM_ATTRIBUTES_STORE_H
+#define DIGIKAM_ITEM_ATTRIBUTES_STORE_H
+
+// Qt includes
+
+#include <QDate>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QSharedDataPointer>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "coredbwatch.h"
+
+namespace Digikam
+{
+
+class ItemInfo;
+
+/**
+ * An immutable snapshot of the attributes which are read over and over while filtering
+ * and sorting items: rating, pick and color labels, dates, file size and tag ids.
+ *
+ * Values are stored in arrays indexed by image id, and the tag ids of an item are a sorted
+ * span of one shared array. A snapshot is implicitly shared and never changes once created,
+ * so it can be read from any thread without locking.
+ *
+ * All accessors take an ItemInfo: if the item is not part of the snapshot, or has changed
+ * since the snapshot was taken, the value is read from the ItemInfo instead.
+ */
+class DIGIKAM_DATABASE_EXPORT ItemAttributesSnapshot
+{
+public:
+
+    /**
+     * The sorted tag ids of an item. Either a view in the snapshot, or an own copy
+     * of the tag ids read from the ItemInfo.
+     */
+    class DIGIKAM_DATABASE_EXPORT Tags
+    {
+    public:
+
+        Tags();
+
+        bool       contains(int tagId) const;
+        bool       isEmpty()           const;
+        int        count()             const;
+        QList<int> toList()            const;
+
+        const int* begin()             const;
+        const int* end()               const;
+
+    private:
+
+        const int*   m_begin;
+        int          m_count;
+        QVector<int> m_owned;
+
+        friend class ItemAttributesSnapshot;
+    };
+
+public:
+
+    /**
+     * Creates a null snapshot: all values are read from the ItemInfo.
+     */
+    ItemAttributesSnapshot();
+    ItemAttributesSnapshot(const ItemAttributesSnapshot& other);
+    ~ItemAttributesSnapshot();
+
+    ItemAttributesSnapshot& operator=(const ItemAttributesSnapshot& other);
+
+    bool isNull()                          const;
+
+    /**
+     * Returns true if the current values of the item are part of the snapshot.
+     */
+    bool contains(qlonglong id)            const;
+
+    int  rating(const ItemInfo& info)      const;
+    int  pickLabel(const ItemInfo& info)   const;
+    int  colorLabel(const ItemInfo& info)  const;
+    Tags tagIds(const ItemInfo& info)      const;
+
+    /**
+     * The dates are returned as milliseconds since epoch, to be compared quickly.
+     * Invalid dates are returned as the lowest value.
+     */
+    qint64 creationDate(const ItemInfo& info)     const;
+    qint64 modificationDate(const ItemInfo& info) const;
+    QDate  creationDay(const ItemInfo& info)      const;
+
+    qlonglong fileSize(const ItemInfo& info)      const;
+
+    static qint64 dateTimeToKey(const QDateTime& dateTime);
+
+private:
+
+    class Private;
+    QSharedDataPointer<Private> d;
+
+    friend class ItemAttributesStore;
+};
+
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * The application wide store of ItemAttributesSnapshot.
+ * The first request loads the visible items of the collection at once, then the store is kept
+ * up to date from the CoreDbWatch changesets: changed items are marked as such in a new
+ * snapshot, and are reloaded on the next request which needs them.
+ */
+class DIGIKAM_DATABASE_EXPORT ItemAttributesStore : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    static ItemAttributesStore* instance();
+
+    /**
+     * Returns the current snapshot, without any database access.
+     */
+    ItemAttributesSnapshot snapshot()                           const;
+
+    /**
+     * Returns a snapshot containing the given items, loading them from the database if needed.
+     * Call this from a thread which can wait for the database.
+     */
+    ItemAttributesSnapshot snapshot(const QList<qlonglong>& ids);
+
+    /**
+     * Drops all loaded values. Call when the database changed.
+     */
+    void invalidate();
+
+private Q_SLOTS:
+
+    void slotImageChanged(const ImageChangeset& changeset);
+    void slotImageTagChanged(const ImageTagChangeset& changeset);
+    void slotCollectionImageChanged(const CollectionImageChangeset& changeset);
+
+private:
+
+    ItemAttributesStore();
+    ~ItemAttributesStore() override;
+
+    // Disable
+    explicit ItemAttributesStore(QObject*) = delete;
+
+    void markChanged(const QList<qlonglong>& ids);
+
+private:
+
+    ItemAttributesSnapshot m_current;
+    mutable QMutex         m_mutex;
+    QMutex                 m_loadMutex;
+    bool                   m_loading;
+    int                    m_generation;
+    QSet<qlonglong>        m_changedWhileLoading;
+
+    friend class ItemInfoStatic;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_ITEM_ATTRIBUTES_STORE_H
@@ -303,6 +303,12 @@ public:
     DatabaseFieldsHashRaw getDatabaseFieldsRaw(const DatabaseFields::Set& requestedSet) const;
     QVariant getDatabaseFieldRaw(const DatabaseFields::Set& requestedField)             const;
 
+    /**
+     * Returns true if getDatabaseFieldsRaw() can return the requested fields
+     * without reading the database.
+     */
+    bool hasDatabaseFieldsRaw(const DatabaseFields::Set& requestedSet)                 const;
+
     //@}
 
 public:
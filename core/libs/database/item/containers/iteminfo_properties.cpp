@@ -571,4 +571,122 @@ QVariant ItemInfo::getDatabaseFieldRaw(const DatabaseFields::Set& requestedField
     return QVariant();
 }
 
+bool ItemInfo::hasDatabaseFieldsRaw(const DatabaseFields::Set& requestedSet) const
+{
+    if (!m_data)
+    {
+        return true;
+    }
+
+    ItemInfoReadLocker lock;
+
+    if (m_data->hasVideoMetadata && (requestedSet.getVideoMetadata() & ~m_data->videoMetadataCached))
+    {
+        return false;
+    }
+
+    if (m_data->hasImageMetadata && (requestedSet.getImageMetadata() & ~m_data->imageMetadataCached))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void ItemInfoList::loadDatabaseFieldsRaw(const DatabaseFields::Set& requestedSet) const
+{
+    const DatabaseFields::ImageMetadata requestedImageMetadata = requestedSet.getImageMetadata();
+    const DatabaseFields::VideoMetadata requestedVideoMetadata = requestedSet.getVideoMetadata();
+    ItemInfoList imageInfoList;
+    ItemInfoList videoInfoList;
+
+    {
+        ItemInfoReadLocker lock;
+
+        Q_FOREACH (const ItemInfo& info, *this)
+        {
+            if (!info.m_data)
+            {
+                continue;
+            }
+
+            if (requestedImageMetadata && info.m_data->hasImageMetadata &&
+                (requestedImageMetadata & ~info.m_data->imageMetadataCached))
+            {
+                imageInfoList << info;
+            }
+
+            if (requestedVideoMetadata && info.m_data->hasVideoMetadata &&
+                (requestedVideoMetadata & ~info.m_data->videoMetadataCached))
+            {
+                videoInfoList << info;
+            }
+        }
+    }
+
+    if (!imageInfoList.isEmpty())
+    {
+        const QHash<qlonglong, QVariantList> allFieldValues = CoreDbAccess().db()->getImagesMetadata(imageInfoList.toImageIdList(),
+                                                                                                     requestedImageMetadata);
+
+        ItemInfoWriteLocker lock;
+
+        Q_FOREACH (const ItemInfo& info, imageInfoList)
+        {
+            QHash<qlonglong, QVariantList>::const_iterator values = allFieldValues.constFind(info.m_data->id);
+
+            if (values == allFieldValues.constEnd())
+            {
+                info.m_data.data()->hasImageMetadata    = false;
+                info.m_data.data()->databaseFieldsHashRaw.removeAllFields(DatabaseFields::ImageMetadataAll);
+                info.m_data.data()->imageMetadataCached = DatabaseFields::ImageMetadataNone;
+
+                continue;
+            }
+
+            int fieldsIndex = 0;
+
+            for (DatabaseFields::ImageMetadataIteratorSetOnly it(requestedImageMetadata) ; !it.atEnd() ; ++it)
+            {
+                info.m_data.data()->databaseFieldsHashRaw.insertField(*it, values->value(fieldsIndex));
+                ++fieldsIndex;
+            }
+
+            info.m_data.data()->imageMetadataCached |= requestedImageMetadata;
+        }
+    }
+
+    if (!videoInfoList.isEmpty())
+    {
+        const QHash<qlonglong, QVariantList> allFieldValues = CoreDbAccess().db()->getVideosMetadata(videoInfoList.toImageIdList(),
+                                                                                                     requestedVideoMetadata);
+
+        ItemInfoWriteLocker lock;
+
+        Q_FOREACH (const ItemInfo& info, videoInfoList)
+        {
+            QHash<qlonglong, QVariantList>::const_iterator values = allFieldValues.constFind(info.m_data->id);
+
+            if (values == allFieldValues.constEnd())
+            {
+                info.m_data.data()->hasVideoMetadata    = false;
+                info.m_data.data()->databaseFieldsHashRaw.removeAllFields(DatabaseFields::VideoMetadataAll);
+                info.m_data.data()->videoMetadataCached = DatabaseFields::VideoMetadataNone;
+
+                continue;
+            }
+
+            int fieldsIndex = 0;
+
+            for (DatabaseFields::VideoMetadataIteratorSetOnly it(requestedVideoMetadata) ; !it.atEnd() ; ++it)
+            {
+                info.m_data.data()->databaseFieldsHashRaw.insertField(*it, values->value(fieldsIndex));
+                ++fieldsIndex;
+            }
+
+            info.m_data.data()->videoMetadataCached |= requestedVideoMetadata;
+        }
+    }
+}
+
 } // namespace Digikam
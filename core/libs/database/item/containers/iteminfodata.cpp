@@ -48,6 +48,11 @@ ItemInfoCache* ItemInfoStatic::cache()
     return &m_instance->m_cache;
 }
 
+ItemAttributesStore* ItemInfoStatic::attributesStore()
+{
+    return &m_instance->m_attributesStore;
+}
+
 // ---------------------------------------------------------------
 
 ItemInfoData::ItemInfoData()
@@ -32,6 +32,7 @@
 #include "coredburl.h"
 #include "coredbalbuminfo.h"
 #include "iteminfocache.h"
+#include "itemattributesstore.h"
 
 namespace Digikam
 {
@@ -43,11 +44,13 @@ public:
     static void create();
     static void destroy();
 
-    static ItemInfoCache* cache();
+    static ItemInfoCache*       cache();
+    static ItemAttributesStore* attributesStore();
 
 public:
 
     ItemInfoCache          m_cache;
+    ItemAttributesStore    m_attributesStore;
     QReadWriteLock         m_lock;
 
     static ItemInfoStatic* m_instance;
@@ -48,6 +48,12 @@ public:
     void loadGroupImageIds()          const;
     void loadTagIds()                 const;
 
+    /**
+     * Loads the requested image and video metadata fields of all items which
+     * do not have them cached, with one query per table and 500 items.
+     */
+    void loadDatabaseFieldsRaw(const DatabaseFields::Set& requestedSet) const;
+
     bool static namefileLessThan(const ItemInfo& d1, const ItemInfo& d2);
 
     /**
@@ -183,6 +183,62 @@ void FieldQueryBuilder::addStringField(const QString& name)
     *boundValues << prepareForLike(reader.value());
 }
 
+bool FieldQueryBuilder::useTextSearchIndex() const
+{
+    // Patterns shorter than a trigram are not indexed, and the index
+    // does not handle the escape character used with SQLite.
+
+    return (((relation == SearchXml::Like) || (relation == SearchXml::NotLike)) &&
+            (reader.value().length() >= 3)                                    &&
+            !reader.value().contains(QLatin1Char('\\'))                       &&
+            CoreDbAccess().db()->hasTextSearchIndex());
+}
+
+void FieldQueryBuilder::addFileNameField()
+{
+    if (useTextSearchIndex())
+    {
+        sql += (relation == SearchXml::Like) ? QLatin1String(" (Images.id IN ")
+                                             : QLatin1String(" (Images.id NOT IN ");
+        sql += QLatin1String("(SELECT rowid FROM ImagesTextIndex WHERE name LIKE ?)) ");
+        *boundValues << prepareForLike(reader.value());
+
+        return;
+    }
+
+    if (CoreDbAccess::parameters().isSQLite())
+    {
+        addStringField(QLatin1String("Images.name"));
+    }
+    else
+    {
+        addStringField(QLatin1String("Images.name COLLATE utf8_general_ci"));
+    }
+}
+
+void FieldQueryBuilder::addCommentField(int type)
+{
+    sql += QString::fromUtf8(" (Images.id IN "
+           " (SELECT imageid FROM ImageComments "
+           "  WHERE type=? AND ");
+
+    // A comment not containing the text can be in an image with other comments
+    // containing it: only the positive searches use the index.
+
+    if ((relation == SearchXml::Like) && useTextSearchIndex())
+    {
+        sql += QString::fromUtf8("id IN (SELECT rowid FROM CommentsTextIndex WHERE comment LIKE ?))) ");
+    }
+    else
+    {
+        sql += QString::fromUtf8("comment ");
+        ItemQueryBuilder::addSqlRelation(sql, relation);
+        sql += QString::fromUtf8(" ?)) ");
+    }
+
+    *boundValues << type << prepareForLike(reader.value());
+}
+
 void FieldQueryBuilder::addDateField(const QString& name)
 {
     if (relation == SearchXml::Equal)
@@ -56,6 +56,19 @@ public:
     void addLongField(const QString& name);
     void addDoubleField(const QString& name);
     void addStringField(const QString& name);
+
+    /**
+     * Adds a condition on the file name or on the comments of a type.
+     * The searches of a part of the text use the text search index if the
+     * database has one.
+     */
+    void addFileNameField();
+    void addCommentField(int type);
+
+    /**
+     * Returns true if the condition can be checked with the text search index.
+     */
+    bool useTextSearchIndex()                                               const;
     void addDateField(const QString& name);
     void addChoiceIntField(const QString& name);
     void addLongListField(const QString& name);
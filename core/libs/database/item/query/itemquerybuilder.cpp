@@ -381,14 +381,7 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
     }
     else if (name == QLatin1String("filename"))
     {
-        if (CoreDbAccess::parameters().isSQLite())
-        {
-            fieldQuery.addStringField(QLatin1String("Images.name"));
-        }
-        else
-        {
-            fieldQuery.addStringField(QLatin1String("Images.name COLLATE utf8_general_ci"));
-        }
+        fieldQuery.addFileNameField();
     }
     else if (name == QLatin1String("modificationdate"))
     {
@@ -856,12 +849,7 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
     }
     else if (name == QLatin1String("comment"))
     {
-        sql += QString::fromUtf8(" (Images.id IN "
-               " (SELECT imageid FROM ImageComments "
-               "  WHERE type=? AND comment ");
-        ItemQueryBuilder::addSqlRelation(sql, relation);
-        sql += QString::fromUtf8(" ?)) ");
-        *boundValues << DatabaseComment::Comment << fieldQuery.prepareForLike(reader.value());
+        fieldQuery.addCommentField(DatabaseComment::Comment);
     }
     else if (name == QLatin1String("commentauthor"))
     {
@@ -874,21 +862,11 @@ bool ItemQueryBuilder::buildField(QString& sql, SearchXmlCachingReader& reader,
     }
     else if (name == QLatin1String("headline"))
     {
-        sql += QString::fromUtf8(" (Images.id IN "
-               " (SELECT imageid FROM ImageComments "
-               "  WHERE type=? AND comment ");
-        ItemQueryBuilder::addSqlRelation(sql, relation);
-        sql += QString::fromUtf8(" ?)) ");
-        *boundValues << DatabaseComment::Headline << fieldQuery.prepareForLike(reader.value());
+        fieldQuery.addCommentField(DatabaseComment::Headline);
     }
     else if (name == QLatin1String("title"))
     {
-        sql += QString::fromUtf8(" (Images.id IN "
-               " (SELECT imageid FROM ImageComments "
-               "  WHERE type=? AND comment ");
-        ItemQueryBuilder::addSqlRelation(sql, relation);
-        sql += QString::fromUtf8(" ?)) ");
-        *boundValues << DatabaseComment::Title << fieldQuery.prepareForLike(reader.value());
+        fieldQuery.addCommentField(DatabaseComment::Title);
     }
     else if (name == QLatin1String("emptytext"))
     {
@@ -787,7 +787,20 @@ void ItemFilterModelPreparer::process(ItemFilterModelTodoPackage package)
 
     if (needPrepareTags)
     {
-        infoList.loadTagIds();
+        // The tags of the items in the attributes store are read from there when filtering.
+
+        const ItemAttributesSnapshot attributes = ItemAttributesStore::instance()->snapshot(infoList.toImageIdList());
+        ItemInfoList                 uncached;
+
+        Q_FOREACH (const ItemInfo& info, infoList)
+        {
+            if (!attributes.contains(info.id()))
+            {
+                uncached << info;
+            }
+        }
+
+        uncached.loadTagIds();
     }
 
     if (needPrepareGroups)
@@ -828,14 +841,24 @@ void ItemFilterModelFilterer::process(ItemFilterModelTodoPackage package)
         hasOneMatchForText = d->hasOneMatchForText;
     }
 
+    QList<qlonglong> ids;
+    ids.reserve(package.infos.size());
+
+    Q_FOREACH (const ItemInfo& info, package.infos)
+    {
+        ids << info.id();
+    }
+
+    const ItemAttributesSnapshot attributes = ItemAttributesStore::instance()->snapshot(ids);
+
     // Actual filtering. The variants to spare checking hasOneMatch over and over again.
 
     if      (hasOneMatch && hasOneMatchForText)
     {
         Q_FOREACH (const ItemInfo& info, package.infos)
         {
-            package.filterResults[info.id()] = (localFilter.matches(info)        &&
-                                                localVersionFilter.matches(info) &&
+            package.filterResults[info.id()] = (localFilter.matches(info, attributes)        &&
+                                                localVersionFilter.matches(info, attributes) &&
                                                 localGroupFilter.matches(info));
         }
     }
@@ -845,8 +868,8 @@ void ItemFilterModelFilterer::process(ItemFilterModelTodoPackage package)
 
         Q_FOREACH (const ItemInfo& info, package.infos)
         {
-            package.filterResults[info.id()] = (localFilter.matches(info, &matchForText) &&
-                                                localVersionFilter.matches(info)         &&
+            package.filterResults[info.id()] = (localFilter.matches(info, attributes, &matchForText) &&
+                                                localVersionFilter.matches(info, attributes)         &&
                                                 localGroupFilter.matches(info));
 
             if (matchForText)
@@ -861,8 +884,8 @@ void ItemFilterModelFilterer::process(ItemFilterModelTodoPackage package)
 
         Q_FOREACH (const ItemInfo& info, package.infos)
         {
-            result                           = (localFilter.matches(info, &matchForText) &&
-                                                localVersionFilter.matches(info)         &&
+            result                           = (localFilter.matches(info, attributes, &matchForText) &&
+                                                localVersionFilter.matches(info, attributes)         &&
                                                 localGroupFilter.matches(info));
 
             package.filterResults[info.id()] = result;
@@ -894,7 +917,8 @@ void ItemFilterModelFilterer::process(ItemFilterModelTodoPackage package)
 void ItemFilterModel::setItemSortSettings(const ItemSortSettings& sorter)
 {
     Q_D(ItemFilterModel);
-    d->sorter = sorter;
+    d->sorter     = sorter;
+    d->attributes = ItemAttributesStore::instance()->snapshot();
     setCategorizedModel(d->sorter.categorizationMode != ItemSortSettings::NoCategories);
     invalidate();
 }
@@ -1167,7 +1191,7 @@ bool ItemFilterModel::infosLessThan(const ItemInfo& left, const ItemInfo& right)
 {
     Q_D(const ItemFilterModel);
 
-    return d->sorter.lessThan(left, right);
+    return d->sorter.lessThan(left, right, d->attributes);
 }
 
 // -------------- Watching changes -----------------------------------------------------------------
@@ -1267,6 +1291,7 @@ void ItemFilterModel::slotImageChange(const ImageChangeset& changeset)
     }
     else
     {
+        d->attributes = ItemAttributesStore::instance()->snapshot();
         invalidate();    // just resort, reuse filter results
     }
 }
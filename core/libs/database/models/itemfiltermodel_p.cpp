@@ -193,6 +193,10 @@ void ItemFilterModel::ItemFilterModelPrivate::packageFinished(const ItemFilterMo
         return;
     }
 
+    // Sort with the values loaded by the filter threads.
+
+    attributes = ItemAttributesStore::instance()->snapshot();
+
     // incorporate result
 
     QHash<qlonglong, bool>::const_iterator it = package.filterResults.constBegin();
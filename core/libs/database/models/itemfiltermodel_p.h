@@ -28,6 +28,7 @@
 // Local includes
 
 #include "iteminfo.h"
+#include "itemattributesstore.h"
 #include "itemfiltermodel.h"
 #include "digikam_export.h"
 
@@ -125,6 +126,9 @@ public:
 
     QList<ItemFilterModelPrepareHook*> prepareHooks;
 
+    /// Used by the sorting, in the main thread.
+    ItemAttributesSnapshot             attributes;
+
 /*
     QHash<int, QSet<qlonglong> >       categoryCountHashInt;
     QHash<QString, QSet<qlonglong> >   categoryCountHashString;
@@ -295,6 +295,12 @@ bool containsNoneOfExcept(const ContainerA& list, const ContainerB& noneOfList,
 }
 
 bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) const
+{
+    return matches(info, ItemAttributesSnapshot(), foundText);
+}
+
+bool ItemFilterSettings::matches(const ItemInfo& info, const ItemAttributesSnapshot& attributes,
+                                 bool* const foundText) const
 {
     if (foundText)
     {
@@ -310,8 +316,8 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
 
     if (!m_includeTagFilter.isEmpty() || !m_excludeTagFilter.isEmpty())
     {
-        QList<int>                 tagIds = info.tagIds();
-        QList<int>::const_iterator it;
+        const ItemAttributesSnapshot::Tags tagIds = attributes.tagIds(info);
+        QList<int>::const_iterator         it;
 
         match = m_includeTagFilter.isEmpty();
 
@@ -359,7 +365,7 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
     }
     else if (m_untaggedFilter)
     {
-        match = !TagsCache::instance()->containsPublicTags(info.tagIds());
+        match = !TagsCache::instance()->containsPublicTags(attributes.tagIds(info).toList());
     }
     else
     {
@@ -370,8 +376,8 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
 
     if (!m_pickLabelTagFilter.isEmpty())
     {
-        QList<int> tagIds = info.tagIds();
-        bool matchPL      = false;
+        const ItemAttributesSnapshot::Tags tagIds = attributes.tagIds(info);
+        bool matchPL                              = false;
 
         if (containsAnyOf(m_pickLabelTagFilter, tagIds))
         {
@@ -397,8 +403,8 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
 
     if (!m_colorLabelTagFilter.isEmpty())
     {
-        QList<int> tagIds = info.tagIds();
-        bool matchCL      = false;
+        const ItemAttributesSnapshot::Tags tagIds = attributes.tagIds(info);
+        bool matchCL                              = false;
 
         if (containsAnyOf(m_colorLabelTagFilter, tagIds))
         {
@@ -423,7 +429,7 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
 
     if (!m_dayFilter.isEmpty())
     {
-        match &= m_dayFilter.contains(QDateTime(info.dateTime().date(), QTime()));
+        match &= m_dayFilter.contains(QDateTime(attributes.creationDay(info), QTime()));
     }
 
     //-- Filter by rating ---------------------------------------------------------
@@ -432,7 +438,7 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
     {
         // for now we treat -1 (no rating) just like a rating of 0.
 
-        int rating = info.rating();
+        int rating = attributes.rating(info);
 
         if (rating == -1)
         {
@@ -716,7 +722,7 @@ bool ItemFilterSettings::matches(const ItemInfo& info, bool* const foundText) co
 
         // Tag names
 
-        Q_FOREACH (int id, info.tagIds())
+        for (int id : attributes.tagIds(info))
         {
             if ((m_textFilterSettings.textFields & SearchTextFilterSettings::TagName) &&
                 (textRegExp.match(m_tagNameHash.value(id)).hasMatch()                 ||
@@ -871,6 +877,11 @@ bool VersionItemFilterSettings::operator==(const VersionItemFilterSettings& othe
 }
 
 bool VersionItemFilterSettings::matches(const ItemInfo& info) const
+{
+    return matches(info, ItemAttributesSnapshot());
+}
+
+bool VersionItemFilterSettings::matches(const ItemInfo& info, const ItemAttributesSnapshot& attributes) const
 {
     if (!isFiltering())
     {
@@ -888,8 +899,8 @@ bool VersionItemFilterSettings::matches(const ItemInfo& info) const
         }
     }
 
-    bool match        = true;
-    QList<int> tagIds = info.tagIds();
+    bool match                                = true;
+    const ItemAttributesSnapshot::Tags tagIds = attributes.tagIds(info);
 
     if (!tagIds.contains(m_includeTagFilter))
     {
@@ -34,6 +34,7 @@
 #include "searchtextbar.h"
 #include "mimefilter.h"
 #include "digikam_export.h"
+#include "itemattributesstore.h"
 
 namespace Digikam
 {
@@ -122,6 +123,13 @@ public:
      */
     bool matches(const ItemInfo& info, bool* const foundText = nullptr) const;
 
+    /**
+     *  Same as above, reading tags, labels, rating and date from the attributes snapshot
+     *  when possible.
+     */
+    bool matches(const ItemInfo& info, const ItemAttributesSnapshot& attributes,
+                 bool* const foundText = nullptr) const;
+
 public:
 
     /// --- Tags filter ---
@@ -269,6 +277,8 @@ public:
      *  Returns true if the given ItemInfo matches the filter criteria.
      */
     bool matches(const ItemInfo& info)                      const;
+    bool matches(const ItemInfo& info,
+                 const ItemAttributesSnapshot& attributes)  const;
 
     bool isHiddenBySettings(const ItemInfo& info)           const;
     bool isExemptedBySettings(const ItemInfo& info)         const;
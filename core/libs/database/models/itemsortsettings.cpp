@@ -297,7 +297,13 @@ int ItemSortSettings::compareCategories(const ItemInfo& left, const ItemInfo& ri
 
 bool ItemSortSettings::lessThan(const ItemInfo& left, const ItemInfo& right) const
 {
-    int result = compare(left, right, sortRole);
+    return lessThan(left, right, ItemAttributesSnapshot());
+}
+
+bool ItemSortSettings::lessThan(const ItemInfo& left, const ItemInfo& right,
+                                const ItemAttributesSnapshot& attributes) const
+{
+    int result = compare(left, right, sortRole, attributes);
 
     if (result != 0)
     {
@@ -313,42 +319,42 @@ bool ItemSortSettings::lessThan(const ItemInfo& left, const ItemInfo& right) con
 
     // If left and right equal for first sort order, use a hierarchy of all sort orders
 
-    if ((result = compare(left, right, SortByFileName)) != 0)
+    if ((result = compare(left, right, SortByFileName, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortByCreationDate)) != 0)
+    if ((result = compare(left, right, SortByCreationDate, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortByModificationDate)) != 0)
+    if ((result = compare(left, right, SortByModificationDate, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortByFilePath)) != 0)
+    if ((result = compare(left, right, SortByFilePath, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortByFileSize)) != 0)
+    if ((result = compare(left, right, SortByFileSize, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortBySimilarity)) != 0)
+    if ((result = compare(left, right, SortBySimilarity, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortByManualOrderAndName)) != 0)
+    if ((result = compare(left, right, SortByManualOrderAndName, attributes)) != 0)
     {
         return (result < 0);
     }
 
-    if ((result = compare(left, right, SortByManualOrderAndDate)) != 0)
+    if ((result = compare(left, right, SortByManualOrderAndDate, attributes)) != 0)
     {
         return (result < 0);
     }
@@ -362,6 +368,12 @@ int ItemSortSettings::compare(const ItemInfo& left, const ItemInfo& right) const
 }
 
 int ItemSortSettings::compare(const ItemInfo& left, const ItemInfo& right, SortRole role) const
+{
+    return compare(left, right, role, ItemAttributesSnapshot());
+}
+
+int ItemSortSettings::compare(const ItemInfo& left, const ItemInfo& right, SortRole role,
+                              const ItemAttributesSnapshot& attributes) const
 {
     switch (role)
     {
@@ -379,24 +391,24 @@ int ItemSortSettings::compare(const ItemInfo& left, const ItemInfo& right, SortR
 
         case SortByFileSize:
         {
-            return compareByOrder(left.fileSize(), right.fileSize(), currentSortOrder);
+            return compareByOrder(attributes.fileSize(left), attributes.fileSize(right), currentSortOrder);
         }
 
         case SortByCreationDate:
         {
-            return compareByOrder(left.dateTime(), right.dateTime(), currentSortOrder);
+            return compareByOrder(attributes.creationDate(left), attributes.creationDate(right), currentSortOrder);
         }
 
         case SortByModificationDate:
         {
-            return compareByOrder(left.modDateTime(), right.modDateTime(), currentSortOrder);
+            return compareByOrder(attributes.modificationDate(left), attributes.modificationDate(right), currentSortOrder);
         }
 
         case SortByRating:
         {
             // I have the feeling that inverting the sort order for rating is the natural order
 
-            return - compareByOrder(left.rating(), right.rating(), currentSortOrder);
+            return - compareByOrder(attributes.rating(left), attributes.rating(right), currentSortOrder);
         }
 
         case SortByImageSize:
@@ -448,7 +460,7 @@ int ItemSortSettings::compare(const ItemInfo& left, const ItemInfo& right, SortR
 
             if (role == SortByManualOrderAndDate)
             {
-                return compareByOrder(left.dateTime(), right.dateTime(), currentSortOrder);
+                return compareByOrder(attributes.creationDate(left), attributes.creationDate(right), currentSortOrder);
             }
 
             return naturalCompare(left.name(), right.name(),
@@ -23,6 +23,7 @@
 // Local includes
 
 #include "digikam_export.h"
+#include "itemattributesstore.h"
 #include "itemsortcollator.h"
 
 namespace Digikam
@@ -97,6 +98,12 @@ public:
      */
     bool lessThan(const ItemInfo& left, const ItemInfo& right) const;
 
+    /**
+     * Same as above, reading the values to compare from the attributes snapshot when possible.
+     */
+    bool lessThan(const ItemInfo& left, const ItemInfo& right,
+                  const ItemAttributesSnapshot& attributes) const;
+
     /**
      * Compares the ItemInfos left and right.
      * Return -1 if left is less than right, 1 if left is greater than right,
@@ -134,6 +141,8 @@ public:
     /// --- Image Sorting ---
 
     int compare(const ItemInfo& left, const ItemInfo& right, SortRole sortRole) const;
+    int compare(const ItemInfo& left, const ItemInfo& right, SortRole sortRole,
+                const ItemAttributesSnapshot& attributes) const;
 
     static Qt::SortOrder defaultSortOrderForCategorizationMode(CategorizationMode mode);
     static Qt::SortOrder defaultSortOrderForSortRole(SortRole role);
@@ -17,6 +17,10 @@
 
 #include "similaritydb.h"
 
+// Qt includes
+
+#include <QVariant>
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -218,6 +222,18 @@ bool SimilarityDb::hasDirtyOrMissingFingerprint(const ItemInfo& imageInfo, Fuzzy
     return false;
 }
 
+bool SimilarityDb::hasMissingPerceptualHash(const ItemInfo& imageInfo) const
+{
+    QList<QVariant> values;
+
+    d->db->execSql(QString::fromUtf8("SELECT M.imageid FROM ImageHaarMatrix AS M "
+                                     "LEFT JOIN ImagePerceptualHashes AS P ON P.imageid=M.imageid "
+                                     "WHERE M.imageid=? AND P.hash IS NULL;"),
+                   imageInfo.id(), &values);
+
+    return !values.isEmpty();
+}
+
 QList<qlonglong> SimilarityDb::getDirtyOrMissingFingerprints(const QList<ItemInfo>& imageInfos,
                                                              FuzzyAlgorithm algorithm)
 {
@@ -307,6 +323,12 @@ void SimilarityDb::copySimilarityAttributes(qlonglong srcId, qlonglong dstId)
                                      "SELECT ?, modificationDate, uniqueHash, matrix "
                                      " FROM ImageHaarMatrix WHERE imageid=?;"),
                    dstId, srcId);
+
+    d->db->execSql(QString::fromUtf8("REPLACE INTO ImagePerceptualHashes "
+                                     "(imageid, hash) "
+                                     "SELECT ?, hash "
+                                     " FROM ImagePerceptualHashes WHERE imageid=?;"),
+                   dstId, srcId);
 }
 
 
@@ -317,6 +339,9 @@ void SimilarityDb::removeImageFingerprint(qlonglong imageID,
     {
         d->db->execSql(QString::fromUtf8("DELETE FROM ImageHaarMatrix WHERE imageid=?;"),
                        imageID);
+
+        d->db->execSql(QString::fromUtf8("DELETE FROM ImagePerceptualHashes WHERE imageid=?;"),
+                       imageID);
     }
     else if (algorithm == FuzzyAlgorithm::TfIdf)
     {
@@ -331,6 +356,38 @@ void SimilarityDb::removeImageFingerprint(qlonglong imageID,
     }
 }
 
+// ----------- Methods for perceptual hash (ImagePerceptualHashes) table access ----------
+
+void SimilarityDb::setPerceptualHash(qlonglong imageID, quint64 hash)
+{
+    // The hash is stored as a signed 64 bits integer, the bits are kept as they are.
+
+    d->db->execSql(QString::fromUtf8("REPLACE INTO ImagePerceptualHashes (imageid, hash) "
+                                     "VALUES(?, ?);"),
+                   imageID, (qlonglong)hash);
+}
+
+QHash<qlonglong, quint64> SimilarityDb::getPerceptualHashes() const
+{
+    QHash<qlonglong, quint64> hashes;
+    QList<QVariant>           values;
+
+    d->db->execSql(QString::fromUtf8("SELECT imageid, hash FROM ImagePerceptualHashes;"),
+                   &values);
+
+    hashes.reserve(values.size() / 2);
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        const qlonglong imageID = (*it).toLongLong();
+        ++it;
+        hashes.insert(imageID, (quint64)(*it).toLongLong());
+        ++it;
+    }
+
+    return hashes;
+}
+
 // ----------- Methods for image similarity table access ----------
 
 double SimilarityDb::getImageSimilarity(qlonglong imageID1, qlonglong imageID2, FuzzyAlgorithm algorithm)
@@ -474,6 +531,260 @@ QList<FuzzyAlgorithm> SimilarityDb::getImageSimilarityAlgorithms(qlonglong image
     return algorithms;
 }
 
+// ----------- Methods for duplicates groups table access ----------
+
+void SimilarityDb::setDuplicatesGroups(const QList<DuplicatesGroup>& groups, bool update)
+{
+    QVariantList references;
+    QVariantList similarities;
+    QVariantList counts;
+    QVariantList itemReferences;
+    QVariantList itemIds;
+
+    Q_FOREACH (const DuplicatesGroup& group, groups)
+    {
+        references   << group.reference;
+        similarities << group.similarity;
+        counts       << group.items.count();
+
+        Q_FOREACH (qlonglong imageId, group.items)
+        {
+            itemReferences << group.reference;
+            itemIds        << imageId;
+        }
+    }
+
+    d->db->beginTransaction();
+
+    if (!update)
+    {
+        d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesItems;"));
+        d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesGroups;"));
+    }
+    else if (!references.isEmpty())
+    {
+        DbEngineSqlQuery deleteItems = d->db->prepareQuery(QString::fromUtf8("DELETE FROM DuplicatesItems "
+                                                                             "WHERE reference=?;"));
+        deleteItems.addBindValue(references);
+        d->db->execBatch(deleteItems);
+    }
+
+    if (!references.isEmpty())
+    {
+        DbEngineSqlQuery groupsQuery = d->db->prepareQuery(QString::fromUtf8("REPLACE INTO DuplicatesGroups "
+                                                                             "(reference, similarity, itemsCount) "
+                                                                             "VALUES (?, ?, ?);"));
+        groupsQuery.addBindValue(references);
+        groupsQuery.addBindValue(similarities);
+        groupsQuery.addBindValue(counts);
+        d->db->execBatch(groupsQuery);
+
+        DbEngineSqlQuery itemsQuery  = d->db->prepareQuery(QString::fromUtf8("REPLACE INTO DuplicatesItems "
+                                                                             "(reference, imageid) "
+                                                                             "VALUES (?, ?);"));
+        itemsQuery.addBindValue(itemReferences);
+        itemsQuery.addBindValue(itemIds);
+        d->db->execBatch(itemsQuery);
+    }
+
+    d->db->commitTransaction();
+}
+
+int SimilarityDb::getDuplicatesGroupsCount()
+{
+    QList<QVariant> values;
+
+    d->db->execSql(QString::fromUtf8("SELECT COUNT(*) FROM DuplicatesGroups;"),
+                   &values);
+
+    if (values.isEmpty())
+    {
+        return 0;
+    }
+
+    return values.first().toInt();
+}
+
+QList<DuplicatesGroup> SimilarityDb::getDuplicatesGroups(int offset, int limit)
+{
+    // The page is selected in the groups table first, then joined with its items.
+
+    QString page = QString::fromUtf8("SELECT reference, similarity FROM DuplicatesGroups "
+                                     "ORDER BY similarity DESC, reference");
+
+    if (limit >= 0)
+    {
+        page += QString::fromUtf8(" LIMIT %1 OFFSET %2").arg(limit).arg(qMax(0, offset));
+    }
+
+    QList<QVariant> values;
+
+    d->db->execSql(QString::fromUtf8("SELECT Page.reference, Page.similarity, DuplicatesItems.imageid "
+                                     "FROM (%1) AS Page "
+                                     "INNER JOIN DuplicatesItems ON DuplicatesItems.reference=Page.reference "
+                                     "ORDER BY Page.similarity DESC, Page.reference, DuplicatesItems.imageid;").arg(page),
+                   &values);
+
+    QList<DuplicatesGroup> groups;
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        const qlonglong reference = (*it).toLongLong();
+        ++it;
+
+        if (groups.isEmpty() || (groups.last().reference != reference))
+        {
+            DuplicatesGroup group;
+            group.reference  = reference;
+            group.similarity = (*it).toDouble();
+            groups << group;
+        }
+
+        ++it;
+        groups.last().items << (*it).toLongLong();
+        ++it;
+    }
+
+    return groups;
+}
+
+DuplicatesGroup SimilarityDb::getDuplicatesGroup(qlonglong reference)
+{
+    QList<QVariant> values;
+
+    d->db->execSql(QString::fromUtf8("SELECT DuplicatesGroups.similarity, DuplicatesItems.imageid "
+                                     "FROM DuplicatesGroups "
+                                     "INNER JOIN DuplicatesItems ON DuplicatesItems.reference=DuplicatesGroups.reference "
+                                     "WHERE DuplicatesGroups.reference=?;"),
+                   reference, &values);
+
+    DuplicatesGroup group;
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        group.reference  = reference;
+        group.similarity = (*it).toDouble();
+        ++it;
+        group.items << (*it).toLongLong();
+        ++it;
+    }
+
+    return group;
+}
+
+QHash<qlonglong, qlonglong> SimilarityDb::removeFromDuplicatesGroups(const QList<qlonglong>& imageIds)
+{
+    // The ids are listed by chunks, the SQLite statements being limited to 999 values.
+
+    const int maxIds = 999;
+
+    QHash<qlonglong, qlonglong> references;
+
+    if (imageIds.isEmpty())
+    {
+        return references;
+    }
+
+    const QSet<qlonglong> removed(imageIds.begin(), imageIds.end());
+    QList<QVariant>       values;
+
+    d->db->beginTransaction();
+
+    for (int i = 0 ; i < imageIds.count() ; i += maxIds)
+    {
+        QStringList ids;
+
+        Q_FOREACH (qlonglong imageId, imageIds.mid(i, maxIds))
+        {
+            ids << QString::number(imageId);
+        }
+
+        const QString idsList = ids.join(QLatin1Char(','));
+
+        values.clear();
+
+        d->db->execSql(QString::fromUtf8("SELECT DISTINCT reference FROM DuplicatesItems "
+                                         "WHERE imageid IN (%1);").arg(idsList),
+                       &values);
+
+        Q_FOREACH (const QVariant& value, values)
+        {
+            references.insert(value.toLongLong(), value.toLongLong());
+        }
+
+        d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesItems "
+                                         "WHERE imageid IN (%1);").arg(idsList));
+    }
+
+    for (QHash<qlonglong, qlonglong>::iterator it = references.begin() ; it != references.end() ; ++it)
+    {
+        const qlonglong reference = it.key();
+        qlonglong newReference    = reference;
+
+        values.clear();
+
+        d->db->execSql(QString::fromUtf8("SELECT COUNT(*) FROM DuplicatesItems WHERE reference=?;"),
+                       reference, &values);
+
+        const int itemsCount = values.isEmpty() ? 0 : values.first().toInt();
+
+        // A deleted reference image is replaced by the surviving item with the lowest id,
+        // unless this item is already the reference of another group.
+
+        if ((itemsCount >= 2) && removed.contains(reference))
+        {
+            values.clear();
+
+            d->db->execSql(QString::fromUtf8("SELECT imageid FROM DuplicatesItems WHERE reference=? "
+                                             "AND imageid NOT IN (SELECT reference FROM DuplicatesGroups) "
+                                             "ORDER BY imageid LIMIT 1;"),
+                           reference, &values);
+
+            newReference = values.isEmpty() ? -1 : values.first().toLongLong();
+        }
+
+        // A group with only one item left is not a group of duplicates anymore.
+
+        if ((itemsCount < 2) || (newReference == -1))
+        {
+            d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesItems WHERE reference=?;"),
+                           reference);
+
+            d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesGroups WHERE reference=?;"),
+                           reference);
+
+            it.value() = -1;
+
+            continue;
+        }
+
+        d->db->execSql(QString::fromUtf8("UPDATE DuplicatesGroups SET reference=?, itemsCount=? "
+                                         "WHERE reference=?;"),
+                       newReference, itemsCount, reference);
+
+        if (newReference != reference)
+        {
+            d->db->execSql(QString::fromUtf8("UPDATE DuplicatesItems SET reference=? "
+                                             "WHERE reference=?;"),
+                           newReference, reference);
+        }
+
+        it.value() = newReference;
+    }
+
+    d->db->commitTransaction();
+
+    return references;
+}
+
+void SimilarityDb::clearDuplicatesGroups()
+{
+    d->db->beginTransaction();
+    d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesItems;"));
+    d->db->execSql(QString::fromUtf8("DELETE FROM DuplicatesGroups;"));
+    d->db->commitTransaction();
+}
+
 // ----------- Database shrinking and integrity check methods ----------
 
 bool SimilarityDb::integrityCheck()
@@ -23,6 +23,7 @@
 #include <QStringList>
 #include <QString>
 #include <QList>
+#include <QHash>
 #include <QPair>
 #include <QSet>
 
@@ -44,6 +45,31 @@ enum class FuzzyAlgorithm
     TfIdf   = 2
 };
 
+/**
+ * A group of duplicates found by a duplicates search. The group is identified
+ * by the id of its reference image, which is also one of its items.
+ */
+class DIGIKAM_DATABASE_EXPORT DuplicatesGroup
+{
+public:
+
+    DuplicatesGroup()
+        : reference (-1),
+          similarity(0.0)
+    {
+    }
+
+    bool isNull() const
+    {
+        return (reference == -1);
+    }
+
+public:
+
+    qlonglong        reference;
+    double           similarity;    ///< The average similarity of the items, in the range 0..1.
+    QList<qlonglong> items;
+};
 
 class DIGIKAM_DATABASE_EXPORT SimilarityDb
 {
@@ -111,6 +137,16 @@ public:
     bool hasDirtyOrMissingFingerprint(const ItemInfo& imageInfo,
                                       FuzzyAlgorithm algorithm = FuzzyAlgorithm::Haar) const;
 
+    /**
+     * Checks if the given image has a Haar fingerprint without perceptual hash,
+     * as the images indexed before the hashes were introduced. Such a fingerprint
+     * is not dirty: the near duplicates search always compares these images.
+     *
+     * @param imageInfo The image info object representing the item.
+     * @return True, if the image has a Haar fingerprint but no perceptual hash.
+     */
+    bool hasMissingPerceptualHash(const ItemInfo& imageInfo) const;
+
     /**
      * Returns a list of all item ids (images, videos,...) where either no fingerprint for the given
      * algorithm exists or is outdated because the file is identified as changed since
@@ -134,7 +170,8 @@ public:
                                                       FuzzyAlgorithm algorithm = FuzzyAlgorithm::Haar);
 
     /**
-     * This method removes the fingerprint entry for the given imageId and algorithm.
+     * This method removes the fingerprint entry for the given imageId and algorithm,
+     * with the perceptual hash of the image.
      * Also, this automatically removes the entries in the ImageSimilarities table for the
      * given algorithm and image id.
      * @param imageID The image id.
@@ -149,6 +186,20 @@ public:
     void copySimilarityAttributes(qlonglong srcId,
                                   qlonglong destId);
 
+    // ----------- Methods for perceptual hash (ImagePerceptualHashes) table access ----------
+
+    /**
+     * Stores the 64 bits perceptual hash computed with the Haar fingerprint of an image.
+     * @param imageID The image id.
+     * @param hash The perceptual hash.
+     */
+    void setPerceptualHash(qlonglong imageID, quint64 hash);
+
+    /**
+     * Returns the perceptual hashes of all images, by image id.
+     */
+    QHash<qlonglong, quint64> getPerceptualHashes() const;
+
     // ----------- Methods for image similarity table access ----------
 
     /**
@@ -198,6 +249,45 @@ public:
     QList<FuzzyAlgorithm> getImageSimilarityAlgorithms(qlonglong imageID1,
                                                        qlonglong imageID2);
 
+    // ----------- Methods for duplicates groups table access ----------
+
+    /**
+     * Writes the groups of a duplicates search in one transaction.
+     * @param groups The groups found by the search.
+     * @param update If false, all groups found by a previous search are removed.
+     *               If true, only the groups with the same references are replaced.
+     */
+    void setDuplicatesGroups(const QList<DuplicatesGroup>& groups, bool update);
+
+    /**
+     * Returns the number of groups found by the last duplicates search.
+     */
+    int getDuplicatesGroupsCount();
+
+    /**
+     * Returns a page of the groups found by the last duplicates search,
+     * ordered by decreasing similarity, with their items.
+     * @param offset The number of groups to skip.
+     * @param limit The maximum number of groups to return, or -1 for all groups.
+     */
+    QList<DuplicatesGroup> getDuplicatesGroups(int offset, int limit);
+
+    /**
+     * Returns the group with the given reference image, or a null group.
+     */
+    DuplicatesGroup getDuplicatesGroup(qlonglong reference);
+
+    /**
+     * Removes the images from the groups, and the groups left with less than two items.
+     * A group whose reference image is removed gets the remaining item with the lowest id
+     * as reference, or is removed if this item is already the reference of another group.
+     * @return the references of the modified groups, mapped to their reference after
+     *         the removal, or to -1 for the removed groups.
+     */
+    QHash<qlonglong, qlonglong> removeFromDuplicatesGroups(const QList<qlonglong>& imageIds);
+
+    void clearDuplicatesGroups();
+
     // ----------- Database shrinking and integrity check methods ----------
 
     /**
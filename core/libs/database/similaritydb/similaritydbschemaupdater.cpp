@@ -40,7 +40,7 @@ namespace Digikam
 
 int SimilarityDbSchemaUpdater::schemaVersion()
 {
-    return 1;
+    return 3;
 }
 
 // -------------------------------------------------------------------------------------
@@ -235,7 +235,9 @@ bool SimilarityDbSchemaUpdater::createDatabase()
 
 bool SimilarityDbSchemaUpdater::createTables()
 {
-    return d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateSimilarityDB")));
+    return (d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateSimilarityDB"))) &&
+            d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateSimilarityDBDuplicatesGroups"))) &&
+            d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateSimilarityDBPerceptualHashes"))));
 }
 
 bool SimilarityDbSchemaUpdater::createIndices()
@@ -252,9 +254,14 @@ bool SimilarityDbSchemaUpdater::makeUpdates()
 {
     if (d->currentVersion < schemaVersion())
     {
-        if (d->currentVersion == 1)
+        if ((d->currentVersion == 1) && !updateV1ToV2())
         {
-            updateV1ToV2();
+            return false;
+        }
+
+        if (d->currentVersion == 2)
+        {
+            return updateV2ToV3();
         }
     }
 
@@ -263,7 +270,49 @@ bool SimilarityDbSchemaUpdater::makeUpdates()
 
 bool SimilarityDbSchemaUpdater::updateV1ToV2()
 {
-    // Do nothing for now.
+    // Version 2 adds the tables of the groups of duplicates found by the last search.
+
+    if (!d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateSimilarityDBDuplicatesGroups"))))
+    {
+        QString errorMsg = i18n("Failed to update the database schema from version 1 to version 2.\n ") +
+                           d->dbAccess->backend()->lastError();
+        d->dbAccess->setLastError(errorMsg);
+
+        if (d->observer)
+        {
+            d->observer->error(errorMsg);
+            d->observer->finishedSchemaUpdate(InitializationObserver::UpdateErrorMustAbort);
+        }
+
+        return false;
+    }
+
+    d->currentVersion = 2;
+
+    return true;
+}
+
+bool SimilarityDbSchemaUpdater::updateV2ToV3()
+{
+    // Version 3 adds the table of the perceptual hashes used to pre-filter the duplicates search.
+
+    if (!d->dbAccess->backend()->execDBAction(d->dbAccess->backend()->getDBAction(QLatin1String("CreateSimilarityDBPerceptualHashes"))))
+    {
+        QString errorMsg = i18n("Failed to update the database schema from version 2 to version 3.\n ") +
+                           d->dbAccess->backend()->lastError();
+        d->dbAccess->setLastError(errorMsg);
+
+        if (d->observer)
+        {
+            d->observer->error(errorMsg);
+            d->observer->finishedSchemaUpdate(InitializationObserver::UpdateErrorMustAbort);
+        }
+
+        return false;
+    }
+
+    d->currentVersion = 3;
+
     return true;
 }
 
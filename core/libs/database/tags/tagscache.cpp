@@ -15,21 +15,28 @@
 
 #include "tagscache.h"
 
+// C++ includes
+
+#include <memory>
+
 // Qt includes
 
+#include <QAtomicInt>
 #include <QMultiHash>
-#include <QReadWriteLock>
-#include <QReadLocker>
-#include <QWriteLocker>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSet>
 #include <QStringList>
 #include <QMap>
-#include <QRegularExpression>
+#include <QVector>
 
 // Local includes
 
 #include "digikam_debug.h"
 #include "coredb.h"
 #include "coredbaccess.h"
+#include "coredbtransaction.h"
 #include "coredbwatch.h"
 #include "digikam_globals.h"
 #include "itempropertiestab.h"
@@ -51,141 +58,637 @@ static bool lessThanForTagProperty(const TagProperty& first, const TagProperty&
 typedef QList<TagProperty>::const_iterator                            TagPropertiesConstIterator;
 typedef QPair<TagPropertiesConstIterator, TagPropertiesConstIterator> TagPropertiesRange;
 
+/// The id of a parent tag and the name of one of its children.
+typedef QPair<int, QString>                                           TagChildKey;
+
 // ------------------------------------------------------------------------------------------
 
-class Q_DECL_HIDDEN TagsCache::Private
+/**
+ * The tags read from the database. A snapshot is never changed once published:
+ * the readers use it without locking, and a new snapshot replaces it when the
+ * tags changed.
+ */
+class Q_DECL_HIDDEN TagsSnapshot
 {
 public:
 
-    explicit Private(TagsCache* const q)
-      : initialized(false),
-        needUpdateInfos(true),
-        needUpdateHash(true),
-        needUpdateProperties(true),
-        needUpdateLabelTags(true),
-        changingDB(false),
-        q(q)
+    explicit TagsSnapshot(int changes = -1)
+      : changes(changes)
+    {
+    }
+
+    // the infos are sorted by id
+
+    QList<TagShortInfo>::const_iterator find(int id) const
+    {
+        TagShortInfo info;
+        info.id = id;
+
+        QList<TagShortInfo>::const_iterator it;
+        it = std::lower_bound(infos.constBegin(),
+                              infos.constEnd(), info,
+                              lessThanForTagShortInfo);
+
+        if ((it == infos.constEnd()) || (info.id < (*it).id))
+        {
+            return infos.constEnd();
+        }
+
+        return it;
+    }
+
+    QString buildTagPath(int id) const
+    {
+        QString path;
+        QList<TagShortInfo>::const_iterator it;
+
+        for (it = find(id) ; it != infos.constEnd() ; it = find(it->pid))
+        {
+            if (path.isNull())
+            {
+                path = it->name;
+            }
+            else
+            {
+                if (it->name.contains(QLatin1String("_Digikam_root_tag_")))
+                {
+                    continue;
+                }
+                else
+                {
+                    path = it->name + QLatin1Char('/') + path;
+                }
+            }
+        }
+
+        return path;
+    }
+
+    void build()
+    {
+        Q_FOREACH (const TagShortInfo& info, infos)
+        {
+            nameHash.insert(info.name, info.id);
+            children.insert(TagChildKey(info.pid, info.name), info.id);
+
+            const QString path = buildTagPath(info.id);
+            paths.insert(info.id, path);
+            pathHash.insert(path, info.id);
+        }
+    }
+
+    /**
+     * Adds or replaces the tag as read from the database,
+     * and updates the paths of the tag and its descendants.
+     */
+    void setTag(const TagShortInfo& info)
+    {
+        takeTag(info.id);
+
+        QList<TagShortInfo>::iterator it = std::lower_bound(infos.begin(), infos.end(),
+                                                            info, lessThanForTagShortInfo);
+        infos.insert(it, info);
+        nameHash.insert(info.name, info.id);
+        children.insert(TagChildKey(info.pid, info.name), info.id);
+
+        updatePaths(subtree(info.id));
+    }
+
+    /**
+     * Removes the tag and its descendants, as deleted by the database.
+     * Returns the ids of the tags removed.
+     */
+    QList<int> removeTag(int id)
+    {
+        const QList<int> ids = subtree(id);
+
+        Q_FOREACH (int tagId, ids)
+        {
+            takeTag(tagId);
+        }
+
+        return ids;
+    }
+
+private:
+
+    /// The tag and its descendants.
+    QList<int> subtree(int id) const
+    {
+        QList<int> ids;
+
+        Q_FOREACH (const TagShortInfo& info, infos)
+        {
+            QList<TagShortInfo>::const_iterator it;
+
+            for (it = find(info.id) ; it != infos.constEnd() ; it = find(it->pid))
+            {
+                if (it->id == id)
+                {
+                    ids << info.id;
+                    break;
+                }
+            }
+        }
+
+        return ids;
+    }
+
+    void takeTag(int id)
+    {
+        QList<TagShortInfo>::const_iterator it = find(id);
+
+        if (it == infos.constEnd())
+        {
+            return;
+        }
+
+        const TagChildKey key(it->pid, it->name);
+
+        if (children.value(key) == id)
+        {
+            children.remove(key);
+        }
+
+        nameHash.remove(it->name, id);
+        removePath(id);
+        infos.removeAt(it - infos.constBegin());
+    }
+
+    void removePath(int id)
     {
+        const QString path = paths.take(id);
+
+        if (pathHash.value(path) == id)
+        {
+            pathHash.remove(path);
+        }
+    }
+
+    void updatePaths(const QList<int>& ids)
+    {
+        Q_FOREACH (int id, ids)
+        {
+            removePath(id);
+        }
+
+        Q_FOREACH (int id, ids)
+        {
+            const QString path = buildTagPath(id);
+            paths.insert(id, path);
+            pathHash.insert(path, id);
+        }
     }
 
 public:
 
-    volatile bool               initialized;
-    volatile bool               needUpdateInfos;
-    volatile bool               needUpdateHash;
-    volatile bool               needUpdateProperties;
-    volatile bool               needUpdateLabelTags;
-    volatile bool               changingDB;
+    int                         changes;        ///< The changes counter when the tags were read
 
-    QReadWriteLock              lock;
     QList<TagShortInfo>         infos;
     QMultiHash<QString, int>    nameHash;
 
-    QList<TagProperty>          tagProperties;
+    /// The tree of the tags as a trie of the tag names: one lookup for each path level.
+    QHash<TagChildKey, int>     children;
+
+    /// The paths of the tags without leading slash, and the tags by path.
+    QHash<int, QString>         paths;
+    QHash<QString, int>         pathHash;
+};
+
+// ------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN TagPropertiesSnapshot
+{
+public:
+
+    explicit TagPropertiesSnapshot(int changes = -1)
+      : changes(changes)
+    {
+    }
+
+    TagPropertiesRange findProperties(int id) const
+    {
+        TagProperty prop;
+        prop.tagId   = id;
+        TagPropertiesRange range;
+        range.first  = std::lower_bound(tagProperties.begin(), tagProperties.end(), prop, lessThanForTagProperty);
+        range.second = std::upper_bound(range.first, tagProperties.end(), prop, lessThanForTagProperty);
+
+        return range;
+    }
+
+    void build()
+    {
+        const QLatin1String internalProp = TagsCache::propertyNameDigikamInternalTag();
+
+        Q_FOREACH (const TagProperty& property, tagProperties)
+        {
+            if (property.property == internalProp)
+            {
+                internalTags << property.tagId;
+            }
+
+            // sort out invalid entries, see bug #277169
+
+            if (property.tagId <= 0)
+            {
+                continue;
+            }
+
+            // the properties are sorted by tag id: the lists are sorted
+
+            QList<int>& ids = tagsWithProperty[property.property];
+
+            if (ids.isEmpty() || (ids.last() != property.tagId))
+            {
+                ids << property.tagId;
+            }
+        }
+    }
+
+    /**
+     * Replaces the properties of the tag by the ones read from the database.
+     */
+    void setProperties(int id, const QList<TagProperty>& properties)
+    {
+        removeProperties(id);
+
+        int index                        = findProperties(id).first - tagProperties.constBegin();
+        const QLatin1String internalProp = TagsCache::propertyNameDigikamInternalTag();
+
+        Q_FOREACH (const TagProperty& property, properties)
+        {
+            tagProperties.insert(index++, property);
+
+            if (property.property == internalProp)
+            {
+                internalTags << id;
+            }
+
+            if (id <= 0)
+            {
+                continue;
+            }
+
+            QList<int>& ids         = tagsWithProperty[property.property];
+            QList<int>::iterator it = std::lower_bound(ids.begin(), ids.end(), id);
+
+            if ((it == ids.end()) || (*it != id))
+            {
+                ids.insert(it, id);
+            }
+        }
+    }
+
+    void removeProperties(int id)
+    {
+        const TagPropertiesRange range = findProperties(id);
+        const int first                = range.first  - tagProperties.constBegin();
+        const int last                 = range.second - tagProperties.constBegin();
+
+        if (first == last)
+        {
+            return;
+        }
+
+        tagProperties.erase(tagProperties.begin() + first, tagProperties.begin() + last);
+        internalTags.remove(id);
+
+        for (QHash<QString, QList<int> >::iterator it = tagsWithProperty.begin() ; it != tagsWithProperty.end() ; )
+        {
+            it.value().removeOne(id);
+
+            if (it.value().isEmpty())
+            {
+                it = tagsWithProperty.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+public:
+
+    int                         changes;
+
+    QList<TagProperty>          tagProperties;  ///< Sorted by tag id
     QHash<QString, QList<int> > tagsWithProperty;
     QSet<int>                   internalTags;
+};
+
+// ------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN LabelTagsSnapshot
+{
+public:
+
+    explicit LabelTagsSnapshot(int changes = -1)
+      : changes(changes)
+    {
+    }
+
+public:
+
+    int                         changes;
+
     QVector<int>                colorLabelsTags; ///< index = Label enum, value = tagId
     QVector<int>                pickLabelsTags;
+};
 
-    TagsCache* const            q;
+// ------------------------------------------------------------------------------------------
 
+class Q_DECL_HIDDEN TagsCache::Private
+{
 public:
 
-    void checkInfos()
+    explicit Private(TagsCache* const q)
+      : initialized   (false),
+        tagsData      (new TagsSnapshot),
+        propertiesData(new TagPropertiesSnapshot),
+        labelTagsData (new LabelTagsSnapshot),
+        q             (q)
     {
-        if (needUpdateInfos && initialized)
+    }
+
+public:
+
+    volatile bool                                   initialized;
+
+    /**
+     * Counters of the changes, incremented when the data must be read again.
+     * A snapshot is up to date while its counter is equal to the current one.
+     */
+    QAtomicInt                                      tagsChanges;
+    QAtomicInt                                      propertiesChanges;
+    QAtomicInt                                      labelTagsChanges;
+
+    /// Only serializes the replacement of the snapshots, never the readers.
+    QMutex                                          publishMutex;
+
+    std::shared_ptr<const TagsSnapshot>             tagsData;
+    std::shared_ptr<const TagPropertiesSnapshot>    propertiesData;
+    std::shared_ptr<const LabelTagsSnapshot>        labelTagsData;
+
+    TagsCache* const                                q;
+
+public:
+
+    /**
+     * Publishes the snapshot, unless a snapshot read after it was published meanwhile.
+     */
+    template <class T>
+    std::shared_ptr<const T> publish(std::shared_ptr<const T>* const data, const std::shared_ptr<const T>& snapshot)
+    {
+        QMutexLocker locker(&publishMutex);
+
+        std::shared_ptr<const T> current = std::atomic_load(data);
+
+        if ((current->changes != -1) && ((snapshot->changes - current->changes) < 0))
+        {
+            return current;
+        }
+
+        std::atomic_store(data, snapshot);
+
+        return snapshot;
+    }
+
+    /**
+     * Counts a change and returns a copy of the current snapshot to apply it to,
+     * or null if the snapshot was already out of date and will be read again.
+     * The publish mutex must be locked.
+     */
+    template <class T>
+    std::shared_ptr<T> copyForChange(std::shared_ptr<const T>* const data, QAtomicInt& counter)
+    {
+        std::shared_ptr<const T> current = std::atomic_load(data);
+        const int changes                = counter.fetchAndAddOrdered(1) + 1;
+
+        if (current->changes != (changes - 1))
+        {
+            return std::shared_ptr<T>();
+        }
+
+        std::shared_ptr<T> snapshot = std::make_shared<T>(*current);
+        snapshot->changes           = changes;
+
+        return snapshot;
+    }
+
+    /**
+     * Applies the change of one tag to the snapshots, reading only this tag
+     * from the database instead of all the tags.
+     */
+    void applyTagChange(const TagChangeset& changeset)
+    {
+        const int id                     = changeset.tagId();
+        const TagChangeset::Operation op = changeset.operation();
+
+        switch (op)
+        {
+            case TagChangeset::Added:
+            case TagChangeset::Moved:
+            case TagChangeset::Deleted:
+            case TagChangeset::Renamed:
+            case TagChangeset::Reparented:
+            case TagChangeset::PropertiesChanged:
+            {
+                break;
+            }
+
+            case TagChangeset::IconChanged:
+            {
+                // the icons are not cached
+
+                return;
+            }
+
+            default:
+            {
+                q->invalidate();
+
+                return;
+            }
+        }
+
+        // The changed tag is read from the database before taking the lock.
+
+        const bool tagChanged = (op != TagChangeset::PropertiesChanged);
+        TagShortInfo info;
+        QList<TagProperty> tagProperties;
+
+        {
+            CoreDbAccess access;
+
+            if (tagChanged && (op != TagChangeset::Deleted))
+            {
+                info = access.db()->getTagShortInfo(id);
+            }
+
+            if ((op == TagChangeset::Added) || (op == TagChangeset::PropertiesChanged))
+            {
+                tagProperties = access.db()->getTagProperties(id);
+            }
+        }
+
+        QMutexLocker locker(&publishMutex);
+
+        if (!tagChanged)
+        {
+            std::shared_ptr<TagPropertiesSnapshot> props = copyForChange<TagPropertiesSnapshot>(&propertiesData, propertiesChanges);
+
+            if (props)
+            {
+                props->setProperties(id, tagProperties);
+                std::atomic_store(&propertiesData, std::shared_ptr<const TagPropertiesSnapshot>(props));
+            }
+
+            return;
+        }
+
+        // The database deletes the descendants of a deleted tag, with their properties.
+
+        QList<int> removed;
+        bool subtreeKnown                  = true;
+        std::shared_ptr<TagsSnapshot> tags = copyForChange<TagsSnapshot>(&tagsData, tagsChanges);
+
+        if      (!tags)
+        {
+            subtreeKnown = false;
+        }
+        else if (info.isNull())
+        {
+            removed = tags->removeTag(id);
+        }
+        else
+        {
+            tags->setTag(info);
+        }
+
+        if (tags)
+        {
+            std::atomic_store(&tagsData, std::shared_ptr<const TagsSnapshot>(tags));
+        }
+
+        if (info.isNull() || (op == TagChangeset::Added))
         {
-            QList<TagShortInfo> newInfos = CoreDbAccess().db()->getTagShortInfos();
-            QWriteLocker locker(&lock);
-            infos                        = newInfos;
-            needUpdateInfos              = false;
-        }
-    }
+            std::shared_ptr<TagPropertiesSnapshot> props = copyForChange<TagPropertiesSnapshot>(&propertiesData, propertiesChanges);
 
-    void checkNameHash()
-    {
-        checkInfos();
+            if      (props && info.isNull() && subtreeKnown)
+            {
+                Q_FOREACH (int tagId, removed)
+                {
+                    props->removeProperties(tagId);
+                }
 
-        if (needUpdateHash && initialized)
-        {
-            QWriteLocker locker(&lock);
-            nameHash.clear();
+                props->removeProperties(id);
+            }
+            else if (props && !info.isNull())
+            {
+                props->setProperties(id, tagProperties);
+            }
+            else
+            {
+                // read again with all the tags
 
-            Q_FOREACH (const TagShortInfo& info, infos)
+                props.reset();
+            }
+
+            if (props)
             {
-                nameHash.insert(info.name, info.id);
+                std::atomic_store(&propertiesData, std::shared_ptr<const TagPropertiesSnapshot>(props));
             }
+        }
+
+        // The label tags are found by path, they are only looked up again.
 
-            needUpdateHash = false;
+        if (op != TagChangeset::Added)
+        {
+            labelTagsChanges.ref();
         }
     }
 
-    void checkProperties()
+    std::shared_ptr<const TagsSnapshot> tags()
     {
-        if (needUpdateProperties && initialized)
-        {
-            QList<TagProperty> props = CoreDbAccess().db()->getTagProperties();
+        std::shared_ptr<const TagsSnapshot> current = std::atomic_load(&tagsData);
+        const int changes                           = tagsChanges.loadAcquire();
 
-            // Ensure not to lock both locks at the same time
-
-            QWriteLocker locker(&lock);
+        if (!initialized || (current->changes == changes))
+        {
+            return current;
+        }
 
-            needUpdateProperties = false;
-            tagProperties        = props;
-            tagsWithProperty.clear();
+        // The database is read without holding any lock of the cache.
 
-            QLatin1String internalProp = TagsCache::propertyNameDigikamInternalTag();
+        std::shared_ptr<TagsSnapshot> snapshot = std::make_shared<TagsSnapshot>(changes);
+        snapshot->infos                        = CoreDbAccess().db()->getTagShortInfos();
+        snapshot->build();
 
-            Q_FOREACH (const TagProperty& property, tagProperties)
-            {
-                if (property.property == internalProp)
-                {
-                    internalTags << property.tagId;
-                }
-            }
-        }
+        return publish<TagsSnapshot>(&tagsData, snapshot);
     }
 
-    // remember to call under lock
-
-    QList<TagShortInfo>::const_iterator find(int id) const
+    std::shared_ptr<const TagPropertiesSnapshot> properties()
     {
-        TagShortInfo info;
-        info.id = id;
-
-        // we use the fact that d->infos is sorted by id
-
-        QList<TagShortInfo>::const_iterator it;
-        it = std::lower_bound(infos.constBegin(),
-                              infos.constEnd(), info,
-                              lessThanForTagShortInfo);
+        std::shared_ptr<const TagPropertiesSnapshot> current = std::atomic_load(&propertiesData);
+        const int changes                                    = propertiesChanges.loadAcquire();
 
-        if ((it == infos.constEnd()) || (info.id < (*it).id))
+        if (!initialized || (current->changes == changes))
         {
-            return infos.constEnd();
+            return current;
         }
 
-        return it;
+        std::shared_ptr<TagPropertiesSnapshot> snapshot = std::make_shared<TagPropertiesSnapshot>(changes);
+        snapshot->tagProperties                         = CoreDbAccess().db()->getTagProperties();
+        snapshot->build();
+
+        return publish<TagPropertiesSnapshot>(&propertiesData, snapshot);
     }
 
-    TagPropertiesRange findProperties(int id) const
+    std::shared_ptr<const LabelTagsSnapshot> labelTags()
     {
-        TagProperty prop;
-        prop.tagId   = id;
-        TagPropertiesRange range;
-        range.first  = std::lower_bound(tagProperties.begin(), tagProperties.end(), prop, lessThanForTagProperty);
-        range.second = std::upper_bound(range.first, tagProperties.end(), prop, lessThanForTagProperty);
+        std::shared_ptr<const LabelTagsSnapshot> current = std::atomic_load(&labelTagsData);
+        const int changes                                = labelTagsChanges.loadAcquire();
 
-        return range;
+        if (!initialized || (current->changes == changes))
+        {
+            return current;
+        }
+
+        std::shared_ptr<LabelTagsSnapshot> snapshot = std::make_shared<LabelTagsSnapshot>(changes);
+
+        QVector<int> colorTags(NumberOfColorLabels);
+        colorTags[NoColorLabel] = q->getOrCreateInternalTag(InternalTagName::colorLabelNone());
+        colorTags[RedLabel]     = q->getOrCreateInternalTag(InternalTagName::colorLabelRed());
+        colorTags[OrangeLabel]  = q->getOrCreateInternalTag(InternalTagName::colorLabelOrange());
+        colorTags[YellowLabel]  = q->getOrCreateInternalTag(InternalTagName::colorLabelYellow());
+        colorTags[GreenLabel]   = q->getOrCreateInternalTag(InternalTagName::colorLabelGreen());
+        colorTags[BlueLabel]    = q->getOrCreateInternalTag(InternalTagName::colorLabelBlue());
+        colorTags[MagentaLabel] = q->getOrCreateInternalTag(InternalTagName::colorLabelMagenta());
+        colorTags[GrayLabel]    = q->getOrCreateInternalTag(InternalTagName::colorLabelGray());
+        colorTags[BlackLabel]   = q->getOrCreateInternalTag(InternalTagName::colorLabelBlack());
+        colorTags[WhiteLabel]   = q->getOrCreateInternalTag(InternalTagName::colorLabelWhite());
+
+        QVector<int> pickTags(NumberOfPickLabels);
+        pickTags[NoPickLabel]   = q->getOrCreateInternalTag(InternalTagName::pickLabelNone());
+        pickTags[RejectedLabel] = q->getOrCreateInternalTag(InternalTagName::pickLabelRejected());
+        pickTags[PendingLabel]  = q->getOrCreateInternalTag(InternalTagName::pickLabelPending());
+        pickTags[AcceptedLabel] = q->getOrCreateInternalTag(InternalTagName::pickLabelAccepted());
+
+        snapshot->colorLabelsTags = colorTags;
+        snapshot->pickLabelsTags  = pickTags;
+
+        return publish<LabelTagsSnapshot>(&labelTagsData, snapshot);
     }
 
-    inline TagPropertiesConstIterator toNextTag(TagPropertiesConstIterator it) const
+    inline TagPropertiesConstIterator toNextTag(const TagPropertiesSnapshot& props, TagPropertiesConstIterator it) const
     {
         // increment iterator until the next tagid is reached
 
         int currentId = it->tagId;
 
-        for (++it ; it != tagProperties.end() ; ++it)
+        for (++it ; it != props.tagProperties.end() ; ++it)
         {
             if (it->tagId != currentId)
             {
@@ -214,67 +717,105 @@ public:
         return std::binary_search(list.constBegin(), list.constEnd(), value);
     }
 
-    void checkLabelTags()
+    int tagForPath(const TagsSnapshot& snapshot, const QString& path) const
     {
-        if (needUpdateLabelTags && initialized)
+        // The path is usually given as stored, without empty parts.
+
+        int start = path.startsWith(QLatin1Char('/')) ? 1 : 0;
+
+        if ((start == path.size()) || path.endsWith(QLatin1Char('/')) ||
+            (path.indexOf(QLatin1String("//"), start) != -1))
+        {
+            return tagForPath(snapshot, path.split(QLatin1Char('/'), QT_SKIP_EMPTY_PARTS));
+        }
+
+        int tagID = snapshot.pathHash.value(start ? path.mid(start) : path);
+
+        // We only have one entry in tag hierarchy (no path),
+        // if only a tag exists, we can assign it to this.
+        // Otherwise we recreate it in the root.
+
+        if (!tagID && (path.indexOf(QLatin1Char('/'), start) == -1))
         {
-            QVector<int> colorTags(NumberOfColorLabels);
-            colorTags[NoColorLabel] = q->getOrCreateInternalTag(InternalTagName::colorLabelNone());
-            colorTags[RedLabel]     = q->getOrCreateInternalTag(InternalTagName::colorLabelRed());
-            colorTags[OrangeLabel]  = q->getOrCreateInternalTag(InternalTagName::colorLabelOrange());
-            colorTags[YellowLabel]  = q->getOrCreateInternalTag(InternalTagName::colorLabelYellow());
-            colorTags[GreenLabel]   = q->getOrCreateInternalTag(InternalTagName::colorLabelGreen());
-            colorTags[BlueLabel]    = q->getOrCreateInternalTag(InternalTagName::colorLabelBlue());
-            colorTags[MagentaLabel] = q->getOrCreateInternalTag(InternalTagName::colorLabelMagenta());
-            colorTags[GrayLabel]    = q->getOrCreateInternalTag(InternalTagName::colorLabelGray());
-            colorTags[BlackLabel]   = q->getOrCreateInternalTag(InternalTagName::colorLabelBlack());
-            colorTags[WhiteLabel]   = q->getOrCreateInternalTag(InternalTagName::colorLabelWhite());
-
-            QVector<int> pickTags(NumberOfPickLabels);
-            pickTags[NoPickLabel]   = q->getOrCreateInternalTag(InternalTagName::pickLabelNone());
-            pickTags[RejectedLabel] = q->getOrCreateInternalTag(InternalTagName::pickLabelRejected());
-            pickTags[PendingLabel]  = q->getOrCreateInternalTag(InternalTagName::pickLabelPending());
-            pickTags[AcceptedLabel] = q->getOrCreateInternalTag(InternalTagName::pickLabelAccepted());
-
-            QWriteLocker locker(&lock);
-            needUpdateLabelTags     = false;
-            colorLabelsTags         = colorTags;
-            pickLabelsTags          = pickTags;
+            const QList<int> possibleTagIds = snapshot.nameHash.values(start ? path.mid(start) : path);
+
+            if (possibleTagIds.size() == 1)
+            {
+                tagID = possibleTagIds.first();
+            }
         }
+
+        return tagID;
     }
 
-    // remember to call under lock
+    int tagForPath(const TagsSnapshot& snapshot, const QStringList& tagHierarchy) const
+    {
+        if (tagHierarchy.isEmpty())
+        {
+            return 0;
+        }
+
+        int tagID = snapshot.pathHash.value(tagHierarchy.join(QLatin1Char('/')));
+
+        if (!tagID && (tagHierarchy.size() == 1))
+        {
+            const QList<int> possibleTagIds = snapshot.nameHash.values(tagHierarchy.first());
+
+            if (possibleTagIds.size() == 1)
+            {
+                tagID = possibleTagIds.first();
+            }
+        }
+
+        return tagID;
+    }
 
-    QString tagPath(int id, LeadingSlashPolicy slashPolicy) const
+    /**
+     * Adds the tags of the path missing in the snapshot and in the created tags.
+     * Returns the id of the tag, 0 for an empty path, or -1 if the database failed.
+     */
+    int createTag(CoreDbAccess& access, const TagsSnapshot& snapshot,
+                  QHash<TagChildKey, int>& created, const QString& tagPathToCreate)
     {
-        QString path;
-        QList<TagShortInfo>::const_iterator it;
+        // split full tag "url" into list of single tag names
 
-        for (it = find(id) ; it != infos.constEnd() ; it = find(it->pid))
+        const QStringList tagHierarchy = tagPathToCreate.split(QLatin1Char('/'), QT_SKIP_EMPTY_PARTS);
+        int tagID                      = 0;
+
+        // Traverse hierarchy from top to bottom: the tag with the name and the
+        // parent found in the previous run.
+
+        Q_FOREACH (const QString& tagName, tagHierarchy)
         {
-            if (path.isNull())
+            const TagChildKey key(tagID, tagName);
+            int childID = snapshot.children.value(key);
+
+            if (!childID)
             {
-                path = it->name;
+                childID = created.value(key);
             }
-            else
+
+            if (!childID)
             {
-                if (it->name.contains(QLatin1String("_Digikam_root_tag_")))
-                {
-                    continue;
-                }
-                else
+                childID = access.db()->addTag(tagID, tagName, QString(), 0);
+
+                if (childID == -1)
                 {
-                    path = it->name + QLatin1Char('/') + path;
+                    // something wrong with DB
+
+                    return -1;
                 }
+
+                // change signals may be queued within a transaction. We know it changed.
+
+                tagsChanges.ref();
+                created.insert(key, childID);
             }
-        }
 
-        if (slashPolicy == IncludeLeadingSlash)
-        {
-            path.prepend(QLatin1Char('/'));
+            tagID = childID;
         }
 
-        return path;
+        return tagID;
     }
 
     QList<int> tagsForFragment(bool (QString::*stringFunction)(const QString&, Qt::CaseSensitivity cs) const,
@@ -282,21 +823,20 @@ public:
                                Qt::CaseSensitivity caseSensitivity,
                                HiddenTagsPolicy hiddenTagsPolicy)
     {
-        checkNameHash();
+        std::shared_ptr<const TagsSnapshot> snapshot = tags();
+        std::shared_ptr<const TagPropertiesSnapshot> props;
         QMultiMap<QString, int> idsMap;
         QMultiHash<QString, int>::const_iterator it;
         const bool excludeHiddenTags = (hiddenTagsPolicy == NoHiddenTags);
 
         if (excludeHiddenTags)
         {
-            checkProperties();
+            props = properties();
         }
 
-        QReadLocker locker(&lock);
-
-        for (it = nameHash.constBegin() ; it != nameHash.constEnd() ; ++it)
+        for (it = snapshot->nameHash.constBegin() ; it != snapshot->nameHash.constEnd() ; ++it)
         {
-            if ((!excludeHiddenTags || !internalTags.contains(it.value())) && (it.key().*stringFunction)(fragment, caseSensitivity))
+            if ((!excludeHiddenTags || !props->internalTags.contains(it.value())) && (it.key().*stringFunction)(fragment, caseSensitivity))
             {
                 idsMap.insert(it.key(), it.value());
             }
@@ -308,26 +848,6 @@ public:
 
 // ------------------------------------------------------------------------------------------
 
-class Q_DECL_HIDDEN ChangingDB
-{
-public:
-
-    explicit ChangingDB(TagsCache::Private* const dd)
-        : d(dd)
-    {
-        d->changingDB = true;
-    }
-
-    ~ChangingDB()
-    {
-        d->changingDB = false;
-    }
-
-    TagsCache::Private* const d;
-};
-
-// ------------------------------------------------------------------------------------------
-
 class Q_DECL_HIDDEN TagsCacheCreator
 {
 public:
@@ -370,10 +890,9 @@ void TagsCache::initialize()
 
 void TagsCache::invalidate()
 {
-    d->needUpdateInfos      = true;
-    d->needUpdateHash       = true;
-    d->needUpdateProperties = true;
-    d->needUpdateLabelTags  = true;
+    d->tagsChanges.ref();
+    d->propertiesChanges.ref();
+    d->labelTagsChanges.ref();
 }
 
 QLatin1String TagsCache::tagPathOfDigikamInternalTags(LeadingSlashPolicy slashPolicy)
@@ -404,12 +923,10 @@ QLatin1String TagsCache::propertyNameExcludedFromWriting()
 
 QString TagsCache::tagName(int id) const
 {
-    d->checkInfos();
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
+    QList<TagShortInfo>::const_iterator it       = snapshot->find(id);
 
-    QReadLocker locker(&d->lock);
-    QList<TagShortInfo>::const_iterator it = d->find(id);
-
-    if (it != d->infos.constEnd())
+    if (it != snapshot->infos.constEnd())
     {
         return it->name;
     }
@@ -437,30 +954,8 @@ QStringList TagsCache::tagNames(const QList<int>& ids, HiddenTagsPolicy hiddenTa
 
 QString TagsCache::tagPath(int id, LeadingSlashPolicy slashPolicy) const
 {
-    d->checkInfos();
-
-    QString path;
-    QReadLocker locker(&d->lock);
-    QList<TagShortInfo>::const_iterator it;
-
-    for (it = d->find(id) ; it != d->infos.constEnd() ; it = d->find(it->pid))
-    {
-        if (path.isNull())
-        {
-            path = it->name;
-        }
-        else
-        {
-            if ((it->name).contains(QRegularExpression(QLatin1String("(_Digikam_root_tag_/|/_Digikam_root_tag_|_Digikam_root_tag_)"))))
-            {
-                continue;
-            }
-            else
-            {
-                path = it->name + QLatin1Char('/') + path;
-            }
-        }
-    }
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
+    QString path                                 = snapshot->paths.value(id);
 
     if (slashPolicy == IncludeLeadingSlash)
     {
@@ -491,18 +986,18 @@ QStringList TagsCache::tagPaths(const QList<int>& ids, LeadingSlashPolicy slashP
 
 QList<int> TagsCache::tagsForName(const QString& tagName, HiddenTagsPolicy hiddenTagsPolicy) const
 {
-    d->checkNameHash();
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
 
     if (hiddenTagsPolicy == NoHiddenTags)
     {
-        d->checkProperties();
+        std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
         QList<int> ids;
-        QReadLocker locker(&d->lock);
         QMultiHash<QString, int>::const_iterator it;
 
-        for (it = d->nameHash.constFind(tagName) ; (it != d->nameHash.constEnd()) && (it.key() == tagName) ; ++it)
+        for (it = snapshot->nameHash.constFind(tagName) ;
+             (it != snapshot->nameHash.constEnd()) && (it.key() == tagName) ; ++it)
         {
-            if (!d->internalTags.contains(it.value()))
+            if (!props->internalTags.contains(it.value()))
             {
                 ids << it.value();
             }
@@ -511,51 +1006,27 @@ QList<int> TagsCache::tagsForName(const QString& tagName, HiddenTagsPolicy hidde
         return ids;
     }
 
-    QReadLocker locker(&d->lock);
-
-    return d->nameHash.values(tagName);
+    return snapshot->nameHash.values(tagName);
 }
 
 int TagsCache::tagForName(const QString& tagName, int parentId) const
 {
-    d->checkNameHash();
-    QReadLocker locker(&d->lock);
-
-    QList<TagShortInfo>::const_iterator tag;
-
-    Q_FOREACH (int id, d->nameHash.values(tagName))
-    {
-        tag = d->find(id);
-
-        if (tag == d->infos.constEnd())
-        {
-            continue;    // error
-        }
-
-        if (tag->pid == parentId)
-        {
-            return tag->id;
-        }
-    }
-
-    return 0;
+    return d->tags()->children.value(TagChildKey(parentId, tagName));
 }
 
 bool TagsCache::hasTag(int id) const
 {
-    d->checkInfos();
-    QReadLocker locker(&d->lock);
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
 
-    return d->find(id) != d->infos.constEnd();
+    return (snapshot->find(id) != snapshot->infos.constEnd());
 }
 
 int TagsCache::parentTag(int id) const
 {
-    d->checkInfos();
-    QReadLocker locker(&d->lock);
-    QList<TagShortInfo>::const_iterator tag = d->find(id);
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
+    QList<TagShortInfo>::const_iterator tag      = snapshot->find(id);
 
-    if (tag != d->infos.constEnd())
+    if (tag != snapshot->infos.constEnd())
     {
         return tag->pid;
     }
@@ -565,15 +1036,13 @@ int TagsCache::parentTag(int id) const
 
 QList<int> TagsCache::parentTags(int id) const
 {
-    d->checkInfos();
-
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
     QList<int> ids;
-    QReadLocker locker(&d->lock);
     QList<TagShortInfo>::const_iterator it;
 
-    for (it = d->find(id);
-         (it != d->infos.constEnd()) && it->pid;
-         it = d->find(it->pid))
+    for (it = snapshot->find(id);
+         (it != snapshot->infos.constEnd()) && it->pid;
+         it = snapshot->find(it->pid))
     {
         if ((it->pid) != 0)
         {
@@ -586,196 +1055,105 @@ QList<int> TagsCache::parentTags(int id) const
 
 int TagsCache::tagForPath(const QString& path) const
 {
-    QString fullPath = path;
-
-    if (fullPath.startsWith(QLatin1Char('/')))
-    {
-        fullPath.remove(0, 1);
-    }
+    return d->tagForPath(*d->tags(), path);
+}
 
-    // split the path into its components
-    QStringList tagHierarchy = path.split(QLatin1Char('/'), QT_SKIP_EMPTY_PARTS);
+QList<int> TagsCache::tagsForPaths(const QStringList& tagPaths) const
+{
+    QList<int> ids;
 
-    if (tagHierarchy.isEmpty())
+    if (!tagPaths.isEmpty())
     {
-        return 0;
-    }
-
-    d->checkNameHash();
-    QReadLocker locker(&d->lock);
+        // All paths are looked up in the same snapshot.
 
-    // The last entry in the list is the leaf node tag name, we use this
-    // to lookup all the tag ids with that name, then find the one
-    // with a matching full path
+        std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
 
-    int tagID                       = 0;
-    QString tagName                 = tagHierarchy.last();
-    const QList<int> possibleTagIds = d->nameHash.values(tagName);
-
-    for (int const id : possibleTagIds)
-    {
-        if (d->tagPath(id, NoLeadingSlash) == fullPath)
+        Q_FOREACH (const QString& path, tagPaths)
         {
-            tagID = id;
-            break;
+            ids << d->tagForPath(*snapshot, path);
         }
     }
 
-    // We only have one entry in tagHierarchy (no path),
-    // if only a tag exists, we can assign it to this.
-    // Otherwise we recreate it in the root.
+    return ids;
+}
 
-    if ((tagID == 0)               &&
-        (tagHierarchy.size() == 1) &&
-        (possibleTagIds.size() == 1))
-    {
-        tagID = possibleTagIds.first();
-    }
+int TagsCache::createTag(const QString& tagPathToCreate)
+{
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
+    QHash<TagChildKey, int> created;
+    CoreDbAccess access;
 
-    return tagID;
+    return d->createTag(access, *snapshot, created, tagPathToCreate);
 }
 
-QList<int> TagsCache::tagsForPaths(const QStringList& tagPaths) const
+QList<int> TagsCache::createTags(const QStringList& tagPaths)
 {
     QList<int> ids;
 
     if (!tagPaths.isEmpty())
     {
+        std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
+        QHash<TagChildKey, int> created;
+        CoreDbAccess access;
+        CoreDbTransaction transaction(&access);
+
         Q_FOREACH (const QString& path, tagPaths)
         {
-            ids << tagForPath(path);
+            ids << d->createTag(access, *snapshot, created, path);
         }
     }
 
     return ids;
 }
 
-int TagsCache::createTag(const QString& tagPathToCreate)
+QList<int> TagsCache::getOrCreateTags(const QStringList& tagPaths)
 {
-    // split full tag "url" into list of single tag names
-
-    QStringList tagHierarchy = tagPathToCreate.split(QLatin1Char('/'), QT_SKIP_EMPTY_PARTS);
+    QList<int> ids;
 
-    if (tagHierarchy.isEmpty())
+    if (tagPaths.isEmpty())
     {
-        return 0;
+        return ids;
     }
 
-    d->checkNameHash();
-
-    int  tagID                 = 0;
-    bool parentTagExisted      = true;
-    int parentTagIDForCreation = 0;
-    QStringList tagsToCreate;
+    std::shared_ptr<const TagsSnapshot> snapshot = d->tags();
+    QList<int> missing;
 
+    for (int i = 0 ; i < tagPaths.size() ; ++i)
     {
-        int  parentTagID = 0;
-        QReadLocker locker(&d->lock);
-
-        // Traverse hierarchy from top to bottom
+        ids << d->tagForPath(*snapshot, tagPaths.at(i));
 
-        Q_FOREACH (const QString& tagName, tagHierarchy)
+        if (!ids.last())
         {
-            tagID = 0;
-
-            // if the parent tag did not exist, we need not check if the child exists
-
-            if (parentTagExisted)
-            {
-                QList<TagShortInfo>::const_iterator tag;
-
-                // find the tag with tag name according to tagHierarchy,
-                // and parent ID identical to the ID of the tag we found in
-                // the previous run.
-
-                Q_FOREACH (int id, d->nameHash.values(tagName))
-                {
-                    tag = d->find(id);
-
-                    if ((tag != d->infos.constEnd()) && (tag->pid == parentTagID))
-                    {
-                        tagID = tag->id;
-                        break;
-                    }
-                }
-            }
-
-            if (tagID)
-            {
-                // tag already found in DB
-
-                parentTagID      = tagID;
-                parentTagExisted = true;
-
-                continue;
-            }
-            else
-            {
-                tagsToCreate << tagName;
-
-                if (parentTagExisted)
-                {
-                    parentTagIDForCreation = parentTagID;
-                }
-
-                parentTagID      = 0;
-                parentTagExisted = false;
-            }
+            missing << i;
         }
     }
 
+    if (missing.isEmpty())
     {
-        CoreDbAccess access;
-
-        Q_FOREACH (const QString& tagName, tagsToCreate)
-        {
-            tagID = access.db()->addTag(parentTagIDForCreation, tagName, QString(), 0);
-
-            if (tagID == -1)
-            {
-                // something wrong with DB
-
-                break;
-            }
-            else
-            {
-                // change signals may be queued within a transaction. We know it changed.
-
-                d->needUpdateInfos = true;
-                d->needUpdateHash  = true;
-            }
-
-            parentTagIDForCreation = tagID;
-        }
+        return ids;
     }
 
-    return tagID;
-}
-
-QList<int> TagsCache::createTags(const QStringList& tagPaths)
-{
-    QList<int> ids;
+    // All missing tags are added in one transaction, the tags added for a path
+    // being reused for the next ones.
 
-    if (!tagPaths.isEmpty())
     {
-        Q_FOREACH (const QString& path, tagPaths)
+        QHash<TagChildKey, int> created;
+        CoreDbAccess access;
+        CoreDbTransaction transaction(&access);
+
+        Q_FOREACH (int i, missing)
         {
-            ids << createTag(path);
+            ids[i] = d->createTag(access, *snapshot, created, tagPaths.at(i));
         }
     }
 
-    return ids;
-}
-
-QList<int> TagsCache::getOrCreateTags(const QStringList& tagPaths)
-{
-    QList<int> ids;
+    // See getOrCreateTag() about the tags created concurrently.
 
-    if (!tagPaths.isEmpty())
+    Q_FOREACH (int i, missing)
     {
-        Q_FOREACH (const QString& path, tagPaths)
+        if (ids.at(i) == -1)
         {
-            ids << getOrCreateTag(path);
+            ids[i] = tagForPath(tagPaths.at(i));
         }
     }
 
@@ -818,9 +1196,8 @@ int TagsCache::getOrCreateTagWithProperty(const QString& tagPath, const QString&
 
 bool TagsCache::hasProperty(int tagId, const QString& property, const QString& value) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
-    TagPropertiesRange range = d->findProperties(tagId);
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
+    TagPropertiesRange range                           = props->findProperties(tagId);
 
     for (TagPropertiesConstIterator it = range.first ; it != range.second ; ++it)
     {
@@ -835,9 +1212,8 @@ bool TagsCache::hasProperty(int tagId, const QString& property, const QString& v
 
 QString TagsCache::propertyValue(int tagId, const QString& property) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
-    TagPropertiesRange range = d->findProperties(tagId);
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
+    TagPropertiesRange range                           = props->findProperties(tagId);
 
     for (TagPropertiesConstIterator it = range.first ; it != range.second ; ++it)
     {
@@ -852,9 +1228,8 @@ QString TagsCache::propertyValue(int tagId, const QString& property) const
 
 QStringList TagsCache::propertyValues(int tagId, const QString& property) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
-    TagPropertiesRange range = d->findProperties(tagId);
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
+    TagPropertiesRange range                           = props->findProperties(tagId);
     QStringList values;
 
     for (TagPropertiesConstIterator it = range.first ; it != range.second ; ++it)
@@ -877,11 +1252,9 @@ QStringList TagsCache::propertyValues(int tagId, const QString& property) const
 
 QMap<QString, QString> TagsCache::properties(int tagId) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
     QMap<QString, QString> map;
-    TagPropertiesRange range = d->findProperties(tagId);
-    QStringList values;
+    TagPropertiesRange range                           = props->findProperties(tagId);
 
     for (TagPropertiesConstIterator it = range.first ; it != range.second ; ++it)
     {
@@ -893,11 +1266,16 @@ QMap<QString, QString> TagsCache::properties(int tagId) const
 
 QList<int> TagsCache::tagsWithProperty(const QString& property, const QString& value) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
-    QList<int>  ids;
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
+
+    if (value.isNull())
+    {
+        return props->tagsWithProperty.value(property);
+    }
 
-    for (TagPropertiesConstIterator it = d->tagProperties.constBegin() ; it != d->tagProperties.constEnd() ; )
+    QList<int> ids;
+
+    for (TagPropertiesConstIterator it = props->tagProperties.constBegin() ; it != props->tagProperties.constEnd() ; )
     {
         // sort out invalid entries, see bug #277169
 
@@ -910,7 +1288,7 @@ QList<int> TagsCache::tagsWithProperty(const QString& property, const QString& v
         if (d->compareProperty(it, property, value))
         {
             ids << it->tagId;
-            it = d->toNextTag(it);
+            it = d->toNextTag(*props, it);
         }
         else
         {
@@ -923,46 +1301,25 @@ QList<int> TagsCache::tagsWithProperty(const QString& property, const QString& v
 
 QList<int> TagsCache::tagsWithPropertyCached(const QString& property) const
 {
-    d->checkProperties();
-    {
-        QReadLocker locker(&d->lock);
-        QHash<QString, QList<int> >::const_iterator it;
-        it = d->tagsWithProperty.constFind(property);
-
-        if (it != d->tagsWithProperty.constEnd())
-        {
-            return it.value();
-        }
-    }
-
-    QList<int> tags = tagsWithProperty(property);
+    // The tags of all properties are computed with the snapshot of the properties.
 
-    {
-        QWriteLocker locker(&d->lock);
-        d->tagsWithProperty[property] = tags;
-    }
-
-    return tags;
+    return tagsWithProperty(property);
 }
 
 bool TagsCache::isInternalTag(int tagId) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
-
-    return d->internalTags.contains(tagId);
+    return d->properties()->internalTags.contains(tagId);
 }
 
 QList<int> TagsCache::publicTags(const QList<int>& tagIds) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
 
     QList<int>::const_iterator it, it2;
 
     for (it = tagIds.begin() ; it != tagIds.end() ; ++it)
     {
-        if (d->internalTags.contains(*it))
+        if (props->internalTags.contains(*it))
         {
             break;
         }
@@ -987,7 +1344,7 @@ QList<int> TagsCache::publicTags(const QList<int>& tagIds) const
 
     for ( ; it2 != tagIds.end() ; ++it2)
     {
-        if (!d->internalTags.contains(*it2))
+        if (!props->internalTags.contains(*it2))
         {
             publicIds << *it2;
         }
@@ -998,12 +1355,11 @@ QList<int> TagsCache::publicTags(const QList<int>& tagIds) const
 
 bool TagsCache::containsPublicTags(const QList<int>& tagIds) const
 {
-    d->checkProperties();
-    QReadLocker locker(&d->lock);
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
 
     Q_FOREACH (int id, tagIds)
     {
-        if (!d->internalTags.contains(id))
+        if (!props->internalTags.contains(id))
         {
             return true;
         }
@@ -1014,15 +1370,14 @@ bool TagsCache::containsPublicTags(const QList<int>& tagIds) const
 
 bool TagsCache::canBeWrittenToMetadata(int tagId) const
 {
-    // as long as we always call isInternalTag first, no need to call checkProperties() again
-    //d->checkProperties();
+    std::shared_ptr<const TagPropertiesSnapshot> props = d->properties();
 
-    if (isInternalTag(tagId))
+    if (props->internalTags.contains(tagId))
     {
         return false;
     }
 
-    if (d->sortedListContains(tagsWithPropertyCached(propertyNameExcludedFromWriting()), tagId))
+    if (d->sortedListContains(props->tagsWithProperty.value(propertyNameExcludedFromWriting()), tagId))
     {
         return false;
     }
@@ -1048,10 +1403,7 @@ void TagsCache::slotTagChanged(const TagChangeset& changeset)
         Q_EMIT tagAboutToBeDeleted(name);
     }
 
-    if (!d->changingDB && (changeset.operation() != TagChangeset::IconChanged))
-    {
-        invalidate();
-    }
+    d->applyTagChange(changeset);
 
     if      (changeset.operation() == TagChangeset::Added)
     {
@@ -1070,38 +1422,28 @@ int TagsCache::tagForColorLabel(int label)
         return 0;
     }
 
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
-
-    return d->colorLabelsTags[label];
+    return d->labelTags()->colorLabelsTags[label];
 }
 
 QVector<int> TagsCache::colorLabelTags()
 {
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
-
-    return d->colorLabelsTags;
+    return d->labelTags()->colorLabelsTags;
 }
 
 int TagsCache::colorLabelForTag(int tagId)
 {
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
-
-    return d->colorLabelsTags.indexOf(tagId);
+    return d->labelTags()->colorLabelsTags.indexOf(tagId);
 }
 
 int TagsCache::colorLabelFromTags(QList<int> tagIds)
 {
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
+    std::shared_ptr<const LabelTagsSnapshot> labels = d->labelTags();
 
     Q_FOREACH (int tagId, tagIds)
     {
         for (int i = FirstColorLabel ; i <= LastColorLabel ; ++i)
         {
-            if (d->colorLabelsTags[i] == tagId)
+            if (labels->colorLabelsTags[i] == tagId)
             {
                 return i;
             }
@@ -1118,38 +1460,28 @@ int TagsCache::tagForPickLabel(int label)
         return 0;
     }
 
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
-
-    return d->pickLabelsTags[label];
+    return d->labelTags()->pickLabelsTags[label];
 }
 
 QVector<int> TagsCache::pickLabelTags()
 {
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
-
-    return d->pickLabelsTags;
+    return d->labelTags()->pickLabelsTags;
 }
 
 int TagsCache::pickLabelForTag(int tagId)
 {
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
-
-    return d->pickLabelsTags.indexOf(tagId);
+    return d->labelTags()->pickLabelsTags.indexOf(tagId);
 }
 
 int TagsCache::pickLabelFromTags(QList<int> tagIds)
 {
-    d->checkLabelTags();
-    QReadLocker locker(&d->lock);
+    std::shared_ptr<const LabelTagsSnapshot> labels = d->labelTags();
 
     Q_FOREACH (int tagId, tagIds)
     {
         for (int i = FirstPickLabel ; i <= LastPickLabel ; ++i)
         {
-            if (d->pickLabelsTags[i] == tagId)
+            if (labels->pickLabelsTags[i] == tagId)
             {
                 return i;
             }
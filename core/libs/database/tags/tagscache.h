@@ -314,7 +314,6 @@ private:
 
     friend class CoreDbAccess;
     friend class TagsCacheCreator;
-    friend class ChangingDB;
 
 private:
 
@@ -0,0 +1,446 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : single pass engine to apply chained per-pixel filters
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgpointfilterpipeline.h"
+
+// Qt includes
+
+#include <QScopedPointer>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgfiltermanager.h"
+#include "dimgpixelconverter.h"
+#include "dimgthreadedfilter.h"
+#include "bcgfilter.h"
+#include "bwsepiafilter.h"
+#include "cbfilter.h"
+#include "curvesfilter.h"
+#include "hslfilter.h"
+#include "levelsfilter.h"
+#include "mixerfilter.h"
+#include "wbfilter.h"
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN DImgPointFilterPipeline::Private
+{
+public:
+
+    /**
+     * A pass over each band: a lookup table fusing consecutive per-channel
+     * filters, or a single filter mixing the channels.
+     */
+    class Pass
+    {
+    public:
+
+        Pass() = default;
+
+    public:
+
+        QList<FilterAction> actions;
+        bool                lookupTable = false;
+
+        /// 4 tables of 256 or 65536 values, in the order of the channels in memory.
+        QVector<ushort>     table;
+    };
+
+public:
+
+    explicit Private()
+        : tablesReady     (false),
+          tablesSixteenBit(false),
+          tablesHasAlpha  (false)
+    {
+    }
+
+    static DImgThreadedFilter* createFilter(const FilterAction& action);
+    static bool isPerChannelFilter(const FilterAction& action);
+
+    void buildTables(bool sixteenBit, bool hasAlpha);
+    void buildTable(Pass& pass, bool sixteenBit, bool hasAlpha) const;
+
+    void processBands(const uchar* const src, uchar* const dst,
+                      int width, int height, bool sixteenBit, bool hasAlpha) const;
+
+public:
+
+    QList<FilterAction> actions;
+    QList<Pass>         passes;
+
+    bool                tablesReady;
+    bool                tablesSixteenBit;
+    bool                tablesHasAlpha;
+};
+
+DImgThreadedFilter* DImgPointFilterPipeline::Private::createFilter(const FilterAction& action)
+{
+    DImgThreadedFilter* const filter = DImgFilterManager::instance()->createFilter(action.identifier(),
+                                                                                   action.version());
+
+    if (!filter)
+    {
+        return nullptr;
+    }
+
+    filter->readParameters(action);
+
+    if (!filter->parametersSuccessfullyRead())
+    {
+        delete filter;
+
+        return nullptr;
+    }
+
+    return filter;
+}
+
+bool DImgPointFilterPipeline::Private::isPerChannelFilter(const FilterAction& action)
+{
+    // The value of each channel only depends on the value of the same channel.
+
+    const QString id = action.identifier();
+
+    return (
+            (id == CurvesFilter::FilterIdentifier()) ||
+            (id == LevelsFilter::FilterIdentifier()) ||
+            (id == BCGFilter::FilterIdentifier())    ||
+            (id == CBFilter::FilterIdentifier())
+           );
+}
+
+void DImgPointFilterPipeline::Private::buildTables(bool sixteenBit, bool hasAlpha)
+{
+    if (tablesReady && (tablesSixteenBit == sixteenBit) && (tablesHasAlpha == hasAlpha))
+    {
+        return;
+    }
+
+    for (int i = 0 ; i < passes.size() ; ++i)
+    {
+        if (passes.at(i).lookupTable)
+        {
+            buildTable(passes[i], sixteenBit, hasAlpha);
+        }
+    }
+
+    tablesReady      = true;
+    tablesSixteenBit = sixteenBit;
+    tablesHasAlpha   = hasAlpha;
+}
+
+void DImgPointFilterPipeline::Private::buildTable(Pass& pass, bool sixteenBit, bool hasAlpha) const
+{
+    // The filters are run once on an image holding all values of a channel.
+    // The tables are exact, as each channel is transformed independently.
+
+    const int size = sixteenBit ? 65536 : 256;
+    DImg ramp(256, size / 256, sixteenBit, hasAlpha);
+
+    if (sixteenBit)
+    {
+        ushort* const data = reinterpret_cast<ushort*>(ramp.bits());
+
+        for (int i = 0 ; i < size ; ++i)
+        {
+            data[4 * i]     = i;
+            data[4 * i + 1] = i;
+            data[4 * i + 2] = i;
+            data[4 * i + 3] = i;
+        }
+    }
+    else
+    {
+        uchar* const data = ramp.bits();
+
+        for (int i = 0 ; i < size ; ++i)
+        {
+            data[4 * i]     = i;
+            data[4 * i + 1] = i;
+            data[4 * i + 2] = i;
+            data[4 * i + 3] = i;
+        }
+    }
+
+    Q_FOREACH (const FilterAction& action, pass.actions)
+    {
+        QScopedPointer<DImgThreadedFilter> filter(createFilter(action));
+
+        if (!filter)
+        {
+            continue;
+        }
+
+        filter->setupFilter(ramp);
+        filter->startFilterDirectly();
+        ramp = filter->getTargetImage();
+    }
+
+    pass.table.resize(4 * size);
+
+    for (int c = 0 ; c < 4 ; ++c)
+    {
+        ushort* const table = pass.table.data() + c * size;
+
+        if (sixteenBit)
+        {
+            const ushort* const data = reinterpret_cast<const ushort*>(ramp.bits());
+
+            for (int i = 0 ; i < size ; ++i)
+            {
+                table[i] = data[4 * i + c];
+            }
+        }
+        else
+        {
+            const uchar* const data = ramp.bits();
+
+            for (int i = 0 ; i < size ; ++i)
+            {
+                table[i] = data[4 * i + c];
+            }
+        }
+    }
+}
+
+void DImgPointFilterPipeline::Private::processBands(const uchar* const src, uchar* const dst,
+                                                    int width, int height, bool sixteenBit, bool hasAlpha) const
+{
+    // A band of scanlines processed at once by all passes is small enough to stay in cache.
+
+    const qint64 bandBytes    = 4 * 1024 * 1024;
+    const qint64 bytesPerLine = (qint64)width * (sixteenBit ? 8 : 4);
+    const int    bandRows     = (int)qMax((qint64)16, bandBytes / qMax((qint64)1, bytesPerLine));
+    const QList<Pass> chain   = passes;
+
+    DImgPixelConverter::processRows(width, height,
+        [=](int begin, int end)
+        {
+            // The filters mixing the channels are created once for the range of rows,
+            // and run again on each band.
+
+            QList<DImgThreadedFilter*> filters;
+
+            Q_FOREACH (const Pass& pass, chain)
+            {
+                filters << (pass.lookupTable ? nullptr : createFilter(pass.actions.first()));
+            }
+
+            for (int y = begin ; y < end ; y += bandRows)
+            {
+                const int    rows   = qMin(bandRows, end - y);
+                const qint64 pixels = (qint64)width * rows;
+
+                DImg band(width, rows, sixteenBit, hasAlpha,
+                          const_cast<uchar*>(src + (qint64)y * bytesPerLine), true);
+
+                for (int i = 0 ; i < chain.size() ; ++i)
+                {
+                    const Pass& pass = chain.at(i);
+
+                    if (pass.lookupTable)
+                    {
+                        const int           size  = sixteenBit ? 65536 : 256;
+                        const ushort* const table = pass.table.constData();
+
+                        if (sixteenBit)
+                        {
+                            ushort* data = reinterpret_cast<ushort*>(band.bits());
+
+                            for (qint64 p = 0 ; p < pixels ; ++p, data += 4)
+                            {
+                                data[0] = table[data[0]];
+                                data[1] = table[size     + data[1]];
+                                data[2] = table[2 * size + data[2]];
+                                data[3] = table[3 * size + data[3]];
+                            }
+                        }
+                        else
+                        {
+                            uchar* data = band.bits();
+
+                            for (qint64 p = 0 ; p < pixels ; ++p, data += 4)
+                            {
+                                data[0] = (uchar)table[data[0]];
+                                data[1] = (uchar)table[size     + data[1]];
+                                data[2] = (uchar)table[2 * size + data[2]];
+                                data[3] = (uchar)table[3 * size + data[3]];
+                            }
+                        }
+                    }
+                    else if (filters.at(i))
+                    {
+                        filters.at(i)->setupFilter(band);
+                        filters.at(i)->startFilterDirectly();
+                        band = filters.at(i)->getTargetImage();
+                    }
+                }
+
+                memcpy(dst + (qint64)y * bytesPerLine, band.bits(), rows * bytesPerLine);
+            }
+
+            qDeleteAll(filters);
+        }
+    );
+}
+
+// --------------------------------------------------------------------------------------------
+
+DImgPointFilterPipeline::DImgPointFilterPipeline()
+    : d(new Private)
+{
+}
+
+DImgPointFilterPipeline::~DImgPointFilterPipeline()
+{
+    delete d;
+}
+
+bool DImgPointFilterPipeline::isPointFilter(const FilterAction& action)
+{
+    if (action.isNull() || (action.category() != FilterAction::ReproducibleFilter))
+    {
+        return false;
+    }
+
+    const QString id = action.identifier();
+
+    if ((id == WBFilter::FilterIdentifier())     ||
+        (id == CurvesFilter::FilterIdentifier()) ||
+        (id == LevelsFilter::FilterIdentifier()) ||
+        (id == BCGFilter::FilterIdentifier())    ||
+        (id == HSLFilter::FilterIdentifier())    ||
+        (id == CBFilter::FilterIdentifier())     ||
+        (id == MixerFilter::FilterIdentifier()))
+    {
+        return true;
+    }
+
+    if (id == BWSepiaFilter::FilterIdentifier())
+    {
+        // The infrared films blur the highlights, and the preview mode renders a thumbnail.
+
+        const int filmType = action.parameter(QLatin1String("filmType")).toInt();
+
+        return (
+                !action.parameter(QLatin1String("preview")).toBool()   &&
+                (filmType != BWSepiaContainer::BWIlfordSFX200)         &&
+                (filmType != BWSepiaContainer::BWIlfordSFX400)         &&
+                (filmType != BWSepiaContainer::BWIlfordSFX800)         &&
+                (filmType != BWSepiaContainer::BWKodakHIE)
+               );
+    }
+
+    return false;
+}
+
+bool DImgPointFilterPipeline::addFilterAction(const FilterAction& action)
+{
+    if (!isPointFilter(action))
+    {
+        return false;
+    }
+
+    QScopedPointer<DImgThreadedFilter> filter(Private::createFilter(action));
+
+    if (!filter)
+    {
+        qCDebug(DIGIKAM_DIMG_LOG) << "Cannot replay action" << action.identifier() << "in point filter pipeline";
+
+        return false;
+    }
+
+    d->actions << action;
+
+    if (Private::isPerChannelFilter(action) && !d->passes.isEmpty() && d->passes.last().lookupTable)
+    {
+        d->passes.last().actions << action;
+    }
+    else
+    {
+        Private::Pass pass;
+        pass.actions     << action;
+        pass.lookupTable  = Private::isPerChannelFilter(action);
+        d->passes        << pass;
+    }
+
+    d->tablesReady = false;
+
+    return true;
+}
+
+QList<FilterAction> DImgPointFilterPipeline::filterActions() const
+{
+    return d->actions;
+}
+
+bool DImgPointFilterPipeline::isEmpty() const
+{
+    return d->actions.isEmpty();
+}
+
+int DImgPointFilterPipeline::count() const
+{
+    return d->actions.count();
+}
+
+void DImgPointFilterPipeline::clear()
+{
+    d->actions.clear();
+    d->passes.clear();
+    d->tablesReady = false;
+}
+
+int DImgPointFilterPipeline::passCount() const
+{
+    return d->passes.count();
+}
+
+void DImgPointFilterPipeline::apply(DImg& image) const
+{
+    if (image.isNull() || d->actions.isEmpty())
+    {
+        return;
+    }
+
+    d->buildTables(image.sixteenBit(), image.hasAlpha());
+
+    // Each band is copied before to be processed, so the result can be written in place.
+
+    d->processBands(image.bits(), image.bits(), image.width(), image.height(),
+                    image.sixteenBit(), image.hasAlpha());
+}
+
+DImg DImgPointFilterPipeline::process(const DImg& image) const
+{
+    if (image.isNull() || d->actions.isEmpty())
+    {
+        return image.copyImageData();
+    }
+
+    d->buildTables(image.sixteenBit(), image.hasAlpha());
+
+    DImg dest(image.width(), image.height(), image.sixteenBit(), image.hasAlpha());
+
+    d->processBands(image.bits(), dest.bits(), image.width(), image.height(),
+                    image.sixteenBit(), image.hasAlpha());
+
+    return dest;
+}
+
+} // namespace Digikam
@@ -0,0 +1,104 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : single pass engine to apply chained per-pixel filters
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_POINT_FILTER_PIPELINE_H
+#define DIGIKAM_DIMG_POINT_FILTER_PIPELINE_H
+
+// Qt includes
+
+#include <QList>
+#include <QString>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+#include "filteraction.h"
+
+namespace Digikam
+{
+
+/**
+ * Applies a chain of per-pixel colour filters (white balance, curves, levels,
+ * brightness/contrast/gamma, hue/saturation/lightness, colour balance,
+ * channel mixer and black & white) described by their FilterActions,
+ * in one pass over the image.
+ *
+ * The chain is compiled once in passes: consecutive filters working on each
+ * channel independently (curves, levels, brightness/contrast/gamma and colour
+ * balance) are fused in one lookup table per channel, and each other filter
+ * is a pass of its own.
+ *
+ * The image is cut in bands of scanlines small enough to stay in the processor
+ * cache. All passes are applied on a band before the next band is processed,
+ * and bands are processed in parallel. The result is the same as applying the
+ * filters one after the other on the whole image, without the intermediate
+ * full size images.
+ */
+class DIGIKAM_EXPORT DImgPointFilterPipeline
+{
+public:
+
+    DImgPointFilterPipeline();
+    ~DImgPointFilterPipeline();
+
+    /**
+     * Returns true if the action describes a reproducible filter working
+     * on each pixel independently, which can be added to a pipeline.
+     */
+    static bool isPointFilter(const FilterAction& action);
+
+    /**
+     * Appends the action to the chain. Returns false and does nothing
+     * if the action cannot be applied by the pipeline.
+     */
+    bool addFilterAction(const FilterAction& action);
+
+    QList<FilterAction> filterActions() const;
+    bool isEmpty()                      const;
+    int  count()                        const;
+    void clear();
+
+    /**
+     * Returns the number of passes done on each band of the image
+     * to apply the chain, after the lookup tables fusion.
+     */
+    int  passCount()                    const;
+
+    /**
+     * Applies the chain in place on the image.
+     */
+    void apply(DImg& image)             const;
+
+    /**
+     * Returns a new image with the chain applied on a copy of the image data.
+     * The image itself is not changed.
+     */
+    DImg process(const DImg& image)     const;
+
+private:
+
+    // Disable
+    DImgPointFilterPipeline(const DImgPointFilterPipeline&)            = delete;
+    DImgPointFilterPipeline& operator=(const DImgPointFilterPipeline&) = delete;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DIMG_POINT_FILTER_PIPELINE_H
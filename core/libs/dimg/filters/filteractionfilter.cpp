@@ -29,6 +29,7 @@
 #include "digikam_export.h"
 #include "dimgbuiltinfilter.h"
 #include "dimgfiltermanager.h"
+#include "dimgpointfilterpipeline.h"
 #include "filteraction.h"
 
 namespace Digikam
@@ -177,8 +178,10 @@ void FilterActionFilter::filterImage()
 
     DImg img = m_orgImage;
 
-    Q_FOREACH (const FilterAction& action, d->actions)
+    for (int i = 0 ; i < d->actions.size() ; ++i)
     {
+        const FilterAction& action = d->actions.at(i);
+
         qCDebug(DIGIKAM_DIMG_LOG) << "Replaying action" << action.identifier();
 
         if (action.isNull())
@@ -186,6 +189,27 @@ void FilterActionFilter::filterImage()
             continue;
         }
 
+        // Consecutive per-pixel filters are applied together in a single pass.
+
+        DImgPointFilterPipeline pipeline;
+
+        for (int j = i ; (j < d->actions.size()) && pipeline.addFilterAction(d->actions.at(j)) ; ++j)
+        {
+        }
+
+        if (pipeline.count() > 1)
+        {
+            qCDebug(DIGIKAM_DIMG_LOG) << "Replaying" << pipeline.count() << "actions in a single pass";
+
+            img              = pipeline.process(img);
+            d->appliedActions << pipeline.filterActions();
+            i               += pipeline.count() - 1;
+            progress        += progressIncrement * pipeline.count();
+            postProgress((int)progress);
+
+            continue;
+        }
+
         if (DImgBuiltinFilter::isSupported(action.identifier()))
         {
             DImgBuiltinFilter filter(action);
@@ -19,9 +19,13 @@
 
 // Qt includes
 
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QFile>
+#include <QHash>
 #include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
 #include <QVarLengthArray>
 
 // KDE includes
@@ -32,6 +36,7 @@
 
 #include "digikam_debug.h"
 #include "dimgloaderobserver.h"
+#include "dimgpixelconverter.h"
 
 namespace Digikam
 {
@@ -75,6 +80,166 @@ public:
     int        proofIntent;
 };
 
+// --------------------------------------------------------------------------------------------
+
+/**
+ * The process wide cache of LittleCMS transforms.
+ *
+ * A LittleCMS 2 transform is read-only once created, and cmsDoTransform() can be called
+ * on the same transform from several threads at the same time. Transforms are shared between
+ * all IccTransform instances using the same profiles, formats, intents and flags, and are
+ * deleted when the last user releases them after they were evicted from the cache.
+ */
+class Q_DECL_HIDDEN IccTransformHandle
+{
+public:
+
+    explicit IccTransformHandle(cmsHTRANSFORM h)
+        : handle(h)
+    {
+    }
+
+    ~IccTransformHandle()
+    {
+        // Deleting a transform does not access the profiles.
+
+        dkCmsDeleteTransform(handle);
+    }
+
+public:
+
+    cmsHTRANSFORM handle;
+
+private:
+
+    Q_DISABLE_COPY(IccTransformHandle)
+};
+
+class Q_DECL_HIDDEN IccTransformCache
+{
+public:
+
+    typedef QSharedPointer<IccTransformHandle> Handle;
+
+public:
+
+    IccTransformCache()
+    {
+    }
+
+    Handle transform(TransformDescription& description, bool proofing)
+    {
+        const QByteArray key = cacheKey(description, proofing);
+
+        QMutexLocker cacheLock(&mutex);
+
+        Handle handle = transforms.value(key);
+
+        if (handle)
+        {
+            usage.removeOne(key);
+            usage.append(key);
+
+            return handle;
+        }
+
+        cmsHTRANSFORM created = nullptr;
+
+        {
+            // The profile handles are not thread-safe while LittleCMS reads them.
+
+            LcmsLock lock;
+
+            if (proofing)
+            {
+                created = dkCmsCreateProofingTransform(description.inputProfile,
+                                                       description.inputFormat,
+                                                       description.outputProfile,
+                                                       description.outputFormat,
+                                                       description.proofProfile,
+                                                       description.intent,
+                                                       description.proofIntent,
+                                                       description.transformFlags);
+            }
+            else
+            {
+                created = dkCmsCreateTransform(description.inputProfile,
+                                               description.inputFormat,
+                                               description.outputProfile,
+                                               description.outputFormat,
+                                               description.intent,
+                                               description.transformFlags);
+            }
+        }
+
+        if (!created)
+        {
+            return Handle();
+        }
+
+        handle = Handle(new IccTransformHandle(created));
+
+        transforms.insert(key, handle);
+        usage.append(key);
+
+        while (usage.size() > maxTransforms)
+        {
+            transforms.remove(usage.takeFirst());
+        }
+
+        return handle;
+    }
+
+private:
+
+    static void addProfile(QCryptographicHash& hash, IccProfile profile)
+    {
+        if (profile.isNull())
+        {
+            hash.addData("null", 4);
+        }
+        else
+        {
+            hash.addData(QCryptographicHash::hash(profile.data(), QCryptographicHash::Md5));
+        }
+    }
+
+    static QByteArray cacheKey(TransformDescription& description, bool proofing)
+    {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+
+        addProfile(hash, description.inputProfile);
+        addProfile(hash, description.outputProfile);
+        addProfile(hash, proofing ? description.proofProfile : IccProfile());
+
+        const int values[6] =
+        {
+            description.inputFormat,
+            description.outputFormat,
+            description.intent,
+            description.transformFlags,
+            description.proofIntent,
+            proofing
+        };
+
+        hash.addData(reinterpret_cast<const char*>(values), sizeof(values));
+
+        return hash.result();
+    }
+
+private:
+
+    const int                  maxTransforms = 32;
+
+    QMutex                     mutex;
+    QHash<QByteArray, Handle>  transforms;
+    QList<QByteArray>          usage;
+};
+
+Q_GLOBAL_STATIC(IccTransformCache, transformCache)
+
+// --------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN IccTransform::Private : public QSharedData
 {
 public:
@@ -132,8 +297,7 @@ public:
         if (handle)
         {
             currentDescription = TransformDescription();
-            LcmsLock lock;
-            dkCmsDeleteTransform(handle);
+            sharedHandle.reset();
             handle             = nullptr;
         }
     }
@@ -196,6 +360,7 @@ public:
     IccProfile                    builtinProfile;
 
     cmsHTRANSFORM                 handle;
+    IccTransformCache::Handle     sharedHandle;
     TransformDescription          currentDescription;
 };
 
@@ -523,13 +688,8 @@ bool IccTransform::open(TransformDescription& description)
 
     d->currentDescription = description;
 
-    LcmsLock lock;
-    d->handle = dkCmsCreateTransform(description.inputProfile,
-                                     description.inputFormat,
-                                     description.outputProfile,
-                                     description.outputFormat,
-                                     description.intent,
-                                     description.transformFlags);
+    d->sharedHandle = transformCache->transform(description, false);
+    d->handle       = d->sharedHandle ? d->sharedHandle->handle : nullptr;
 
     if (!d->handle)
     {
@@ -556,15 +716,8 @@ bool IccTransform::openProofing(TransformDescription& description)
 
     d->currentDescription = description;
 
-    LcmsLock lock;
-    d->handle = dkCmsCreateProofingTransform(description.inputProfile,
-                                             description.inputFormat,
-                                             description.outputProfile,
-                                             description.outputFormat,
-                                             description.proofProfile,
-                                             description.intent,
-                                             description.proofIntent,
-                                             description.transformFlags);
+    d->sharedHandle = transformCache->transform(description, true);
+    d->handle       = d->sharedHandle ? d->sharedHandle->handle : nullptr;
 
     if (!d->handle)
     {
@@ -693,84 +846,83 @@ bool IccTransform::apply(QImage& qimage)
 
 void IccTransform::transform(DImg& image, const TransformDescription& description, DImgLoaderObserver* const observer)
 {
-    const int bytesDepth    = image.bytesDepth();
-    const int pixels        = image.width() * image.height();
+    const int     width        = image.width();
+    const int     height       = image.height();
+    const int     bytesDepth   = image.bytesDepth();
+    const qint64  bytesPerLine = (qint64)width * bytesDepth;
+    uchar* const  data         = image.bits();
+    cmsHTRANSFORM handle       = d->handle;
 
-    // convert ten scanlines in a batch
+    // it is safe to use the same input and output buffer if the format is the same
 
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
+    const bool    inPlace      = (description.inputFormat == description.outputFormat);
 
-    // see dimgloader.cpp, granularity().
+    // The transform is shared and thread-safe: the image is converted by bands of scanlines,
+    // each band being processed in parallel. The progress is reported between the bands,
+    // from the current thread.
 
-    int granularity         = 1;
+    const int     bands        = observer ? qBound(1, height / 10, 20) : 1;
+    const int     rowsPerBand  = (height + bands - 1) / bands;
 
-    if (observer)
+    for (int band = 0 ; band < height ; band += rowsPerBand)
     {
-        granularity = (int)((pixels / (20 * 0.9)) / observer->granularity());
-    }
+        uchar* const bandData = data + (qint64)band * bytesPerLine;
 
-    int checkPoint = pixels;
+        DImgPixelConverter::processRows(width, qMin(rowsPerBand, height - band),
+            [=](int begin, int end)
+            {
+                // convert ten scanlines in a batch
 
-    // it is safe to use the same input and output buffer if the format is the same
+                const int step = 10;
 
-    if (description.inputFormat == description.outputFormat)
-    {
-        for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
-        {
-            int pixelsThisStep =  qMin(p, pixelsPerStep);
-            int size           =  pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-            data               += size;
+                if (inPlace)
+                {
+                    uchar* const rows = bandData + (qint64)begin * bytesPerLine;
+                    dkCmsDoTransform(handle, rows, rows, width * (end - begin));
 
-            if (observer && (p <= checkPoint))
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(0.1F + 0.9F * (1.0F - float(p) / float(pixels)));
-            }
-        }
-    }
-    else
-    {
-        QVarLengthArray<uchar> buffer(pixelsPerStep * bytesDepth);
+                    return;
+                }
 
-        for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
-        {
-            int pixelsThisStep  = qMin(p, pixelsPerStep);
-            int size            = pixelsThisStep * bytesDepth;
-            LcmsLock lock;
-            memcpy(buffer.data(), data, size);
-            dkCmsDoTransform(d->handle, buffer.data(), data, pixelsThisStep);
-            data               += size;
+                QVarLengthArray<uchar> buffer(bytesPerLine * step);
 
-            if (observer && (p <= checkPoint))
-            {
-                checkPoint -= granularity;
-                observer->progressInfo(0.1F + 0.9F * (1.0F - float(p) / float(pixels)));
+                for (int y = begin ; y < end ; y += step)
+                {
+                    const int    lines = qMin(step, end - y);
+                    uchar* const rows  = bandData + (qint64)y * bytesPerLine;
+
+                    memcpy(buffer.data(), rows, bytesPerLine * lines);
+                    dkCmsDoTransform(handle, buffer.data(), rows, width * lines);
+                }
             }
+        );
+
+        if (observer)
+        {
+            observer->progressInfo(0.1F + 0.9F * float(qMin(band + rowsPerBand, height)) / float(height));
         }
     }
 }
 
 void IccTransform::transform(QImage& image, const TransformDescription&)
 {
-    const int bytesDepth    = 4;
-    const int pixels        = image.width() * image.height();
+    const int     width        = image.width();
+    const qint64  bytesPerLine = image.bytesPerLine();
+    cmsHTRANSFORM handle       = d->handle;
 
-    // convert ten scanlines in a batch
+    // bits() detaches the image, call it once before to process rows in parallel.
 
-    const int pixelsPerStep = image.width() * 10;
-    uchar* data             = image.bits();
+    uchar* const  data         = image.bits();
 
-    for (int p = pixels ; p > 0 ; p -= pixelsPerStep)
-    {
-        int pixelsThisStep =  qMin(p, pixelsPerStep);
-        int size           =  pixelsThisStep * bytesDepth;
-        LcmsLock lock;
-        dkCmsDoTransform(d->handle, data, data, pixelsThisStep);
-        data               += size;
-    }
+    DImgPixelConverter::processRows(width, image.height(),
+        [data, bytesPerLine, width, handle](int begin, int end)
+        {
+            for (int y = begin ; y < end ; ++y)
+            {
+                uchar* const line = data + (qint64)y * bytesPerLine;
+                dkCmsDoTransform(handle, line, line, width);
+            }
+        }
+    );
 }
 
 void IccTransform::close()
@@ -74,6 +74,92 @@ int DImgLoader::granularity(DImgLoaderObserver* const observer, int total, float
     return (granularity ? granularity : 1);
 }
 
+int DImgLoader::scaledLoadingFactor(int width, int height) const
+{
+    QVariant attribute = imageGetAttribute(QLatin1String("scaledLoadingSize"));
+
+    if (!attribute.isValid() || (attribute.toInt() <= 0) || !(m_loadFlags & LoadImageData))
+    {
+        return 1;
+    }
+
+    int scaledLoadingSize = attribute.toInt();
+    int imgSize           = qMax(width, height);
+    int factor            = 1;
+
+    // Same rule than JPEG DCT scaling: the reduced image is never smaller than the requested size.
+
+    while (scaledLoadingSize * factor * 2 <= imgSize)
+    {
+        factor *= 2;
+    }
+
+    return factor;
+}
+
+void DImgLoader::addRowToScaledBoxes(const uchar* const src, int width, bool sixteenBit,
+                                     int factor, quint64* const sums)
+{
+    const int scaledWidth = (width + factor - 1) / factor;
+
+    for (int dx = 0, x = 0 ; dx < scaledWidth ; ++dx)
+    {
+        quint64* const sum = sums + dx * 4;
+        const int xEnd     = qMin(x + factor, width);
+
+        if (sixteenBit)
+        {
+            for ( ; x < xEnd ; ++x)
+            {
+                const unsigned short* const pix = reinterpret_cast<const unsigned short*>(src) + x * 4;
+                sum[0] += pix[0];
+                sum[1] += pix[1];
+                sum[2] += pix[2];
+                sum[3] += pix[3];
+            }
+        }
+        else
+        {
+            for ( ; x < xEnd ; ++x)
+            {
+                const uchar* const pix = src + x * 4;
+                sum[0] += pix[0];
+                sum[1] += pix[1];
+                sum[2] += pix[2];
+                sum[3] += pix[3];
+            }
+        }
+    }
+}
+
+void DImgLoader::writeScaledBoxesRow(quint64* const sums, int width, int rows, bool sixteenBit,
+                                     int factor, uchar* const dst)
+{
+    const int scaledWidth = (width + factor - 1) / factor;
+
+    for (int dx = 0 ; dx < scaledWidth ; ++dx)
+    {
+        quint64* const sum  = sums + dx * 4;
+        const quint64 count = (quint64)rows * (quint64)qMin(factor, width - dx * factor);
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            const quint64 value = (sum[c] + count / 2) / count;
+
+            if (sixteenBit)
+            {
+                reinterpret_cast<unsigned short*>(dst)[dx * 4 + c] = (unsigned short)value;
+            }
+            else
+            {
+                dst[dx * 4 + c] = (uchar)value;
+            }
+
+            sum[c] = 0;
+        }
+    }
+}
+
 unsigned char*& DImgLoader::imageData()
 {
     return m_image->m_priv->data;
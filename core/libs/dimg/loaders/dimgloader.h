@@ -133,6 +133,23 @@ protected:
     virtual bool            saveMetadata(const QString& filePath);
     virtual int             granularity(DImgLoaderObserver* const observer, int total, float progressSlice = 1.0F);
 
+    /**
+     * Reduced size loading helpers, for loaders which cannot scale in the decoder.
+     * scaledLoadingFactor() returns the power of two reduction factor to apply
+     * on an image of size @p width x @p height for the "scaledLoadingSize" image
+     * attribute, or 1 if no reduction is requested.
+     * Rows in DImg pixel layout are accumulated in @p sums, a zero-initialized
+     * array of 4 values per destination pixel, with addRowToScaledBoxes(), and
+     * writeScaledBoxesRow() writes the averaged destination row when the
+     * @p rows source rows of the boxes have been accumulated, and resets @p sums.
+     */
+    int                     scaledLoadingFactor(int width, int height)              const;
+
+    static void             addRowToScaledBoxes(const uchar* const src, int width, bool sixteenBit,
+                                                int factor, quint64* const sums);
+    static void             writeScaledBoxesRow(quint64* const sums, int width, int rows, bool sixteenBit,
+                                                int factor, uchar* const dst);
+
 protected:
 
     DImg*     m_image;
@@ -0,0 +1,229 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : pixel conversion between codecs data and DImg layout
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgpixelconverter.h"
+
+// Qt includes
+
+#include <QFuture>
+#include <QList>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+namespace Digikam
+{
+
+namespace
+{
+
+/**
+ * The loops are instantiated for each layout, so the inner loops have
+ * constant strides and offsets, and no branch.
+ */
+template <typename T, int SrcChannels, bool Rgb, bool KeepAlpha>
+void unpackRow(const T* src, T* dst, int width, T opaque, int shift)
+{
+    const int r = Rgb ? 0 : 2;
+    const int b = Rgb ? 2 : 0;
+
+    for (int x = 0 ; x < width ; ++x)
+    {
+        dst[0] = (T)(src[b] << shift);
+        dst[1] = (T)(src[1] << shift);
+        dst[2] = (T)(src[r] << shift);
+        dst[3] = KeepAlpha ? (T)(src[3] << shift) : opaque;
+
+        src   += SrcChannels;
+        dst   += 4;
+    }
+}
+
+template <typename T>
+void unpackRow(const T* src, T* dst, int width, int srcChannels,
+               DImgPixelConverter::ChannelOrder order, bool keepAlpha, T opaque, int shift)
+{
+    const bool rgb = (order == DImgPixelConverter::RGBOrder);
+
+    if (srcChannels == 4)
+    {
+        if (keepAlpha)
+        {
+            rgb ? unpackRow<T, 4, true,  true>(src, dst, width, opaque, shift)
+                : unpackRow<T, 4, false, true>(src, dst, width, opaque, shift);
+        }
+        else
+        {
+            rgb ? unpackRow<T, 4, true,  false>(src, dst, width, opaque, shift)
+                : unpackRow<T, 4, false, false>(src, dst, width, opaque, shift);
+        }
+    }
+    else
+    {
+        rgb ? unpackRow<T, 3, true,  false>(src, dst, width, opaque, shift)
+            : unpackRow<T, 3, false, false>(src, dst, width, opaque, shift);
+    }
+}
+
+template <typename S, typename D, int DstChannels, bool Rgb>
+void packRow(const S* src, D* dst, int width, int leftShift, int rightShift)
+{
+    const int r = Rgb ? 0 : 2;
+    const int b = Rgb ? 2 : 0;
+
+    for (int x = 0 ; x < width ; ++x)
+    {
+        dst[b] = (D)((src[0] << leftShift) >> rightShift);
+        dst[1] = (D)((src[1] << leftShift) >> rightShift);
+        dst[r] = (D)((src[2] << leftShift) >> rightShift);
+
+        if (DstChannels == 4)
+        {
+            dst[3] = (D)((src[3] << leftShift) >> rightShift);
+        }
+
+        src   += 4;
+        dst   += DstChannels;
+    }
+}
+
+template <typename S, typename D>
+void packRow(const S* src, D* dst, int width, int dstChannels,
+             DImgPixelConverter::ChannelOrder order, int leftShift, int rightShift)
+{
+    const bool rgb = (order == DImgPixelConverter::RGBOrder);
+
+    if (dstChannels == 4)
+    {
+        rgb ? packRow<S, D, 4, true> (src, dst, width, leftShift, rightShift)
+            : packRow<S, D, 4, false>(src, dst, width, leftShift, rightShift);
+    }
+    else
+    {
+        rgb ? packRow<S, D, 3, true> (src, dst, width, leftShift, rightShift)
+            : packRow<S, D, 3, false>(src, dst, width, leftShift, rightShift);
+    }
+}
+
+template <typename T, quint32 Max>
+void premultiplyRow(T* data, int width)
+{
+    for (int x = 0 ; x < width ; ++x)
+    {
+        const quint32 a = data[3];
+        data[0]         = (T)(((quint32)data[0] * a) / Max);
+        data[1]         = (T)(((quint32)data[1] * a) / Max);
+        data[2]         = (T)(((quint32)data[2] * a) / Max);
+        data           += 4;
+    }
+}
+
+} // namespace
+
+void DImgPixelConverter::toBGRA8(const uchar* const src, uchar* const dst, int width,
+                                 int srcChannels, ChannelOrder order, bool keepAlpha)
+{
+    unpackRow<uchar>(src, dst, width, srcChannels, order, keepAlpha, 0xFF, 0);
+}
+
+void DImgPixelConverter::toBGRA16(const ushort* const src, ushort* const dst, int width,
+                                  int srcChannels, ChannelOrder order, bool keepAlpha, int shift)
+{
+    unpackRow<ushort>(src, dst, width, srcChannels, order, keepAlpha, 0xFFFF, shift);
+}
+
+void DImgPixelConverter::fromBGRA8(const uchar* const src, uchar* const dst, int width,
+                                   int dstChannels, ChannelOrder order)
+{
+    packRow<uchar, uchar>(src, dst, width, dstChannels, order, 0, 0);
+}
+
+void DImgPixelConverter::fromBGRA16(const ushort* const src, ushort* const dst, int width,
+                                    int dstChannels, ChannelOrder order, int shift)
+{
+    packRow<ushort, ushort>(src, dst, width, dstChannels, order, 0, shift);
+}
+
+void DImgPixelConverter::fromBGRA16To8(const ushort* const src, uchar* const dst, int width,
+                                       int dstChannels, ChannelOrder order)
+{
+    packRow<ushort, uchar>(src, dst, width, dstChannels, order, 0, 8);
+}
+
+void DImgPixelConverter::fromBGRA8To16(const uchar* const src, ushort* const dst, int width,
+                                       int dstChannels, ChannelOrder order, int shift)
+{
+    packRow<uchar, ushort>(src, dst, width, dstChannels, order, shift, 0);
+}
+
+void DImgPixelConverter::swapBytes16(ushort* const data, qint64 count)
+{
+    ushort* ptr = data;
+
+    for (qint64 i = 0 ; i < count ; ++i)
+    {
+        ptr[i] = (ushort)((ptr[i] << 8) | (ptr[i] >> 8));
+    }
+}
+
+void DImgPixelConverter::premultiplyAlpha8(uchar* const data, int width)
+{
+    premultiplyRow<uchar, 255>(data, width);
+}
+
+void DImgPixelConverter::premultiplyAlpha16(ushort* const data, int width)
+{
+    premultiplyRow<ushort, 65535>(data, width);
+}
+
+void DImgPixelConverter::processRows(int width, int height, const std::function<void(int, int)>& rows)
+{
+    // Below this size, the threads overhead is larger than the conversion time.
+
+    const qint64 minPixelsByTask = 256 * 256;
+    const int    maxTasks        = qMin((qint64)QThreadPool::globalInstance()->maxThreadCount(),
+                                        ((qint64)width * (qint64)height) / minPixelsByTask);
+    const int    tasksCount      = qMin(maxTasks, height);
+
+    if (tasksCount < 2)
+    {
+        rows(0, height);
+
+        return;
+    }
+
+    QList<QFuture<void> > tasks;
+    const int step = (height + tasksCount - 1) / tasksCount;
+
+    for (int begin = step ; begin < height ; begin += step)
+    {
+        tasks.append(QtConcurrent::run(
+                                       [&rows, begin, step, height]()
+                                       {
+                                           rows(begin, qMin(begin + step, height));
+                                       }
+                                      )
+        );
+    }
+
+    // The current thread processes the first range.
+
+    rows(0, qMin(step, height));
+
+    Q_FOREACH (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+}
+
+} // namespace Digikam
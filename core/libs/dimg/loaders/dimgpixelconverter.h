@@ -0,0 +1,109 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : pixel conversion between codecs data and DImg layout
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_PIXEL_CONVERTER_H
+#define DIGIKAM_DIMG_PIXEL_CONVERTER_H
+
+// C++ includes
+
+#include <functional>
+
+// Qt includes
+
+#include <QtGlobal>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Row conversion helpers shared by the DImg loader plugins.
+ *
+ * DImg stores pixels as BGRA, with 8 or 16 bits by channel in host byte order.
+ * Codecs use interleaved rows with 3 or 4 channels, in RGB or BGR order.
+ * All conversion loops work on one row of @p width pixels, without branch
+ * in the inner loop, so the compiler can vectorize them.
+ */
+class DIGIKAM_EXPORT DImgPixelConverter
+{
+public:
+
+    enum ChannelOrder
+    {
+        RGBOrder = 0,
+        BGROrder
+    };
+
+public:
+
+    /**
+     * Codec to DImg: unpack a row of @p srcChannels (3 or 4) channels to BGRA.
+     * If @p keepAlpha is false or the source has no alpha, the alpha is set opaque.
+     * With 16 bits, values are shifted left by @p shift, to expand 10 or 12 bits data.
+     */
+    static void toBGRA8(const uchar* const src, uchar* const dst, int width,
+                        int srcChannels, ChannelOrder order, bool keepAlpha);
+
+    static void toBGRA16(const ushort* const src, ushort* const dst, int width,
+                         int srcChannels, ChannelOrder order, bool keepAlpha, int shift = 0);
+
+    /**
+     * DImg to codec: pack a BGRA row to @p dstChannels (3 or 4) channels.
+     * With 16 bits, values are shifted right by @p shift, to reduce to 10 or 12 bits data.
+     * fromBGRA16To8() reduces 16 bits data to 8 bits, as DImg::convertDepth().
+     * fromBGRA8To16() expands 8 bits data to 8 + @p shift bits.
+     */
+    static void fromBGRA8(const uchar* const src, uchar* const dst, int width,
+                          int dstChannels, ChannelOrder order);
+
+    static void fromBGRA16(const ushort* const src, ushort* const dst, int width,
+                           int dstChannels, ChannelOrder order, int shift = 0);
+
+    static void fromBGRA16To8(const ushort* const src, uchar* const dst, int width,
+                              int dstChannels, ChannelOrder order);
+
+    static void fromBGRA8To16(const uchar* const src, ushort* const dst, int width,
+                              int dstChannels, ChannelOrder order, int shift);
+
+    /**
+     * Swap in place the bytes of @p count 16 bits values.
+     */
+    static void swapBytes16(ushort* const data, qint64 count);
+
+    /**
+     * Multiply in place the color channels of a row of 4 channels pixels by the
+     * alpha value, stored as fourth channel.
+     */
+    static void premultiplyAlpha8(uchar* const data, int width);
+    static void premultiplyAlpha16(ushort* const data, int width);
+
+    /**
+     * Run @p rows on ranges of rows [begin, end[ covering @p height, in parallel
+     * using the global thread pool. Small images are processed in the current thread.
+     */
+    static void processRows(int width, int height, const std::function<void(int, int)>& rows);
+
+private:
+
+    // Disable
+    DImgPixelConverter()  = delete;
+    ~DImgPixelConverter() = delete;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DIMG_PIXEL_CONVERTER_H
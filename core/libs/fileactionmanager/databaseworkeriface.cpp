@@ -75,8 +75,7 @@ void FileActionMngrDatabaseWorker::changeTags(const FileActionItemInfoList& info
 
             hub.write(info, DisjointMetadata::PartialWrite);
 
-            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged) &&
-                d->shallSendForWriting(info.id()))
+            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged))
             {
                 forWriting << info;
             }
@@ -124,8 +123,7 @@ void FileActionMngrDatabaseWorker::assignPickLabel(const FileActionItemInfoList&
             hub.setPickLabel(pickId);
             hub.write(info, DisjointMetadata::PartialWrite);
 
-            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged) &&
-                d->shallSendForWriting(info.id()))
+            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged))
             {
                 forWriting << info;
             }
@@ -171,8 +169,7 @@ void FileActionMngrDatabaseWorker::assignColorLabel(const FileActionItemInfoList
             hub.setColorLabel(colorId);
             hub.write(info, DisjointMetadata::PartialWrite);
 
-            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged) &&
-                d->shallSendForWriting(info.id()))
+            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged))
             {
                 forWriting << info;
             }
@@ -219,8 +216,7 @@ void FileActionMngrDatabaseWorker::assignRating(const FileActionItemInfoList& in
             hub.setRating(rating);
             hub.write(info, DisjointMetadata::PartialWrite);
 
-            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged) &&
-                d->shallSendForWriting(info.id()))
+            if (hub.willWriteMetadata(DisjointMetadata::FullWriteIfChanged))
             {
                 forWriting << info;
             }
@@ -349,8 +345,6 @@ void FileActionMngrDatabaseWorker::applyMetadata(const FileActionItemInfoList& i
     {
         int flags = hub->changedFlags();
 
-        // don't filter by shallSendForWriting here; we write from the hub, not from freshly loaded data
-
         infos.schedulingForWrite(infos.size(), i18n("Writing metadata to files"), d->fileProgressCreator());
 
         for (ItemInfoTaskSplitter splitter(infos) ; splitter.hasNext() ; )
@@ -26,6 +26,7 @@
 
 #include "iteminfo.h"
 #include "progressmanager.h"
+#include "digikam_export.h"
 
 namespace Digikam
 {
@@ -65,7 +66,7 @@ protected:
 
 // -------------------------------------------------------------------------------------------------------------------
 
-class FileActionProgressItemContainer :public QObject, public TwoProgressItemsContainer
+class DIGIKAM_GUI_EXPORT FileActionProgressItemContainer :public QObject, public TwoProgressItemsContainer
 {
     Q_OBJECT
 
@@ -91,7 +92,7 @@ private:
 
 // -------------------------------------------------------------------------------------------------------------------
 
-class FileActionItemInfoList : public QList<ItemInfo>
+class DIGIKAM_GUI_EXPORT FileActionItemInfoList : public QList<ItemInfo>
 {
 public:
 
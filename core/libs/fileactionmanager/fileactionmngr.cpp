@@ -58,6 +58,9 @@ FileActionMngr::FileActionMngr()
 
     connect(d->fileWorker, SIGNAL(imageChangeFailed(QString,QStringList)),
             this, SIGNAL(signalImageChangeFailed(QString,QStringList)));
+
+    connect(d->writeQueue, SIGNAL(signalQueueDepthChanged(int)),
+            this, SIGNAL(signalPendingMetadataWrites(int)));
 }
 
 FileActionMngr::~FileActionMngr()
@@ -68,7 +71,11 @@ FileActionMngr::~FileActionMngr()
 
 bool FileActionMngr::requestShutDown()
 {
-    if (!isActive())
+    // Do not wait for the end of the write window of the queued metadata changes.
+
+    d->writeQueue->flush();
+
+    if (!isActive() && !d->writeQueue->pendingCount())
     {
         shutDown();
         return true;
@@ -83,6 +90,16 @@ bool FileActionMngr::requestShutDown()
     connect(d, SIGNAL(signalTasksFinished()),
             dialog, SLOT(accept()));
 
+    // The files are written by the threads of the queue: the dialog shows how many are left.
+
+    connect(d->writeQueue, &MetadataWriteQueue::signalQueueDepthChanged,
+            dialog, [dialog](int count)
+            {
+                dialog->setLabelText(i18ncp("@label", "Finishing tasks, writing metadata to 1 file",
+                                            "Finishing tasks, writing metadata to %1 files", count));
+            }
+    );
+
     dialog->exec();
 
     // Either, we finished and all is fine, or the user cancelled and we kill
@@ -96,6 +113,11 @@ void FileActionMngr::shutDown()
     d->dbWorker->deactivate();
     d->fileWorker->deactivate();
     d->dbWorker->wait();
+
+    // The queued metadata writes are only started here, on the threads of the queue,
+    // without blocking the caller: the queue waits for the last ones when it is destroyed.
+
+    d->writeQueue->flush();
     d->fileWorker->wait();
 }
 
@@ -104,6 +126,21 @@ bool FileActionMngr::isActive()
     return d->isActive();
 }
 
+int FileActionMngr::metadataWriteWindow() const
+{
+    return d->writeQueue->window();
+}
+
+int FileActionMngr::pendingMetadataWrites() const
+{
+    return d->writeQueue->pendingCount();
+}
+
+int FileActionMngr::averageMetadataWriteLatency() const
+{
+    return d->writeQueue->averageLatency();
+}
+
 void FileActionMngr::assignTags(const QList<qlonglong>& ids, const QList<int>& tagIDs)
 {
     assignTags(ItemInfoList(ids), tagIDs);
@@ -50,9 +50,23 @@ public:
     void shutDown();
     bool isActive();
 
+    /**
+     * The metadata changes to a file made during this delay in milliseconds
+     * are written together to the file. See MetaEngineSettingsContainer::metadataWriteWindow.
+     */
+    int  metadataWriteWindow()         const;
+
+    /**
+     * The number of files waiting for their metadata to be written,
+     * and the average delay in milliseconds before a change is written.
+     */
+    int  pendingMetadataWrites()       const;
+    int  averageMetadataWriteLatency() const;
+
 Q_SIGNALS:
 
     void signalImageChangeFailed(const QString& message, const QStringList& fileNames);
+    void signalPendingMetadataWrites(int count);
 
 public Q_SLOTS:
 
@@ -44,6 +44,8 @@ FileActionMngr::Private::Private(FileActionMngr* const qq)
         fileWorker->add(new FileActionMngrFileWorker(this));
     }
 
+    writeQueue = new MetadataWriteQueue(this);
+
     sleepTimer = new QTimer(this);
     sleepTimer->setSingleShot(true);
     sleepTimer->setInterval(1000);
@@ -101,12 +103,14 @@ void FileActionMngr::Private::connectToDatabaseWorker()
 
 void FileActionMngr::Private::connectDatabaseToFileWorker()
 {
+    // The metadata changes are merged per file in the write queue, before being written.
+
     connect(dbWorker, SIGNAL(writeMetadataToFiles(FileActionItemInfoList)),
-            fileWorker, SLOT(writeMetadataToFiles(FileActionItemInfoList)),
+            writeQueue, SLOT(enqueueAll(FileActionItemInfoList)),
             Qt::DirectConnection);
 
     connect(dbWorker, SIGNAL(writeMetadata(FileActionItemInfoList,int)),
-            fileWorker, SLOT(writeMetadata(FileActionItemInfoList,int)),
+            writeQueue, SLOT(enqueue(FileActionItemInfoList,int)),
             Qt::DirectConnection);
 
     connect(dbWorker, SIGNAL(writeOrientationToFiles(FileActionItemInfoList,int)),
@@ -125,30 +129,6 @@ bool FileActionMngr::Private::isActive() const
     return dbProgress.activeProgressItems || fileProgress.activeProgressItems;
 }
 
-bool FileActionMngr::Private::shallSendForWriting(qlonglong id)
-{
-    QMutexLocker lock(&mutex);
-
-    if (scheduledToWrite.contains(id))
-    {
-        return false;
-    }
-
-    scheduledToWrite << id;
-
-    return true;
-}
-
-void FileActionMngr::Private::startingToWrite(const QList<ItemInfo>& infos)
-{
-    QMutexLocker lock(&mutex);
-
-    Q_FOREACH (const ItemInfo& info, infos)
-    {
-        scheduledToWrite.remove(info.id());
-    }
-}
-
 void FileActionMngr::Private::slotSleepTimer()
 {
     if (!dbProgress.activeProgressItems)
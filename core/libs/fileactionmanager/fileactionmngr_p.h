@@ -18,8 +18,6 @@
 
 // Qt includes
 
-#include <QMutex>
-#include <QSet>
 #include <QTimer>
 
 // Local includes
@@ -29,6 +27,7 @@
 #include "fileactionimageinfolist.h"
 #include "databaseworkeriface.h"
 #include "metadatahub.h"
+#include "metadatawritequeue.h"
 #include "parallelworkers.h"
 
 
@@ -151,12 +150,6 @@ public:
 
     bool isActive() const;
 
-    /// db worker will send info to file worker if returns true
-    bool shallSendForWriting(qlonglong id);
-
-    /// file worker calls this when receiving a task
-    void startingToWrite(const QList<ItemInfo>& infos);
-
     void connectToDatabaseWorker();
     void connectDatabaseToFileWorker();
 
@@ -171,15 +164,14 @@ public Q_SLOTS:
 
 public:
 
-    QSet<qlonglong>                       scheduledToWrite;
     QString                               dbMessage;
     QString                               writerMessage;
-    QMutex                                mutex;
 
     FileActionMngr*                       q;
 
     DatabaseWorkerInterface*              dbWorker;
     ParallelAdapter<FileWorkerInterface>* fileWorker;
+    MetadataWriteQueue*                   writeQueue;
 
     QTimer*                               sleepTimer;
 
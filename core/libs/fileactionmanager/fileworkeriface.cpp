@@ -77,87 +77,8 @@ void FileActionMngrFileWorker::writeOrientationToFiles(const FileActionItemInfoL
     infos.finishedWriting();
 }
 
-void FileActionMngrFileWorker::writeMetadataToFiles(const FileActionItemInfoList& infos)
-{
-    d->startingToWrite(infos);
-
-    ScanController::instance()->suspendCollectionScan();
-
-    Q_FOREACH (const ItemInfo& info, infos)
-    {
-        MetadataHub hub;
-
-        if (state() == WorkerObject::Deactivating)
-        {
-            break;
-        }
-
-        hub.load(info);
-        QString filePath = info.filePath();
-
-        if (MetaEngineSettings::instance()->settings().useLazySync)
-        {
-            hub.write(filePath, MetadataHub::WRITE_ALL);
-        }
-        else
-        {
-            ScanController::FileMetadataWrite writeScope(info);
-            writeScope.changed(hub.write(filePath, MetadataHub::WRITE_ALL));
-        }
-
-        // hub emits fileMetadataChanged
-
-        infos.writtenToOne();
-    }
-
-    ScanController::instance()->resumeCollectionScan();
-
-    infos.finishedWriting();
-}
-
-void FileActionMngrFileWorker::writeMetadata(const FileActionItemInfoList& infos, int flags)
-{
-    d->startingToWrite(infos);
-
-    ScanController::instance()->suspendCollectionScan();
-
-    Q_FOREACH (const ItemInfo& info, infos)
-    {
-        MetadataHub hub;
-
-        if (state() == WorkerObject::Deactivating)
-        {
-            break;
-        }
-
-        hub.load(info);
-
-        // apply to file metadata
-
-        if (MetaEngineSettings::instance()->settings().useLazySync)
-        {
-            hub.writeToMetadata(info, (MetadataHub::WriteComponents)flags);
-        }
-        else
-        {
-            ScanController::FileMetadataWrite writeScope(info);
-            writeScope.changed(hub.writeToMetadata(info, (MetadataHub::WriteComponents)flags));
-        }
-
-        // hub emits fileMetadataChanged
-
-        infos.writtenToOne();
-    }
-
-    ScanController::instance()->resumeCollectionScan();
-
-    infos.finishedWriting();
-}
-
 void FileActionMngrFileWorker::transform(const FileActionItemInfoList& infos, int action)
 {
-    d->startingToWrite(infos);
-
     QStringList failedItems;
     ScanController::instance()->suspendCollectionScan();
 
@@ -34,8 +34,6 @@ class FileWorkerInterface : public WorkerObject         // clazy:exclude=ctor-mi
 public Q_SLOTS:
 
     virtual void writeOrientationToFiles(const FileActionItemInfoList&, int) {};
-    virtual void writeMetadataToFiles(const FileActionItemInfoList&)         {};
-    virtual void writeMetadata(const FileActionItemInfoList&, int)           {};
     virtual void transform(const FileActionItemInfoList&, int)               {};
 
 Q_SIGNALS:
@@ -60,8 +58,6 @@ public:
 public:
 
     void writeOrientationToFiles(const FileActionItemInfoList& infos, int orientation) override;
-    void writeMetadataToFiles(const FileActionItemInfoList& infos)                     override;
-    void writeMetadata(const FileActionItemInfoList& infos, int flags)                 override;
     void transform(const FileActionItemInfoList& infos, int orientation)               override;
 
 private:
@@ -0,0 +1,547 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : coalescing write-back queue of metadata to files
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "metadatawritequeue.h"
+
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStorageInfo>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "iteminfo.h"
+#include "metadatahub.h"
+#include "metaenginesettings.h"
+#include "scancontroller.h"
+#include "threadmanager.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+/// Delay before trying again to write an item still being written by a previous write.
+const int RETRY_DELAY = 100;
+
+class Q_DECL_HIDDEN MetadataWriteEntry
+{
+public:
+
+    ItemInfo                                                        info;
+    int                                                             flags   = 0;
+    int                                                             changes = 0;
+    qint64                                                          queued  = 0;
+    QList<QExplicitlySharedDataPointer<FileActionProgressItemContainer> > progress;
+};
+
+} // namespace
+
+class Q_DECL_HIDDEN MetadataWriteQueue::Private
+{
+public:
+
+    explicit Private()
+      : window          (2000),
+        threadsPerDevice(2),
+        timerRequested  (false),
+        lastDepth       (0),
+        writtenCount    (0),
+        latencySum      (0),
+        latencyMax      (0),
+        timer           (nullptr)
+    {
+        clock.start();
+    }
+
+    QThreadPool* poolFor(const QString& filePath, QObject* const parent);
+
+    /**
+     * The writes wait on the disks more than they use the cores: each storage device has
+     * its own pool, so a slow disk does not hold the others. A pool does not use more
+     * threads than the background jobs of the ThreadManager.
+     */
+    int poolThreads() const
+    {
+        return qMin(threadsPerDevice, ThreadManager::instance()->maximumJobThreads(ThreadManager::Background));
+    }
+
+    QList<QThreadPool*> allPools();
+    qint64 nextFlushDelay();
+
+    /// The number of items waiting or being written. The mutex must be locked.
+    int queueDepth() const;
+
+    /// Advances the progress of the entry and records its latency, once its file is written.
+    void written(const MetadataWriteEntry& entry);
+
+public:
+
+    int                                 window;
+    int                                 threadsPerDevice;
+
+    QMutex                              mutex;
+    QHash<qlonglong, MetadataWriteEntry> pending;
+    QSet<qlonglong>                     inFlight;
+    bool                                timerRequested;
+    int                                 lastDepth;
+
+    qint64                              writtenCount;
+    qint64                              latencySum;
+    qint64                              latencyMax;
+
+    QHash<QString, QByteArray>          devices;
+    QHash<QByteArray, QThreadPool*>     pools;
+
+    QElapsedTimer                       clock;
+    QTimer*                             timer;
+};
+
+QThreadPool* MetadataWriteQueue::Private::poolFor(const QString& filePath, QObject* const parent)
+{
+    const QString dir = QFileInfo(filePath).absolutePath();
+
+    {
+        QMutexLocker lock(&mutex);
+
+        QHash<QString, QByteArray>::const_iterator it = devices.constFind(dir);
+
+        if (it != devices.constEnd())
+        {
+            return pools.value(it.value());
+        }
+    }
+
+    // The storage of a directory is only looked up once, outside of the lock.
+
+    const QByteArray device = QStorageInfo(dir).device();
+
+    QMutexLocker lock(&mutex);
+
+    devices.insert(dir, device);
+    QThreadPool* pool = pools.value(device);
+
+    if (!pool)
+    {
+        pool = new QThreadPool(parent);
+        pool->setMaxThreadCount(poolThreads());
+        pools.insert(device, pool);
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Metadata write queue: new pool for storage device" << device;
+    }
+
+    return pool;
+}
+
+QList<QThreadPool*> MetadataWriteQueue::Private::allPools()
+{
+    QMutexLocker lock(&mutex);
+
+    return pools.values();
+}
+
+qint64 MetadataWriteQueue::Private::nextFlushDelay()
+{
+    QMutexLocker lock(&mutex);
+
+    if (pending.isEmpty())
+    {
+        return -1;
+    }
+
+    const qint64 now  = clock.elapsed();
+    qint64 delay      = -1;
+
+    for (QHash<qlonglong, MetadataWriteEntry>::const_iterator it = pending.constBegin() ;
+         it != pending.constEnd() ; ++it)
+    {
+        qint64 due = it.value().queued + window - now;
+
+        if (inFlight.contains(it.key()))
+        {
+            due = qMax(due, (qint64)RETRY_DELAY);
+        }
+
+        delay = (delay == -1) ? due : qMin(delay, due);
+    }
+
+    return qMax(delay, (qint64)0);
+}
+
+int MetadataWriteQueue::Private::queueDepth() const
+{
+    // An item changed while it is written is both pending and in flight.
+
+    int depth = pending.count();
+
+    Q_FOREACH (qlonglong id, inFlight)
+    {
+        if (!pending.contains(id))
+        {
+            depth++;
+        }
+    }
+
+    return depth;
+}
+
+void MetadataWriteQueue::Private::written(const MetadataWriteEntry& entry)
+{
+    Q_FOREACH (const QExplicitlySharedDataPointer<FileActionProgressItemContainer>& progress, entry.progress)
+    {
+        progress->written(1);
+    }
+
+    QMutexLocker lock(&mutex);
+
+    const qint64 latency = clock.elapsed() - entry.queued;
+    inFlight.remove(entry.info.id());
+    writtenCount++;
+    latencySum          += latency;
+    latencyMax           = qMax(latencyMax, latency);
+}
+
+// -----------------------------------------------------------------------------------------------
+
+MetadataWriteQueue::MetadataWriteQueue(QObject* const parent)
+    : QObject(parent),
+      d      (new Private)
+{
+    d->timer = new QTimer(this);
+    d->timer->setSingleShot(true);
+
+    connect(d->timer, SIGNAL(timeout()),
+            this, SLOT(slotFlushDue()));
+
+    d->window = qMax(0, MetaEngineSettings::instance()->settings().metadataWriteWindow);
+
+    connect(MetaEngineSettings::instance(), SIGNAL(signalSettingsChanged()),
+            this, SLOT(slotSettingsChanged()));
+}
+
+MetadataWriteQueue::~MetadataWriteQueue()
+{
+    flushAndWait();
+
+    delete d;
+}
+
+void MetadataWriteQueue::setWindow(int msecs)
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        d->window = qMax(0, msecs);
+    }
+
+    QMetaObject::invokeMethod(this, "slotScheduleFlush", Qt::QueuedConnection);
+}
+
+int MetadataWriteQueue::window() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->window;
+}
+
+void MetadataWriteQueue::setThreadsPerDevice(int count)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->threadsPerDevice = qMax(1, count);
+
+    Q_FOREACH (QThreadPool* const pool, d->pools)
+    {
+        pool->setMaxThreadCount(d->poolThreads());
+    }
+}
+
+int MetadataWriteQueue::threadsPerDevice() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->threadsPerDevice;
+}
+
+int MetadataWriteQueue::pendingCount() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return d->queueDepth();
+}
+
+int MetadataWriteQueue::averageLatency() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return (d->writtenCount ? (int)(d->latencySum / d->writtenCount) : 0);
+}
+
+int MetadataWriteQueue::maximumLatency() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return (int)d->latencyMax;
+}
+
+int MetadataWriteQueue::writtenCount() const
+{
+    QMutexLocker lock(&d->mutex);
+
+    return (int)d->writtenCount;
+}
+
+void MetadataWriteQueue::enqueue(const FileActionItemInfoList& infos, int flags)
+{
+    if (infos.isEmpty())
+    {
+        return;
+    }
+
+    bool schedule = false;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        const qint64 now = d->clock.elapsed();
+
+        Q_FOREACH (const ItemInfo& info, infos)
+        {
+            QHash<qlonglong, MetadataWriteEntry>::iterator it = d->pending.find(info.id());
+
+            if (it == d->pending.end())
+            {
+                it         = d->pending.insert(info.id(), MetadataWriteEntry());
+                it->info   = info;
+                it->queued = now;
+            }
+
+            it->flags |= flags;
+            it->changes++;
+            it->progress << infos.container;
+        }
+
+        if (!d->timerRequested)
+        {
+            d->timerRequested = true;
+            schedule          = true;
+        }
+    }
+
+    // The timer lives in the thread of the queue, while items are queued from the database worker.
+
+    if (schedule)
+    {
+        QMetaObject::invokeMethod(this, "slotScheduleFlush", Qt::QueuedConnection);
+    }
+
+    updateQueueDepth();
+}
+
+void MetadataWriteQueue::enqueueAll(const FileActionItemInfoList& infos)
+{
+    enqueue(infos, MetadataHub::WRITE_ALL);
+}
+
+void MetadataWriteQueue::flush()
+{
+    flushEntries(true);
+}
+
+void MetadataWriteQueue::flushAndWait()
+{
+    Q_FOREVER
+    {
+        flushEntries(true);
+
+        Q_FOREACH (QThreadPool* const pool, d->allPools())
+        {
+            pool->waitForDone();
+        }
+
+        if (pendingCount() == 0)
+        {
+            break;
+        }
+    }
+}
+
+void MetadataWriteQueue::writeToFile(const ItemInfo& info, int flags)
+{
+    // The values are read from the database now, so they include all the merged changes.
+
+    MetadataHub hub;
+    hub.load(info);
+
+    if (MetaEngineSettings::instance()->settings().useLazySync)
+    {
+        hub.writeToMetadata(info, (MetadataHub::WriteComponents)flags);
+    }
+    else
+    {
+        ScanController::FileMetadataWrite writeScope(info);
+        writeScope.changed(hub.writeToMetadata(info, (MetadataHub::WriteComponents)flags));
+    }
+
+    // hub emits fileMetadataChanged
+}
+
+void MetadataWriteQueue::slotSettingsChanged()
+{
+    const int msecs = MetaEngineSettings::instance()->settings().metadataWriteWindow;
+
+    if (msecs != window())
+    {
+        setWindow(msecs);
+    }
+}
+
+void MetadataWriteQueue::slotScheduleFlush()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        d->timerRequested = false;
+    }
+
+    const qint64 delay = d->nextFlushDelay();
+
+    if (delay == -1)
+    {
+        d->timer->stop();
+
+        return;
+    }
+
+    const int remaining = d->timer->isActive() ? d->timer->remainingTime() : -1;
+
+    if ((remaining == -1) || (delay < remaining))
+    {
+        d->timer->start((int)delay);
+    }
+}
+
+void MetadataWriteQueue::slotFlushDue()
+{
+    flushEntries(false);
+
+    const qint64 delay = d->nextFlushDelay();
+
+    if (delay != -1)
+    {
+        d->timer->start((int)delay);
+    }
+}
+
+void MetadataWriteQueue::flushEntries(bool all)
+{
+    QList<MetadataWriteEntry> batch;
+    int merged = 0;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        const qint64 now = d->clock.elapsed();
+
+        for (QHash<qlonglong, MetadataWriteEntry>::iterator it = d->pending.begin() ; it != d->pending.end() ; )
+        {
+            // An item still being written is written again after, never twice at the same time.
+
+            if (d->inFlight.contains(it.key()) || (!all && ((now - it->queued) < d->window)))
+            {
+                ++it;
+                continue;
+            }
+
+            d->inFlight << it.key();
+            merged += it->changes - 1;
+            batch  << it.value();
+            it      = d->pending.erase(it);
+        }
+    }
+
+    if (batch.isEmpty())
+    {
+        return;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Metadata write queue: writing" << batch.size() << "files,"
+                                 << merged << "changes merged," << pendingCount() << "queued";
+
+    // The collection scan is suspended until the last file of the batch is written.
+
+    ScanController::instance()->suspendCollectionScan();
+
+    QSharedPointer<QAtomicInt> remaining(new QAtomicInt(batch.size()));
+
+    Q_FOREACH (const MetadataWriteEntry& entry, batch)
+    {
+        QThreadPool* const pool = d->poolFor(entry.info.filePath(), this);
+
+        QtConcurrent::run(pool,
+            [this, entry, remaining]()
+            {
+                writeToFile(entry.info, entry.flags);
+                d->written(entry);
+
+                if (!remaining->deref())
+                {
+                    ScanController::instance()->resumeCollectionScan();
+                }
+
+                updateQueueDepth();
+            }
+        );
+    }
+}
+
+void MetadataWriteQueue::updateQueueDepth()
+{
+    int depth = 0;
+
+    {
+        QMutexLocker lock(&d->mutex);
+
+        depth = d->queueDepth();
+
+        if (depth == d->lastDepth)
+        {
+            return;
+        }
+
+        d->lastDepth = depth;
+
+        if (depth == 0)
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Metadata write queue: all files written, latency average"
+                                         << (d->writtenCount ? d->latencySum / d->writtenCount : 0)
+                                         << "ms, maximum" << d->latencyMax << "ms";
+        }
+    }
+
+    Q_EMIT signalQueueDepthChanged(depth);
+}
+
+} // namespace Digikam
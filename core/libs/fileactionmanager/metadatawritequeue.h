@@ -0,0 +1,149 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : coalescing write-back queue of metadata to files
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_METADATA_WRITE_QUEUE_H
+#define DIGIKAM_METADATA_WRITE_QUEUE_H
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "fileactionimageinfolist.h"
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Collects the items whose metadata must be written to the files, and writes
+ * each file once when no change was queued for it during a time window.
+ *
+ * The changes queued for the same item in the window are merged: the write
+ * components are added, and the item is written from the database once.
+ * Tagging, rating and captioning the same images thus rewrites each file
+ * only once. The latency of a change is bounded by the window, counted from
+ * the first change queued for the item.
+ *
+ * The files are written by a pool of threads per storage device, so that
+ * the writes to a slow disk do not hold the writes to the others.
+ *
+ * enqueue() can be called from any thread.
+ */
+class DIGIKAM_GUI_EXPORT MetadataWriteQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit MetadataWriteQueue(QObject* const parent = nullptr);
+    ~MetadataWriteQueue() override;
+
+    /**
+     * The delay in milliseconds during which the changes to a file are merged.
+     * With 0, the files are written as soon as possible. The window is read from
+     * the "Metadata Write Window" entry of the metadata settings, 2000 ms by default.
+     */
+    void setWindow(int msecs);
+    int  window()                               const;
+
+    /**
+     * The number of files written at the same time on a storage device. Default is 2,
+     * never more than the threads of the background jobs of the ThreadManager.
+     */
+    void setThreadsPerDevice(int count);
+    int  threadsPerDevice()                     const;
+
+    /**
+     * The number of files waiting to be written, or being written.
+     */
+    int  pendingCount()                         const;
+
+    /**
+     * The average and maximum delays in milliseconds between the first change
+     * queued for a file and the end of its write, since the start.
+     */
+    int  averageLatency()                       const;
+    int  maximumLatency()                       const;
+
+    /**
+     * The number of files written since the start.
+     */
+    int  writtenCount()                         const;
+
+    /**
+     * Starts the writes of all queued items now.
+     */
+    void flush();
+
+    /**
+     * Writes all queued items, and returns when all files are written.
+     */
+    void flushAndWait();
+
+public Q_SLOTS:
+
+    /**
+     * Queues the items for writing the given MetadataHub::WriteComponents from the
+     * database to the files. The write progress of the infos advances by one for
+     * each file written.
+     */
+    void enqueue(const FileActionItemInfoList& infos, int flags);
+
+    /**
+     * Queues the items for writing all metadata from the database to the files.
+     */
+    void enqueueAll(const FileActionItemInfoList& infos);
+
+Q_SIGNALS:
+
+    /// Emitted when the number of files waiting to be written, or being written, changes.
+    void signalQueueDepthChanged(int count);
+
+protected:
+
+    /**
+     * Writes the metadata of the item from the database to its file, called
+     * from the threads of the storage devices. Subclasses reimplementing it
+     * must call flushAndWait() in their destructor.
+     */
+    virtual void writeToFile(const ItemInfo& info, int flags);
+
+private Q_SLOTS:
+
+    void slotScheduleFlush();
+    void slotFlushDue();
+    void slotSettingsChanged();
+
+private:
+
+    void flushEntries(bool all);
+    void updateQueueDepth();
+
+private:
+
+    // Disable
+    MetadataWriteQueue(const MetadataWriteQueue&)            = delete;
+    MetadataWriteQueue& operator=(const MetadataWriteQueue&) = delete;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_METADATA_WRITE_QUEUE_H
@@ -51,6 +51,7 @@ MetaEngineSettingsContainer::MetaEngineSettingsContainer()
       useCompatibleFileName (false),
       useLazySync           (false),
       useFastScan           (false),
+      metadataWriteWindow   (2000),
       metadataWritingMode   (MetaEngine::WRITE_TO_FILE_ONLY),
       rotationBehavior      (RotatingFlags | RotateByLosslessRotation),
       albumDateFrom         (OldestItemDate),
@@ -90,6 +91,7 @@ void MetaEngineSettingsContainer::readFromConfig(KConfigGroup& group)
     rescanImageIfModified = group.readEntry("Rescan File If Modified",                  false);
     useLazySync           = group.readEntry("Use Lazy Synchronization",                 false);
     useFastScan           = group.readEntry("Use Fast Scan At Startup",                 false);
+    metadataWriteWindow   = group.readEntry("Metadata Write Window",                    2000);
 
     rotationBehavior      = NoRotation;
 
@@ -154,6 +156,7 @@ void MetaEngineSettingsContainer::writeToConfig(KConfigGroup& group) const
     group.writeEntry("Album Date Source",                       (int)albumDateFrom);
     group.writeEntry("Use Lazy Synchronization",                useLazySync);
     group.writeEntry("Use Fast Scan At Startup",                useFastScan);
+    group.writeEntry("Metadata Write Window",                   metadataWriteWindow);
 
     group.writeEntry("Custom Sidecar Extensions",               sidecarExtensions);
 
@@ -234,6 +237,8 @@ QDebug operator<<(QDebug dbg, const MetaEngineSettingsContainer& inf)
                   << inf.useCompatibleFileName << "), ";
     dbg.nospace() << "useLazySync("
                   << inf.useLazySync << "), ";
+    dbg.nospace() << "metadataWriteWindow("
+                  << inf.metadataWriteWindow << "), ";
     dbg.nospace() << "metadataWritingMode("
                   << inf.metadataWritingMode << "), ";
     dbg.nospace() << "rotationBehavior("
@@ -109,6 +109,9 @@ public:
     bool                            useLazySync;
     bool                            useFastScan;
 
+    /// The delay in milliseconds during which the metadata changes to a file are merged before writing.
+    int                             metadataWriteWindow;
+
     MetaEngine::MetadataWritingMode metadataWritingMode;
 
     RotationBehaviorFlags           rotationBehavior;
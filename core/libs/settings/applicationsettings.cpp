@@ -293,6 +293,7 @@ void ApplicationSettings::readSettings()
     int method                                           = group.readEntry(d->configDuplicatesSearchReferenceSelectionMethod,
                                                                            (int)HaarIface::RefImageSelMethod::OlderOrLarger);
     d->duplicatesSearchLastReferenceImageSelectionMethod = (HaarIface::RefImageSelMethod)method;
+    d->duplicatesSearchLastNearDuplicates                = group.readEntry(d->configDuplicatesSearchLastNearDuplicates,   false);
 
     // ---------------------------------------------------------------------
 
@@ -474,6 +475,7 @@ void ApplicationSettings::saveSettings()
     group.writeEntry(d->configDuplicatesSearchLastAlbumTagRelation,     d->duplicatesSearchLastAlbumTagRelation);
     group.writeEntry(d->configDuplicatesSearchLastRestrictions,         d->duplicatesSearchLastRestrictions);
     group.writeEntry(d->configDuplicatesSearchReferenceSelectionMethod, (int)d->duplicatesSearchLastReferenceImageSelectionMethod);
+    group.writeEntry(d->configDuplicatesSearchLastNearDuplicates,       d->duplicatesSearchLastNearDuplicates);
 
     group = config->group(d->configGroupGrouping);
 
@@ -557,6 +557,9 @@ public:
     void setDuplicatesSearchRestrictions(int val);
     int  getDuplicatesSearchRestrictions() const;
 
+    void setDuplicatesNearDuplicatesSearch(bool val);
+    bool getDuplicatesNearDuplicatesSearch() const;
+
     void setHelpBoxNotificationSeen(bool val);
     bool getHelpBoxNotificationSeen();
 
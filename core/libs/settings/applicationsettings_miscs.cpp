@@ -354,6 +354,16 @@ int  ApplicationSettings::getDuplicatesSearchRestrictions() const
     return d->duplicatesSearchLastRestrictions;
 }
 
+void ApplicationSettings::setDuplicatesNearDuplicatesSearch(bool val)
+{
+    d->duplicatesSearchLastNearDuplicates = val;
+}
+
+bool ApplicationSettings::getDuplicatesNearDuplicatesSearch() const
+{
+    return d->duplicatesSearchLastNearDuplicates;
+}
+
 void ApplicationSettings::setGroupingOperateOnAll(ApplicationSettings::OperationType type,
                                                   ApplicationSettings::ApplyToEntireGroup applyAll)
 {
@@ -134,6 +134,7 @@ const QString ApplicationSettings::Private::configDuplicatesSearchLastMaxSimilar
 const QString ApplicationSettings::Private::configDuplicatesSearchLastAlbumTagRelation(QLatin1String("Last search album tag relation"));
 const QString ApplicationSettings::Private::configDuplicatesSearchLastRestrictions(QLatin1String("Last search results restriction"));
 const QString ApplicationSettings::Private::configDuplicatesSearchReferenceSelectionMethod(QLatin1String("Last reference image method"));
+const QString ApplicationSettings::Private::configDuplicatesSearchLastNearDuplicates(QLatin1String("Last near duplicates search"));
 const ApplicationSettings::OperationStrings ApplicationSettings::Private::configGroupingOperateOnAll =
         ApplicationSettings::Private::createConfigGroupingOperateOnAll();
 
@@ -249,6 +250,7 @@ ApplicationSettings::Private::Private(ApplicationSettings* const qq)
       duplicatesSearchLastAlbumTagRelation              (0),
       duplicatesSearchLastRestrictions                  (0),
       duplicatesSearchLastReferenceImageSelectionMethod (HaarIface::RefImageSelMethod::OlderOrLarger),
+      duplicatesSearchLastNearDuplicates                (false),
       groupingOperateOnAll                              (ApplicationSettings::OperationModes()),
       q                                                 (qq)
 {
@@ -385,6 +387,7 @@ void ApplicationSettings::Private::init()
     duplicatesSearchLastAlbumTagRelation              = 0;
     duplicatesSearchLastRestrictions                  = 0;
     duplicatesSearchLastReferenceImageSelectionMethod = HaarIface::RefImageSelMethod::OlderOrLarger;
+    duplicatesSearchLastNearDuplicates                = false;
 
     scanAtStart                                       = true;
     cleanAtStart                                      = true;
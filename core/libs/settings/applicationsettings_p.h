@@ -191,6 +191,7 @@ public:
     static const QString configDuplicatesSearchLastAlbumTagRelation;
     static const QString configDuplicatesSearchLastRestrictions;
     static const QString configDuplicatesSearchReferenceSelectionMethod;
+    static const QString configDuplicatesSearchLastNearDuplicates;
     static const ApplicationSettings::OperationStrings configGroupingOperateOnAll;
 
     /// start up setting
@@ -348,6 +349,7 @@ public:
     int                                          duplicatesSearchLastAlbumTagRelation;
     int                                          duplicatesSearchLastRestrictions;
     HaarIface::RefImageSelMethod                 duplicatesSearchLastReferenceImageSelectionMethod;
+    bool                                         duplicatesSearchLastNearDuplicates;
 
     /// Grouping operation settings
     ApplicationSettings::OperationModes          groupingOperateOnAll;
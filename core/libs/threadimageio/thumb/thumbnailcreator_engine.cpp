@@ -98,7 +98,12 @@ ThumbnailImage ThumbnailCreator::createThumbnail(const ThumbnailInfo& info, cons
                 }
                 else if ((ext == QLatin1String("PNG"))  ||
                          (ext == QLatin1String("TIFF")) ||
-                         (ext == QLatin1String("TIF")))
+                         (ext == QLatin1String("TIF"))  ||
+                         (ext == QLatin1String("HEIC")) ||
+                         (ext == QLatin1String("HEIF")) ||
+                         (ext == QLatin1String("JP2"))  ||
+                         (ext == QLatin1String("J2K"))  ||
+                         (ext == QLatin1String("JPX")))
                 {
                     // Use DImg load scaled mode
 
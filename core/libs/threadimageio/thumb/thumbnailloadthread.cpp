@@ -642,6 +642,23 @@ void ThumbnailLoadThread::deleteThumbnail(const QString& filePath)
     creator.deleteThumbnailsFromDisk(filePath);
 }
 
+QImage ThumbnailLoadThread::loadThumbnailSynchronously(const ThumbnailIdentifier& identifier, int size)
+{
+    ThumbnailCreator creator(static_d->storageMethod);
+
+    if (static_d->provider)
+    {
+        creator.setThumbnailInfoProvider(static_d->provider);
+    }
+
+    creator.setOnlyLargeThumbnails(true);
+    creator.setRemoveAlphaChannel(true);
+    creator.setExifRotate(MetaEngineSettings::instance()->settings().exifRotate);
+    creator.setThumbnailSize(qBound(1, size, ThumbnailSize::maxThumbsSize()));
+
+    return creator.load(identifier);
+}
+
 ThumbnailImageCatcher::ThumbnailImageCatcher(QObject* const parent)
     : QObject(parent),
       d      (new Private)
@@ -224,6 +224,15 @@ public:
      */
     static void deleteThumbnail(const QString& filePath);
 
+    /**
+     * Load the thumbnail of the given size synchronously, without the loading cache.
+     * The thumbnail is read from the thumbnail storage, or created and stored if it
+     * does not exist yet, using the embedded previews when possible.
+     * This method works independently from the multithreaded thumbnail loading,
+     * and can be called from any thread. Returns a null QImage on failure.
+     */
+    static QImage loadThumbnailSynchronously(const ThumbnailIdentifier& identifier, int size);
+
 Q_SIGNALS:
 
     /// NOTE: See LoadSaveThread for a QImage-based thumbnailLoaded() signal.
@@ -40,6 +40,7 @@
 #include "iccmanager.h"
 #include "iccprofile.h"
 #include "loadingcache.h"
+#include "metaenginesettings.h"
 #include "thumbsdbaccess.h"
 #include "thumbnailsize.h"
 #include "thumbnailcreator.h"
@@ -23,10 +23,10 @@
 namespace Digikam
 {
 
-VideoThumbDecoder::VideoThumbDecoder(const QString& filename)
+VideoThumbDecoder::VideoThumbDecoder(const QString& filename, int scaledSize)
     : d(new Private)
 {
-    initialize(filename);
+    initialize(filename, scaledSize);
 }
 
 VideoThumbDecoder::~VideoThumbDecoder()
@@ -35,11 +35,14 @@ VideoThumbDecoder::~VideoThumbDecoder()
     delete d;
 }
 
-void VideoThumbDecoder::initialize(const QString& filename)
+void VideoThumbDecoder::initialize(const QString& filename, int scaledSize)
 {
-    d->lastWidth  = -1;
-    d->lastHeight = -1;
-    d->lastPixfmt = AV_PIX_FMT_NONE;
+    d->lastWidth     = -1;
+    d->lastHeight    = -1;
+    d->lastPixfmt    = AV_PIX_FMT_NONE;
+    d->scaledSize    = scaledSize;
+    d->keyFramesOnly = false;
+    d->draining      = false;
 
 #if LIBAVFORMAT_VERSION_MAJOR < 58
 
@@ -183,6 +186,7 @@ void VideoThumbDecoder::seek(int timeInSeconds)
     if (ret >= 0)
     {
         avcodec_flush_buffers(d->pVideoCodecContext);
+        d->draining = false;
     }
     else
     {
@@ -190,6 +194,10 @@ void VideoThumbDecoder::seek(int timeInSeconds)
         return;
     }
 
+    // Only the key frames are decoded until one is found.
+
+    d->pVideoCodecContext->skip_frame = AVDISCARD_NONKEY;
+
     int keyFrameAttempts = 0;
     bool gotFrame        = false;
 
@@ -210,6 +218,8 @@ void VideoThumbDecoder::seek(int timeInSeconds)
     while ((!gotFrame || !d->pFrame->key_frame) &&
            (keyFrameAttempts < 200));
 
+    d->pVideoCodecContext->skip_frame = d->keyFramesOnly ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+
     if (!gotFrame)
     {
         qDebug(DIGIKAM_GENERAL_LOG) << "Seeking in video failed";
@@ -225,6 +235,13 @@ bool VideoThumbDecoder::decodeVideoFrame() const
         frameFinished = d->decodeVideoPacket();
     }
 
+    if (!frameFinished)
+    {
+        // The last frames can still be in the decoder threads.
+
+        frameFinished = d->drainVideoFrame();
+    }
+
     if (!frameFinished)
     {
         qDebug(DIGIKAM_GENERAL_LOG) << "decodeVideoFrame() failed: frame not finished";
@@ -233,6 +250,16 @@ bool VideoThumbDecoder::decodeVideoFrame() const
     return frameFinished;
 }
 
+void VideoThumbDecoder::setKeyFramesOnly(bool enabled)
+{
+    d->keyFramesOnly = enabled;
+
+    if (d->pVideoCodecContext)
+    {
+        d->pVideoCodecContext->skip_frame = enabled ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+    }
+}
+
 void VideoThumbDecoder::getScaledVideoFrame(int scaledSize,
                                        bool maintainAspectRatio,
                                        VideoFrame& videoFrame)
@@ -32,7 +32,11 @@ class VideoThumbDecoder
 {
 public:
 
-    explicit VideoThumbDecoder(const QString& filename);
+    /**
+     * Opens the video. If scaledSize is not 0, the frames can be decoded at a
+     * reduced resolution not smaller than this size, when the codec supports it.
+     */
+    explicit VideoThumbDecoder(const QString& filename, int scaledSize = 0);
     ~VideoThumbDecoder();
 
 public:
@@ -43,13 +47,23 @@ public:
     int     getDuration()    const;
     bool    getInitialized() const;
 
+    /**
+     * Seeks to the key frame before timeInSeconds. The frames which are not
+     * key frames are skipped by the decoder while searching.
+     */
     void seek(int timeInSeconds);
     bool decodeVideoFrame()  const;
+
+    /**
+     * Only decode the key frames. This is much faster to sample frames
+     * spread in the video, as the other frames are not decoded.
+     */
+    void setKeyFramesOnly(bool enabled);
     void getScaledVideoFrame(int scaledSize,
                              bool maintainAspectRatio,
                              VideoFrame& videoFrame);
 
-    void initialize(const QString& filename);
+    void initialize(const QString& filename, int scaledSize = 0);
     void destroy();
 
 private:
@@ -19,6 +19,7 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "threadmanager.h"
 
 namespace Digikam
 {
@@ -41,7 +42,10 @@ VideoThumbDecoder::Private::Private()
       filterFrame           (nullptr),
       lastWidth             (0),
       lastHeight            (0),
-      lastPixfmt            (AV_PIX_FMT_NONE)
+      lastPixfmt            (AV_PIX_FMT_NONE),
+      scaledSize            (0),
+      keyFramesOnly         (false),
+      draining              (false)
 {
 }
 
@@ -97,6 +101,30 @@ bool VideoThumbDecoder::Private::initializeVideo()
     pVideoCodecContext = avcodec_alloc_context3(pVideoCodec);
     avcodec_parameters_to_context(pVideoCodecContext, pVideoCodecParameters);
 
+    // Decode with several threads, by frames or by slices depending of the codec.
+    // The thumbnails are often generated by several threads at the same time, and
+    // shown in the views: FFmpeg uses the budget of the interactive jobs of the ThreadManager.
+
+    pVideoCodecContext->thread_count = qBound(1, ThreadManager::instance()->maximumJobThreads(ThreadManager::Interactive), 8);
+    pVideoCodecContext->thread_type  = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
+    // Decode at a reduced resolution if the codec supports it, and
+    // the frames are still larger than the size of the thumbnail.
+
+    const int longest = qMax(pVideoCodecParameters->width, pVideoCodecParameters->height);
+
+    if ((scaledSize > 0) && (longest > 0))
+    {
+        int lowres = 0;
+
+        while ((lowres < pVideoCodec->max_lowres) && ((longest >> (lowres + 1)) >= scaledSize))
+        {
+            ++lowres;
+        }
+
+        pVideoCodecContext->lowres = lowres;
+    }
+
     if (avcodec_open2(pVideoCodecContext, pVideoCodec, nullptr) < 0)
     {
         qDebug(DIGIKAM_GENERAL_LOG) << "Could not open video codec";
@@ -142,6 +170,19 @@ bool VideoThumbDecoder::Private::decodeVideoPacket() const
     return (frameFinished > 0);
 }
 
+bool VideoThumbDecoder::Private::drainVideoFrame()
+{
+    if (!draining)
+    {
+        avcodec_send_packet(pVideoCodecContext, nullptr);
+        draining = true;
+    }
+
+    av_frame_unref(pFrame);
+
+    return (avcodec_receive_frame(pVideoCodecContext, pFrame) >= 0);
+}
+
 int VideoThumbDecoder::Private::decodeVideoNew(AVCodecContext* const avContext,
                                           AVFrame* const avFrame,
                                           int* gotFrame,
@@ -369,8 +410,13 @@ void VideoThumbDecoder::Private::convertAndScaleFrame(AVPixelFormat format,
 
     calculateDimensions(scaledSize, maintainAspectRatio, scaledWidth, scaledHeight);
 
-    SwsContext* const scaleContext = sws_getContext(pVideoCodecContext->width,
-                                                    pVideoCodecContext->height,
+    // With a reduced resolution decoding, the frame is smaller than the video.
+
+    const int frameWidth           = (pFrame->width  > 0) ? pFrame->width  : pVideoCodecContext->width;
+    const int frameHeight          = (pFrame->height > 0) ? pFrame->height : pVideoCodecContext->height;
+
+    SwsContext* const scaleContext = sws_getContext(frameWidth,
+                                                    frameHeight,
                                                     pVideoCodecContextPixFormat,
                                                     scaledWidth,
                                                     scaledHeight,
@@ -399,7 +445,7 @@ void VideoThumbDecoder::Private::convertAndScaleFrame(AVPixelFormat format,
               pFrame->data,
               pFrame->linesize,
               0,
-              pVideoCodecContext->height,
+              frameHeight,
               convertedFrame->data,
               convertedFrame->linesize);
 
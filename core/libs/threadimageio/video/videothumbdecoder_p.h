@@ -72,6 +72,9 @@ public:
     int                lastWidth;
     int                lastHeight;
     enum AVPixelFormat lastPixfmt;
+    int                scaledSize;
+    bool               keyFramesOnly;
+    bool               draining;
 
 public:
 
@@ -79,6 +82,12 @@ public:
     bool getVideoPacket();
     bool decodeVideoPacket() const;
 
+    /**
+     * Returns the next frame delayed by the decoder threads, once all
+     * packets are read.
+     */
+    bool drainVideoFrame();
+
     void convertAndScaleFrame(AVPixelFormat format,
                               int scaledSize,
                               bool maintainAspectRatio,
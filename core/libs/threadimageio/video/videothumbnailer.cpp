@@ -159,7 +159,7 @@ void VideoThumbnailer::generateThumbnail(const QString& videoFile,
                                          VideoThumbWriter& imageWriter,
                                          QImage &image)
 {
-    VideoThumbDecoder movieDecoder(videoFile);
+    VideoThumbDecoder movieDecoder(videoFile, d->thumbnailSize);
 
     if (movieDecoder.getInitialized())
     {
@@ -201,13 +201,31 @@ void VideoThumbnailer::generateSmartThumbnail(VideoThumbDecoder& movieDecoder,
     vector<VideoFrame> videoFrames(d->SMART_FRAME_ATTEMPTS);
     vector<Private::Histogram<int> > histograms(d->SMART_FRAME_ATTEMPTS);
 
-    for (int i = 0 ; i < d->SMART_FRAME_ATTEMPTS ; ++i)
+    // The candidates are the next key frames: they are decoded much faster
+    // than all frames, and they are spread in the video.
+
+    movieDecoder.setKeyFramesOnly(true);
+
+    int count = 0;
+
+    for ( ; count < d->SMART_FRAME_ATTEMPTS ; ++count)
     {
-        movieDecoder.decodeVideoFrame();
-        movieDecoder.getScaledVideoFrame(d->thumbnailSize, d->maintainAspectRatio, videoFrames[i]);
-        d->generateHistogram(videoFrames[i], histograms[i]);
+        // At the end of the video, the last frame decoded was already converted.
+
+        if (!movieDecoder.decodeVideoFrame() && (count > 0))
+        {
+            break;
+        }
+
+        movieDecoder.getScaledVideoFrame(d->thumbnailSize, d->maintainAspectRatio, videoFrames[count]);
+        d->generateHistogram(videoFrames[count], histograms[count]);
     }
 
+    movieDecoder.setKeyFramesOnly(false);
+
+    videoFrames.resize(count);
+    histograms.resize(count);
+
     int bestFrame = d->getBestThumbnailIndex(videoFrames, histograms);
 
     if (bestFrame == -1)
@@ -16,12 +16,15 @@
 
 #include "actionthreadbase.h"
 
+// C++ includes
+
+#include <functional>
+
 // Qt includes
 
 #include <QMutexLocker>
 #include <QWaitCondition>
 #include <QMutex>
-#include <QThreadPool>
 
 // Local includes
 
@@ -50,34 +53,100 @@ void ActionJob::cancel()
 
 // -----------------------------------------------------------------
 
+/**
+ * Runs a job on a thread of the ThreadManager, and reports its end.
+ */
+class Q_DECL_HIDDEN ActionJobRunnable : public QRunnable
+{
+public:
+
+    ActionJobRunnable(ActionJob* const job, const std::function<void()>& done)
+        : job (job),
+          done(done)
+    {
+        setAutoDelete(true);
+    }
+
+protected:
+
+    void run() override
+    {
+        job->run();
+        done();
+    }
+
+private:
+
+    ActionJob*            job;
+    std::function<void()> done;
+
+private:
+
+    Q_DISABLE_COPY(ActionJobRunnable)
+};
+
+// -----------------------------------------------------------------
+
 class Q_DECL_HIDDEN ActionThreadBase::Private
 {
 public:
 
     explicit Private()
-      : running(false),
-        pool   (nullptr)
+      : running      (false),
+        looping      (false),
+        maxThreads   (1),
+        inFlight     (0),
+        priorityClass(ThreadManager::Background)
     {
     }
 
-    volatile bool       running;
+    /**
+     * Returns the job to start with the highest priority value, as QThreadPool does.
+     * The mutex must be locked.
+     */
+    ActionJob* nextJob() const
+    {
+        ActionJob* job = nullptr;
+        int priority   = 0;
 
-    QWaitCondition      condVarJobs;
-    QMutex              mutex;
+        for (ActionJobCollection::const_iterator it = todo.constBegin() ; it != todo.constEnd() ; ++it)
+        {
+            if (!job || (it.value() > priority))
+            {
+                job      = it.key();
+                priority = it.value();
+            }
+        }
+
+        return job;
+    }
+
+public:
+
+    volatile bool                running;
+
+    /// True from the start of the thread to the end of its loop. Changed with the mutex locked.
+    bool                         looping;
+
+    QWaitCondition               condVarJobs;
+    QMutex                       mutex;
 
-    ActionJobCollection todo;
-    ActionJobCollection pending;
-    ActionJobCollection processed;
+    ActionJobCollection          todo;
+    ActionJobCollection          pending;
+    ActionJobCollection          processed;
 
-    QThreadPool*        pool;
+    int                          maxThreads;
+
+    /// The jobs started on the threads of the ThreadManager and not returned yet.
+    int                          inFlight;
+
+    ThreadManager::PriorityClass priorityClass;
 };
 
 ActionThreadBase::ActionThreadBase(QObject* const parent)
     : QThread(parent),
       d      (new Private)
 {
-    d->pool = new QThreadPool(this);
-
     setDefaultMaximumNumberOfThreads();
 }
 
@@ -93,7 +162,14 @@ ActionThreadBase::~ActionThreadBase()
 
     // Wait for the jobs to finish
 
-    d->pool->waitForDone();
+    {
+        QMutexLocker lock(&d->mutex);
+
+        while (d->inFlight)
+        {
+            d->condVarJobs.wait(&d->mutex);
+        }
+    }
 
     // Cleanup all jobs from memory
 
@@ -107,14 +183,19 @@ ActionThreadBase::~ActionThreadBase()
 
 void ActionThreadBase::setMaximumNumberOfThreads(int n)
 {
-    d->pool->setMaxThreadCount(n);
+    {
+        QMutexLocker lock(&d->mutex);
+
+        d->maxThreads = qMax(1, n);
+        d->condVarJobs.wakeAll();
+    }
 
     qCDebug(DIGIKAM_GENERAL_LOG) << "Using " << n << " CPU core to run threads";
 }
 
 int ActionThreadBase::maximumNumberOfThreads() const
 {
-    return d->pool->maxThreadCount();
+    return d->maxThreads;
 }
 
 void ActionThreadBase::setDefaultMaximumNumberOfThreads()
@@ -122,6 +203,18 @@ void ActionThreadBase::setDefaultMaximumNumberOfThreads()
     setMaximumNumberOfThreads(QThread::idealThreadCount());
 }
 
+void ActionThreadBase::setPriorityClass(ThreadManager::PriorityClass priorityClass)
+{
+    QMutexLocker lock(&d->mutex);
+
+    d->priorityClass = priorityClass;
+}
+
+ThreadManager::PriorityClass ActionThreadBase::priorityClass() const
+{
+    return d->priorityClass;
+}
+
 void ActionThreadBase::slotJobFinished()
 {
     ActionJob* const job = dynamic_cast<ActionJob*>(sender());
@@ -138,7 +231,9 @@ void ActionThreadBase::slotJobFinished()
     d->processed.insert(job, 0);
     d->pending.remove(job);
 
-    if (isEmpty())
+    // Jobs appended while the last ones run are not pending yet.
+
+    if (isEmpty() && d->todo.isEmpty())
     {
         d->running = false;
     }
@@ -199,31 +294,83 @@ void ActionThreadBase::appendJobs(const ActionJobCollection& jobs)
     d->condVarJobs.wakeAll();
 }
 
+void ActionThreadBase::startIfNeeded()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+
+        // The loop takes the jobs appended before it ends.
+
+        if (d->looping)
+        {
+            return;
+        }
+
+        d->looping = true;
+    }
+
+    // The loop ended: the thread only has to return.
+
+    wait();
+    start();
+}
+
 void ActionThreadBase::run()
 {
-    d->running = true;
+    {
+        QMutexLocker lock(&d->mutex);
+        d->running = true;
+        d->looping = true;
+    }
+
+    Private* const priv = d;
 
-    while (d->running)
+    Q_FOREVER
     {
         QMutexLocker lock(&d->mutex);
 
-        if (!d->todo.isEmpty())
+        if (!d->running)
+        {
+            // Jobs appended while the last ones were finishing are processed before the loop ends.
+
+            if (d->todo.isEmpty())
+            {
+                d->looping = false;
+                break;
+            }
+
+            d->running = true;
+        }
+
+        // The threads are shared with other subsystems: only the jobs which can run now are started,
+        // the others waiting here to be started in the order of their priority.
+
+        const int maxJobs = qMin(d->maxThreads, ThreadManager::instance()->maximumJobThreads(d->priorityClass));
+
+        if (!d->todo.isEmpty() && (d->inFlight < maxJobs))
         {
             qCDebug(DIGIKAM_GENERAL_LOG) << "Action Thread run " << d->todo.count() << " new jobs";
 
-            for (ActionJobCollection::iterator it = d->todo.begin() ; it != d->todo.end() ; ++it)
+            while (!d->todo.isEmpty() && (d->inFlight < maxJobs))
             {
-                ActionJob* const job = it.key();
-                int priority         = it.value();
+                ActionJob* const job = d->nextJob();
+                int priority         = d->todo.take(job);
 
                 connect(job, SIGNAL(signalDone()),
                         this, SLOT(slotJobFinished()));
 
-                d->pool->start(job, priority);
                 d->pending.insert(job, priority);
+                d->inFlight++;
+
+                ThreadManager::instance()->scheduleJob(new ActionJobRunnable(job,
+                    [priv]()
+                    {
+                        QMutexLocker jobLock(&priv->mutex);
+                        priv->inFlight--;
+                        priv->condVarJobs.wakeAll();
+                    }
+                ), d->priorityClass);
             }
-
-            d->todo.clear();
         }
         else
         {
@@ -27,6 +27,7 @@
 // Local includes
 
 #include "digikam_export.h"
+#include "threadmanager.h"
 
 namespace Digikam
 {
@@ -83,7 +84,7 @@ protected:
 /**
  * Define a QHash of job/priority to process by ActionThreadBase manager.
  * Priority value can be used to control the run queue's order of execution.
- * Zero priority want mean to process job with higher priority.
+ * As with QThreadPool, the jobs with a higher priority value are processed first.
  */
 typedef QHash<ActionJob*, int> ActionJobCollection;
 
@@ -114,6 +115,13 @@ public:
      */
     void setDefaultMaximumNumberOfThreads();
 
+    /**
+     * The class of the jobs on the threads shared by all subsystems, see ThreadManager.
+     * Default is ThreadManager::Background.
+     */
+    void setPriorityClass(ThreadManager::PriorityClass priorityClass);
+    ThreadManager::PriorityClass priorityClass() const;
+
     /**
      * Cancel processing of current jobs under progress.
      */
@@ -127,11 +135,18 @@ protected:
     void run()                            override;
 
     /**
-     * Append a collection of jobs to process into QThreadPool.
-     *  Jobs are add to pending lists and will be deleted by ActionThreadBase, not QThreadPool.
+     * Append a collection of jobs to process on the threads of the ThreadManager.
+     * At most maximumNumberOfThreads() jobs run at the same time, the higher priority values first.
+     * Jobs are add to pending lists and will be deleted by ActionThreadBase, not QThreadPool.
      */
     void appendJobs(const ActionJobCollection& jobs);
 
+    /**
+     * Start the thread to process the jobs appended, unless its loop still runs.
+     * Unlike start(), this also restarts a thread whose loop ended but which did not return yet.
+     */
+    void startIfNeeded();
+
     /**
      * Return true if list of pending jobs to process is empty.
      */
@@ -16,10 +16,12 @@
 
 // Qt includes
 
+#include <QAtomicInt>
 #include <QEventLoop>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QPair>
+#include <QSharedPointer>
 #include <QThread>
 #include <QThreadPool>
 #include <QWaitCondition>
@@ -220,19 +222,114 @@ void WorkerObjectRunnable::run()
 
 // -------------------------------------------------------------------------------------------------
 
+/**
+ * The calls of ThreadManager::parallelFor(), shared by the calling thread and its helper jobs.
+ */
+class Q_DECL_HIDDEN ParallelForState
+{
+public:
+
+    ParallelForState(int count, const std::function<void(int)>& func)
+        : count(count),
+          done (0),
+          func (func)
+    {
+    }
+
+    /**
+     * Makes the calls not taken yet by another thread.
+     */
+    void runCalls()
+    {
+        int calls = 0;
+
+        for (int i = next.fetchAndAddOrdered(1) ; i < count ; i = next.fetchAndAddOrdered(1))
+        {
+            func(i);
+            ++calls;
+        }
+
+        if (calls)
+        {
+            QMutexLocker lock(&mutex);
+            done += calls;
+
+            if (done == count)
+            {
+                condVar.wakeAll();
+            }
+        }
+    }
+
+    void waitForDone()
+    {
+        QMutexLocker lock(&mutex);
+
+        while (done < count)
+        {
+            condVar.wait(&mutex);
+        }
+    }
+
+public:
+
+    const int                   count;
+    int                         done;
+    std::function<void(int)>    func;
+    QAtomicInt                  next;
+    QMutex                      mutex;
+    QWaitCondition              condVar;
+};
+
+class Q_DECL_HIDDEN ParallelForRunnable : public QRunnable
+{
+public:
+
+    explicit ParallelForRunnable(const QSharedPointer<ParallelForState>& state)
+        : state(state)
+    {
+        setAutoDelete(true);
+    }
+
+protected:
+
+    void run() override
+    {
+        // A helper started after all calls were taken has nothing to do.
+
+        state->runCalls();
+    }
+
+private:
+
+    QSharedPointer<ParallelForState> state;
+
+private:
+
+    Q_DISABLE_COPY(ParallelForRunnable)
+};
+
+// -------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN ThreadManager::Private
 {
 public:
 
     Private()
-      : parkingThread(nullptr),
-        pool         (nullptr)
+      : parkingThread  (nullptr),
+        pool           (nullptr),
+        interactivePool(nullptr),
+        jobPool        (nullptr)
     {
     }
 
     ParkingThread* parkingThread;
     QThreadPool*   pool;
 
+    /// The threads of the jobs, see scheduleJob().
+    QThreadPool*   interactivePool;
+    QThreadPool*   jobPool;
+
 public:
 
     void changeMaxThreadCount(int diff)
@@ -266,10 +363,23 @@ ThreadManager::ThreadManager()
     d->pool          = new QThreadPool(this);
 
     d->pool->setMaxThreadCount(QThread::idealThreadCount() + 1);
+
+    // The jobs use as many threads as cores, a part of them being reserved to the interactive jobs.
+
+    const int cores       = QThread::idealThreadCount();
+    const int reservation = qMax(1, cores / 4);
+
+    d->interactivePool    = new QThreadPool(this);
+    d->interactivePool->setMaxThreadCount(reservation);
+
+    d->jobPool            = new QThreadPool(this);
+    d->jobPool->setMaxThreadCount(qMax(1, cores - reservation));
 }
 
 ThreadManager::~ThreadManager()
 {
+    d->interactivePool->waitForDone();
+    d->jobPool->waitForDone();
     d->pool->waitForDone();
 
     delete d;
@@ -303,6 +413,59 @@ void ThreadManager::schedule(QRunnable* runnable)
     d->pool->start(runnable);
 }
 
+void ThreadManager::scheduleJob(QRunnable* const runnable, PriorityClass priorityClass)
+{
+    switch (priorityClass)
+    {
+        case Interactive:
+        {
+            d->interactivePool->start(runnable);
+            break;
+        }
+
+        case Background:
+        {
+            d->jobPool->start(runnable, 1);
+            break;
+        }
+
+        case Maintenance:
+        {
+            d->jobPool->start(runnable, 0);
+            break;
+        }
+    }
+}
+
+int ThreadManager::maximumJobThreads(PriorityClass priorityClass) const
+{
+    if (priorityClass == Interactive)
+    {
+        return d->interactivePool->maxThreadCount();
+    }
+
+    return d->jobPool->maxThreadCount();
+}
+
+void ThreadManager::parallelFor(int count, const std::function<void(int)>& func, PriorityClass priorityClass)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    QSharedPointer<ParallelForState> state(new ParallelForState(count, func));
+    const int helpers = qMin(count, maximumJobThreads(priorityClass)) - 1;
+
+    for (int i = 0 ; i < helpers ; ++i)
+    {
+        scheduleJob(new ParallelForRunnable(state), priorityClass);
+    }
+
+    state->runCalls();
+    state->waitForDone();
+}
+
 void ThreadManager::slotDestroyed(QObject*)
 {
     d->changeMaxThreadCount(-1);
@@ -15,6 +15,10 @@
 #ifndef DIGIKAM_THREAD_MANAGER_H
 #define DIGIKAM_THREAD_MANAGER_H
 
+// C++ includes
+
+#include <functional>
+
 // Qt includes
 
 #include <QObject>
@@ -30,10 +34,31 @@ namespace Digikam
 class DynamicThread;
 class WorkerObject;
 
+/**
+ * The ThreadManager owns the threads of all subsystems.
+ *
+ * The worker objects and dynamic threads run loops which can wait for a long time,
+ * and get a thread each when scheduled.
+ *
+ * The jobs, which run to completion, are shared by all subsystems through scheduleJob().
+ * They run on as many threads as cores. A quarter of the threads, at least one, is
+ * reserved to the interactive jobs, so they never wait for the maintenance work.
+ * The background and maintenance jobs share the other threads, the background ones
+ * being started first.
+ */
 class DIGIKAM_EXPORT ThreadManager : public QObject
 {
     Q_OBJECT
 
+public:
+
+    enum PriorityClass
+    {
+        Interactive = 0,    ///< Work the user waits for, as listing an album.
+        Background,         ///< Work started by the user, as processing a batch queue.
+        Maintenance         ///< Work on the whole collection, as generating the fingerprints.
+    };
+
 public:
 
     static ThreadManager* instance();
@@ -41,6 +66,24 @@ public:
     void initialize(WorkerObject* const object);
     void initialize(DynamicThread* const dynamicThread);
 
+    /**
+     * Runs a job, a runnable which does not wait for other jobs, on the threads shared by
+     * the jobs of all subsystems. The runnable is deleted after if autoDelete() is true.
+     */
+    void scheduleJob(QRunnable* const runnable, PriorityClass priorityClass);
+
+    /**
+     * Returns the number of threads running the jobs of the class.
+     */
+    int maximumJobThreads(PriorityClass priorityClass) const;
+
+    /**
+     * Calls func for each index from 0 to count - 1 on the threads of the jobs of the class,
+     * and returns when all calls are done. The calling thread takes its share of the calls,
+     * so this can be used from a job without waiting for a free thread.
+     */
+    void parallelFor(int count, const std::function<void(int)>& func, PriorityClass priorityClass);
+
 public Q_SLOTS:
 
     void schedule(WorkerObject* object);
@@ -44,7 +44,11 @@ QImage FrameUtils::makeFramedImage(const QString& file, const QSize& outSize)
         settings.RGBInterpolate4Colors = false;
         settings.RAWQuality            = DRawDecoderSettings::BILINEAR;
 
-        DImg dimg(file, nullptr, DRawDecoding(settings));
+        // Only decode the file at the size needed, when the format allows it.
+
+        DImg dimg;
+        dimg.setAttribute(QLatin1String("scaledLoadingSize"), qMax(outSize.width(), outSize.height()));
+        dimg.load(file, nullptr, DRawDecoding(settings));
         dimg.exifRotate(file);
         timg = dimg.copyQImage();
     }
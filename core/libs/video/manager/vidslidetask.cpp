@@ -17,6 +17,7 @@
 // C++ includes
 
 #include <cmath>
+#include <functional>
 
 // Qt includes
 
@@ -24,6 +25,15 @@
 #include <QSize>
 #include <QPainter>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QRunnable>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+#include <QWaitCondition>
 
 // KDE includes
 
@@ -45,6 +55,7 @@
 #include "dfileoperations.h"
 #include "transitionmngr.h"
 #include "effectmngr.h"
+#include "threadmanager.h"
 #include "digikam_debug.h"
 #include "digikam_config.h"
 
@@ -53,14 +64,79 @@ using namespace QtAV;
 namespace Digikam
 {
 
+namespace
+{
+
+/// Maximum size in bytes of the frames rendered ahead of the encoder, for all the segments.
+const qint64 FRAMES_BUFFER_SIZE = 1024LL * 1024LL * 1024LL;
+
+/// Frames that the segment being encoded can always queue, even when the buffer is full.
+const int    SEGMENT_MIN_FRAMES = 4;
+
+/**
+ * The frames of a part of the video: the effect on an image, then the
+ * transition to the next image. The frames are rendered by a worker thread
+ * and taken in order by the encoder. A segment not yet started by a worker
+ * when the encoder needs it is rendered by the encoder itself.
+ */
+class Q_DECL_HIDDEN VidSlideSegment
+{
+public:
+
+    QQueue<VideoFrame> frames;
+    bool               done = false;
+    QAtomicInt         claimed;
+};
+
+/**
+ * The workers running for the task. The workers scheduled but started after
+ * the end of the rendering return at once, so the task never waits for them.
+ */
+class Q_DECL_HIDDEN VidSlideWorkers
+{
+public:
+
+    QMutex         mutex;
+    QWaitCondition condition;
+    int            running = 0;
+    bool           closed  = false;
+};
+
+class Q_DECL_HIDDEN VidSlideRunnable : public QRunnable
+{
+public:
+
+    explicit VidSlideRunnable(const std::function<void()>& func)
+        : m_func(func)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_func();
+    }
+
+private:
+
+    std::function<void()> m_func;
+};
+
+} // namespace
+
 class Q_DECL_HIDDEN VidSlideTask::Private
 {
 public:
 
     explicit Private()
-      : settings(nullptr),
-        astream (0),
-        adec    (AudioDecoder::create("FFmpeg"))
+      : settings      (nullptr),
+        astream       (0),
+        adec          (AudioDecoder::create("FFmpeg")),
+        pixelFormat   (VideoFormat::Format_Invalid),
+        maxFrames     (SEGMENT_MIN_FRAMES),
+        queuedFrames  (0),
+        encodedSegment(0),
+        workers       (new VidSlideWorkers)
     {
     }
 
@@ -76,6 +152,45 @@ public:
 
     AudioFrame nextAudioFrame(const AudioFormat& afmt);
 
+    /**
+     * Renders the frames of the segment at index and passes them to sink,
+     * which returns false to stop the rendering.
+     * The segment 0 is the transition to the first image, and the segment i
+     * the effect on the image i-1 followed by the transition to the image i.
+     */
+    void       renderSegment(int index, const std::function<bool(const QImage&)>& sink);
+
+    /**
+     * Renders the segment at index in a worker thread, if the encoder did not
+     * take it already, and queues its frames.
+     */
+    void       renderSegmentInWorker(int index);
+
+    /**
+     * Schedules the rendering of the segment at index on the background job threads.
+     */
+    void       startWorker(int index);
+
+    /**
+     * Converts the frame to the encoder format and queues it in the segment.
+     * Waits while the frames of all segments use the buffer, except for the
+     * first frames of the segment being encoded.
+     * Returns false if the rendering was aborted.
+     */
+    bool       queueFrame(int index, const QImage& img);
+
+    /**
+     * Returns the framed image at index, decoding it if needed. Each image is
+     * used by two segments, and dropped when both released it.
+     */
+    QImage     framedImage(int index);
+    void       releaseFramedImage(int index);
+
+    /**
+     * Stops all segments still rendering and waits for the workers.
+     */
+    void       abortRendering();
+
 public:
 
     VidSlideSettings*           settings;
@@ -84,6 +199,24 @@ public:
     int                         astream;
     AudioDecoder*               adec;
     QList<QUrl>::const_iterator curAudioFile;
+
+    QSize                       osize;
+    VideoFormat::PixelFormat    pixelFormat;
+    QAtomicInt                  aborted;
+    QVector<VidSlideSegment*>   segments;
+
+    QMutex                      framesMutex;
+    QWaitCondition              framesCondition;
+    int                         maxFrames;          ///< Frames queued by all the segments at most.
+    int                         queuedFrames;
+    int                         encodedSegment;
+    QSharedPointer<VidSlideWorkers> workers;
+
+    QMutex                      imagesMutex;
+    QWaitCondition              imagesCondition;
+    QHash<int, QImage>          images;
+    QHash<int, int>             imagesReleased;
+    QSet<int>                   imagesLoading;
 };
 
 bool VidSlideTask::Private::encodeFrame(VideoFrame& vframe,
@@ -225,6 +358,222 @@ AudioFrame VidSlideTask::Private::nextAudioFrame(const AudioFormat& afmt)
     return AudioFrame();
 }
 
+void VidSlideTask::Private::renderSegment(int index, const std::function<bool(const QImage&)>& sink)
+{
+    const int count = settings->inputImages.count();
+    QImage qiimg;
+
+    if (index == 0)
+    {
+        qiimg = FrameUtils::makeFramedImage(QString(), osize);
+    }
+    else
+    {
+        // -- Image effect ----------
+
+        EffectMngr effmngr;
+        effmngr.setOutputSize(osize);
+        effmngr.setFrames(settings->imgFrames);
+        effmngr.setImage(framedImage(index - 1));
+        effmngr.setEffect(settings->vEffect);
+        releaseFramedImage(index - 1);
+
+        int frames = 0;
+        int itmout = 0;
+
+        do
+        {
+            qiimg = effmngr.currentFrame(itmout);
+
+            if (!sink(qiimg))
+            {
+                break;
+            }
+
+            ++frames;
+        }
+        while ((frames < settings->imgFrames) && !aborted);
+    }
+
+    // -- Transition to the next image ----------
+
+    if (!aborted)
+    {
+        QImage qoimg;
+
+        if (index < count)
+        {
+            qoimg = framedImage(index);
+            releaseFramedImage(index);
+        }
+        else
+        {
+            qoimg = FrameUtils::makeFramedImage(QString(), osize);
+        }
+
+        TransitionMngr transmngr;
+        transmngr.setOutputSize(osize);
+        transmngr.setInImage(qiimg);
+        transmngr.setOutImage(qoimg);
+        transmngr.setTransition(settings->transition);
+
+        int ttmout = 0;
+
+        do
+        {
+            if (!sink(transmngr.currentFrame(ttmout)))
+            {
+                break;
+            }
+        }
+        while ((ttmout != -1) && !aborted);
+    }
+}
+
+void VidSlideTask::Private::renderSegmentInWorker(int index)
+{
+    VidSlideSegment* const segment = segments[index];
+
+    if (segment->claimed.testAndSetOrdered(0, 1))
+    {
+        renderSegment(index, [this, index](const QImage& img)
+            {
+                return queueFrame(index, img);
+            }
+        );
+    }
+
+    QMutexLocker lock(&framesMutex);
+    segment->done = true;
+    framesCondition.wakeAll();
+}
+
+void VidSlideTask::Private::startWorker(int index)
+{
+    QSharedPointer<VidSlideWorkers> w = workers;
+
+    ThreadManager::instance()->scheduleJob(new VidSlideRunnable([this, w, index]()
+        {
+            {
+                QMutexLocker lock(&w->mutex);
+
+                if (w->closed)
+                {
+                    return;
+                }
+
+                ++w->running;
+            }
+
+            renderSegmentInWorker(index);
+
+            QMutexLocker lock(&w->mutex);
+            --w->running;
+            w->condition.wakeAll();
+        }
+    ), ThreadManager::Background);
+}
+
+bool VidSlideTask::Private::queueFrame(int index, const QImage& img)
+{
+    // The pixel format conversion is done here to not hold the encoder.
+
+    VideoFrame vframe(img);
+
+    if (vframe.pixelFormat() != pixelFormat)
+    {
+        vframe = vframe.to(pixelFormat);
+    }
+
+    VidSlideSegment* const segment = segments[index];
+    QMutexLocker lock(&framesMutex);
+
+    // The segment being encoded can always queue a few frames, else the encoder
+    // could wait for frames that no worker can render.
+
+    while ((queuedFrames >= maxFrames)                                                     &&
+           ((index != encodedSegment) || (segment->frames.count() >= SEGMENT_MIN_FRAMES)) &&
+           !aborted)
+    {
+        framesCondition.wait(&framesMutex);
+    }
+
+    if (aborted)
+    {
+        return false;
+    }
+
+    segment->frames.enqueue(vframe);
+    ++queuedFrames;
+    framesCondition.wakeAll();
+
+    return true;
+}
+
+QImage VidSlideTask::Private::framedImage(int index)
+{
+    {
+        QMutexLocker lock(&imagesMutex);
+
+        while (imagesLoading.contains(index))
+        {
+            imagesCondition.wait(&imagesMutex);
+        }
+
+        if (images.contains(index))
+        {
+            return images.value(index);
+        }
+
+        imagesLoading << index;
+    }
+
+    QImage img = FrameUtils::makeFramedImage(settings->inputImages[index].toLocalFile(), osize);
+
+    QMutexLocker lock(&imagesMutex);
+
+    images.insert(index, img);
+    imagesLoading.remove(index);
+    imagesCondition.wakeAll();
+
+    return img;
+}
+
+void VidSlideTask::Private::releaseFramedImage(int index)
+{
+    QMutexLocker lock(&imagesMutex);
+
+    if (++imagesReleased[index] == 2)
+    {
+        images.remove(index);
+        imagesReleased.remove(index);
+    }
+}
+
+void VidSlideTask::Private::abortRendering()
+{
+    // The segments not started yet are not rendered anymore.
+
+    Q_FOREACH (VidSlideSegment* const segment, segments)
+    {
+        segment->claimed = 1;
+    }
+
+    {
+        QMutexLocker lock(&framesMutex);
+        aborted = 1;
+        framesCondition.wakeAll();
+    }
+
+    QMutexLocker lock(&workers->mutex);
+    workers->closed = true;
+
+    while (workers->running > 0)
+    {
+        workers->condition.wait(&workers->mutex);
+    }
+}
+
 // -------------------------------------------------------
 
 VidSlideTask::VidSlideTask(VidSlideSettings* const settings)
@@ -328,89 +677,144 @@ void VidSlideTask::run()
         return;
     }
 
-    QImage qiimg;
-
     // ---------------------------------------------
-    // Loop to encode frames with images list
+    // Render the segments of the video on the background job threads, ahead of the encoder
+
+    const int count = d->settings->inputImages.count();
+    d->osize        = osize;
+    d->pixelFormat  = venc->pixelFormat();
+    d->aborted      = 0;
+
+    for (int i = 0 ; i < (count + 1) ; ++i)
+    {
+        d->segments << new VidSlideSegment;
+    }
 
-    TransitionMngr transmngr;
-    transmngr.setOutputSize(osize);
+    // The encoder uses one of the background threads. The segments that no
+    // worker started when the encoder needs them are rendered by the encoder.
 
-    EffectMngr effmngr;
-    effmngr.setOutputSize(osize);
-    effmngr.setFrames(d->settings->imgFrames);
+    const int ahead          = qMax(1, ThreadManager::instance()->maximumJobThreads(ThreadManager::Background) - 1);
 
-    for (int i = 0 ; ((i < d->settings->inputImages.count() + 1) && !m_cancel) ; ++i)
+    // The frames are queued in the pixel format of the encoder.
+
+    const VideoFormat format(d->pixelFormat);
+    qint64 frameBytes        = 0;
+
+    for (int p = 0 ; p < format.planeCount() ; ++p)
     {
-        if (i == 0)
-        {
-            qiimg = FrameUtils::makeFramedImage(QString(), osize);
-        }
+        frameBytes += (qint64)format.bytesPerLine(osize.width(), p) * format.height(osize.height(), p);
+    }
 
-        QString ofile;
+    frameBytes               = qMax((qint64)1, frameBytes);
+    d->maxFrames             = (int)qMax((qint64)SEGMENT_MIN_FRAMES, FRAMES_BUFFER_SIZE / frameBytes);
+    d->queuedFrames          = 0;
+    d->encodedSegment        = 0;
 
-        if (i < d->settings->inputImages.count())
-        {
-            ofile = d->settings->inputImages[i].toLocalFile();
-        }
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Render video segments with" << ahead << "threads,"
+                                 << d->maxFrames << "frames queued at most";
 
-        QImage qoimg = FrameUtils::makeFramedImage(ofile, osize);
+    for (int i = 0 ; i < qMin(ahead, count + 1) ; ++i)
+    {
+        d->startWorker(i);
+    }
 
-        // -- Transition encoding ----------
+    // ---------------------------------------------
+    // Encode the frames of the segments in order
 
-        transmngr.setInImage(qiimg);
-        transmngr.setOutImage(qoimg);
-        transmngr.setTransition(d->settings->transition);
+    for (int i = 0 ; ((i < count + 1) && !m_cancel) ; ++i)
+    {
+        VidSlideSegment* const segment = d->segments[i];
 
-        int ttmout = 0;
+        {
+            QMutexLocker lock(&d->framesMutex);
+            d->encodedSegment = i;
+            d->framesCondition.wakeAll();
+        }
 
-        do
+        if (segment->claimed.testAndSetOrdered(0, 1))
         {
-            VideoFrame frame(transmngr.currentFrame(ttmout));
+            // No worker started this segment yet: render it here, without queuing the frames.
 
-            if (!d->encodeFrame(frame, venc, aenc, mux))
-            {
-                qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot encode transition frame";
-            }
-        }
-        while ((ttmout != -1) && !m_cancel);
+            d->renderSegment(i, [this, venc, aenc, &mux, i](const QImage& img)
+                {
+                    VideoFrame frame(img);
 
-        // -- Images encoding ----------
+                    if (!d->encodeFrame(frame, venc, aenc, mux))
+                    {
+                        qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot encode frame of segment" << i;
+                    }
 
-        if (i < d->settings->inputImages.count())
+                    return !m_cancel;
+                }
+            );
+        }
+        else
         {
-            VideoFrame frame;
-            int count  = 0;
-            int itmout = 0;
-            effmngr.setImage(qoimg);
-            effmngr.setEffect(d->settings->vEffect);
-
-            do
+            Q_FOREVER
             {
-                qiimg = effmngr.currentFrame(itmout);
-                frame = VideoFrame(qiimg);
+                VideoFrame frame;
 
-                if (d->encodeFrame(frame, venc, aenc, mux))
                 {
+                    QMutexLocker lock(&d->framesMutex);
 
-                    ++count;
-/*
-                    qCDebug(DIGIKAM_GENERAL_LOG) << ofile
-                                                 << " => encode count:" << count
-                                                 << "frame size:"       << frame.width()
-                                                 << "x"                 << frame.height();
-*/
+                    while (segment->frames.isEmpty() && !segment->done)
+                    {
+                        d->framesCondition.wait(&d->framesMutex);
+                    }
+
+                    if (segment->frames.isEmpty())
+                    {
+                        break;
+                    }
+
+                    frame = segment->frames.dequeue();
+                    --d->queuedFrames;
+                    d->framesCondition.wakeAll();
+                }
+
+                if (m_cancel)
+                {
+                    break;
+                }
+
+                if (!d->encodeFrame(frame, venc, aenc, mux))
+                {
+                    qCWarning(DIGIKAM_GENERAL_LOG) << "Cannot encode frame of segment" << i;
                 }
             }
-            while ((count < d->settings->imgFrames) && !m_cancel);
         }
 
-        qCDebug(DIGIKAM_GENERAL_LOG) << "Encoded image" << i << "done";
+        if (m_cancel)
+        {
+            break;
+        }
+
+        // A new segment is rendered when one is done, to bound the memory used.
 
-        Q_EMIT signalMessage(i18n("Encoding %1 Done", ofile), false);
-        Q_EMIT signalProgress(i);
+        if ((i + ahead) < (count + 1))
+        {
+            d->startWorker(i + ahead);
+        }
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Encoded segment" << i << "done";
+
+        // The segment i ends the effect on the image i-1. The last segment, the
+        // transition to the end, is reported once the delayed frames are written.
+
+        if ((i > 0) && (i < count))
+        {
+            Q_EMIT signalMessage(i18n("Encoding %1 Done", d->settings->inputImages[i - 1].toLocalFile()), false);
+            Q_EMIT signalProgress(i);
+        }
     }
 
+    d->abortRendering();
+
+    qDeleteAll(d->segments);
+    d->segments.clear();
+    d->images.clear();
+    d->imagesReleased.clear();
+
     // ---------------------------------------------
     // Get delayed frames
 
@@ -433,6 +837,12 @@ void VidSlideTask::run()
         }
     }
 
+    if (!m_cancel && (count > 0))
+    {
+        Q_EMIT signalMessage(i18n("Encoding %1 Done", d->settings->inputImages[count - 1].toLocalFile()), false);
+        Q_EMIT signalProgress(count);
+    }
+
     // ---------------------------------------------
     // Cleanup
 
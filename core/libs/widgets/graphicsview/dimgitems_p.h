@@ -26,6 +26,7 @@
 #include "digikam_export.h"
 #include "dimg.h"
 #include "dimgpreviewitem.h"
+#include "dimgtilerenderer.h"
 #include "imagezoomsettings.h"
 #include "previewsettings.h"
 
@@ -77,6 +78,7 @@ public:
     DImg                  image;
     ImageZoomSettings     zoomSettings;
     mutable CachedPixmaps cachedPixmaps;
+    DImgTileRenderer      tileRenderer;
 };
 
 // -------------------------------------------------------------------------------
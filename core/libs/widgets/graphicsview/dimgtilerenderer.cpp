@@ -0,0 +1,626 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : tiled renderer of a scaled DImg for Graphics View items
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgtilerenderer.h"
+
+// Qt includes
+
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPixmap>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimgpixelconverter.h"
+#include "threadmanager.h"
+
+namespace Digikam
+{
+
+namespace
+{
+
+/// Width and height of the tiles, in device pixels.
+const int TILE_SIZE      = 256;
+
+/// The pyramid is reduced until the image is not larger than this size.
+const int MIN_LEVEL_SIZE = 512;
+
+/// The coarse version of the image drawn in place of missing tiles is not larger than this size.
+const int PREVIEW_SIZE   = 2048;
+
+class Q_DECL_HIDDEN TileKey
+{
+public:
+
+    TileKey()
+      : x(0),
+        y(0)
+    {
+    }
+
+    TileKey(const QSize& completeSize, int tileX, int tileY)
+      : size(completeSize),
+        x   (tileX),
+        y   (tileY)
+    {
+    }
+
+    bool operator==(const TileKey& other) const
+    {
+        return ((size == other.size) && (x == other.x) && (y == other.y));
+    }
+
+public:
+
+    QSize size;
+    int   x;
+    int   y;
+};
+
+inline uint qHash(const TileKey& key, uint seed = 0)
+{
+    return ::qHash(((quint64)key.size.width() << 48) ^ ((quint64)key.size.height() << 32) ^
+                   ((quint64)key.x << 16)           ^  (quint64)key.y, seed);
+}
+
+class Q_DECL_HIDDEN TileResult
+{
+public:
+
+    int     generation;
+    TileKey key;
+    QImage  image;
+};
+
+template <typename T>
+void reduceRow(const T* const row0, const T* const row1, T* const dst, int srcWidth, int dstWidth)
+{
+    for (int x = 0 ; x < dstWidth ; ++x)
+    {
+        const int x0 = qMin(2 * x,     srcWidth - 1) * 4;
+        const int x1 = qMin(2 * x + 1, srcWidth - 1) * 4;
+
+        for (int c = 0 ; c < 4 ; ++c)
+        {
+            dst[x * 4 + c] = (T)(((uint)row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+        }
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN DImgTileRenderer::Private
+{
+public:
+
+    explicit Private()
+      : hasConverter  (false),
+        levelsCount   (0),
+        pyramidStarted(false),
+        previewLevel  (-1),
+        generation    (0),
+        notified      (false)
+    {
+        converter = &DImgTileRenderer::toQImage;
+        cache.setMaxCost(256 * 1024);
+        // The renderer keeps its own pools, as the tiles queued for a previous zoom level are
+        // dropped with clear(). The tiles are work the user waits for: they use the budget of
+        // the interactive jobs of the ThreadManager, the pyramid taking one of these threads.
+
+        const int threads = ThreadManager::instance()->maximumJobThreads(ThreadManager::Interactive);
+
+        pool.setMaxThreadCount(qMax(1, threads - 1));
+        pyramidPool.setMaxThreadCount(1);
+    }
+
+    static int levelsCountFor(const DImg& img);
+
+    int  levelFor(const QSize& completeSize) const;
+    DImg availableLevel(int level);
+    void updatePreview();
+
+    static int tileCost(const QPixmap& pix)
+    {
+        return qMax(1, (int)((qint64)pix.width() * pix.height() * qMax(pix.depth(), 8) / 8 / 1024));
+    }
+
+public:
+
+    DImg                     image;
+    TileConverter            converter;
+    bool                     hasConverter;
+
+    QCache<TileKey, QPixmap> cache;             ///< The cost of a tile is its size in KiB.
+    QSet<TileKey>            pending;
+    QSize                    pendingSize;
+
+    int                      levelsCount;
+    bool                     pyramidStarted;
+    QPixmap                  preview;
+    int                      previewLevel;
+
+    QThreadPool              pool;
+    QThreadPool              pyramidPool;
+
+    /// Shared with the worker threads.
+
+    QMutex                   mutex;
+    int                      generation;
+    QVector<DImg>            levels;            ///< The pyramid. The first item is null, the image is only read in the main thread.
+    QList<TileResult>        results;
+    bool                     notified;
+};
+
+int DImgTileRenderer::Private::levelsCountFor(const DImg& img)
+{
+    int size  = qMax(img.width(), img.height());
+    int count = 0;
+
+    while (size > MIN_LEVEL_SIZE)
+    {
+        size /= 2;
+        ++count;
+    }
+
+    return count;
+}
+
+int DImgTileRenderer::Private::levelFor(const QSize& completeSize) const
+{
+    const double zoom = qMax((double)completeSize.width()  / image.width(),
+                             (double)completeSize.height() / image.height());
+    int level         = 0;
+
+    // The coarsest level which is still at least as large as the requested size.
+
+    while ((level < levelsCount) && ((zoom * (1 << (level + 1))) <= 1.0))
+    {
+        ++level;
+    }
+
+    return level;
+}
+
+DImg DImgTileRenderer::Private::availableLevel(int level)
+{
+    QMutexLocker lock(&mutex);
+
+    // The levels are built from the finest to the coarsest: use a finer one until the requested one is ready.
+
+    for (int i = qMin(level, levels.size() - 1) ; i > 0 ; --i)
+    {
+        if (!levels.at(i).isNull())
+        {
+            return levels.at(i);
+        }
+    }
+
+    return DImg();
+}
+
+void DImgTileRenderer::Private::updatePreview()
+{
+    DImg previewImage;
+    int  level = -1;
+
+    {
+        QMutexLocker lock(&mutex);
+
+        // The largest level not larger than the preview size.
+
+        for (int i = 1 ; i < levels.size() ; ++i)
+        {
+            const DImg& img = levels.at(i);
+
+            if (!img.isNull() && (qMax(img.width(), img.height()) <= (uint)PREVIEW_SIZE))
+            {
+                previewImage = img;
+                level        = i;
+                break;
+            }
+        }
+    }
+
+    if (!previewImage.isNull() && (level != previewLevel))
+    {
+        preview      = QPixmap::fromImage(converter(previewImage));
+        previewLevel = level;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+
+DImgTileRenderer::DImgTileRenderer(QObject* const parent)
+    : QObject(parent),
+      d      (new Private)
+{
+}
+
+DImgTileRenderer::~DImgTileRenderer()
+{
+    d->pool.clear();
+    d->pyramidPool.clear();
+
+    {
+        QMutexLocker lock(&d->mutex);
+        ++d->generation;
+    }
+
+    d->pool.waitForDone();
+    d->pyramidPool.waitForDone();
+
+    delete d;
+}
+
+void DImgTileRenderer::setImage(const DImg& image)
+{
+    clear();
+
+    d->image = image;
+}
+
+DImg DImgTileRenderer::image() const
+{
+    return d->image;
+}
+
+void DImgTileRenderer::clear()
+{
+    {
+        QMutexLocker lock(&d->mutex);
+        ++d->generation;
+        d->levels.clear();
+        d->results.clear();
+    }
+
+    // The running tasks finish with their own copy of a level, their results are dropped.
+
+    d->pool.clear();
+    d->pyramidPool.clear();
+
+    d->cache.clear();
+    d->pending.clear();
+    d->pendingSize    = QSize();
+    d->pyramidStarted = false;
+    d->preview        = QPixmap();
+    d->previewLevel   = -1;
+    d->converter      = &DImgTileRenderer::toQImage;
+    d->hasConverter   = false;
+}
+
+void DImgTileRenderer::setTileConverter(const TileConverter& converter)
+{
+    clear();
+
+    d->converter    = converter ? converter : TileConverter(&DImgTileRenderer::toQImage);
+    d->hasConverter = true;
+}
+
+bool DImgTileRenderer::hasTileConverter() const
+{
+    return d->hasConverter;
+}
+
+void DImgTileRenderer::setCacheSize(qint64 bytes)
+{
+    d->cache.setMaxCost((int)qMax((qint64)1, bytes / 1024));
+}
+
+qint64 DImgTileRenderer::cacheSize() const
+{
+    return ((qint64)d->cache.maxCost() * 1024);
+}
+
+bool DImgTileRenderer::paint(QPainter* const painter, const QRectF& targetRect,
+                             const QRect& deviceRect, const QSize& completeSize)
+{
+    if (d->image.isNull() || deviceRect.isEmpty() || completeSize.isEmpty())
+    {
+        return true;
+    }
+
+    // The image size can have changed in place since the last clear().
+
+    if (!d->pyramidStarted)
+    {
+        d->levelsCount = Private::levelsCountFor(d->image);
+    }
+
+    const int level = d->levelFor(completeSize);
+    DImg      source;
+
+    if (level > 0)
+    {
+        if (!d->pyramidStarted)
+        {
+            d->pyramidStarted = true;
+
+            // The first level is computed here, as the image can be changed in place by its owner
+            // once this call returns. The next levels are computed from it in the background.
+
+            const DImg firstLevel = halfSize(d->image);
+
+            {
+                QMutexLocker lock(&d->mutex);
+                d->levels.resize(d->levelsCount + 1);
+                d->levels[1] = firstLevel;
+            }
+
+            if (d->levelsCount > 1)
+            {
+                const int generation  = d->generation;
+                const int levelsCount = d->levelsCount;
+
+                QtConcurrent::run(&d->pyramidPool,
+                                  [this, generation, firstLevel, levelsCount]()
+                                  {
+                                      buildPyramid(generation, firstLevel, levelsCount);
+                                  }
+                );
+            }
+
+            d->updatePreview();
+        }
+
+        source = d->availableLevel(level);
+    }
+
+    // The tiles queued for a previous zoom level are not needed anymore.
+
+    if (completeSize != d->pendingSize)
+    {
+        d->pool.clear();
+        d->pending.clear();
+        d->pendingSize = completeSize;
+    }
+
+    const QRect  imageRect(QPoint(0, 0), completeSize);
+    const QRect  drawRect  = deviceRect.intersected(imageRect);
+    const double scaleX    = targetRect.width()  / deviceRect.width();
+    const double scaleY    = targetRect.height() / deviceRect.height();
+    bool         complete  = true;
+
+    if (drawRect.isEmpty())
+    {
+        return true;
+    }
+
+    for (int ty = drawRect.top() / TILE_SIZE ; ty <= (drawRect.bottom() / TILE_SIZE) ; ++ty)
+    {
+        for (int tx = drawRect.left() / TILE_SIZE ; tx <= (drawRect.right() / TILE_SIZE) ; ++tx)
+        {
+            const QRect   tileRect = QRect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE).intersected(imageRect);
+            const QRect   part     = tileRect.intersected(drawRect);
+            const QRectF  target(targetRect.x() + (part.x() - deviceRect.x()) * scaleX,
+                                 targetRect.y() + (part.y() - deviceRect.y()) * scaleY,
+                                 part.width()  * scaleX,
+                                 part.height() * scaleY);
+            const TileKey key(completeSize, tx, ty);
+            QPixmap* const cached  = d->cache.object(key);
+
+            if (cached)
+            {
+                painter->drawPixmap(target, *cached, QRectF(part.translated(-tileRect.topLeft())));
+
+                continue;
+            }
+
+            if (source.isNull())
+            {
+                // Close to the image size, a tile is quickly computed from the image itself.
+
+                const QPixmap pix = QPixmap::fromImage(d->converter(d->image.smoothScaleClipped(completeSize, tileRect)));
+                painter->drawPixmap(target, pix, QRectF(part.translated(-tileRect.topLeft())));
+                d->cache.insert(key, new QPixmap(pix), Private::tileCost(pix));
+
+                continue;
+            }
+
+            complete = false;
+
+            if (!d->pending.contains(key))
+            {
+                d->pending.insert(key);
+
+                const int           generation = d->generation;
+                const TileConverter converter  = d->converter;
+
+                QtConcurrent::run(&d->pool,
+                                  [this, generation, source, completeSize, tileRect, converter]()
+                                  {
+                                      renderTile(generation, source, completeSize, tileRect, converter);
+                                  }
+                );
+            }
+
+            if (!d->preview.isNull())
+            {
+                const double previewX = (double)d->preview.width()  / completeSize.width();
+                const double previewY = (double)d->preview.height() / completeSize.height();
+
+                painter->drawPixmap(target, d->preview, QRectF(part.x()     * previewX, part.y()      * previewY,
+                                                               part.width() * previewX, part.height() * previewY));
+            }
+        }
+    }
+
+    return complete;
+}
+
+void DImgTileRenderer::buildPyramid(int generation, const DImg& firstLevel, int levelsCount)
+{
+    DImg level = firstLevel;
+
+    for (int i = 2 ; i <= levelsCount ; ++i)
+    {
+        {
+            QMutexLocker lock(&d->mutex);
+
+            if (generation != d->generation)
+            {
+                return;
+            }
+        }
+
+        level = halfSize(level);
+
+        QMutexLocker lock(&d->mutex);
+
+        if ((generation != d->generation) || (i >= d->levels.size()))
+        {
+            return;
+        }
+
+        d->levels[i] = level;
+
+        if (!d->notified)
+        {
+            d->notified = true;
+            QMetaObject::invokeMethod(this, "slotTilesRendered", Qt::QueuedConnection);
+        }
+    }
+}
+
+void DImgTileRenderer::renderTile(int generation, const DImg& level, const QSize& completeSize,
+                                  const QRect& tileRect, const TileConverter& converter)
+{
+    {
+        QMutexLocker lock(&d->mutex);
+
+        if (generation != d->generation)
+        {
+            return;
+        }
+    }
+
+    TileResult result;
+    result.generation = generation;
+    result.key        = TileKey(completeSize, tileRect.x() / TILE_SIZE, tileRect.y() / TILE_SIZE);
+    result.image      = converter(level.smoothScaleClipped(completeSize, tileRect));
+
+    QMutexLocker lock(&d->mutex);
+
+    if (generation != d->generation)
+    {
+        return;
+    }
+
+    d->results << result;
+
+    if (!d->notified)
+    {
+        d->notified = true;
+        QMetaObject::invokeMethod(this, "slotTilesRendered", Qt::QueuedConnection);
+    }
+}
+
+void DImgTileRenderer::slotTilesRendered()
+{
+    QList<TileResult> results;
+
+    {
+        QMutexLocker lock(&d->mutex);
+        results.swap(d->results);
+        d->notified = false;
+    }
+
+    Q_FOREACH (const TileResult& result, results)
+    {
+        if (result.generation != d->generation)
+        {
+            continue;
+        }
+
+        d->pending.remove(result.key);
+
+        QPixmap* const pix = new QPixmap(QPixmap::fromImage(result.image));
+        d->cache.insert(result.key, pix, Private::tileCost(*pix));
+    }
+
+    d->updatePreview();
+
+    Q_EMIT tilesReady();
+}
+
+QImage DImgTileRenderer::toQImage(const DImg& image)
+{
+    QImage img = image.copyQImage();
+
+    if (!image.hasAlpha())
+    {
+        img = img.convertToFormat(QImage::Format_RGB32);
+    }
+
+    return img;
+}
+
+DImg DImgTileRenderer::halfSize(const DImg& image)
+{
+    if (image.isNull())
+    {
+        return DImg();
+    }
+
+    const int srcWidth   = (int)image.width();
+    const int srcHeight  = (int)image.height();
+    const int dstWidth   = qMax(1, srcWidth  / 2);
+    const int dstHeight  = qMax(1, srcHeight / 2);
+    const bool sixteen   = image.sixteenBit();
+    DImg reduced(dstWidth, dstHeight, sixteen, image.hasAlpha());
+
+    const uchar* const src         = image.bits();
+    uchar* const       dst         = reduced.bits();
+    const qint64       srcLineSize = (qint64)srcWidth * image.bytesDepth();
+    const qint64       dstLineSize = (qint64)dstWidth * reduced.bytesDepth();
+
+    DImgPixelConverter::processRows(dstWidth, dstHeight,
+        [=](int begin, int end)
+        {
+            for (int y = begin ; y < end ; ++y)
+            {
+                const uchar* const row0 = src + qMin(2 * y,     srcHeight - 1) * srcLineSize;
+                const uchar* const row1 = src + qMin(2 * y + 1, srcHeight - 1) * srcLineSize;
+                uchar* const       line = dst + y * dstLineSize;
+
+                if (sixteen)
+                {
+                    reduceRow(reinterpret_cast<const ushort*>(row0), reinterpret_cast<const ushort*>(row1),
+                              reinterpret_cast<ushort*>(line), srcWidth, dstWidth);
+                }
+                else
+                {
+                    reduceRow(row0, row1, line, srcWidth, dstWidth);
+                }
+            }
+        }
+    );
+
+    return reduced;
+}
+
+} // namespace Digikam
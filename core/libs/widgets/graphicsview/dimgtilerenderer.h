@@ -0,0 +1,141 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : tiled renderer of a scaled DImg for Graphics View items
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_TILE_RENDERER_H
+#define DIGIKAM_DIMG_TILE_RENDERER_H
+
+// C++ includes
+
+#include <functional>
+
+// Qt includes
+
+#include <QImage>
+#include <QObject>
+#include <QRect>
+#include <QSize>
+
+// Local includes
+
+#include "digikam_export.h"
+#include "dimg.h"
+
+class QPainter;
+
+namespace Digikam
+{
+
+/**
+ * Renders a DImg scaled to any size, by tiles of 256x256 pixels kept in a
+ * cache limited in bytes, the least recently used tiles being dropped first.
+ *
+ * When the image is reduced by more than 2, the tiles are computed on worker
+ * threads from a pyramid of images reduced by 2, 4, 8... built in the
+ * background. A coarse version of the image is drawn in place of the tiles
+ * not yet available, and tilesReady() is emitted when they arrive.
+ *
+ * The image is only read in the main thread: its owner can change it in
+ * place, and must call clear() when done.
+ */
+class DIGIKAM_EXPORT DImgTileRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Converts a scaled part of the image to the image to display.
+     * Called from worker threads: it must not use the GUI.
+     */
+    typedef std::function<QImage(const DImg&)> TileConverter;
+
+public:
+
+    explicit DImgTileRenderer(QObject* const parent = nullptr);
+    ~DImgTileRenderer() override;
+
+    /**
+     * Sets the image to render. As with clear(), all tiles are dropped.
+     * Note: DImg is explicitly shared, and no copy is taken here.
+     */
+    void setImage(const DImg& image);
+    DImg image()                                                const;
+
+    /**
+     * Drops all tiles, the pyramid and the tile converter.
+     * Call this when the image data or the display settings changed.
+     */
+    void clear();
+
+    /**
+     * The converter applied to each tile. The default one only converts the
+     * tile to a QImage. Changing the converter drops all tiles.
+     */
+    void setTileConverter(const TileConverter& converter);
+    bool hasTileConverter()                                     const;
+
+    /**
+     * The maximum size in bytes of the cached tiles. Default is 256 MB.
+     */
+    void   setCacheSize(qint64 bytes);
+    qint64 cacheSize()                                          const;
+
+    /**
+     * Draws the region deviceRect of the image scaled to completeSize
+     * in targetRect, both sizes being in device pixels.
+     * Returns true if all tiles of the region were available.
+     */
+    bool paint(QPainter* const painter, const QRectF& targetRect,
+               const QRect& deviceRect, const QSize& completeSize);
+
+    /**
+     * Converts an image to a QImage as done by the default tile converter.
+     */
+    static QImage toQImage(const DImg& image);
+
+    /**
+     * Returns the image reduced by 2, each pixel being the average of 2x2 pixels.
+     */
+    static DImg halfSize(const DImg& image);
+
+Q_SIGNALS:
+
+    /// Emitted when tiles rendered in the background can be painted.
+    void tilesReady();
+
+private Q_SLOTS:
+
+    void slotTilesRendered();
+
+private:
+
+    void buildPyramid(int generation, const DImg& firstLevel, int levelsCount);
+    void renderTile(int generation, const DImg& level, const QSize& completeSize,
+                    const QRect& tileRect, const TileConverter& converter);
+
+private:
+
+    // Disable
+    DImgTileRenderer(const DImgTileRenderer&)            = delete;
+    DImgTileRenderer& operator=(const DImgTileRenderer&) = delete;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_DIMG_TILE_RENDERER_H
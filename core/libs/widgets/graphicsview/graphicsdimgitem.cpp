@@ -131,6 +131,15 @@ void GraphicsDImgItem::GraphicsDImgItemPrivate::init(GraphicsDImgItem* const q)
 
     q->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
     q->setAcceptedMouseButtons(Qt::NoButton);
+
+    // Repaint when tiles rendered in the background are available.
+
+    QObject::connect(&tileRenderer, &DImgTileRenderer::tilesReady,
+                     q, [q]()
+        {
+            q->update();
+        }
+    );
 }
 
 GraphicsDImgItem::~GraphicsDImgItem()
@@ -146,6 +155,7 @@ void GraphicsDImgItem::setImage(const DImg& img)
     d->image = img;
     d->zoomSettings.setImageSize(img.size(), img.originalSize());
     d->cachedPixmaps.clear();
+    d->tileRenderer.setImage(img);
     sizeHasChanged();
 
     Q_EMIT imageChanged();
@@ -173,6 +183,7 @@ void GraphicsDImgItem::clearCache()
     Q_D(GraphicsDImgItem);
 
     d->cachedPixmaps.clear();
+    d->tileRenderer.clear();
 }
 
 const ImageZoomSettings* GraphicsDImgItem::zoomSettings() const
@@ -198,13 +209,11 @@ QRectF GraphicsDImgItem::boundingRect() const
     return QRectF(QPointF(0, 0), d->zoomSettings.zoomedSize()).toAlignedRect();
 }
 
-void GraphicsDImgItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*)
+void GraphicsDImgItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
     Q_D(GraphicsDImgItem);
 
     QRect   drawRect     = option->exposedRect.intersected(boundingRect()).toAlignedRect();
-    QRect   pixSourceRect;
-    QPixmap pix;
     QSize   completeSize = boundingRect().size().toSize();
 
     /* For high resolution ("retina") displays, Mac OS X / Qt
@@ -233,33 +242,22 @@ void GraphicsDImgItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
                                    ratio * drawRect.width(),
                                    ratio * drawRect.height()).toRect();
 
-    if (d->cachedPixmaps.find(scaledDrawRect, &pix, &pixSourceRect))
-    {
-        if (pixSourceRect.isNull())
-        {
-            painter->drawPixmap(drawRect, pix);
-        }
-        else
-        {
-            painter->drawPixmap(drawRect, pix, pixSourceRect);
-        }
-    }
-    else
+    // scale "as if" scaling to whole image, but only render the tiles of our exposed region
+
+    QSize scaledCompleteSize = QSizeF(ratio * completeSize.width(),
+                                      ratio * completeSize.height()).toSize();
+
+    if (!d->tileRenderer.hasTileConverter())
     {
-        // scale "as if" scaling to whole image, but clip output to our exposed region
-
-        QSize scaledCompleteSize = QSizeF(ratio * completeSize.width(),
-                                          ratio * completeSize.height()).toSize();
-        DImg scaledImage         = d->image.smoothScaleClipped(scaledCompleteSize.width(),
-                                                               scaledCompleteSize.height(),
-                                                               scaledDrawRect.x(),
-                                                               scaledDrawRect.y(),
-                                                               scaledDrawRect.width(),
-                                                               scaledDrawRect.height());
-        pix                      = scaledImage.convertToPixmap();
-        d->cachedPixmaps.insert(scaledDrawRect, pix);
-        painter->drawPixmap(drawRect, pix);
+        d->tileRenderer.setTileConverter(tileConverter(widget));
     }
+
+    d->tileRenderer.paint(painter, drawRect, scaledDrawRect, scaledCompleteSize);
+}
+
+DImgTileRenderer::TileConverter GraphicsDImgItem::tileConverter(QWidget* const) const
+{
+    return DImgTileRenderer::TileConverter();
 }
 
 void GraphicsDImgItem::contextMenuEvent(QGraphicsSceneContextMenuEvent* e)
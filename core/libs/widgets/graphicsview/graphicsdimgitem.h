@@ -25,6 +25,7 @@
 // Local includes
 
 #include "digikam_export.h"
+#include "dimgtilerenderer.h"
 
 namespace Digikam
 {
@@ -74,6 +75,13 @@ protected:
 
     void contextMenuEvent(QGraphicsSceneContextMenuEvent* e)          override;
 
+    /**
+     * Returns the converter applied to the scaled parts of the image before display,
+     * for example to apply color management. Called from paint() after clearCache().
+     * The default implementation returns a null converter, to only convert the image.
+     */
+    virtual DImgTileRenderer::TileConverter tileConverter(QWidget* const widget) const;
+
 public:
 
     // Declared public because of DImgPreviewItemPrivate.
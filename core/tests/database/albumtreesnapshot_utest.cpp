@@ -0,0 +1,174 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the album trees snapshot
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "albumtreesnapshot_utest.h"
+
+// Qt includes
+
+#include <QFile>
+#include <QTemporaryDir>
+
+// Local includes
+
+#include "albumtreesnapshot.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "dbengineparameters.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(AlbumTreeSnapshotTest)
+
+AlbumTreeSnapshotTest::AlbumTreeSnapshotTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void AlbumTreeSnapshotTest::initTestCase()
+{
+    DbEngineParameters params(QLatin1String("QSQLITE"), QLatin1String(":memory:"), QString());
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+}
+
+void AlbumTreeSnapshotTest::testSaveLoad()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = dir.filePath(QLatin1String("albumtree.snapshot"));
+
+    AlbumTreeSnapshot snapshot;
+    snapshot.databaseUuid  = QUuid::createUuid();
+    snapshot.changeCounter = 42;
+
+    AlbumInfo album;
+    album.id           = 3;
+    album.albumRootId  = 1;
+    album.relativePath = QLatin1String("/2022/Holidays");
+    album.caption      = QLatin1String("Beach");
+    album.date         = QDate(2022, 8, 1);
+    album.iconId       = 17;
+    snapshot.albums << album;
+
+    TagInfo tag;
+    tag.id   = 5;
+    tag.pid  = 2;
+    tag.name = QLatin1String("Family");
+    tag.icon = QLatin1String("tag-people");
+    snapshot.tags << tag;
+
+    SearchInfo search;
+    search.id    = 8;
+    search.name  = QLatin1String("Last week");
+    search.type  = DatabaseSearch::AdvancedSearch;
+    search.query = QLatin1String("<search/>");
+    snapshot.searches << search;
+
+    snapshot.hasAlbumsCount = true;
+    snapshot.albumsCount.insert(3, 120);
+    snapshot.hasDatesCount  = true;
+    snapshot.datesCount.insert(QDateTime(QDate(2022, 8, 1), QTime(0, 0)), 120);
+
+    QVERIFY(snapshot.save(path));
+
+    AlbumTreeSnapshot loaded;
+    QVERIFY(loaded.load(path));
+
+    QCOMPARE(loaded.databaseUuid,   snapshot.databaseUuid);
+    QCOMPARE(loaded.changeCounter,  snapshot.changeCounter);
+
+    QCOMPARE(loaded.albums.size(),  1);
+    QCOMPARE(loaded.albums.first().id,           album.id);
+    QCOMPARE(loaded.albums.first().albumRootId,  album.albumRootId);
+    QCOMPARE(loaded.albums.first().relativePath, album.relativePath);
+    QCOMPARE(loaded.albums.first().caption,      album.caption);
+    QCOMPARE(loaded.albums.first().date,         album.date);
+    QCOMPARE(loaded.albums.first().iconId,       album.iconId);
+
+    QCOMPARE(loaded.tags.size(),    1);
+    QCOMPARE(loaded.tags.first().id,   tag.id);
+    QCOMPARE(loaded.tags.first().pid,  tag.pid);
+    QCOMPARE(loaded.tags.first().name, tag.name);
+    QCOMPARE(loaded.tags.first().icon, tag.icon);
+
+    QCOMPARE(loaded.searches.size(), 1);
+    QCOMPARE(loaded.searches.first().type,  search.type);
+    QCOMPARE(loaded.searches.first().query, search.query);
+
+    QVERIFY(loaded.hasAlbumsCount);
+    QVERIFY(!loaded.hasTagsCount);
+    QVERIFY(loaded.hasDatesCount);
+    QCOMPARE(loaded.albumsCount, snapshot.albumsCount);
+    QCOMPARE(loaded.datesCount,  snapshot.datesCount);
+}
+
+void AlbumTreeSnapshotTest::testInvalidFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = dir.filePath(QLatin1String("albumtree.snapshot"));
+
+    AlbumTreeSnapshot snapshot;
+    QVERIFY(!snapshot.load(path));
+
+    snapshot.databaseUuid  = QUuid::createUuid();
+    snapshot.changeCounter = 1;
+
+    for (int i = 1 ; i <= 100 ; ++i)
+    {
+        AlbumInfo album;
+        album.id           = i;
+        album.albumRootId  = 1;
+        album.relativePath = QString::fromLatin1("/album%1").arg(i);
+        snapshot.albums << album;
+    }
+
+    QVERIFY(snapshot.save(path));
+
+    // A truncated snapshot is not loaded.
+
+    QFile file(path);
+    QVERIFY(file.resize(file.size() / 2));
+
+    AlbumTreeSnapshot truncated;
+    QVERIFY(!truncated.load(path));
+    QVERIFY(truncated.albums.isEmpty());
+    QCOMPARE(truncated.changeCounter, (qlonglong)-1);
+
+    // Neither is a file which is not a snapshot.
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("not a snapshot of the album trees");
+    file.close();
+
+    QVERIFY(!truncated.load(path));
+}
+
+void AlbumTreeSnapshotTest::testChangeCounter()
+{
+    const qlonglong counter = CoreDbAccess().db()->getAlbumTreeChangeCounter();
+    QVERIFY(counter >= 0);
+
+    const int tagId = CoreDbAccess().db()->addTag(0, QLatin1String("Snapshot"), QString(), 0);
+    QVERIFY(tagId > 0);
+
+    QCOMPARE(CoreDbAccess().db()->getAlbumTreeChangeCounter(), counter + 1);
+
+    CoreDbAccess().db()->deleteTag(tagId);
+
+    QCOMPARE(CoreDbAccess().db()->getAlbumTreeChangeCounter(), counter + 2);
+}
@@ -0,0 +1,40 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the album trees snapshot
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ALBUM_TREE_SNAPSHOT_UTEST_H
+#define DIGIKAM_ALBUM_TREE_SNAPSHOT_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QTest>
+
+class AlbumTreeSnapshotTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit AlbumTreeSnapshotTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testSaveLoad();
+    void testInvalidFiles();
+    void testChangeCounter();
+};
+
+#endif // DIGIKAM_ALBUM_TREE_SNAPSHOT_UTEST_H
@@ -0,0 +1,215 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the items counted by day of creation
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "coredbdatecounts_utest.h"
+
+// Qt includes
+
+#include <QDateTime>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbbackend.h"
+#include "collectionlocation.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(CoreDbDateCountsTest)
+
+CoreDbDateCountsTest::CoreDbDateCountsTest(QObject* const parent)
+    : QObject    (parent),
+      m_albumA   (-1),
+      m_albumB   (-1),
+      m_trashedId(-1)
+{
+}
+
+void CoreDbDateCountsTest::initTestCase()
+{
+    DbEngineParameters params(QString::fromUtf8("QSQLITE"),
+                              QString::fromUtf8(":memory:"),
+                              QString::fromUtf8(""));
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+
+    CoreDbAccess access;
+    QVERIFY(access.db()->hasImageDateCounts());
+
+    const int rootId = access.db()->addAlbumRoot(CollectionLocation::VolumeHardWired,
+                                                 QLatin1String("volumeid:?path=/tmp"),
+                                                 QLatin1String("/"), QLatin1String("test"));
+    m_albumA         = access.db()->addAlbum(rootId, QLatin1String("/a"), QString(),
+                                             QDate::currentDate(), QString());
+    m_albumB         = access.db()->addAlbum(rootId, QLatin1String("/b"), QString(),
+                                             QDate::currentDate(), QString());
+}
+
+void CoreDbDateCountsTest::cleanupTestCase()
+{
+    CoreDbAccess::cleanUpDatabase();
+}
+
+qlonglong CoreDbDateCountsTest::addItem(int albumId, const QString& name, const QVariant& creationDate)
+{
+    CoreDbAccess access;
+    const qlonglong id = access.db()->addItem(albumId, name, DatabaseItem::Visible, DatabaseItem::Image,
+                                              QDateTime::currentDateTime(), 1000, QString());
+
+    access.db()->addItemInformation(id, QVariantList() << creationDate, DatabaseFields::CreationDate);
+
+    return id;
+}
+
+QHash<QDate, int> CoreDbDateCountsTest::groupByCounts() const
+{
+    QList<QVariant> values;
+
+    CoreDbAccess().backend()->execSql(QString::fromUtf8("SELECT substr(creationDate, 1, 10), COUNT(*) FROM ImageInformation "
+                                                        "INNER JOIN Images ON Images.id=ImageInformation.imageid "
+                                                        " WHERE Images.status=1 AND creationDate IS NOT NULL "
+                                                        " GROUP BY substr(creationDate, 1, 10);"),
+                                      &values);
+
+    QHash<QDate, int> counts;
+
+    for (QList<QVariant>::const_iterator it = values.constBegin() ; it != values.constEnd() ; )
+    {
+        const QDate date = QDate::fromString(it->toString(), Qt::ISODate);
+        ++it;
+        counts[date]    += it->toInt();
+        ++it;
+    }
+
+    return counts;
+}
+
+void CoreDbDateCountsTest::compareCounts()
+{
+    const QHash<QDate, int> counts = CoreDbAccess().db()->getCreationDateCounts();
+    const QHash<QDate, int> groups = groupByCounts();
+
+    QCOMPARE(counts, groups);
+}
+
+void CoreDbDateCountsTest::testAdd()
+{
+    const QDateTime day1(QDate(2021, 5, 1), QTime(10, 0));
+    const QDateTime day2(QDate(2021, 5, 2), QTime(23, 59));
+
+    addItem(m_albumA, QLatin1String("a1.jpg"), day1);
+    addItem(m_albumA, QLatin1String("a2.jpg"), day1.addSecs(3600));
+    addItem(m_albumA, QLatin1String("a3.jpg"), day2);
+    addItem(m_albumA, QLatin1String("a4.jpg"), QVariant());
+    addItem(m_albumB, QLatin1String("b1.jpg"), day2);
+
+    const QHash<QDate, int> counts = CoreDbAccess().db()->getCreationDateCounts();
+
+    QCOMPARE(counts.count(),            2);
+    QCOMPARE(counts.value(day1.date()), 2);
+    QCOMPARE(counts.value(day2.date()), 2);
+
+    compareCounts();
+}
+
+void CoreDbDateCountsTest::testCreationDateChange()
+{
+    CoreDbAccess access;
+    const qlonglong a1 = access.db()->getImageId(m_albumA, QLatin1String("a1.jpg"));
+    const qlonglong a3 = access.db()->getImageId(m_albumA, QLatin1String("a3.jpg"));
+    const qlonglong a4 = access.db()->getImageId(m_albumA, QLatin1String("a4.jpg"));
+
+    // To another day, to a new day, from and to no date, and in the same day.
+
+    access.db()->changeItemInformation(a1, QVariantList() << QDateTime(QDate(2021, 5, 2), QTime(8, 0)),
+                                       DatabaseFields::CreationDate);
+    compareCounts();
+
+    access.db()->changeItemInformation(a3, QVariantList() << QDateTime(QDate(2022, 1, 1), QTime(8, 0)),
+                                       DatabaseFields::CreationDate);
+    compareCounts();
+
+    access.db()->changeItemInformation(a4, QVariantList() << QDateTime(QDate(2021, 5, 1), QTime(12, 0)),
+                                       DatabaseFields::CreationDate);
+    compareCounts();
+
+    access.db()->changeItemInformation(a3, QVariantList() << QVariant(),
+                                       DatabaseFields::CreationDate);
+    compareCounts();
+
+    access.db()->changeItemInformation(a1, QVariantList() << QDateTime(QDate(2021, 5, 2), QTime(20, 0)),
+                                       DatabaseFields::CreationDate);
+    compareCounts();
+
+    QVERIFY(!access.db()->getCreationDateCounts().contains(QDate(2022, 1, 1)));
+}
+
+void CoreDbDateCountsTest::testStatusChange()
+{
+    CoreDbAccess access;
+    const qlonglong a2 = access.db()->getImageId(m_albumA, QLatin1String("a2.jpg"));
+    const qlonglong b1 = access.db()->getImageId(m_albumB, QLatin1String("b1.jpg"));
+
+    access.db()->setItemStatus(a2, DatabaseItem::Hidden);
+    compareCounts();
+
+    // The date of a hidden item changes without counting it.
+
+    access.db()->changeItemInformation(a2, QVariantList() << QDateTime(QDate(2020, 3, 3), QTime(8, 0)),
+                                       DatabaseFields::CreationDate);
+    compareCounts();
+
+    access.db()->setItemStatus(a2, DatabaseItem::Visible);
+    compareCounts();
+    QCOMPARE(access.db()->getCreationDateCounts().value(QDate(2020, 3, 3)), 1);
+
+    access.db()->removeItems(QList<qlonglong>() << b1, QList<int>() << m_albumB);
+    compareCounts();
+
+    m_trashedId = b1;
+}
+
+void CoreDbDateCountsTest::testMove()
+{
+    CoreDbAccess access;
+    const QHash<QDate, int> before = access.db()->getCreationDateCounts();
+
+    access.db()->moveItem(m_albumA, QLatin1String("a1.jpg"), m_albumB, QLatin1String("a1.jpg"));
+    compareCounts();
+
+    QCOMPARE(access.db()->getCreationDateCounts(), before);
+}
+
+void CoreDbDateCountsTest::testDelete()
+{
+    CoreDbAccess access;
+
+    // A visible item, and the trashed one, which is not counted anymore.
+
+    access.db()->deleteItem(m_albumB, QLatin1String("a1.jpg"));
+    compareCounts();
+
+    access.db()->removeItemsPermanently(QList<qlonglong>() << m_trashedId);
+    access.db()->deleteRemovedItems();
+    compareCounts();
+
+    access.db()->deleteItem(m_albumA, QLatin1String("a2.jpg"));
+    access.db()->deleteItem(m_albumA, QLatin1String("a3.jpg"));
+    access.db()->deleteItem(m_albumA, QLatin1String("a4.jpg"));
+    compareCounts();
+
+    QVERIFY(access.db()->getCreationDateCounts().isEmpty());
+}
@@ -0,0 +1,62 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the items counted by day of creation
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_COREDB_DATE_COUNTS_UTEST_H
+#define DIGIKAM_COREDB_DATE_COUNTS_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QDate>
+#include <QHash>
+#include <QTest>
+
+class CoreDbDateCountsTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit CoreDbDateCountsTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testAdd();
+    void testCreationDateChange();
+    void testStatusChange();
+    void testMove();
+    void testDelete();
+
+private:
+
+    qlonglong addItem(int albumId, const QString& name, const QVariant& creationDate);
+
+    /**
+     * Counts the visible items by day with GROUP BY, as done without the table of the counts.
+     */
+    QHash<QDate, int> groupByCounts() const;
+
+    void compareCounts();
+
+private:
+
+    int       m_albumA;
+    int       m_albumB;
+    qlonglong m_trashedId;
+};
+
+#endif // DIGIKAM_COREDB_DATE_COUNTS_UTEST_H
@@ -76,33 +76,18 @@ do {\
         if (ENABLE_TIMEOUT)\
             QVERIFY(QDateTime::currentMSecsSinceEpoch() - startTime < 1000); \
     } \
-    QTest::qWait(1000); /* Wait until AlbumManager refreshed the salbums */ \
-    \
-    AlbumList aList = AlbumManager::instance()->allSAlbums(); \
-    for (AlbumList::iterator it = aList.begin() ; it != aList.end() ; ++it) { \
-        SAlbum* salbum = dynamic_cast<SAlbum*>(*it); \
-        if (salbum) \
-            salbum->removeExtraData(this); \
-    }\
-    \
     QTreeWidget w; \
-    for (AlbumList::const_iterator it = aList.constBegin() ; it != aList.constEnd() ; ++it) \
+    const QList<DuplicatesGroup> groups = SimilarityDbAccess().db()->getDuplicatesGroups(0, -1); \
+    for (const DuplicatesGroup& group : groups) \
     { \
-        SAlbum* const salbum = dynamic_cast<SAlbum*>(*it); \
-    \
-        if (salbum && salbum->isDuplicatesSearch() && !salbum->extraData(this)) \
-        { \
-            /* Adding item to listView by creating an item and passing listView as parent */  \
-            FindDuplicatesAlbumItem* const item = new FindDuplicatesAlbumItem(&w, salbum); \
-            salbum->setExtraData(this, item); \
-            const auto id = salbum->title().toLongLong(); \
-            ItemInfo info(id); \
-            const auto path = QDir(filesPath).relativeFilePath(info.filePath()); \
-            const QList<ItemInfo> duplicates = item->duplicatedItems(); \
+        /* Adding item to listView by creating an item and passing listView as parent */  \
+        FindDuplicatesAlbumItem* const item = new FindDuplicatesAlbumItem(&w, group); \
+        ItemInfo info(group.reference); \
+        const auto path = QDir(filesPath).relativeFilePath(info.filePath()); \
+        const QList<ItemInfo> duplicates = item->duplicatedItems(); \
     \
-            if (!references.contains(path)) \
-                references.insert(path, duplicates); \
-        } \
+        if (!references.contains(path)) \
+            references.insert(path, duplicates); \
     } \
 } while(false);
 
@@ -573,6 +558,93 @@ void HaarIfaceTest::testReferenceFolderPartlySelected() {
     }
 }
 
+void HaarIfaceTest::testRemoveFromDuplicatesGroups()
+{
+    QList<DuplicatesGroup> groups;
+
+    DuplicatesGroup group;
+    group.similarity = 0.9;
+
+    // The reference image is deleted: the next item becomes the reference.
+
+    group.reference = 100001;
+    group.items     = QList<qlonglong>() << 100001 << 100002 << 100003;
+    groups << group;
+
+    // Only one item is left: the group is removed.
+
+    group.reference = 100011;
+    group.items     = QList<qlonglong>() << 100011 << 100012;
+    groups << group;
+
+    // A duplicate is deleted: the reference does not change.
+
+    group.reference = 100021;
+    group.items     = QList<qlonglong>() << 100021 << 100022 << 100023;
+    groups << group;
+
+    // More images deleted than the values of one statement, with the reference.
+
+    group.reference = 200000;
+    group.items.clear();
+
+    for (qlonglong id = 200000 ; id < 201500 ; ++id)
+    {
+        group.items << id;
+    }
+
+    groups << group;
+
+    SimilarityDbAccess().db()->setDuplicatesGroups(groups, false);
+    QCOMPARE(SimilarityDbAccess().db()->getDuplicatesGroupsCount(), 4);
+
+    QList<qlonglong> deleted;
+    deleted << 100001 << 100012 << 100023;
+
+    for (qlonglong id = 200000 ; id < 201200 ; ++id)
+    {
+        deleted << id;
+    }
+
+    const QHash<qlonglong, qlonglong> modified = SimilarityDbAccess().db()->removeFromDuplicatesGroups(deleted);
+
+    QCOMPARE(modified.count(), 4);
+    QCOMPARE(modified.value(100001), 100002LL);
+    QCOMPARE(modified.value(100011), -1LL);
+    QCOMPARE(modified.value(100021), 100021LL);
+    QCOMPARE(modified.value(200000), 201200LL);
+
+    QCOMPARE(SimilarityDbAccess().db()->getDuplicatesGroupsCount(), 3);
+
+    QVERIFY(SimilarityDbAccess().db()->getDuplicatesGroup(100001).isNull());
+    QVERIFY(SimilarityDbAccess().db()->getDuplicatesGroup(100011).isNull());
+    QVERIFY(SimilarityDbAccess().db()->getDuplicatesGroup(200000).isNull());
+
+    DuplicatesGroup updated = SimilarityDbAccess().db()->getDuplicatesGroup(100002);
+    QCOMPARE(updated.reference, 100002LL);
+    QCOMPARE(updated.items.count(), 2);
+    QVERIFY(updated.items.contains(100002));
+    QVERIFY(updated.items.contains(100003));
+
+    updated = SimilarityDbAccess().db()->getDuplicatesGroup(100021);
+    QCOMPARE(updated.items.count(), 2);
+    QVERIFY(!updated.items.contains(100023));
+
+    updated = SimilarityDbAccess().db()->getDuplicatesGroup(201200);
+    QCOMPARE(updated.items.count(), 300);
+    QVERIFY(updated.items.contains(201200));
+
+    // The items count of the listed groups follows the removal.
+
+    Q_FOREACH (const DuplicatesGroup& listed, SimilarityDbAccess().db()->getDuplicatesGroups(0, -1))
+    {
+        QVERIFY(listed.items.contains(listed.reference));
+        QVERIFY(listed.items.count() >= 2);
+    }
+
+    SimilarityDbAccess().db()->clearDuplicatesGroups();
+}
+
 HaarIfaceTest::~HaarIfaceTest()
 {
 }
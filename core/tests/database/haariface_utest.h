@@ -48,6 +48,7 @@ private Q_SLOTS:
     void testPreferFolderWhole();
     void testReferenceFolderNotSelected();
     void testReferenceFolderPartlySelected();
+    void testRemoveFromDuplicatesGroups();
 
 private:
     void startSqlite(const QDir& dbDir);
@@ -0,0 +1,185 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for ItemAttributesStore class
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "itemattributesstore_utest.h"
+
+// Qt includes
+
+#include <QDateTime>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "collectionlocation.h"
+#include "digikam_globals.h"
+#include "itemattributesstore.h"
+#include "itemfiltersettings.h"
+#include "iteminfo.h"
+#include "itemsortsettings.h"
+#include "tagscache.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ItemAttributesStoreTest)
+
+ItemAttributesStoreTest::ItemAttributesStoreTest(QObject* const parent)
+    : QObject(parent),
+      m_tagA (0),
+      m_tagB (0)
+{
+}
+
+void ItemAttributesStoreTest::initTestCase()
+{
+    DbEngineParameters params(QString::fromUtf8("QSQLITE"),
+                              QString::fromUtf8(":memory:"),
+                              QString::fromUtf8(""));
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+
+    m_tagA = TagsCache::instance()->createTag(QLatin1String("Test/A"));
+    m_tagB = TagsCache::instance()->createTag(QLatin1String("Test/B"));
+
+    CoreDbAccess access;
+    const int rootId  = access.db()->addAlbumRoot(CollectionLocation::VolumeHardWired,
+                                                  QLatin1String("volumeid:?path=/tmp"),
+                                                  QLatin1String("/"), QLatin1String("test"));
+    const int albumId = access.db()->addAlbum(rootId, QLatin1String("/"), QString(),
+                                              QDate::currentDate(), QString());
+
+    const QDateTime date(QDate(2022, 11, 14), QTime(10, 0));
+
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+        const qlonglong id = access.db()->addItem(albumId, QString::fromLatin1("item%1.jpg").arg(i),
+                                                  DatabaseItem::Visible, DatabaseItem::Image,
+                                                  date.addDays(i), 1000 * (3 - i), QString());
+
+        access.db()->addItemInformation(id, QVariantList() << i + 1 << date.addDays(-i),
+                                        DatabaseFields::Rating | DatabaseFields::CreationDate);
+        m_ids << id;
+    }
+
+    // Tags are added in reverse order, the store keeps them sorted.
+
+    access.db()->addItemTag(m_ids.at(0), m_tagB);
+    access.db()->addItemTag(m_ids.at(0), m_tagA);
+    access.db()->addItemTag(m_ids.at(1), m_tagA);
+    access.db()->addItemTag(m_ids.at(2), TagsCache::instance()->tagForPickLabel(AcceptedLabel));
+}
+
+void ItemAttributesStoreTest::testLoad()
+{
+    QVERIFY(ItemAttributesStore::instance()->snapshot().isNull());
+
+    const ItemAttributesSnapshot snapshot = ItemAttributesStore::instance()->snapshot(m_ids);
+
+    QVERIFY(!snapshot.isNull());
+
+    Q_FOREACH (const qlonglong& id, m_ids)
+    {
+        QVERIFY(snapshot.contains(id));
+    }
+
+    QVERIFY(!snapshot.contains(m_ids.last() + 100));
+
+    const ItemAttributesSnapshot::Tags tags = snapshot.tagIds(ItemInfo(m_ids.at(0)));
+
+    QCOMPARE(tags.count(), 2);
+    QCOMPARE(*tags.begin(), qMin(m_tagA, m_tagB));
+    QVERIFY(tags.contains(m_tagA));
+    QVERIFY(tags.contains(m_tagB));
+    QCOMPARE(snapshot.pickLabel(ItemInfo(m_ids.at(2))), (int)AcceptedLabel);
+}
+
+void ItemAttributesStoreTest::testSameValuesAsItemInfo()
+{
+    const ItemAttributesSnapshot snapshot = ItemAttributesStore::instance()->snapshot(m_ids);
+    const ItemAttributesSnapshot null;
+
+    Q_FOREACH (const qlonglong& id, m_ids)
+    {
+        ItemInfo info(id);
+
+        QCOMPARE(snapshot.rating(info),           null.rating(info));
+        QCOMPARE(snapshot.pickLabel(info),        null.pickLabel(info));
+        QCOMPARE(snapshot.colorLabel(info),       null.colorLabel(info));
+        QCOMPARE(snapshot.creationDate(info),     null.creationDate(info));
+        QCOMPARE(snapshot.creationDay(info),      null.creationDay(info));
+        QCOMPARE(snapshot.modificationDate(info), null.modificationDate(info));
+        QCOMPARE(snapshot.fileSize(info),         null.fileSize(info));
+        QCOMPARE(snapshot.tagIds(info).toList(),  null.tagIds(info).toList());
+    }
+}
+
+void ItemAttributesStoreTest::testChangesets()
+{
+    const qlonglong id                  = m_ids.at(1);
+    const ItemAttributesSnapshot before = ItemAttributesStore::instance()->snapshot(m_ids);
+
+    CoreDbAccess().db()->changeItemInformation(id, QVariantList() << 5, DatabaseFields::Rating);
+    CoreDbAccess().db()->addItemTag(id, m_tagB);
+
+    // A snapshot never changes, the store marks the item as changed in a new snapshot.
+
+    QVERIFY(before.contains(id));
+    QVERIFY(!ItemAttributesStore::instance()->snapshot().contains(id));
+    QCOMPARE(ItemAttributesStore::instance()->snapshot().rating(ItemInfo(id)), 5);
+
+    const ItemAttributesSnapshot after  = ItemAttributesStore::instance()->snapshot(m_ids);
+
+    QVERIFY(after.contains(id));
+    QCOMPARE(after.rating(ItemInfo(id)), 5);
+    QVERIFY(after.tagIds(ItemInfo(id)).contains(m_tagB));
+}
+
+void ItemAttributesStoreTest::testFilterAndSort()
+{
+    const ItemAttributesSnapshot snapshot = ItemAttributesStore::instance()->snapshot(m_ids);
+
+    ItemFilterSettings filter;
+    filter.setRatingFilter(2, ItemFilterSettings::GreaterEqualCondition, false);
+    filter.setTagFilter(QList<int>() << m_tagA, QList<int>(), ItemFilterSettings::OrCondition,
+                        false, QList<int>(), QList<int>());
+
+    ItemSortSettings sorter;
+    sorter.setSortRole(ItemSortSettings::SortByCreationDate);
+    sorter.setSortOrder(ItemSortSettings::AscendingOrder);
+
+    Q_FOREACH (const qlonglong& id, m_ids)
+    {
+        ItemInfo info(id);
+
+        QCOMPARE(filter.matches(info, snapshot), filter.matches(info));
+
+        Q_FOREACH (const qlonglong& other, m_ids)
+        {
+            ItemInfo otherInfo(other);
+
+            QCOMPARE(sorter.lessThan(info, otherInfo, snapshot), sorter.lessThan(info, otherInfo));
+        }
+    }
+
+    // Item 0 is rated 1, item 1 has tag A and rating 5, item 2 has no tag A.
+
+    QVERIFY(!filter.matches(ItemInfo(m_ids.at(0)), snapshot));
+    QVERIFY(filter.matches(ItemInfo(m_ids.at(1)), snapshot));
+    QVERIFY(!filter.matches(ItemInfo(m_ids.at(2)), snapshot));
+
+    // Creation dates decrease with the item index.
+
+    QVERIFY(sorter.lessThan(ItemInfo(m_ids.at(2)), ItemInfo(m_ids.at(0)), snapshot));
+}
@@ -0,0 +1,53 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for ItemAttributesStore class
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ITEM_ATTRIBUTES_STORE_UTEST_H
+#define DIGIKAM_ITEM_ATTRIBUTES_STORE_UTEST_H
+
+// Qt includes
+
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+/**
+ * Unit tests for ItemAttributesStore class in core/libs/database/item/containers/itemattributesstore.h
+ *
+ * Uses a temporary in-memory sqlite database, and does not require a GUI.
+ */
+class ItemAttributesStoreTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit ItemAttributesStoreTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testLoad();
+    void testSameValuesAsItemInfo();
+    void testChangesets();
+    void testFilterAndSort();
+
+private:
+
+    QList<qlonglong> m_ids;
+    int              m_tagA;
+    int              m_tagB;
+};
+
+#endif // DIGIKAM_ITEM_ATTRIBUTES_STORE_UTEST_H
@@ -0,0 +1,253 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the metadata write-back queue
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "metadatawritequeue_utest.h"
+
+// Qt includes
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "collectionlocation.h"
+#include "fileactionimageinfolist.h"
+#include "iteminfo.h"
+#include "metadatahub.h"
+#include "metadatawritequeue.h"
+#include "metaenginesettings.h"
+#include "progressmanager.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(MetadataWriteQueueTest)
+
+namespace
+{
+
+/**
+ * Records the writes instead of writing the files.
+ */
+class RecordingWriteQueue : public MetadataWriteQueue
+{
+public:
+
+    RecordingWriteQueue() = default;
+
+    ~RecordingWriteQueue() override
+    {
+        flushAndWait();
+    }
+
+    int writes(qlonglong id)
+    {
+        QMutexLocker lock(&mutex);
+
+        return writeCounts.value(id);
+    }
+
+    int flags(qlonglong id)
+    {
+        QMutexLocker lock(&mutex);
+
+        return writeFlags.value(id);
+    }
+
+protected:
+
+    void writeToFile(const ItemInfo& info, int flags) override
+    {
+        QMutexLocker lock(&mutex);
+
+        writeCounts[info.id()]++;
+        writeFlags[info.id()] |= flags;
+    }
+
+private:
+
+    QMutex                mutex;
+    QHash<qlonglong, int> writeCounts;
+    QHash<qlonglong, int> writeFlags;
+};
+
+/**
+ * Owns the progress items of the lists, as the progress manager of the application would.
+ */
+class ProgressItemOwner : public FileActionProgressItemCreator
+{
+public:
+
+    ProgressItemOwner() = default;
+
+    ~ProgressItemOwner() override
+    {
+        qDeleteAll(items);
+    }
+
+    ProgressItem* createProgressItem(const QString& action) const override
+    {
+        return new ProgressItem(nullptr, action, action, QString(), false, false);
+    }
+
+    void addProgressItem(ProgressItem* const item) override
+    {
+        items << item;
+    }
+
+    bool allCompleted() const
+    {
+        Q_FOREACH (ProgressItem* const item, items)
+        {
+            if (item->completedItems() != item->totalItems())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+public:
+
+    QList<ProgressItem*> items;
+};
+
+FileActionItemInfoList infoList(const QList<qlonglong>& ids, ProgressItemOwner* const owner)
+{
+    QList<ItemInfo> infos;
+
+    Q_FOREACH (qlonglong id, ids)
+    {
+        infos << ItemInfo(id);
+    }
+
+    FileActionItemInfoList list = FileActionItemInfoList::create(infos);
+    list.schedulingForWrite(QLatin1String("Writing metadata"), owner);
+
+    return list;
+}
+
+} // namespace
+
+MetadataWriteQueueTest::MetadataWriteQueueTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void MetadataWriteQueueTest::initTestCase()
+{
+    DbEngineParameters params(QString::fromUtf8("QSQLITE"),
+                              QString::fromUtf8(":memory:"),
+                              QString::fromUtf8(""));
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+
+    CoreDbAccess access;
+    const int rootId  = access.db()->addAlbumRoot(CollectionLocation::VolumeHardWired,
+                                                  QLatin1String("volumeid:?path=/tmp"),
+                                                  QLatin1String("/"), QLatin1String("test"));
+    const int albumId = access.db()->addAlbum(rootId, QLatin1String("/"), QString(),
+                                              QDate::currentDate(), QString());
+
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+        m_ids << access.db()->addItem(albumId, QString::fromLatin1("item%1.jpg").arg(i),
+                                      DatabaseItem::Visible, DatabaseItem::Image,
+                                      QDateTime::currentDateTime(), 1000, QString());
+    }
+}
+
+void MetadataWriteQueueTest::testMergeInWindow()
+{
+    ProgressItemOwner   owner;
+    RecordingWriteQueue queue;
+    queue.setWindow(1000);
+
+    const qlonglong a = m_ids.at(0);
+    const qlonglong b = m_ids.at(1);
+
+    // Tagging, rating and captioning the same item in the window: one write with all the components.
+
+    queue.enqueue(infoList(QList<qlonglong>() << a,      &owner), MetadataHub::WRITE_TAGS);
+    queue.enqueue(infoList(QList<qlonglong>() << a << b, &owner), MetadataHub::WRITE_RATING);
+    queue.enqueue(infoList(QList<qlonglong>() << a,      &owner), MetadataHub::WRITE_COMMENTS);
+
+    QCOMPARE(queue.pendingCount(), 2);
+    QCOMPARE(queue.writtenCount(), 0);
+
+    QTRY_COMPARE_WITH_TIMEOUT(queue.writtenCount(), 2, 10000);
+
+    // Nothing else is written after the window.
+
+    QTest::qWait(1500);
+
+    QCOMPARE(queue.writtenCount(), 2);
+    QCOMPARE(queue.pendingCount(), 0);
+    QCOMPARE(queue.writes(a), 1);
+    QCOMPARE(queue.writes(b), 1);
+    QCOMPARE(queue.flags(a),  (int)(MetadataHub::WRITE_TAGS | MetadataHub::WRITE_RATING | MetadataHub::WRITE_COMMENTS));
+    QCOMPARE(queue.flags(b),  (int)MetadataHub::WRITE_RATING);
+
+    // The progress of each list advanced once for each of its items.
+
+    QVERIFY(owner.allCompleted());
+}
+
+void MetadataWriteQueueTest::testFlush()
+{
+    ProgressItemOwner   owner;
+    RecordingWriteQueue queue;
+
+    QCOMPARE(queue.window(), MetaEngineSettings::instance()->settings().metadataWriteWindow);
+
+    // A window long enough to never expire in the test: only the flush writes the files.
+
+    queue.setWindow(600000);
+
+    queue.enqueue(infoList(m_ids, &owner), MetadataHub::WRITE_TAGS);
+    queue.enqueue(infoList(QList<qlonglong>() << m_ids.at(2), &owner), MetadataHub::WRITE_RATING);
+
+    QTest::qWait(200);
+
+    QCOMPARE(queue.pendingCount(), m_ids.count());
+    QCOMPARE(queue.writtenCount(), 0);
+
+    queue.flush();
+
+    QTRY_COMPARE_WITH_TIMEOUT(queue.writtenCount(), m_ids.count(), 10000);
+    QCOMPARE(queue.pendingCount(), 0);
+
+    Q_FOREACH (qlonglong id, m_ids)
+    {
+        QCOMPARE(queue.writes(id), 1);
+    }
+
+    QCOMPARE(queue.flags(m_ids.at(2)), (int)(MetadataHub::WRITE_TAGS | MetadataHub::WRITE_RATING));
+
+    // Changes queued after a flush are written by the next one.
+
+    queue.enqueue(infoList(QList<qlonglong>() << m_ids.at(0), &owner), MetadataHub::WRITE_COMMENTS);
+    QCOMPARE(queue.pendingCount(), 1);
+
+    queue.flushAndWait();
+
+    QCOMPARE(queue.pendingCount(), 0);
+    QCOMPARE(queue.writes(m_ids.at(0)), 2);
+    QVERIFY(owner.allCompleted());
+}
@@ -0,0 +1,44 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the metadata write-back queue
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_METADATA_WRITE_QUEUE_UTEST_H
+#define DIGIKAM_METADATA_WRITE_QUEUE_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QList>
+#include <QTest>
+
+class MetadataWriteQueueTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit MetadataWriteQueueTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testMergeInWindow();
+    void testFlush();
+
+private:
+
+    QList<qlonglong> m_ids;
+};
+
+#endif // DIGIKAM_METADATA_WRITE_QUEUE_UTEST_H
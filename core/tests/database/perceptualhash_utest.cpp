@@ -0,0 +1,163 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the perceptual hash and its BK-tree
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "perceptualhash_utest.h"
+
+// C++ includes
+
+#include <cmath>
+
+// Qt includes
+
+#include <QImage>
+#include <QSet>
+
+// Local includes
+
+#include "haar.h"
+#include "perceptualhash.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(PerceptualHashTest)
+
+namespace
+{
+
+QImage patternImage(int width, int height, bool inverted = false)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        for (int x = 0 ; x < width ; ++x)
+        {
+            const double u = (double)x / width;
+            const double v = (double)y / height;
+            int value      = (int)(128.0 + 100.0 * std::sin(u * 9.0) * std::cos(v * 7.0 + u * 2.0));
+            value          = inverted ? (255 - value) : value;
+
+            image.setPixel(x, y, qRgb(value, qBound(0, value + 20, 255), value / 2));
+        }
+    }
+
+    return image;
+}
+
+quint64 hashOf(const QImage& image)
+{
+    // Haar::ImageData::fillPixelData() is not exported, the pixels are copied here the same way.
+
+    const QImage scaled = image.scaled(Haar::NumberOfPixels, Haar::NumberOfPixels, Qt::IgnoreAspectRatio);
+    QScopedPointer<Haar::ImageData> data(new Haar::ImageData);
+    int cn              = 0;
+
+    for (int y = 0 ; y < Haar::NumberOfPixels ; ++y)
+    {
+        for (int x = 0 ; x < Haar::NumberOfPixels ; ++x)
+        {
+            const QRgb pixel = scaled.pixel(x, y);
+            data->data1[cn]  = qRed  (pixel);
+            data->data2[cn]  = qGreen(pixel);
+            data->data3[cn]  = qBlue (pixel);
+            ++cn;
+        }
+    }
+
+    return PerceptualHash::compute(data.data());
+}
+
+} // namespace
+
+PerceptualHashTest::PerceptualHashTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void PerceptualHashTest::testHash()
+{
+    const quint64 original = hashOf(patternImage(512, 384));
+    const quint64 resized  = hashOf(patternImage(200, 150));
+    const quint64 inverted = hashOf(patternImage(512, 384, true));
+
+    QVERIFY(original != 0);
+    QVERIFY(original != ~Q_UINT64_C(0));
+
+    QCOMPARE(hashOf(patternImage(512, 384)), original);
+    QVERIFY(PerceptualHash::hammingDistance(original, resized)  <= PerceptualHash::NearDuplicatesDistance);
+    QVERIFY(PerceptualHash::hammingDistance(original, inverted) >  PerceptualHash::NearDuplicatesDistance);
+
+    QCOMPARE(PerceptualHash::hammingDistance(0, ~Q_UINT64_C(0)), 64);
+    QCOMPARE(PerceptualHash::hammingDistance(Q_UINT64_C(0xF0), Q_UINT64_C(0x0F)), 8);
+}
+
+void PerceptualHashTest::testTree()
+{
+    PerceptualHashTree tree;
+    QVERIFY(tree.isEmpty());
+    QVERIFY(tree.find(0, 64).isEmpty());
+
+    // Random hashes, some of them close to the others and some repeated.
+
+    QList<quint64> hashes;
+    quint64 seed = Q_UINT64_C(0x2545F4914F6CDD1D);
+
+    for (int i = 0 ; i < 2000 ; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        if      ((i % 10) == 1)
+        {
+            hashes << (hashes.last() ^ (Q_UINT64_C(1) << (seed % 64)));
+        }
+        else if ((i % 10) == 2)
+        {
+            hashes << hashes.last();
+        }
+        else
+        {
+            hashes << seed;
+        }
+
+        tree.insert(hashes.last(), i);
+    }
+
+    QCOMPARE(tree.count(), hashes.count());
+
+    for (int i = 0 ; i < hashes.count() ; i += 97)
+    {
+        for (int distance : { 0, 4, PerceptualHash::NearDuplicatesDistance, 24 })
+        {
+            QSet<qlonglong> expected;
+
+            for (int j = 0 ; j < hashes.count() ; ++j)
+            {
+                if (PerceptualHash::hammingDistance(hashes.at(i), hashes.at(j)) <= distance)
+                {
+                    expected << j;
+                }
+            }
+
+            const QList<qlonglong> found = tree.find(hashes.at(i), distance);
+
+            QCOMPARE(found.count(), expected.count());
+            QCOMPARE(QSet<qlonglong>(found.begin(), found.end()), expected);
+        }
+    }
+
+    tree.clear();
+    QVERIFY(tree.isEmpty());
+}
@@ -0,0 +1,37 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the perceptual hash and its BK-tree
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_PERCEPTUAL_HASH_UTEST_H
+#define DIGIKAM_PERCEPTUAL_HASH_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QTest>
+
+class PerceptualHashTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit PerceptualHashTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testHash();
+    void testTree();
+};
+
+#endif // DIGIKAM_PERCEPTUAL_HASH_UTEST_H
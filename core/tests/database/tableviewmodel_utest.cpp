@@ -0,0 +1,221 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the metadata loading of the table view model
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "tableviewmodel_utest.h"
+
+// Qt includes
+
+#include <QDateTime>
+
+// Local includes
+
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "collectionlocation.h"
+#include "iteminfo.h"
+#include "itemmodel.h"
+#include "itemfiltermodel.h"
+#include "tableview_model.h"
+#include "tableview_shared.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(TableViewModelTest)
+
+namespace
+{
+
+/**
+ * A table view model without view, listing the items of an image model by id.
+ */
+class TableModelFixture
+{
+public:
+
+    TableModelFixture()
+    {
+        shared.imageModel       = new ItemModel();
+        shared.imageFilterModel = new ItemFilterModel();
+        shared.imageFilterModel->setSourceItemModel(shared.imageModel);
+        shared.isActive         = true;
+        shared.tableViewModel   = new TableViewModel(&shared);
+    }
+
+    ~TableModelFixture()
+    {
+        delete shared.tableViewModel;
+        delete shared.imageFilterModel;
+        delete shared.imageModel;
+    }
+
+    void addItems(const QList<qlonglong>& ids)
+    {
+        QList<ItemInfo> infos;
+
+        Q_FOREACH (qlonglong id, ids)
+        {
+            infos << ItemInfo(id);
+        }
+
+        shared.imageModel->addItemInfosSynchronously(infos);
+    }
+
+    TableViewModel::Item* item(int row) const
+    {
+        return shared.tableViewModel->itemFromIndex(shared.tableViewModel->index(row, 0));
+    }
+
+    bool isLoaded(int row, const DatabaseFields::Set& fields) const
+    {
+        return shared.tableViewModel->infoFromItem(item(row)).hasDatabaseFieldsRaw(fields);
+    }
+
+    /**
+     * Returns the number of rows in [first, last] with the fields loaded.
+     */
+    int loadedRows(int first, int last, const DatabaseFields::Set& fields) const
+    {
+        int count = 0;
+
+        for (int row = first ; row <= last ; ++row)
+        {
+            if (isLoaded(row, fields))
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+public:
+
+    TableViewShared shared;
+};
+
+} // namespace
+
+TableViewModelTest::TableViewModelTest(QObject* const parent)
+    : QObject  (parent),
+      m_albumId(-1)
+{
+}
+
+void TableViewModelTest::initTestCase()
+{
+    DbEngineParameters params(QString::fromUtf8("QSQLITE"),
+                              QString::fromUtf8(":memory:"),
+                              QString::fromUtf8(""));
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+
+    CoreDbAccess access;
+    const int rootId = access.db()->addAlbumRoot(CollectionLocation::VolumeHardWired,
+                                                 QLatin1String("volumeid:?path=/tmp"),
+                                                 QLatin1String("/"), QLatin1String("test"));
+    m_albumId        = access.db()->addAlbum(rootId, QLatin1String("/"), QString(),
+                                             QDate::currentDate(), QString());
+}
+
+void TableViewModelTest::cleanupTestCase()
+{
+    CoreDbAccess::cleanUpDatabase();
+}
+
+QList<qlonglong> TableViewModelTest::addItems(int first, int count)
+{
+    QList<qlonglong> ids;
+    CoreDbAccess access;
+
+    for (int i = first ; i < (first + count) ; ++i)
+    {
+        const qlonglong id = access.db()->addItem(m_albumId, QString::fromLatin1("item%1.jpg").arg(i),
+                                                  DatabaseItem::Visible, DatabaseItem::Image,
+                                                  QDateTime::currentDateTime(), 1000, QString());
+
+        access.db()->addImageMetadata(id, QVariantList() << QString::fromLatin1("Make%1").arg(i)
+                                                         << QString::fromLatin1("Model%1").arg(i),
+                                      DatabaseFields::Make | DatabaseFields::Model);
+        ids << id;
+    }
+
+    return ids;
+}
+
+void TableViewModelTest::testLoadRowsAround()
+{
+    TableModelFixture fixture;
+    fixture.addItems(addItems(0, 600));
+
+    QCOMPARE(fixture.shared.tableViewModel->rowCount(QModelIndex()), 600);
+
+    const DatabaseFields::Set make(DatabaseFields::Make);
+
+    QCOMPARE(fixture.loadedRows(0, 599, make), 0);
+
+    // Painting the first row loads the first rows only, not the whole table.
+
+    QCOMPARE(fixture.shared.tableViewModel->itemDatabaseFieldRaw(fixture.item(0), make).toString(),
+             QLatin1String("Make0"));
+
+    QCOMPARE(fixture.loadedRows(0,   199, make), 200);
+    QCOMPARE(fixture.loadedRows(200, 599, make), 0);
+
+    // Scrolling to another part of the table loads the rows around the painted one.
+
+    QCOMPARE(fixture.shared.tableViewModel->itemDatabaseFieldRaw(fixture.item(400), make).toString(),
+             QLatin1String("Make400"));
+
+    QCOMPARE(fixture.loadedRows(200, 299, make), 0);
+    QCOMPARE(fixture.loadedRows(300, 499, make), 200);
+    QCOMPARE(fixture.loadedRows(500, 599, make), 0);
+
+    // The rows loaded are not read again, the other fields are still missing.
+
+    QCOMPARE(fixture.shared.tableViewModel->itemDatabaseFieldRaw(fixture.item(350), make).toString(),
+             QLatin1String("Make350"));
+
+    QCOMPARE(fixture.loadedRows(200, 299, make), 0);
+    QCOMPARE(fixture.loadedRows(0, 599, DatabaseFields::Set(DatabaseFields::Model)), 0);
+}
+
+void TableViewModelTest::testInsertedRows()
+{
+    TableModelFixture fixture;
+    fixture.addItems(addItems(1000, 600));
+
+    const DatabaseFields::Set model(DatabaseFields::Model);
+
+    QCOMPARE(fixture.shared.tableViewModel->itemDatabaseFieldRaw(fixture.item(0), model).toString(),
+             QLatin1String("Model1000"));
+
+    QCOMPARE(fixture.loadedRows(0, 199, model), 200);
+
+    // The rows inserted are listed after the others, ordered by id, and are not loaded.
+    // The rows loaded before stay loaded, and the others are not loaded with them.
+
+    fixture.addItems(addItems(1600, 10));
+
+    QCOMPARE(fixture.shared.tableViewModel->rowCount(QModelIndex()), 610);
+    QCOMPARE(fixture.loadedRows(0,   199, model), 200);
+    QCOMPARE(fixture.loadedRows(200, 609, model), 0);
+
+    QCOMPARE(fixture.shared.tableViewModel->itemDatabaseFieldRaw(fixture.item(609), model).toString(),
+             QLatin1String("Model1609"));
+
+    QCOMPARE(fixture.loadedRows(0,   199, model), 200);
+    QCOMPARE(fixture.loadedRows(200, 409, model), 0);
+    QCOMPARE(fixture.loadedRows(410, 609, model), 200);
+}
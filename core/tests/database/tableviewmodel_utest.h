@@ -0,0 +1,49 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the metadata loading of the table view model
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_TABLE_VIEW_MODEL_UTEST_H
+#define DIGIKAM_TABLE_VIEW_MODEL_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QList>
+#include <QTest>
+
+class TableViewModelTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit TableViewModelTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testLoadRowsAround();
+    void testInsertedRows();
+
+private:
+
+    QList<qlonglong> addItems(int first, int count);
+
+private:
+
+    int m_albumId;
+};
+
+#endif // DIGIKAM_TABLE_VIEW_MODEL_UTEST_H
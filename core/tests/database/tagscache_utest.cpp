@@ -172,6 +172,76 @@ void TagsCacheTest::testDuplicateTop()
     QCOMPARE(tagsCache->tagPath(id3), QLatin1String("/Super/Top"));
 }
 
+void TagsCacheTest::testGetOrCreateTags()
+{
+    auto existingId = tagsCache->createTag(QLatin1String("Places/France"));
+
+    QStringList paths;
+    paths << QLatin1String("Places/France/Paris")
+          << QLatin1String("/Places/France")
+          << QLatin1String("People/Family")
+          << QLatin1String("Places/France/Paris")
+          << QLatin1String("People/Friends/");
+
+    auto ids = tagsCache->getOrCreateTags(paths);
+
+    QCOMPARE(ids.size(), paths.size());
+    QCOMPARE(countTags(), 6);
+
+    // the existing tags and the tags created for the previous paths are reused
+
+    QCOMPARE(ids[1], existingId);
+    QCOMPARE(ids[3], ids[0]);
+    QCOMPARE(tagsCache->parentTag(ids[0]), existingId);
+    QCOMPARE(tagsCache->parentTag(ids[2]), tagsCache->parentTag(ids[4]));
+
+    QCOMPARE(tagsCache->tagPath(ids[0]), QLatin1String("/Places/France/Paris"));
+    QCOMPARE(tagsCache->tagPath(ids[4], Digikam::TagsCache::NoLeadingSlash), QLatin1String("People/Friends"));
+    QCOMPARE(tagsCache->tagsForPaths(paths), ids);
+    QCOMPARE(tagsCache->tagForName(QLatin1String("Family"), tagsCache->parentTag(ids[2])), ids[2]);
+}
+
+void TagsCacheTest::testTagChanges()
+{
+    auto id       = tagsCache->createTag(QLatin1String("Top/Middle/Bottom"));
+    auto middleId = tagsCache->parentTag(id);
+    auto topId    = tagsCache->parentTag(middleId);
+    auto otherId  = tagsCache->createTag(QLatin1String("Other"));
+
+    // the tags changed in the database are updated in the cache, with the paths below them
+
+    Digikam::CoreDbAccess().db()->setTagName(topId, QLatin1String("Renamed"));
+
+    QCOMPARE(tagsCache->tagName(topId), QLatin1String("Renamed"));
+    QCOMPARE(tagsCache->tagPath(id), QLatin1String("/Renamed/Middle/Bottom"));
+    QCOMPARE(tagsCache->tagForPath(QLatin1String("Renamed/Middle/Bottom")), id);
+    QCOMPARE(tagsCache->tagForPath(QLatin1String("Top/Middle/Bottom")), 0);
+    QVERIFY(tagsCache->tagsForName(QLatin1String("Top")).isEmpty());
+
+    Digikam::CoreDbAccess().db()->setTagParentID(middleId, otherId);
+
+    QCOMPARE(tagsCache->parentTag(middleId), otherId);
+    QCOMPARE(tagsCache->tagPath(id), QLatin1String("/Other/Middle/Bottom"));
+    QCOMPARE(tagsCache->tagForName(QLatin1String("Middle"), otherId), middleId);
+    QCOMPARE(tagsCache->tagForName(QLatin1String("Middle"), topId), 0);
+
+    Digikam::CoreDbAccess().db()->addTagProperty(id, QLatin1String("testProperty"), QLatin1String("value"));
+
+    QVERIFY(tagsCache->hasProperty(id, QLatin1String("testProperty")));
+    QCOMPARE(tagsCache->tagsWithProperty(QLatin1String("testProperty")), QList<int>() << id);
+
+    // deleting a tag deletes its descendants and their properties
+
+    Digikam::CoreDbAccess().db()->deleteTag(middleId);
+
+    QVERIFY(!tagsCache->hasTag(middleId));
+    QVERIFY(!tagsCache->hasTag(id));
+    QVERIFY(tagsCache->hasTag(otherId));
+    QCOMPARE(tagsCache->tagForPath(QLatin1String("Other/Middle/Bottom")), 0);
+    QVERIFY(tagsCache->tagsWithProperty(QLatin1String("testProperty")).isEmpty());
+    QCOMPARE(countTags(), 2);
+}
+
 // utilities
 
 int TagsCacheTest::countTags()
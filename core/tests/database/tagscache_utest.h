@@ -53,6 +53,8 @@ private Q_SLOTS:
     void testComplexHierarchy();
     void testRepeatedNames();
     void testDuplicateTop();
+    void testGetOrCreateTags();
+    void testTagChanges();
 
 
 private:
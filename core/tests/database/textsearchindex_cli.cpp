@@ -0,0 +1,150 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : a command line tool to compare the text searches
+ *               with and without the text search index
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+// Local includes
+
+#include "digikam_debug.h"
+
+namespace
+{
+
+void explainQuery(QSqlDatabase& db, const QString& sql, const QString& value)
+{
+    QSqlQuery query(db);
+    query.prepare(QLatin1String("EXPLAIN QUERY PLAN ") + sql);
+    query.addBindValue(value);
+
+    if (!query.exec())
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "   Query failed:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next())
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "   Plan:" << query.value(3).toString();
+    }
+}
+
+void runQuery(QSqlDatabase& db, const QString& title, const QString& sql, const QString& value)
+{
+    qCDebug(DIGIKAM_TESTS_LOG) << title;
+    qCDebug(DIGIKAM_TESTS_LOG) << "   SQL:" << sql;
+
+    explainQuery(db, sql, value);
+
+    // The best time of several runs, to not measure the filling of the caches.
+
+    qint64 best = -1;
+    int    rows = 0;
+
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QSqlQuery query(db);
+        query.prepare(sql);
+        query.addBindValue(value);
+
+        if (!query.exec())
+        {
+            return;
+        }
+
+        rows = 0;
+
+        while (query.next())
+        {
+            ++rows;
+        }
+
+        qint64 elapsed = timer.elapsed();
+        best           = (best == -1) ? elapsed : qMin(best, elapsed);
+    }
+
+    qCDebug(DIGIKAM_TESTS_LOG) << "  " << rows << "items found in" << best << "ms";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    if (argc < 3)
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "textsearchindex_cli - compare the text searches with and without the index";
+        qCDebug(DIGIKAM_TESTS_LOG) << "Usage: <digikam4.db> <text>";
+        return -1;
+    }
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"));
+    db.setDatabaseName(QString::fromLocal8Bit(argv[1]));
+
+    if (!db.open())
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "Cannot open database" << argv[1] << db.lastError().text();
+        return -1;
+    }
+
+    const QString value = QLatin1Char('%') + QString::fromLocal8Bit(argv[2]) + QLatin1Char('%');
+    const bool hasIndex = db.tables().contains(QLatin1String("ImagesTextIndex"));
+
+    runQuery(db, QLatin1String("File names, table scan:"),
+             QLatin1String("SELECT Images.id FROM Images WHERE (Images.name LIKE ? ESCAPE '\\');"),
+             value);
+
+    if (hasIndex)
+    {
+        runQuery(db, QLatin1String("File names, text search index:"),
+                 QLatin1String("SELECT Images.id FROM Images WHERE "
+                               "(Images.id IN (SELECT rowid FROM ImagesTextIndex WHERE name LIKE ?));"),
+                 value);
+    }
+
+    runQuery(db, QLatin1String("Comments, table scan:"),
+             QLatin1String("SELECT Images.id FROM Images WHERE (Images.id IN "
+                           "(SELECT imageid FROM ImageComments WHERE type=1 AND comment LIKE ?));"),
+             value);
+
+    if (hasIndex)
+    {
+        runQuery(db, QLatin1String("Comments, text search index:"),
+                 QLatin1String("SELECT Images.id FROM Images WHERE (Images.id IN "
+                               "(SELECT imageid FROM ImageComments WHERE type=1 AND id IN "
+                               "(SELECT rowid FROM CommentsTextIndex WHERE comment LIKE ?)));"),
+                 value);
+    }
+    else
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "The database has no text search index";
+    }
+
+    db.close();
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the text search index of the core database
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "textsearchindex_utest.h"
+
+// C++ includes
+
+#include <algorithm>
+
+// Qt includes
+
+#include <QDateTime>
+#include <QStringList>
+
+// Local includes
+
+#include "collectionlocation.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "coredbsearchxml.h"
+#include "itemlister.h"
+#include "itemlisterreceiver.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(TextSearchIndexTest)
+
+TextSearchIndexTest::TextSearchIndexTest(QObject* const parent)
+    : QObject       (parent),
+      m_indexVersion(0)
+{
+}
+
+void TextSearchIndexTest::initTestCase()
+{
+    DbEngineParameters params(QString::fromUtf8("QSQLITE"),
+                              QString::fromUtf8(":memory:"),
+                              QString::fromUtf8(""));
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+
+    m_indexVersion = CoreDbAccess().db()->getTextSearchIndexVersion();
+
+    if (!m_indexVersion)
+    {
+        QSKIP("The SQLite library has no FTS5 module or no trigram tokenizer");
+    }
+
+    CoreDbAccess access;
+    const int rootId  = access.db()->addAlbumRoot(CollectionLocation::VolumeHardWired,
+                                                  QLatin1String("volumeid:?path=/tmp"),
+                                                  QLatin1String("/"), QLatin1String("test"));
+    const int albumId = access.db()->addAlbum(rootId, QLatin1String("/"), QString(),
+                                              QDate::currentDate(), QString());
+
+    // The names mix the cases, the accented letters, the separators and the words.
+
+    const QStringList names = QStringList() << QString::fromUtf8("Paris_2021.jpg")
+                                            << QString::fromUtf8("paris-eiffel.JPG")
+                                            << QString::fromUtf8("Café de Flore.jpg")
+                                            << QString::fromUtf8("cafe.png")
+                                            << QString::fromUtf8("Mörkö.jpg")
+                                            << QString::fromUtf8("morning walk.jpg")
+                                            << QString::fromUtf8("evening walk in Paris.jpg")
+                                            << QString::fromUtf8("CRÈME.jpg");
+
+    QList<qlonglong> ids;
+
+    Q_FOREACH (const QString& name, names)
+    {
+        ids << access.db()->addItem(albumId, name, DatabaseItem::Visible, DatabaseItem::Image,
+                                    QDateTime::currentDateTime(), 1000, QString());
+    }
+
+    access.db()->setImageComment(ids.at(0), QString::fromUtf8("Night in Paris"),            DatabaseComment::Comment);
+    access.db()->setImageComment(ids.at(2), QString::fromUtf8("Crème brûlée at the café"), DatabaseComment::Comment);
+    access.db()->setImageComment(ids.at(5), QString::fromUtf8("Walk by the river"),         DatabaseComment::Comment);
+    access.db()->setImageComment(ids.at(3), QString::fromUtf8("Le Café"),                   DatabaseComment::Title);
+    access.db()->setImageComment(ids.at(6), QString::fromUtf8("Walk in PARIS"),             DatabaseComment::Headline);
+
+    // A comment replaced after its insertion is indexed again.
+
+    const QString language = QLatin1String("x-default");
+    const QString author   = QString::fromLatin1("");
+
+    access.db()->setImageComment(ids.at(7), QString::fromUtf8("Old comment"),   DatabaseComment::Comment, language, author);
+    access.db()->setImageComment(ids.at(7), QString::fromUtf8("crème caramel"), DatabaseComment::Comment, language, author);
+}
+
+QString TextSearchIndexTest::fieldSearch(const QString& field, int relation, const QString& text) const
+{
+    SearchXmlWriter writer;
+    writer.writeGroup();
+    writer.writeField(field, (SearchXml::Relation)relation);
+    writer.writeValue(text);
+    writer.finishField();
+    writer.finishGroup();
+    writer.finish();
+
+    return writer.xml();
+}
+
+QList<qlonglong> TextSearchIndexTest::search(const QString& xml, bool useIndex)
+{
+    CoreDbAccess().db()->setTextSearchIndexVersion(useIndex ? m_indexVersion : 0);
+
+    ItemLister lister;
+    lister.setListOnlyAvailable(false);
+
+    ItemListerValueListReceiver receiver;
+    lister.listSearch(&receiver, xml);
+
+    CoreDbAccess().db()->setTextSearchIndexVersion(m_indexVersion);
+
+    QList<qlonglong> ids;
+
+    Q_FOREACH (const ItemListerRecord& record, receiver.records)
+    {
+        ids << record.imageID;
+    }
+
+    std::sort(ids.begin(), ids.end());
+
+    return ids;
+}
+
+void TextSearchIndexTest::testFileNames_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("relation");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("prefix")             << QString::fromUtf8("par")       << (int)SearchXml::Like    << 3;
+    QTest::newRow("upper case")         << QString::fromUtf8("PARIS")     << (int)SearchXml::Like    << 3;
+    QTest::newRow("underscore")         << QString::fromUtf8("is_20")     << (int)SearchXml::Like    << 1;
+    QTest::newRow("extension")          << QString::fromUtf8(".jp")       << (int)SearchXml::Like    << 7;
+    QTest::newRow("accented")           << QString::fromUtf8("café")      << (int)SearchXml::Like    << 1;
+    QTest::newRow("accented uppercase") << QString::fromUtf8("CAFÉ")      << (int)SearchXml::Like    << -1;
+    QTest::newRow("without accent")     << QString::fromUtf8("cafe")      << (int)SearchXml::Like    << 1;
+    QTest::newRow("umlaut")             << QString::fromUtf8("mörk")      << (int)SearchXml::Like    << 1;
+    QTest::newRow("grave uppercase")    << QString::fromUtf8("ème")       << (int)SearchXml::Like    << -1;
+    QTest::newRow("words")              << QString::fromUtf8("walk in")   << (int)SearchXml::Like    << 1;
+    QTest::newRow("across words")       << QString::fromUtf8("ing wa")    << (int)SearchXml::Like    << 2;
+    QTest::newRow("not found")          << QString::fromUtf8("london")    << (int)SearchXml::Like    << 0;
+    QTest::newRow("not like")           << QString::fromUtf8("paris")     << (int)SearchXml::NotLike << 5;
+}
+
+void TextSearchIndexTest::testFileNames()
+{
+    QFETCH(QString, text);
+    QFETCH(int,     relation);
+    QFETCH(int,     count);
+
+    const QString xml              = fieldSearch(QLatin1String("filename"), relation, text);
+    const QList<qlonglong> indexed = search(xml, true);
+
+    QCOMPARE(indexed, search(xml, false));
+
+    // The case folding of the letters out of ASCII is not checked: it depends on the SQLite build.
+
+    if (count != -1)
+    {
+        QCOMPARE(indexed.count(), count);
+    }
+}
+
+void TextSearchIndexTest::testComments_data()
+{
+    QTest::addColumn<QString>("field");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("comment prefix")     << QString::fromUtf8("comment")  << QString::fromUtf8("nig")        << 1;
+    QTest::newRow("comment case")       << QString::fromUtf8("comment")  << QString::fromUtf8("WALK")       << 1;
+    QTest::newRow("comment accented")   << QString::fromUtf8("comment")  << QString::fromUtf8("crème")      << 2;
+    QTest::newRow("comment words")      << QString::fromUtf8("comment")  << QString::fromUtf8("at the caf") << 1;
+    QTest::newRow("comment replaced")   << QString::fromUtf8("comment")  << QString::fromUtf8("old comm")   << 0;
+    QTest::newRow("title")              << QString::fromUtf8("title")    << QString::fromUtf8("le caf")     << 1;
+    QTest::newRow("headline")           << QString::fromUtf8("headline") << QString::fromUtf8("in paris")   << 1;
+    QTest::newRow("other type")         << QString::fromUtf8("title")    << QString::fromUtf8("night")      << 0;
+}
+
+void TextSearchIndexTest::testComments()
+{
+    QFETCH(QString, field);
+    QFETCH(QString, text);
+    QFETCH(int,     count);
+
+    const QString xml              = fieldSearch(field, SearchXml::Like, text);
+    const QList<qlonglong> indexed = search(xml, true);
+
+    QCOMPARE(indexed, search(xml, false));
+    QCOMPARE(indexed.count(), count);
+}
+
+void TextSearchIndexTest::testKeywords_data()
+{
+    QTest::addColumn<QString>("keywords");
+    QTest::addColumn<int>("count");
+
+    // Each word of the quick search must be found in one of the text fields.
+
+    QTest::newRow("one word")           << QString::fromUtf8("paris")              << 3;
+    QTest::newRow("two words")          << QString::fromUtf8("walk paris")         << 1;
+    QTest::newRow("name and comment")   << QString::fromUtf8("night paris")        << 1;
+    QTest::newRow("accented words")     << QString::fromUtf8("café crème")         << 1;
+    QTest::newRow("short word")         << QString::fromUtf8("in walk")            << 2;
+    QTest::newRow("quoted words")       << QString::fromUtf8("\"walk in\" paris") << 1;
+}
+
+void TextSearchIndexTest::testKeywords()
+{
+    QFETCH(QString, keywords);
+    QFETCH(int,     count);
+
+    const QString xml              = KeywordSearchWriter().xml(KeywordSearch::split(keywords));
+    const QList<qlonglong> indexed = search(xml, true);
+
+    QCOMPARE(indexed, search(xml, false));
+    QCOMPARE(indexed.count(), count);
+}
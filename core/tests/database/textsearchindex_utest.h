@@ -0,0 +1,57 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the text search index of the core database
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_TEXT_SEARCH_INDEX_UTEST_H
+#define DIGIKAM_TEXT_SEARCH_INDEX_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QList>
+#include <QTest>
+
+class TextSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit TextSearchIndexTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testFileNames_data();
+    void testFileNames();
+    void testComments_data();
+    void testComments();
+    void testKeywords_data();
+    void testKeywords();
+
+private:
+
+    /**
+     * Returns the sorted ids found by the search, with or without the text search index.
+     */
+    QList<qlonglong> search(const QString& xml, bool useIndex);
+
+    QString fieldSearch(const QString& field, int relation, const QString& text) const;
+
+private:
+
+    int m_indexVersion;
+};
+
+#endif // DIGIKAM_TEXT_SEARCH_INDEX_UTEST_H
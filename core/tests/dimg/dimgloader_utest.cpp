@@ -21,12 +21,14 @@
 #include <QFileInfo>
 #include <QList>
 #include <QDir>
+#include <QFile>
 
 // Local includes
 
 #include "digikam_debug.h"
 #include "metaengine.h"
 #include "dimg.h"
+#include "dcolor.h"
 #include "dpluginloader.h"
 #include "dtestdatadir.h"
 #include "drawdecoding.h"
@@ -38,7 +40,7 @@ DImgLoaderTest::DImgLoaderTest(QObject* const parent)
 {
 }
 
-void DImgLoaderTest::testDImgLoader()
+void DImgLoaderTest::initTestCase()
 {
     MetaEngine::initializeExiv2();
     QDir dir(qApp->applicationDirPath());
@@ -47,7 +49,15 @@ void DImgLoaderTest::testDImgLoader()
 
     QVERIFY2(!DPluginLoader::instance()->allPlugins().isEmpty(),
              "Not able to found digiKam plugin in standard paths. Test is aborted...");
+}
+
+void DImgLoaderTest::cleanupTestCase()
+{
+    DPluginLoader::instance()->cleanUp();
+}
 
+void DImgLoaderTest::testDImgLoader()
+{
     QString fname = DTestDataDir::TestData(QString::fromUtf8("core/tests/dimg"))
                     .root().path() + QLatin1String("/DSC00636.JPG");
     qCDebug(DIGIKAM_TESTS_LOG) << "Test Data File:" << fname;
@@ -64,6 +74,80 @@ void DImgLoaderTest::testDImgLoader()
     QVERIFY2(img.size() == QSize(100, 67), "Incorrect JPEG image size...");
     QVERIFY2(img.save(fname + QLatin1String(".png"), QLatin1String("PNG")),
              "Cannot save PNG image with DImg plugin");
+}
 
-    DPluginLoader::instance()->cleanUp();
+void DImgLoaderTest::testScaledLoading()
+{
+    QString fname = DTestDataDir::TestData(QString::fromUtf8("core/tests/dimg"))
+                    .root().path() + QLatin1String("/DSC00636.JPG");
+
+    DImg full(fname);
+
+    QVERIFY2(!full.isNull(), "Cannot load JPEG image with DImg plugin");
+
+    QString pngName = fname + QLatin1String("-scaled.png");
+
+    QVERIFY2(full.save(pngName, QLatin1String("PNG")), "Cannot save PNG image with DImg plugin");
+
+    // 100x67 image with a requested size of 25 pixels: reduction factor is 4.
+
+    DImg scaled;
+    scaled.setAttribute(QLatin1String("scaledLoadingSize"), 25);
+
+    QVERIFY2(scaled.load(pngName), "Cannot load PNG image with reduced size");
+    QCOMPARE(scaled.size(), QSize(25, 17));
+    QCOMPARE(scaled.attribute(QLatin1String("originalSize")).toSize(), QSize(100, 67));
+
+    // The reduced image must match the full size image averaged on boxes of 4x4 pixels,
+    // the boxes of the last row and column being cut by the image borders.
+
+    DImg reference(pngName);
+    const int factor   = 4;
+    int    maxDelta    = 0;
+    double sumDelta    = 0.0;
+
+    for (uint y = 0 ; y < scaled.height() ; ++y)
+    {
+        for (uint x = 0 ; x < scaled.width() ; ++x)
+        {
+            double sum[3] = { 0.0, 0.0, 0.0 };
+            int    count  = 0;
+
+            for (uint sy = y * factor ; (sy < (y + 1) * factor) && (sy < reference.height()) ; ++sy)
+            {
+                for (uint sx = x * factor ; (sx < (x + 1) * factor) && (sx < reference.width()) ; ++sx)
+                {
+                    DColor c  = reference.getPixelColor(sx, sy);
+                    sum[0]   += c.red();
+                    sum[1]   += c.green();
+                    sum[2]   += c.blue();
+                    ++count;
+                }
+            }
+
+            DColor c          = scaled.getPixelColor(x, y);
+            const int delta[] =
+            {
+                qAbs(c.red()   - qRound(sum[0] / count)),
+                qAbs(c.green() - qRound(sum[1] / count)),
+                qAbs(c.blue()  - qRound(sum[2] / count))
+            };
+
+            for (int d : delta)
+            {
+                maxDelta  = qMax(maxDelta, d);
+                sumDelta += d;
+            }
+        }
+    }
+
+    const double meanDelta = sumDelta / (3.0 * scaled.width() * scaled.height());
+
+    qCDebug(DIGIKAM_TESTS_LOG) << "Color difference with box averaging: maximum" << maxDelta
+                               << "mean" << meanDelta;
+
+    QVERIFY(maxDelta  <= 2);
+    QVERIFY(meanDelta <  0.5);
+
+    QFile::remove(pngName);
 }
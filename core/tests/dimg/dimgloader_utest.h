@@ -37,7 +37,11 @@ public:
 
 private Q_SLOTS:
 
+    void initTestCase();
+    void cleanupTestCase();
+
     void testDImgLoader();
+    void testScaledLoading();
 };
 
 #endif // DIGIKAM_DIMG_LOADER_UTEST_H
@@ -0,0 +1,307 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark DImg pixel conversions
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgpixelconverter_utest.h"
+
+// Qt includes
+
+#include <QApplication>
+#include <QAtomicInt>
+#include <QDir>
+#include <QTest>
+#include <QVector>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "dcolor.h"
+#include "dimgpixelconverter.h"
+#include "dpluginloader.h"
+#include "metaengine.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgPixelConverterTest)
+
+DImgPixelConverterTest::DImgPixelConverterTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void DImgPixelConverterTest::initTestCase()
+{
+    MetaEngine::initializeExiv2();
+    QDir dir(qApp->applicationDirPath());
+    qputenv("DK_PLUGIN_PATH", dir.canonicalPath().toUtf8());
+    DPluginLoader::instance()->init();
+
+    QVERIFY2(!DPluginLoader::instance()->allPlugins().isEmpty(),
+             "Not able to found digiKam plugin in standard paths. Test is aborted...");
+
+    QVERIFY(m_tempDir.isValid());
+}
+
+void DImgPixelConverterTest::cleanupTestCase()
+{
+    DPluginLoader::instance()->cleanUp();
+}
+
+void DImgPixelConverterTest::testRowConversions()
+{
+    // Two RGB pixels, and the same with alpha.
+
+    const uchar rgb8[6]  = { 1, 2, 3, 4, 5, 6 };
+    const uchar rgba8[8] = { 1, 2, 3, 10, 4, 5, 6, 20 };
+    uchar       bgra8[8] = { 0 };
+
+    DImgPixelConverter::toBGRA8(rgb8, bgra8, 2, 3, DImgPixelConverter::RGBOrder, false);
+
+    const uchar expected8[8] = { 3, 2, 1, 0xFF, 6, 5, 4, 0xFF };
+    QVERIFY(memcmp(bgra8, expected8, 8) == 0);
+
+    DImgPixelConverter::toBGRA8(rgba8, bgra8, 2, 4, DImgPixelConverter::RGBOrder, true);
+
+    const uchar expectedAlpha8[8] = { 3, 2, 1, 10, 6, 5, 4, 20 };
+    QVERIFY(memcmp(bgra8, expectedAlpha8, 8) == 0);
+
+    DImgPixelConverter::toBGRA8(rgba8, bgra8, 2, 4, DImgPixelConverter::BGROrder, false);
+
+    const uchar expectedOpaque8[8] = { 1, 2, 3, 0xFF, 4, 5, 6, 0xFF };
+    QVERIFY(memcmp(bgra8, expectedOpaque8, 8) == 0);
+
+    // Back to codec layout.
+
+    uchar packed8[8] = { 0 };
+    DImgPixelConverter::fromBGRA8(expectedAlpha8, packed8, 2, 4, DImgPixelConverter::RGBOrder);
+    QVERIFY(memcmp(packed8, rgba8, 8) == 0);
+
+    DImgPixelConverter::fromBGRA8(expected8, packed8, 2, 3, DImgPixelConverter::RGBOrder);
+    QVERIFY(memcmp(packed8, rgb8, 6) == 0);
+
+    // 10 bits data expanded to 16 bits, and reduced back.
+
+    const ushort rgb10[3] = { 1023, 512, 1 };
+    ushort       bgra16[4];
+
+    DImgPixelConverter::toBGRA16(rgb10, bgra16, 1, 3, DImgPixelConverter::RGBOrder, false, 6);
+    QCOMPARE(bgra16[0], (ushort)(1    << 6));
+    QCOMPARE(bgra16[1], (ushort)(512  << 6));
+    QCOMPARE(bgra16[2], (ushort)(1023 << 6));
+    QCOMPARE(bgra16[3], (ushort)0xFFFF);
+
+    ushort packed16[3];
+    DImgPixelConverter::fromBGRA16(bgra16, packed16, 1, 3, DImgPixelConverter::RGBOrder, 6);
+    QVERIFY(memcmp(packed16, rgb10, sizeof(rgb10)) == 0);
+
+    DImgPixelConverter::fromBGRA16To8(bgra16, packed8, 1, 3, DImgPixelConverter::RGBOrder);
+    QCOMPARE(packed8[0], (uchar)(1023 >> 2));
+    QCOMPARE(packed8[1], (uchar)(512  >> 2));
+    QCOMPARE(packed8[2], (uchar)0);
+
+    DImgPixelConverter::fromBGRA8To16(expected8, packed16, 1, 3, DImgPixelConverter::RGBOrder, 2);
+    QCOMPARE(packed16[0], (ushort)(1 << 2));
+    QCOMPARE(packed16[1], (ushort)(2 << 2));
+    QCOMPARE(packed16[2], (ushort)(3 << 2));
+}
+
+void DImgPixelConverterTest::testSwapAndPremultiply()
+{
+    ushort values[3] = { 0x1234, 0xFF00, 0x00AB };
+    DImgPixelConverter::swapBytes16(values, 3);
+
+    QCOMPARE(values[0], (ushort)0x3412);
+    QCOMPARE(values[1], (ushort)0x00FF);
+    QCOMPARE(values[2], (ushort)0xAB00);
+
+    uchar pixels8[8] = { 255, 128, 0, 255, 200, 100, 50, 0 };
+    DImgPixelConverter::premultiplyAlpha8(pixels8, 2);
+
+    const uchar expected8[8] = { 255, 128, 0, 255, 0, 0, 0, 0 };
+    QVERIFY(memcmp(pixels8, expected8, 8) == 0);
+
+    ushort pixels16[4] = { 65535, 32768, 1000, 32768 };
+    DImgPixelConverter::premultiplyAlpha16(pixels16, 1);
+
+    QCOMPARE(pixels16[0], (ushort)32768);
+    QCOMPARE(pixels16[1], (ushort)16384);
+    QCOMPARE(pixels16[2], (ushort)500);
+    QCOMPARE(pixels16[3], (ushort)32768);
+}
+
+void DImgPixelConverterTest::testProcessRows()
+{
+    // Each row must be processed exactly once, with small and large images.
+
+    const QList<QSize> sizes = { QSize(10, 10), QSize(4000, 3000), QSize(100000, 7) };
+
+    Q_FOREACH (const QSize& size, sizes)
+    {
+        QVector<QAtomicInt> counts(size.height());
+        QAtomicInt* const   data = counts.data();
+
+        DImgPixelConverter::processRows(size.width(), size.height(),
+            [data](int begin, int end)
+            {
+                for (int y = begin ; y < end ; ++y)
+                {
+                    data[y].ref();
+                }
+            }
+        );
+
+        for (int y = 0 ; y < size.height() ; ++y)
+        {
+            QCOMPARE(counts[y].loadAcquire(), 1);
+        }
+    }
+}
+
+void DImgPixelConverterTest::benchmarkRowConversions_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<bool>("toDImg");
+
+    QTest::newRow("RGB8 to BGRA8")    << false << 3 << true;
+    QTest::newRow("RGBA8 to BGRA8")   << false << 4 << true;
+    QTest::newRow("RGB16 to BGRA16")  << true  << 3 << true;
+    QTest::newRow("RGBA16 to BGRA16") << true  << 4 << true;
+    QTest::newRow("BGRA8 to RGB8")    << false << 3 << false;
+    QTest::newRow("BGRA16 to RGBA16") << true  << 4 << false;
+}
+
+void DImgPixelConverterTest::benchmarkRowConversions()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(int,  channels);
+    QFETCH(bool, toDImg);
+
+    const int width      = 3000;
+    const int height     = 2000;
+    const int bytesDepth = sixteenBit ? 2 : 1;
+
+    QByteArray codec((qint64)width * height * channels * bytesDepth, 0x40);
+    QByteArray dimg((qint64)width * height * 4 * bytesDepth, 0x40);
+
+    uchar* const codecData = reinterpret_cast<uchar*>(codec.data());
+    uchar* const dimgData  = reinterpret_cast<uchar*>(dimg.data());
+
+    QBENCHMARK
+    {
+        DImgPixelConverter::processRows(width, height,
+            [=](int begin, int end)
+            {
+                for (int y = begin ; y < end ; ++y)
+                {
+                    uchar* const c = codecData + (qint64)y * width * channels * bytesDepth;
+                    uchar* const d = dimgData  + (qint64)y * width * 4        * bytesDepth;
+
+                    if      (toDImg && sixteenBit)
+                    {
+                        DImgPixelConverter::toBGRA16(reinterpret_cast<ushort*>(c), reinterpret_cast<ushort*>(d),
+                                                     width, channels, DImgPixelConverter::RGBOrder, true);
+                    }
+                    else if (toDImg)
+                    {
+                        DImgPixelConverter::toBGRA8(c, d, width, channels, DImgPixelConverter::RGBOrder, true);
+                    }
+                    else if (sixteenBit)
+                    {
+                        DImgPixelConverter::fromBGRA16(reinterpret_cast<ushort*>(d), reinterpret_cast<ushort*>(c),
+                                                       width, channels, DImgPixelConverter::RGBOrder);
+                    }
+                    else
+                    {
+                        DImgPixelConverter::fromBGRA8(d, c, width, channels, DImgPixelConverter::RGBOrder);
+                    }
+                }
+            }
+        );
+    }
+}
+
+void DImgPixelConverterTest::benchmarkFormats_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<bool>("save");
+
+    const QStringList formats = { QLatin1String("PNG"),  QLatin1String("TIFF"),
+                                  QLatin1String("JPEG"), QLatin1String("JP2"),
+                                  QLatin1String("HEIF"), QLatin1String("WEBP") };
+
+    Q_FOREACH (const QString& format, formats)
+    {
+        Q_FOREACH (bool sixteenBit, QList<bool>({ false, true }))
+        {
+            Q_FOREACH (bool save, QList<bool>({ false, true }))
+            {
+                QTest::newRow(QString::fromLatin1("%1 %2 bits %3").arg(format)
+                                                                  .arg(sixteenBit ? 16 : 8)
+                                                                  .arg(save ? QLatin1String("save")
+                                                                            : QLatin1String("load")).toLatin1().constData())
+                    << format << sixteenBit << save;
+            }
+        }
+    }
+}
+
+void DImgPixelConverterTest::benchmarkFormats()
+{
+    QFETCH(QString, format);
+    QFETCH(bool,    sixteenBit);
+    QFETCH(bool,    save);
+
+    // A gradient image, large enough to use the row-parallel conversions.
+
+    const int width  = 2000;
+    const int height = 1500;
+    DImg image(width, height, sixteenBit, true);
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        for (int x = 0 ; x < width ; ++x)
+        {
+            image.setPixelColor(x, y, sixteenBit ? DColor(x * 32, y * 43, (x + y) * 18, 65535, true)
+                                                 : DColor(x / 8,  y / 6,  (x + y) / 14, 255,   false));
+        }
+    }
+
+    const QString path = m_tempDir.filePath(QString::fromLatin1("benchmark%1.%2")
+                                            .arg(sixteenBit ? 16 : 8)
+                                            .arg(format.toLower()));
+
+    if (!image.save(path, format))
+    {
+        QSKIP("DImg plugin to save this format is not available");
+    }
+
+    if (save)
+    {
+        QBENCHMARK
+        {
+            QVERIFY(image.save(path, format));
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            DImg loaded;
+            QVERIFY(loaded.load(path, false, false, false, false));
+            QCOMPARE(loaded.size(), QSize(width, height));
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark DImg pixel conversions
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_PIXEL_CONVERTER_UTEST_H
+#define DIGIKAM_DIMG_PIXEL_CONVERTER_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class DImgPixelConverterTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit DImgPixelConverterTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testRowConversions();
+    void testSwapAndPremultiply();
+    void testProcessRows();
+
+    void benchmarkRowConversions_data();
+    void benchmarkRowConversions();
+
+    void benchmarkFormats_data();
+    void benchmarkFormats();
+
+private:
+
+    QTemporaryDir m_tempDir;
+};
+
+#endif // DIGIKAM_DIMG_PIXEL_CONVERTER_UTEST_H
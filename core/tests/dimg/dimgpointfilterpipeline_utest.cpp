@@ -0,0 +1,306 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark chained per-pixel filters
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgpointfilterpipeline_utest.h"
+
+// Qt includes
+
+#include <QList>
+#include <QScopedPointer>
+#include <QTest>
+
+// Local includes
+
+#include "bcgfilter.h"
+#include "blurfilter.h"
+#include "cbfilter.h"
+#include "dimg.h"
+#include "dimgfiltermanager.h"
+#include "dimgpointfilterpipeline.h"
+#include "filteractionfilter.h"
+#include "hslfilter.h"
+#include "mixerfilter.h"
+#include "wbfilter.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(DImgPointFilterPipelineTest)
+
+namespace
+{
+
+DImg gradientImage(int width, int height, bool sixteenBit)
+{
+    DImg image(width, height, sixteenBit, true);
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        for (int x = 0 ; x < width ; ++x)
+        {
+            image.setPixelColor(x, y, sixteenBit ? DColor(x * 32, y * 43, (x + y) * 18, 65535, true)
+                                                 : DColor(x / 8,  y / 6,  (x + y) / 14, 255,   false));
+        }
+    }
+
+    return image;
+}
+
+/**
+ * A chain of five colour adjustments, as done by a batch queue workflow.
+ */
+QList<FilterAction> colorChain()
+{
+    DImg dummy(1, 1, false, true);
+    QList<FilterAction> actions;
+
+    WBContainer wb;
+    wb.temperature    = 5500.0;
+    wb.expositionMain = 0.3;
+    actions << WBFilter(&dummy, nullptr, wb).filterAction();
+
+    BCGContainer bcg;
+    bcg.brightness    = 0.05;
+    bcg.contrast      = 1.2;
+    bcg.gamma         = 0.9;
+    actions << BCGFilter(&dummy, nullptr, bcg).filterAction();
+
+    HSLContainer hsl;
+    hsl.hue           = 10.0;
+    hsl.saturation    = 15.0;
+    hsl.lightness     = -5.0;
+    actions << HSLFilter(&dummy, nullptr, hsl).filterAction();
+
+    CBContainer cb;
+    cb.red            = 0.1;
+    cb.blue           = -0.1;
+    actions << CBFilter(&dummy, nullptr, cb).filterAction();
+
+    MixerContainer mixer;
+    mixer.redGreenGain = 0.2;
+    mixer.redRedGain   = 0.8;
+    actions << MixerFilter(&dummy, nullptr, mixer).filterAction();
+
+    return actions;
+}
+
+DImg applySequentially(const DImg& image, const QList<FilterAction>& actions)
+{
+    DImg img = image.copyImageData();
+
+    Q_FOREACH (const FilterAction& action, actions)
+    {
+        QScopedPointer<DImgThreadedFilter> filter(DImgFilterManager::instance()->createFilter(action.identifier(),
+                                                                                              action.version()));
+        filter->readParameters(action);
+        filter->setupFilter(img);
+        filter->startFilterDirectly();
+        img = filter->getTargetImage();
+    }
+
+    return img;
+}
+
+} // namespace
+
+DImgPointFilterPipelineTest::DImgPointFilterPipelineTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void DImgPointFilterPipelineTest::testPointFilters()
+{
+    DImgPointFilterPipeline pipeline;
+
+    Q_FOREACH (const FilterAction& action, colorChain())
+    {
+        QVERIFY(DImgPointFilterPipeline::isPointFilter(action));
+        QVERIFY(pipeline.addFilterAction(action));
+    }
+
+    QCOMPARE(pipeline.count(),     5);
+    QCOMPARE(pipeline.passCount(), 5);
+
+    // A blur is not a per-pixel operation.
+
+    DImg dummy(1, 1, false, true);
+    FilterAction blur = BlurFilter(&dummy, nullptr, 3).filterAction();
+
+    QVERIFY(!DImgPointFilterPipeline::isPointFilter(blur));
+    QVERIFY(!pipeline.addFilterAction(blur));
+    QVERIFY(!pipeline.addFilterAction(FilterAction()));
+    QCOMPARE(pipeline.count(), 5);
+
+    pipeline.clear();
+    QVERIFY(pipeline.isEmpty());
+}
+
+void DImgPointFilterPipelineTest::testSamePixels_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("8 bits small")  << false << QSize(64,   48);
+    QTest::newRow("8 bits")        << false << QSize(2000, 1500);
+    QTest::newRow("16 bits small") << true  << QSize(64,   48);
+    QTest::newRow("16 bits")       << true  << QSize(2000, 1500);
+}
+
+void DImgPointFilterPipelineTest::testSamePixels()
+{
+    QFETCH(bool,  sixteenBit);
+    QFETCH(QSize, size);
+
+    const DImg image                  = gradientImage(size.width(), size.height(), sixteenBit);
+    const QList<FilterAction> actions = colorChain();
+
+    DImg expected = applySequentially(image, actions);
+
+    DImgPointFilterPipeline pipeline;
+
+    Q_FOREACH (const FilterAction& action, actions)
+    {
+        QVERIFY(pipeline.addFilterAction(action));
+    }
+
+    DImg processed = pipeline.process(image);
+
+    QCOMPARE(processed.size(),       expected.size());
+    QCOMPARE(processed.sixteenBit(), sixteenBit);
+    QVERIFY(memcmp(processed.bits(), expected.bits(), expected.numBytes()) == 0);
+
+    // In place.
+
+    DImg inPlace = image.copy();
+    pipeline.apply(inPlace);
+
+    QVERIFY(memcmp(inPlace.bits(), expected.bits(), expected.numBytes()) == 0);
+}
+
+void DImgPointFilterPipelineTest::testFilterActionFilter()
+{
+    // Replaying the history gives the same image, with all actions applied.
+
+    const DImg image                  = gradientImage(800, 600, true);
+    const QList<FilterAction> actions = colorChain();
+
+    FilterActionFilter filter;
+    filter.setFilterActions(actions);
+    filter.setupFilter(image.copyImageData());
+    filter.startFilterDirectly();
+
+    QVERIFY(filter.completelyApplied());
+    QCOMPARE(filter.appliedFilterActions().size(), actions.size());
+
+    DImg expected = applySequentially(image, actions);
+
+    QVERIFY(memcmp(filter.getTargetImage().bits(), expected.bits(), expected.numBytes()) == 0);
+}
+
+void DImgPointFilterPipelineTest::testFusedTools_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void DImgPointFilterPipelineTest::testFusedTools()
+{
+    QFETCH(bool, sixteenBit);
+
+    // The filters of the BCG Correction and Color Balance tools chained in a
+    // batch queue workflow are applied in one pass over the image.
+
+    DImg dummy(1, 1, false, true);
+    QList<FilterAction> actions;
+
+    BCGContainer bcg;
+    bcg.brightness = 0.1;
+    bcg.contrast   = 1.3;
+    bcg.gamma      = 1.2;
+    actions << BCGFilter(&dummy, nullptr, bcg).filterAction();
+
+    CBContainer cb;
+    cb.red         = 1.2;
+    cb.green       = 0.9;
+    cb.gamma       = 1.1;
+    actions << CBFilter(&dummy, nullptr, cb).filterAction();
+
+    DImgPointFilterPipeline pipeline;
+
+    Q_FOREACH (const FilterAction& action, actions)
+    {
+        QVERIFY(pipeline.addFilterAction(action));
+    }
+
+    QCOMPARE(pipeline.count(),     2);
+    QCOMPARE(pipeline.passCount(), 1);
+
+    const DImg image = gradientImage(1200, 900, sixteenBit);
+    DImg expected    = applySequentially(image, actions);
+    DImg processed   = pipeline.process(image);
+
+    QVERIFY(memcmp(processed.bits(), expected.bits(), expected.numBytes()) == 0);
+
+    // A filter mixing the channels is a pass of its own.
+
+    HSLContainer hsl;
+    hsl.saturation = 20.0;
+    actions << HSLFilter(&dummy, nullptr, hsl).filterAction();
+    actions << BCGFilter(&dummy, nullptr, bcg).filterAction();
+
+    QVERIFY(pipeline.addFilterAction(actions.at(2)));
+    QVERIFY(pipeline.addFilterAction(actions.at(3)));
+    QCOMPARE(pipeline.passCount(), 3);
+
+    expected  = applySequentially(image, actions);
+    processed = pipeline.process(image);
+
+    QVERIFY(memcmp(processed.bits(), expected.bits(), expected.numBytes()) == 0);
+}
+
+void DImgPointFilterPipelineTest::benchmarkChain_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<bool>("fused");
+
+    QTest::newRow("8 bits sequential")  << false << false;
+    QTest::newRow("8 bits fused")       << false << true;
+    QTest::newRow("16 bits sequential") << true  << false;
+    QTest::newRow("16 bits fused")      << true  << true;
+}
+
+void DImgPointFilterPipelineTest::benchmarkChain()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(bool, fused);
+
+    const DImg image                  = gradientImage(6000, 4000, sixteenBit);
+    const QList<FilterAction> actions = colorChain();
+
+    DImgPointFilterPipeline pipeline;
+
+    Q_FOREACH (const FilterAction& action, actions)
+    {
+        pipeline.addFilterAction(action);
+    }
+
+    QBENCHMARK
+    {
+        DImg result = fused ? pipeline.process(image)
+                            : applySequentially(image, actions);
+
+        QVERIFY(!result.isNull());
+    }
+}
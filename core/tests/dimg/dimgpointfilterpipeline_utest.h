@@ -0,0 +1,43 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark chained per-pixel filters
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_POINT_FILTER_PIPELINE_UTEST_H
+#define DIGIKAM_DIMG_POINT_FILTER_PIPELINE_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class DImgPointFilterPipelineTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit DImgPointFilterPipelineTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testPointFilters();
+    void testSamePixels_data();
+    void testSamePixels();
+    void testFilterActionFilter();
+    void testFusedTools_data();
+    void testFusedTools();
+
+    void benchmarkChain_data();
+    void benchmarkChain();
+};
+
+#endif // DIGIKAM_DIMG_POINT_FILTER_PIPELINE_UTEST_H
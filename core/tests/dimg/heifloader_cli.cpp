@@ -0,0 +1,150 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Benchmark HEIF loader with grid images.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+// Qt includes
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+
+// Libheif includes
+
+#include <libheif/heif.h>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "dpluginloader.h"
+#include "metaengine.h"
+
+using namespace Digikam;
+
+/**
+ * Decode the primary image as a whole, with one call to heif_decode_image(),
+ * as reference of the HEIF loader behavior without parallel tiles decoding.
+ */
+qint64 decodeWithLibheif(const QString& path, int iterations)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0 ; i < iterations ; ++i)
+    {
+        struct heif_context* const ctx    = heif_context_alloc();
+        struct heif_image_handle* handle  = nullptr;
+        struct heif_image* image          = nullptr;
+        struct heif_error error           = heif_context_read_from_file(ctx, QFile::encodeName(path).constData(), nullptr);
+
+        if (error.code == heif_error_Ok)
+        {
+            error = heif_context_get_primary_image_handle(ctx, &handle);
+        }
+
+        if (error.code == heif_error_Ok)
+        {
+            struct heif_decoding_options* const options = heif_decoding_options_alloc();
+            options->ignore_transformations             = 1;
+            error                                       = heif_decode_image(handle, &image,
+                                                                            heif_colorspace_RGB,
+                                                                            heif_chroma_interleaved_RGB,
+                                                                            options);
+            heif_decoding_options_free(options);
+        }
+
+        heif_image_release(image);
+        heif_image_handle_release(handle);
+        heif_context_free(ctx);
+
+        if (error.code != heif_error_Ok)
+        {
+            qCWarning(DIGIKAM_TESTS_LOG) << "Cannot decode" << path << "with libheif:" << error.message;
+
+            return -1;
+        }
+    }
+
+    return timer.elapsed() / iterations;
+}
+
+qint64 loadWithDImg(const QString& path, int iterations, QSize& size)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0 ; i < iterations ; ++i)
+    {
+        DImg img;
+
+        if (!img.load(path, false, false, false, false))
+        {
+            qCWarning(DIGIKAM_TESTS_LOG) << "Cannot load" << path << "with DImg";
+
+            return -1;
+        }
+
+        size = img.size();
+    }
+
+    return timer.elapsed() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        qCDebug(DIGIKAM_TESTS_LOG) << "heifloader_cli - benchmark HEIF loader with grid images";
+        qCDebug(DIGIKAM_TESTS_LOG) << "Usage: [-n <iterations>] <heif images>";
+
+        return -1;
+    }
+
+    QApplication app(argc, argv);
+
+    MetaEngine::initializeExiv2();
+    DPluginLoader::instance()->init();
+
+    int iterations = 5;
+    QStringList list;
+
+    for (int i = 1 ; i < argc ; ++i)
+    {
+        if ((QLatin1String(argv[i]) == QLatin1String("-n")) && ((i + 1) < argc))
+        {
+            iterations = qMax(1, QString::fromLocal8Bit(argv[++i]).toInt());
+        }
+        else
+        {
+            list.append(QString::fromLocal8Bit(argv[i]));
+        }
+    }
+
+    Q_FOREACH (const QString& path, list)
+    {
+        QSize size;
+        qint64 dimgTime = loadWithDImg(path, iterations, size);
+        qint64 heifTime = decodeWithLibheif(path, iterations);
+
+        qCDebug(DIGIKAM_TESTS_LOG) << QFileInfo(path).fileName() << size
+                                   << ": DImg load" << dimgTime << "ms"
+                                   << "- libheif whole image decode" << heifTime << "ms"
+                                   << "(average of" << iterations << "runs)";
+    }
+
+    DPluginLoader::instance()->cleanUp();
+
+    return 0;
+}
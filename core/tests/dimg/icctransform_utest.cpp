@@ -0,0 +1,198 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark ICC color transforms
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "icctransform_utest.h"
+
+// Qt includes
+
+#include <QFuture>
+#include <QList>
+#include <QTest>
+#include <QtConcurrent>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dimg.h"
+#include "icctransform.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(IccTransformTest)
+
+namespace
+{
+
+DImg gradientImage(int width, int height, bool sixteenBit)
+{
+    DImg image(width, height, sixteenBit, true);
+
+    if (sixteenBit)
+    {
+        ushort* const data = reinterpret_cast<ushort*>(image.bits());
+
+        for (qint64 i = 0 ; i < (qint64)width * height ; ++i)
+        {
+            data[4 * i]     = (ushort)(i * 7);
+            data[4 * i + 1] = (ushort)(i * 13);
+            data[4 * i + 2] = (ushort)(i * 29);
+            data[4 * i + 3] = 0xFFFF;
+        }
+    }
+    else
+    {
+        uchar* const data = image.bits();
+
+        for (qint64 i = 0 ; i < (qint64)width * height ; ++i)
+        {
+            data[4 * i]     = (uchar)(i * 7);
+            data[4 * i + 1] = (uchar)(i * 13);
+            data[4 * i + 2] = (uchar)(i * 29);
+            data[4 * i + 3] = 0xFF;
+        }
+    }
+
+    return image;
+}
+
+} // namespace
+
+IccTransformTest::IccTransformTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void IccTransformTest::initTestCase()
+{
+    IccTransform::init();
+
+    m_input  = IccProfile::sRGB();
+    m_output = IccProfile::wideGamutRGB();
+
+    if (!m_input.open() || !m_output.open())
+    {
+        QSKIP("digiKam ICC profiles are not installed");
+    }
+}
+
+void IccTransformTest::testParallelTransform()
+{
+    // A large image is converted in parallel, a single row in the current thread:
+    // both must give the same pixels.
+
+    const int width  = 3000;
+    const int height = 2000;
+
+    Q_FOREACH (bool sixteenBit, QList<bool>({ false, true }))
+    {
+        DImg image = gradientImage(width, height, sixteenBit);
+        QList<DImg> rows;
+
+        Q_FOREACH (int y, QList<int>({ 0, height / 2, height - 1 }))
+        {
+            rows << image.copy(0, y, width, 1);
+        }
+
+        IccTransform transform;
+        transform.setInputProfile(m_input);
+        transform.setOutputProfile(m_output);
+        QVERIFY(transform.apply(image));
+
+        int index = 0;
+
+        Q_FOREACH (int y, QList<int>({ 0, height / 2, height - 1 }))
+        {
+            DImg& row = rows[index++];
+            QVERIFY(transform.apply(row));
+
+            QVERIFY(memcmp(row.bits(), image.scanLine(y), width * image.bytesDepth()) == 0);
+        }
+    }
+}
+
+void IccTransformTest::testConcurrentTransforms()
+{
+    // Several transforms sharing the same cached LittleCMS transform are applied at once.
+
+    const DImg reference = gradientImage(1000, 1000, true);
+
+    DImg expected = reference.copy();
+    IccTransform transform;
+    transform.setInputProfile(m_input);
+    transform.setOutputProfile(m_output);
+    QVERIFY(transform.apply(expected));
+
+    QList<DImg>           images;
+    QList<QFuture<void> > tasks;
+
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+        images << reference.copy();
+    }
+
+    for (int i = 0 ; i < images.size() ; ++i)
+    {
+        DImg* const image = &images[i];
+        IccProfile input  = m_input;
+        IccProfile output = m_output;
+
+        tasks.append(QtConcurrent::run(
+                                       [image, input, output]()
+                                       {
+                                           IccTransform t;
+                                           t.setInputProfile(input);
+                                           t.setOutputProfile(output);
+                                           t.apply(*image);
+                                       }
+                                      )
+        );
+    }
+
+    Q_FOREACH (QFuture<void> t, tasks)
+    {
+        t.waitForFinished();
+    }
+
+    Q_FOREACH (const DImg& image, images)
+    {
+        QVERIFY(memcmp(image.bits(), expected.bits(), expected.numBytes()) == 0);
+    }
+}
+
+void IccTransformTest::benchmarkTransform_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("50 MP 8 bits")  << false;
+    QTest::newRow("50 MP 16 bits") << true;
+}
+
+void IccTransformTest::benchmarkTransform()
+{
+    QFETCH(bool, sixteenBit);
+
+    // 8660 x 5773 pixels, as a 50 MP camera sensor.
+
+    DImg image = gradientImage(8660, 5773, sixteenBit);
+
+    IccTransform transform;
+    transform.setInputProfile(m_input);
+    transform.setOutputProfile(m_output);
+    transform.setDoNotEmbedOutputProfile(true);
+
+    QBENCHMARK
+    {
+        QVERIFY(transform.apply(image));
+    }
+}
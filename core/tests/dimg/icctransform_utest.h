@@ -0,0 +1,50 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark ICC color transforms
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ICC_TRANSFORM_UTEST_H
+#define DIGIKAM_ICC_TRANSFORM_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+
+// Local includes
+
+#include "iccprofile.h"
+
+class IccTransformTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit IccTransformTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testParallelTransform();
+    void testConcurrentTransforms();
+
+    void benchmarkTransform_data();
+    void benchmarkTransform();
+
+private:
+
+    Digikam::IccProfile m_input;
+    Digikam::IccProfile m_output;
+};
+
+#endif // DIGIKAM_ICC_TRANSFORM_UTEST_H
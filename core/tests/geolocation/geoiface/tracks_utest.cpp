@@ -121,6 +121,30 @@ void TestTracks::testCustomDateTimeParsing()
         QCOMPARE(time1.date(), QDate(2010, 01, 14));
         QCOMPARE(time1.time(), QTime(12, 41, 02, 287));
     }
+
+    {
+        // without milliseconds: 2009-03-11T13:39:55Z
+        const QDateTime time1 = TrackReader::ParseTime(QString::fromLatin1("2009-03-11T13:39:55Z"));
+        QCOMPARE(time1.timeSpec(), Qt::UTC);
+        QCOMPARE(time1.date(), QDate(2009, 03, 11));
+        QCOMPARE(time1.time(), QTime(13, 39, 55));
+    }
+
+    {
+        // the time zone offset can change the date: 2010-01-14T01:26:02+02:00
+        const QDateTime time1 = TrackReader::ParseTime(QString::fromLatin1("2010-01-14T01:26:02+02:00"));
+        QCOMPARE(time1.timeSpec(), Qt::UTC);
+        QCOMPARE(time1.date(), QDate(2010, 01, 13));
+        QCOMPARE(time1.time(), QTime(23, 26, 02));
+    }
+
+    {
+        // without time zone, the time is a local time
+        const QDateTime time1 = TrackReader::ParseTime(QString::fromLatin1("2010-01-14T09:26:02.287"));
+        QCOMPARE(time1.timeSpec(), Qt::LocalTime);
+        QCOMPARE(time1.date(), QDate(2010, 01, 14));
+        QCOMPARE(time1.time(), QTime(9, 26, 02, 287));
+    }
 }
 
 /**
@@ -0,0 +1,224 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the tiles of the GPS search marker tiler
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "gpsmarkertiler_utest.h"
+
+// Qt includes
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QItemSelectionModel>
+#include <QPair>
+
+// Local includes
+
+#include "collectionlocation.h"
+#include "coredb.h"
+#include "coredbaccess.h"
+#include "gpsiteminfosorter.h"
+#include "gpsmarkertiler.h"
+#include "itemalbummodel.h"
+#include "itemfiltermodel.h"
+#include "iteminfo.h"
+#include "itemposition.h"
+#include "tileindex.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(GPSMarkerTilerTest)
+
+namespace
+{
+
+/**
+ * Returns the id of the image of the representative marker of the tile, or -1.
+ */
+qlonglong representativeId(GPSMarkerTiler* const tiler, const TileIndex& tileIndex, int sortKey)
+{
+    const QVariant marker = tiler->getTileRepresentativeMarker(tileIndex, sortKey);
+
+    if (!marker.isValid())
+    {
+        return -1;
+    }
+
+    return marker.value<QPair<TileIndex, int> >().second;
+}
+
+/**
+ * The tiler with empty models: no image is selected, filtered or in a region.
+ */
+class TilerFixture
+{
+public:
+
+    TilerFixture()
+      : selectionModel(&filterModel)
+    {
+        filterModel.setSourceItemModel(&albumModel);
+        tiler = new GPSMarkerTiler(nullptr, &filterModel, &selectionModel);
+    }
+
+    ~TilerFixture()
+    {
+        delete tiler;
+    }
+
+    /// Loads the index of the positions from the database.
+    bool loadIndex(int count)
+    {
+        tiler->prepareTiles(GeoCoordinates(), GeoCoordinates(), 0);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while ((tiler->getTileMarkerCount(TileIndex()) != count) && (timer.elapsed() < 10000))
+        {
+            QTest::qWait(50);
+        }
+
+        return (tiler->getTileMarkerCount(TileIndex()) == count);
+    }
+
+public:
+
+    ItemAlbumModel      albumModel;
+    ItemFilterModel     filterModel;
+    QItemSelectionModel selectionModel;
+    GPSMarkerTiler*     tiler = nullptr;
+};
+
+} // namespace
+
+GPSMarkerTilerTest::GPSMarkerTilerTest(QObject* const parent)
+    : QObject (parent),
+      m_first (-1),
+      m_second(-1),
+      m_third (-1)
+{
+}
+
+void GPSMarkerTilerTest::initTestCase()
+{
+    DbEngineParameters params(QString::fromUtf8("QSQLITE"),
+                              QString::fromUtf8(":memory:"),
+                              QString::fromUtf8(""));
+
+    CoreDbAccess::setParameters(params);
+    QVERIFY(CoreDbAccess::checkReadyForUse());
+
+    {
+        CoreDbAccess access;
+        const int rootId  = access.db()->addAlbumRoot(CollectionLocation::VolumeHardWired,
+                                                      QLatin1String("volumeid:?path=/tmp"),
+                                                      QLatin1String("/"), QLatin1String("test"));
+        const int albumId = access.db()->addAlbum(rootId, QLatin1String("/"), QString(),
+                                                  QDate::currentDate(), QString());
+
+        m_first  = access.db()->addItem(albumId, QLatin1String("first.jpg"),  DatabaseItem::Visible,
+                                        DatabaseItem::Image, QDateTime::currentDateTime(), 1000, QString());
+        m_second = access.db()->addItem(albumId, QLatin1String("second.jpg"), DatabaseItem::Visible,
+                                        DatabaseItem::Image, QDateTime::currentDateTime(), 1000, QString());
+        m_third  = access.db()->addItem(albumId, QLatin1String("third.jpg"),  DatabaseItem::Visible,
+                                        DatabaseItem::Image, QDateTime::currentDateTime(), 1000, QString());
+    }
+
+    // The first two images are close to each other, the third is far away.
+
+    setPosition(m_first,   10.0,    10.0);
+    setPosition(m_second,  10.001,  10.001);
+    setPosition(m_third,  -40.0,   -60.0);
+
+    ItemInfo(m_second).setRating(5);
+    ItemInfo(m_third).setRating(3);
+}
+
+void GPSMarkerTilerTest::setPosition(qlonglong id, double lat, double lon)
+{
+    ItemPosition position = ItemInfo(id).imagePosition();
+    position.setLatitude(lat);
+    position.setLongitude(lon);
+    position.apply();
+}
+
+void GPSMarkerTilerTest::testTileCounts()
+{
+    TilerFixture fixture;
+    QVERIFY(fixture.loadIndex(3));
+
+    const TileIndex closeTile = TileIndex::fromCoordinates(GeoCoordinates(10.0, 10.0), 2);
+    const TileIndex farTile   = TileIndex::fromCoordinates(GeoCoordinates(-40.0, -60.0), 2);
+
+    // The tiles are split on demand: each image is in one tile of each level.
+
+    QCOMPARE(fixture.tiler->getTileMarkerCount(closeTile), 2);
+    QCOMPARE(fixture.tiler->getTileMarkerCount(farTile),   1);
+
+    const TileIndex deepTile = TileIndex::fromCoordinates(GeoCoordinates(-40.0, -60.0), TileIndex::MaxLevel);
+
+    QCOMPARE(fixture.tiler->getTileMarkerCount(deepTile), 1);
+
+    // A removed position is removed from the tiles which are already split.
+
+    CoreDbAccess().db()->removeItemPosition(m_third);
+
+    QTRY_COMPARE_WITH_TIMEOUT(fixture.tiler->getTileMarkerCount(TileIndex()), 2, 10000);
+    QCOMPARE(fixture.tiler->getTileMarkerCount(farTile),  0);
+    QCOMPARE(fixture.tiler->getTileMarkerCount(deepTile), 0);
+
+    setPosition(m_third, -40.0, -60.0);
+
+    QTRY_COMPARE_WITH_TIMEOUT(fixture.tiler->getTileMarkerCount(TileIndex()), 3, 10000);
+    QCOMPARE(fixture.tiler->getTileMarkerCount(farTile), 1);
+}
+
+void GPSMarkerTilerTest::testRepresentativeMarker()
+{
+    TilerFixture fixture;
+    QVERIFY(fixture.loadIndex(3));
+
+    const int byRating        = GPSItemInfoSorter::SortRating;
+    const int byDate          = GPSItemInfoSorter::SortYoungestFirst;
+    const TileIndex closeTile = TileIndex::fromCoordinates(GeoCoordinates(10.0, 10.0), 2);
+
+    // The best rated image, or the image with the lowest id without the rating.
+
+    QCOMPARE(representativeId(fixture.tiler, closeTile, byRating), m_second);
+    QCOMPARE(representativeId(fixture.tiler, closeTile, byDate),   qMin(m_first, m_second));
+
+    // The cached marker of a tile is kept for its sort key.
+
+    QCOMPARE(representativeId(fixture.tiler, closeTile, byRating), m_second);
+
+    // A split tile chooses among the best markers of its children.
+
+    QCOMPARE(representativeId(fixture.tiler, TileIndex(), byRating), m_second);
+
+    // The cached markers are dropped when an image leaves the tile.
+
+    setPosition(m_second, -40.001, -60.001);
+
+    QTRY_COMPARE_WITH_TIMEOUT(fixture.tiler->getTileMarkerCount(closeTile), 1, 10000);
+    QCOMPARE(representativeId(fixture.tiler, closeTile, byRating), m_first);
+
+    const TileIndex farTile = TileIndex::fromCoordinates(GeoCoordinates(-40.0, -60.0), 2);
+
+    QCOMPARE(representativeId(fixture.tiler, farTile,     byRating), m_second);
+    QCOMPARE(representativeId(fixture.tiler, TileIndex(), byRating), m_second);
+
+    setPosition(m_second, 10.001, 10.001);
+
+    QTRY_COMPARE_WITH_TIMEOUT(fixture.tiler->getTileMarkerCount(closeTile), 2, 10000);
+    QCOMPARE(representativeId(fixture.tiler, farTile, byRating), m_third);
+}
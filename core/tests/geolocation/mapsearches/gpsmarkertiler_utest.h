@@ -0,0 +1,49 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Unit tests for the tiles of the GPS search marker tiler
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_GPS_MARKER_TILER_UTEST_H
+#define DIGIKAM_GPS_MARKER_TILER_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QTest>
+
+class GPSMarkerTilerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit GPSMarkerTilerTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+
+    void testTileCounts();
+    void testRepresentativeMarker();
+
+private:
+
+    void setPosition(qlonglong id, double lat, double lon);
+
+private:
+
+    qlonglong m_first;
+    qlonglong m_second;
+    qlonglong m_third;
+};
+
+#endif // DIGIKAM_GPS_MARKER_TILER_UTEST_H
@@ -0,0 +1,276 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark the image editor undo cache
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "undocache_utest.h"
+
+// Qt includes
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QStandardPaths>
+#include <QStorageInfo>
+#include <QTest>
+
+// Local includes
+
+#include "dimg.h"
+#include "undocache.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(UndoCacheTest)
+
+namespace
+{
+
+/**
+ * A noisy gradient, which does not compress to nothing.
+ */
+DImg createImage(int width, int height, bool sixteenBit, bool hasAlpha)
+{
+    DImg image(width, height, sixteenBit, hasAlpha);
+    uchar* const bits = image.bits();
+    quint32 seed      = 1;
+
+    for (quint64 i = 0 ; i < image.numBytes() ; ++i)
+    {
+        seed    = seed * 1103515245 + 12345;
+        bits[i] = (uchar)((i / 64) + ((seed >> 16) & 0x0F));
+    }
+
+    return image;
+}
+
+/**
+ * Changes the pixels of a rectangle, as an editor tool would do.
+ */
+void paint(DImg& image, const QRect& rect, uchar value)
+{
+    const int    bytesDepth   = image.bytesDepth();
+    const qint64 bytesPerLine = (qint64)image.width() * bytesDepth;
+
+    for (int y = rect.top() ; y <= rect.bottom() ; ++y)
+    {
+        memset(image.bits() + y * bytesPerLine + rect.x() * bytesDepth, value, rect.width() * bytesDepth);
+    }
+}
+
+bool sameImage(const DImg& a, const DImg& b)
+{
+    return (
+            !a.isNull()                          &&
+            (a.width()      == b.width())        &&
+            (a.height()     == b.height())       &&
+            (a.sixteenBit() == b.sixteenBit())   &&
+            (a.hasAlpha()   == b.hasAlpha())     &&
+            (memcmp(a.bits(), b.bits(), a.numBytes()) == 0)
+           );
+}
+
+} // namespace
+
+UndoCacheTest::UndoCacheTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void UndoCacheTest::testRoundTrip_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+    QTest::addColumn<bool>("hasAlpha");
+
+    QTest::newRow("8 bits")             << false << false;
+    QTest::newRow("8 bits with alpha")  << false << true;
+    QTest::newRow("16 bits")            << true  << false;
+    QTest::newRow("16 bits with alpha") << true  << true;
+}
+
+void UndoCacheTest::testRoundTrip()
+{
+    QFETCH(bool, sixteenBit);
+    QFETCH(bool, hasAlpha);
+
+    // A size which is not a multiple of the tiles size.
+
+    UndoCache    cache;
+    DImg         image = createImage(1000, 700, sixteenBit, hasAlpha);
+    QList<DImg>  expected;
+
+    for (int level = 1 ; level <= 5 ; ++level)
+    {
+        QVERIFY(cache.putData(level, image));
+        expected << image.copyImageData();
+
+        // The cache must keep its own copy of the data.
+
+        paint(image, QRect(level * 100, level * 50, 300, 200), (uchar)(level * 40));
+    }
+
+    QVERIFY(!cache.putData(3, image));
+
+    // Read the levels twice: while queued or just stored, and once stored.
+
+    for (int pass = 0 ; pass < 2 ; ++pass)
+    {
+        for (int level = 5 ; level >= 1 ; --level)
+        {
+            QVERIFY(sameImage(cache.getData(level), expected.at(level - 1)));
+        }
+    }
+
+    QVERIFY(cache.getData(6).isNull());
+
+    // The returned images are copies.
+
+    DImg restored = cache.getData(2);
+    paint(restored, QRect(0, 0, 100, 100), 0);
+    QVERIFY(sameImage(cache.getData(2), expected.at(1)));
+}
+
+void UndoCacheTest::testClearFrom()
+{
+    UndoCache cache;
+    DImg      image = createImage(600, 600, false, true);
+    DImg      first = image.copyImageData();
+
+    QVERIFY(cache.putData(1, image));
+
+    paint(image, QRect(10, 10, 50, 50), 200);
+    QVERIFY(cache.putData(2, image));
+
+    paint(image, QRect(300, 300, 200, 200), 100);
+    QVERIFY(cache.putData(3, image));
+
+    cache.clearFrom(2);
+
+    QVERIFY(cache.getData(2).isNull());
+    QVERIFY(cache.getData(3).isNull());
+    QVERIFY(sameImage(cache.getData(1), first));
+
+    // A new branch of levels replaces the removed ones.
+
+    paint(image, QRect(0, 0, 600, 10), 50);
+    QVERIFY(cache.putData(2, image));
+    QVERIFY(sameImage(cache.getData(2), image));
+    QVERIFY(sameImage(cache.getData(1), first));
+
+    cache.clear();
+
+    QVERIFY(cache.getData(1).isNull());
+    QVERIFY(cache.putData(1, image));
+    QVERIFY(sameImage(cache.getData(1), image));
+}
+
+void UndoCacheTest::testGeometryChange()
+{
+    // A crop or a depth conversion between levels: no tile can be shared.
+
+    UndoCache cache;
+    DImg      image   = createImage(900, 600, false, false);
+    DImg      cropped = image.copy(100, 100, 500, 300);
+    DImg      deep    = cropped.copyImageData();
+    deep.convertDepth(64);
+
+    QVERIFY(cache.putData(1, image));
+    QVERIFY(cache.putData(2, cropped));
+    QVERIFY(cache.putData(3, deep));
+    QVERIFY(cache.putData(4, cropped));
+
+    QVERIFY(sameImage(cache.getData(1), image));
+    QVERIFY(sameImage(cache.getData(2), cropped));
+    QVERIFY(sameImage(cache.getData(3), deep));
+    QVERIFY(sameImage(cache.getData(4), cropped));
+}
+
+void UndoCacheTest::testSpillToDisk()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    const QString filter   = QString::fromUtf8("undocache-%1-*").arg(QCoreApplication::applicationPid());
+
+    UndoCache cache;
+
+    // The cache files are only written when 2 GiB are free on the disk.
+
+    if (QStorageInfo(cacheDir).bytesAvailable() < (qint64)2048 * 1024 * 1024)
+    {
+        QSKIP("Not enough free disk space for the undo cache files");
+    }
+
+    // Each level changes all tiles and is larger than the memory limit once compressed:
+    // only the newest level stays in memory.
+
+    cache.setMemoryLimit(1024 * 1024);
+
+    DImg        image = createImage(1000, 700, false, true);
+    QList<DImg> expected;
+
+    for (int level = 1 ; level <= 4 ; ++level)
+    {
+        uchar* const bits = image.bits();
+
+        for (quint64 i = 0 ; i < image.numBytes() ; ++i)
+        {
+            bits[i] += 17;
+        }
+
+        QVERIFY(cache.putData(level, image));
+        expected << image.copyImageData();
+    }
+
+    // Wait for the levels to be stored.
+
+    cache.setMemoryLimit(1024 * 1024);
+
+    QVERIFY(!QDir(cacheDir).entryList(QStringList() << filter, QDir::Files).isEmpty());
+
+    for (int level = 1 ; level <= 4 ; ++level)
+    {
+        QVERIFY(sameImage(cache.getData(level), expected.at(level - 1)));
+    }
+
+    cache.clear();
+
+    QVERIFY(QDir(cacheDir).entryList(QStringList() << filter, QDir::Files).isEmpty());
+}
+
+void UndoCacheTest::benchmarkPutData_data()
+{
+    QTest::addColumn<bool>("sixteenBit");
+
+    QTest::newRow("8 bits")  << false;
+    QTest::newRow("16 bits") << true;
+}
+
+void UndoCacheTest::benchmarkPutData()
+{
+    QFETCH(bool, sixteenBit);
+
+    // Local edits on a 24 MP image, the most common case in the editor.
+
+    UndoCache cache;
+    DImg      image = createImage(6000, 4000, sixteenBit, false);
+    int       level = 1;
+
+    QBENCHMARK
+    {
+        paint(image, QRect((level * 250) % 5000, (level * 150) % 3000, 1000, 1000), (uchar)level);
+        QVERIFY(cache.putData(level, image));
+        ++level;
+    }
+
+    QVERIFY(!cache.getData(1).isNull());
+    QVERIFY(sameImage(cache.getData(level - 1), image));
+}
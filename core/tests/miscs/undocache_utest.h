@@ -0,0 +1,42 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark the image editor undo cache
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_UNDO_CACHE_UTEST_H
+#define DIGIKAM_UNDO_CACHE_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class UndoCacheTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    UndoCacheTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testClearFrom();
+    void testGeometryChange();
+    void testSpillToDisk();
+
+    void benchmarkPutData_data();
+    void benchmarkPutData();
+};
+
+#endif // DIGIKAM_UNDO_CACHE_UTEST_H
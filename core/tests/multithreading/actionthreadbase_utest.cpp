@@ -0,0 +1,275 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the jobs scheduling of ActionThreadBase
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "actionthreadbase_utest.h"
+
+// Qt includes
+
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QTest>
+#include <QThread>
+#include <QVector>
+
+// Local includes
+
+#include "actionthreadbase.h"
+#include "threadmanager.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(ActionThreadBaseTest)
+
+namespace
+{
+
+/**
+ * A job recording its priority in the list of the processed jobs.
+ */
+class OrderJob : public ActionJob
+{
+public:
+
+    OrderJob(int priority, QList<int>* const order, QMutex* const mutex)
+        : ActionJob(),
+          m_priority(priority),
+          m_order   (order),
+          m_mutex   (mutex)
+    {
+    }
+
+protected:
+
+    void run() override
+    {
+        {
+            QMutexLocker lock(m_mutex);
+            m_order->append(m_priority);
+        }
+
+        Q_EMIT signalDone();
+    }
+
+private:
+
+    int         m_priority;
+    QList<int>* m_order;
+    QMutex*     m_mutex;
+};
+
+/**
+ * A long job, as a part of the duplicates search, which runs until the gate is opened.
+ */
+class BlockingJob : public ActionJob
+{
+public:
+
+    BlockingJob(QSemaphore* const started, QSemaphore* const gate)
+        : ActionJob(),
+          m_started (started),
+          m_gate    (gate)
+    {
+    }
+
+protected:
+
+    void run() override
+    {
+        m_started->release();
+        m_gate->acquire();
+
+        Q_EMIT signalDone();
+    }
+
+private:
+
+    QSemaphore* m_started;
+    QSemaphore* m_gate;
+};
+
+/**
+ * A job running a parallel loop on the threads of its own class.
+ */
+class NestedLoopJob : public QRunnable
+{
+public:
+
+    NestedLoopJob(QAtomicInt* const total, QSemaphore* const done)
+        : m_total(total),
+          m_done (done)
+    {
+        setAutoDelete(true);
+    }
+
+protected:
+
+    void run() override
+    {
+        QAtomicInt* const total = m_total;
+
+        ThreadManager::instance()->parallelFor(100,
+            [total](int)
+            {
+                total->ref();
+            },
+            ThreadManager::Background
+        );
+
+        m_done->release();
+    }
+
+private:
+
+    QAtomicInt* m_total;
+    QSemaphore* m_done;
+};
+
+class OrderThread : public ActionThreadBase
+{
+public:
+
+    explicit OrderThread(QObject* const parent = nullptr)
+        : ActionThreadBase(parent)
+    {
+    }
+
+    void addJobs(const ActionJobCollection& jobs)
+    {
+        appendJobs(jobs);
+    }
+};
+
+} // namespace
+
+ActionThreadBaseTest::ActionThreadBaseTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void ActionThreadBaseTest::testDequeueOrder()
+{
+    QList<int> order;
+    QMutex     mutex;
+
+    // With one job running at once, the jobs are started in the order of their priority.
+
+    OrderThread thread;
+    thread.setMaximumNumberOfThreads(1);
+
+    ActionJobCollection collection;
+
+    for (int priority : { 2, 7, 0, 5, 3 })
+    {
+        collection.insert(new OrderJob(priority, &order, &mutex), priority);
+    }
+
+    thread.addJobs(collection);
+    thread.start();
+
+    QTRY_COMPARE(order.count(), 5);
+    QCOMPARE(order, QList<int>() << 7 << 5 << 3 << 2 << 0);
+}
+
+void ActionThreadBaseTest::testSharedThreads()
+{
+    // The jobs of all classes together do not use more threads than cores.
+
+    const int interactive = ThreadManager::instance()->maximumJobThreads(ThreadManager::Interactive);
+    const int background  = ThreadManager::instance()->maximumJobThreads(ThreadManager::Background);
+    const int maintenance = ThreadManager::instance()->maximumJobThreads(ThreadManager::Maintenance);
+
+    QVERIFY(interactive >= 1);
+    QVERIFY(background  >= 1);
+    QCOMPARE(maintenance, background);
+    QVERIFY((interactive + background) <= qMax(2, QThread::idealThreadCount()));
+}
+
+void ActionThreadBaseTest::testInteractiveWhileBackgroundBusy()
+{
+    // A duplicates search takes all the background threads...
+
+    const int  background = ThreadManager::instance()->maximumJobThreads(ThreadManager::Background);
+    QSemaphore started;
+    QSemaphore gate;
+
+    OrderThread search;
+    search.setPriorityClass(ThreadManager::Background);
+
+    ActionJobCollection jobs;
+
+    for (int i = 0 ; i < (background + 2) ; ++i)
+    {
+        jobs.insert(new BlockingJob(&started, &gate), 0);
+    }
+
+    search.addJobs(jobs);
+    search.start();
+
+    QVERIFY(started.tryAcquire(background, 10000));
+
+    // ... while an album listing still gets a thread.
+
+    QList<int> order;
+    QMutex     mutex;
+
+    OrderThread listing;
+    listing.setPriorityClass(ThreadManager::Interactive);
+
+    ActionJobCollection listingJobs;
+    listingJobs.insert(new OrderJob(1, &order, &mutex), 0);
+    listing.addJobs(listingJobs);
+    listing.start();
+
+    QTRY_COMPARE_WITH_TIMEOUT(order.count(), 1, 10000);
+
+    // The search jobs waiting for a thread are not run on the interactive threads.
+
+    QVERIFY(!started.tryAcquire(1, 200));
+
+    gate.release(background + 2);
+
+    QVERIFY(started.tryAcquire(2, 10000));
+}
+
+void ActionThreadBaseTest::testParallelFor()
+{
+    QVector<int> calls(1000, 0);
+
+    ThreadManager::instance()->parallelFor(calls.count(),
+        [&calls](int i)
+        {
+            calls[i]++;
+        },
+        ThreadManager::Background
+    );
+
+    QCOMPARE(calls, QVector<int>(1000, 1));
+
+    // From jobs taking all the threads of the class: the calling jobs make the calls themselves.
+
+    const int  background = ThreadManager::instance()->maximumJobThreads(ThreadManager::Background);
+    QAtomicInt total;
+    QSemaphore done;
+
+    for (int j = 0 ; j < background ; ++j)
+    {
+        ThreadManager::instance()->scheduleJob(new NestedLoopJob(&total, &done), ThreadManager::Background);
+    }
+
+    QVERIFY(done.tryAcquire(background, 10000));
+    QCOMPARE(total.loadAcquire(), background * 100);
+}
@@ -0,0 +1,38 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the jobs scheduling of ActionThreadBase
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_ACTION_THREAD_BASE_UTEST_H
+#define DIGIKAM_ACTION_THREAD_BASE_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class ActionThreadBaseTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit ActionThreadBaseTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testDequeueOrder();
+    void testSharedThreads();
+    void testInteractiveWhileBackgroundBusy();
+    void testParallelFor();
+};
+
+#endif // DIGIKAM_ACTION_THREAD_BASE_UTEST_H
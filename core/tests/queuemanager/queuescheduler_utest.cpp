@@ -0,0 +1,246 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the scheduling of the queue items
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "queuescheduler_utest.h"
+
+// Qt includes
+
+#include <QTest>
+
+// Local includes
+
+#include "queuescheduler.h"
+#include "task.h"
+
+using namespace Digikam;
+
+QTEST_GUILESS_MAIN(QueueSchedulerTest)
+
+namespace
+{
+
+BatchSetList toolsOf(const QList<BatchTool::BatchToolGroup>& groups)
+{
+    BatchSetList tools;
+
+    Q_FOREACH (BatchTool::BatchToolGroup group, groups)
+    {
+        BatchToolSet set;
+        set.group = group;
+        tools << set;
+    }
+
+    return tools;
+}
+
+} // namespace
+
+QueueSchedulerTest::QueueSchedulerTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void QueueSchedulerTest::testEstimateMemory()
+{
+    const QSize size(1000, 1000);
+    const qint64 pixels = 1000 * 1000;
+
+    // The metadata tools do not load the image.
+
+    QCOMPARE(Task::estimateMemory(size, false, BatchSetList()),
+             (qint64)16 * 1024 * 1024);
+    QCOMPARE(Task::estimateMemory(size, true, toolsOf({ BatchTool::MetadataTool })),
+             (qint64)16 * 1024 * 1024);
+
+    // The loaded image and the result.
+
+    QCOMPARE(Task::estimateMemory(size, false, toolsOf({ BatchTool::MetadataTool, BatchTool::ConvertTool })),
+             pixels * 4 * 2);
+    QCOMPARE(Task::estimateMemory(size, true, toolsOf({ BatchTool::TransformTool })),
+             pixels * 8 * 2);
+
+    // The enhance and filters tools also use a temporary image.
+
+    QCOMPARE(Task::estimateMemory(size, false, toolsOf({ BatchTool::ColorTool, BatchTool::FiltersTool })),
+             pixels * 4 * 3);
+    QCOMPARE(Task::estimateMemory(size, true, toolsOf({ BatchTool::EnhanceTool })),
+             pixels * 8 * 3);
+
+    // A 24 megapixels image is assumed when the size is not known.
+
+    QCOMPARE(Task::estimateMemory(QSize(), false, toolsOf({ BatchTool::ConvertTool })),
+             (qint64)6000 * 4000 * 4 * 2);
+    QCOMPARE(Task::estimateMemory(QSize(0, 1000), false, toolsOf({ BatchTool::ConvertTool })),
+             (qint64)6000 * 4000 * 4 * 2);
+}
+
+void QueueSchedulerTest::testMemoryBudget()
+{
+    QueueScheduler scheduler;
+    scheduler.setMemoryBudget(1000);
+    scheduler.setMaximumRunning(4);
+
+    const int a = scheduler.addItem(1, 400);
+    const int b = scheduler.addItem(1, 400);
+    const int c = scheduler.addItem(1, 400);
+    const int e = scheduler.addItem(2, 150);
+
+    // The third item of the queue waits for memory, a smaller item of another queue does not.
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << a << e << b);
+    QCOMPARE(scheduler.usedMemory(), (qint64)950);
+    QCOMPARE(scheduler.usedMemory(1), (qint64)800);
+    QCOMPARE(scheduler.runningCount(), 3);
+    QCOMPARE(scheduler.waitingCount(1), 1);
+    QVERIFY(scheduler.itemsToStart().isEmpty());
+
+    // The memory released by an item lets the next one start.
+
+    QCOMPARE(scheduler.itemDone(a), 1);
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << c);
+    QCOMPARE(scheduler.usedMemory(), (qint64)950);
+
+    // An item is released once only.
+
+    QCOMPARE(scheduler.itemDone(a), -1);
+    QCOMPARE(scheduler.itemDone(b), 1);
+    QCOMPARE(scheduler.itemDone(c), 1);
+    QCOMPARE(scheduler.itemDone(e), 2);
+    QCOMPARE(scheduler.usedMemory(), (qint64)0);
+    QCOMPARE(scheduler.runningCount(), 0);
+}
+
+void QueueSchedulerTest::testLargeItemAlone()
+{
+    QueueScheduler scheduler;
+    scheduler.setMemoryBudget(1000);
+    scheduler.setMaximumRunning(4);
+
+    const int a = scheduler.addItem(1, 100);
+    const int b = scheduler.addItem(1, 5000);
+    const int c = scheduler.addItem(1, 100);
+
+    // The item larger than the budget waits for the items running, then runs alone.
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << a);
+    QCOMPARE(scheduler.itemDone(a), 1);
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << b);
+    QVERIFY(scheduler.itemsToStart().isEmpty());
+    QCOMPARE(scheduler.itemDone(b), 1);
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << c);
+}
+
+void QueueSchedulerTest::testQueuesInTurn()
+{
+    QueueScheduler scheduler;
+    scheduler.setMemoryBudget(1000);
+    scheduler.setMaximumRunning(3);
+
+    QList<int> first;
+    QList<int> second;
+
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+        first  << scheduler.addItem(1, 10);
+        second << scheduler.addItem(2, 10);
+    }
+
+    // The queues take turns, and the turn goes on from the last queue which started an item.
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << first.at(0) << second.at(0) << first.at(1));
+
+    scheduler.itemDone(first.at(0));
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << second.at(1));
+
+    scheduler.itemDone(second.at(0));
+    scheduler.itemDone(second.at(1));
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << first.at(2) << second.at(2));
+}
+
+void QueueSchedulerTest::testSingleCoreQueue()
+{
+    QueueScheduler scheduler;
+    scheduler.setMemoryBudget(1000);
+    scheduler.setMaximumRunning(4);
+    scheduler.setQueueMultiCore(1, false);
+
+    const int a = scheduler.addItem(1, 10);
+    const int b = scheduler.addItem(1, 10);
+    const int c = scheduler.addItem(2, 10);
+    const int e = scheduler.addItem(2, 10);
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << a << c << e);
+    QCOMPARE(scheduler.runningCount(1), 1);
+
+    scheduler.itemDone(a);
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << b);
+}
+
+void QueueSchedulerTest::testMemoryNotEstimated()
+{
+    QueueScheduler scheduler;
+    scheduler.setMemoryBudget(1000);
+    scheduler.setMaximumRunning(4);
+
+    const int a = scheduler.addItem(1);
+    const int b = scheduler.addItem(1, 10);
+    const int c = scheduler.addItem(2, 10);
+
+    // An item without estimate holds its queue only.
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << c);
+    QCOMPARE(scheduler.waitingCount(1), 2);
+
+    scheduler.setItemMemory(a, 20);
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << a << b);
+    QCOMPARE(scheduler.usedMemory(), (qint64)40);
+
+    // The estimate of an item running does not change.
+
+    scheduler.setItemMemory(a, 500);
+    QCOMPARE(scheduler.itemDone(a), 1);
+    QCOMPARE(scheduler.usedMemory(), (qint64)20);
+}
+
+void QueueSchedulerTest::testClear()
+{
+    QueueScheduler scheduler;
+    scheduler.setMemoryBudget(1000);
+    scheduler.setMaximumRunning(1);
+
+    const int a = scheduler.addItem(1, 10);
+    const int b = scheduler.addItem(1, 10);
+    const int c = scheduler.addItem(2, 10);
+
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << a);
+    QCOMPARE(scheduler.waitingItems(), QList<int>() << b << c);
+
+    scheduler.clear();
+
+    QVERIFY(scheduler.waitingItems().isEmpty());
+    QCOMPARE(scheduler.runningCount(), 0);
+    QCOMPARE(scheduler.usedMemory(), (qint64)0);
+    QCOMPARE(scheduler.itemDone(a), -1);
+
+    // New items get new numbers.
+
+    const int e = scheduler.addItem(1, 10);
+
+    QVERIFY(e != a);
+    QCOMPARE(scheduler.itemsToStart(), QList<int>() << e);
+}
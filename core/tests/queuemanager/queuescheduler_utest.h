@@ -0,0 +1,42 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the scheduling of the queue items
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_QUEUE_SCHEDULER_UTEST_H
+#define DIGIKAM_QUEUE_SCHEDULER_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class QueueSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit QueueSchedulerTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testEstimateMemory();
+
+    void testMemoryBudget();
+    void testLargeItemAlone();
+    void testQueuesInTurn();
+    void testSingleCoreQueue();
+    void testMemoryNotEstimated();
+    void testClear();
+};
+
+#endif // DIGIKAM_QUEUE_SCHEDULER_UTEST_H
@@ -4,7 +4,7 @@
  * https://www.digikam.org
  *
  * Date        : 2016-04-21
- * Description : Video thumbnails extraction CLI test tool
+ * Description : Video thumbnails extraction CLI test tool and benchmark
  *
  * SPDX-FileCopyrightText: 2016-2022 by Gilles Caulier <caulier dot gilles at gmail dot com>
  *
@@ -15,6 +15,7 @@
 // Qt includes
 
 #include <QCoreApplication>
+#include <QElapsedTimer>
 
 // Local includes
 
@@ -30,32 +31,61 @@ int main(int argc, char** argv)
     {
         qCDebug(DIGIKAM_TESTS_LOG) << "videothumbtest - Load video files to extract thumbnails";
         qCDebug(DIGIKAM_TESTS_LOG) << "Usage: <videofiles>";
+        qCDebug(DIGIKAM_TESTS_LOG) << "The time to extract the thumbnails is reported with and without smart frame selection.";
         return -1;
     }
 
     QCoreApplication app(argc, argv);
 
+    qint64 totalTime      = 0;
+    qint64 totalSmartTime = 0;
+
     for (int i = 1 ; i < argc ; i++)
     {
         QString path = QString::fromLocal8Bit(argv[i]);
         VideoThumbnailer thumbnailer;
         VideoStripFilter videoStrip;
         QImage image;
+        QElapsedTimer timer;
 
         thumbnailer.addFilter(&videoStrip);
         thumbnailer.setThumbnailSize(256);
+
+        timer.start();
         thumbnailer.generateThumbnail(path, image);
+        qint64 elapsed = timer.elapsed();
+        totalTime     += elapsed;
 
         if (!image.isNull())
         {
-            qCDebug(DIGIKAM_TESTS_LOG) << "Extracted thumbnail from" << path << image.size();
+            qCDebug(DIGIKAM_TESTS_LOG) << "Extracted thumbnail from" << path << image.size()
+                                       << "in" << elapsed << "ms";
             image.save(QString::fromUtf8("./%1.png").arg(path), "PNG");
         }
         else
         {
            qCDebug(DIGIKAM_TESTS_LOG) << "Cannot extract thumbnail from" << path;
         }
+
+        QImage smartImage;
+        thumbnailer.setSmartFrameSelection(true);
+
+        timer.restart();
+        thumbnailer.generateThumbnail(path, smartImage);
+        elapsed         = timer.elapsed();
+        totalSmartTime += elapsed;
+
+        if (!smartImage.isNull())
+        {
+            qCDebug(DIGIKAM_TESTS_LOG) << "Extracted smart thumbnail from" << path << smartImage.size()
+                                       << "in" << elapsed << "ms";
+            smartImage.save(QString::fromUtf8("./%1-smart.png").arg(path), "PNG");
+        }
     }
 
+    qCDebug(DIGIKAM_TESTS_LOG) << "Thumbnails of" << (argc - 1) << "videos extracted in"
+                               << totalTime << "ms, with smart frame selection in"
+                               << totalSmartTime << "ms";
+
     return 0;
 }
@@ -0,0 +1,198 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the encoding of a video slideshow
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "vidslidetask_utest.h"
+
+// Qt includes
+
+#include <QColor>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTest>
+
+// Local includes
+
+#include "digikam_debug.h"
+#include "dpluginloader.h"
+#include "metaengine.h"
+#include "vidslidethread.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(VidSlideTaskTest)
+
+VidSlideTaskTest::VidSlideTaskTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void VidSlideTaskTest::initTestCase()
+{
+    MetaEngine::initializeExiv2();
+    QDir dir(qApp->applicationDirPath());
+    qputenv("DK_PLUGIN_PATH", dir.canonicalPath().toUtf8());
+    DPluginLoader::instance()->init();
+
+    QVERIFY(m_tempDir.isValid());
+
+    // Images of different colors, larger than the small video sizes.
+
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+        QImage img(800, 600, QImage::Format_RGB32);
+        img.fill(QColor::fromHsv(i * 60, 255, 255));
+
+        const QString path = m_tempDir.filePath(QString::fromLatin1("image%1.png").arg(i));
+        QVERIFY(img.save(path, "PNG"));
+
+        m_images << QUrl::fromLocalFile(path);
+    }
+}
+
+void VidSlideTaskTest::cleanupTestCase()
+{
+    DPluginLoader::instance()->cleanUp();
+}
+
+qint64 VidSlideTaskTest::encode(VidSlideSettings& settings)
+{
+    settings.inputImages  = m_images;
+    settings.transition   = TransitionMngr::HorizontalLines;
+    settings.vEffect      = EffectMngr::KenBurnsZoomIn;
+    settings.vCodec       = VidSlideSettings::MPEG4;
+    settings.vFormat      = VidSlideSettings::AVI;
+    settings.conflictRule = FileSaveConflictBox::OVERWRITE;
+    settings.outputDir    = QUrl::fromLocalFile(m_tempDir.path());
+
+    VidSlideThread encoder;
+
+    QSignalSpy spyDone(&encoder, SIGNAL(signalDone(bool)));
+    QSignalSpy spyProgress(&encoder, SIGNAL(signalProgress(int)));
+    QSignalSpy spyMessage(&encoder, SIGNAL(signalMessage(QString,bool)));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    encoder.processStream(&settings);
+    encoder.start();
+
+    if (!spyDone.wait(300000))
+    {
+        return -1;
+    }
+
+    const qint64 elapsed = timer.elapsed();
+
+    QTest::qWait(100);
+
+    if (!spyDone.first().first().toBool())
+    {
+        return -1;
+    }
+
+    // One message for each image, in the order of the images, after its frames are encoded.
+
+    QStringList messages;
+
+    for (int i = 0 ; i < spyMessage.count() ; ++i)
+    {
+        if (spyMessage.at(i).at(1).toBool())
+        {
+            qCWarning(DIGIKAM_TESTS_LOG) << "Error:" << spyMessage.at(i).at(0).toString();
+
+            return -1;
+        }
+
+        messages << spyMessage.at(i).at(0).toString();
+    }
+
+    if (messages.count() != m_images.count() + 1)
+    {
+        qCWarning(DIGIKAM_TESTS_LOG) << "Unexpected messages:" << messages;
+
+        return -1;
+    }
+
+    for (int i = 0 ; i < m_images.count() ; ++i)
+    {
+        if (!messages.at(i).contains(m_images.at(i).fileName()))
+        {
+            qCWarning(DIGIKAM_TESTS_LOG) << "Unexpected message" << i << ":" << messages.at(i);
+
+            return -1;
+        }
+    }
+
+    // The last message gives the video, written once all the images are reported.
+
+    if (!messages.last().contains(settings.outputVideo) || !QFileInfo(settings.outputVideo).size())
+    {
+        return -1;
+    }
+
+    // The progress grows up to the count of images.
+
+    int last = -1;
+
+    for (int i = 0 ; i < spyProgress.count() ; ++i)
+    {
+        const int progress = spyProgress.at(i).first().toInt();
+
+        if (progress <= last)
+        {
+            return -1;
+        }
+
+        last = progress;
+    }
+
+    if (last != m_images.count())
+    {
+        return -1;
+    }
+
+    return elapsed;
+}
+
+void VidSlideTaskTest::testEncodeInOrder()
+{
+    VidSlideSettings settings;
+    settings.vType     = VidSlideSettings::VGA;
+    settings.imgFrames = 50;
+
+    const qint64 elapsed = encode(settings);
+
+    QVERIFY(elapsed >= 0);
+
+    qCDebug(DIGIKAM_TESTS_LOG) << "VGA slideshow of" << m_images.count() << "images encoded in" << elapsed << "ms";
+}
+
+void VidSlideTaskTest::testEncodeLargeSize()
+{
+    // At 4K, the buffer of the frames rendered ahead only holds a few frames
+    // of each segment: the segments in flight must not wait for each other.
+
+    VidSlideSettings settings;
+    settings.vType     = VidSlideSettings::UHD4K;
+    settings.imgFrames = 25;
+
+    const qint64 elapsed = encode(settings);
+
+    QVERIFY(elapsed >= 0);
+
+    qCDebug(DIGIKAM_TESTS_LOG) << "4K slideshow of" << m_images.count() << "images encoded in" << elapsed << "ms";
+}
@@ -0,0 +1,59 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check the encoding of a video slideshow
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_VIDSLIDE_TASK_UTEST_H
+#define DIGIKAM_VIDSLIDE_TASK_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+#include <QList>
+#include <QUrl>
+#include <QTemporaryDir>
+
+// Local includes
+
+#include "vidslidesettings.h"
+
+class VidSlideTaskTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit VidSlideTaskTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testEncodeInOrder();
+    void testEncodeLargeSize();
+
+private:
+
+    /**
+     * Encodes the images with the settings, checks the messages and the progress,
+     * and returns the time taken in milliseconds.
+     */
+    qint64 encode(Digikam::VidSlideSettings& settings);
+
+private:
+
+    QTemporaryDir m_tempDir;
+    QList<QUrl>   m_images;
+};
+
+#endif // DIGIKAM_VIDSLIDE_TASK_UTEST_H
@@ -0,0 +1,209 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark the DImg tile renderer
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "dimgtilerenderer_utest.h"
+
+// Qt includes
+
+#include <QImage>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QTest>
+
+// Local includes
+
+#include "dcolor.h"
+#include "dimg.h"
+#include "dimgtilerenderer.h"
+
+using namespace Digikam;
+
+QTEST_MAIN(DImgTileRendererTest)
+
+namespace
+{
+
+DImg createImage(int width, int height, bool sixteenBit)
+{
+    DImg image(width, height, sixteenBit, false);
+
+    for (int y = 0 ; y < height ; ++y)
+    {
+        for (int x = 0 ; x < width ; ++x)
+        {
+            image.setPixelColor(x, y, sixteenBit ? DColor((x * 7) & 0xFFFF, (y * 11) & 0xFFFF, ((x + y) * 5) & 0xFFFF, 65535, true)
+                                                 : DColor(x & 0xFF, y & 0xFF, (x + y) & 0xFF, 255, false));
+        }
+    }
+
+    return image;
+}
+
+/**
+ * Paints the region of the image scaled to completeSize with the renderer.
+ */
+QImage render(DImgTileRenderer& renderer, const QRect& region, const QSize& completeSize, bool* const complete)
+{
+    QImage   target(region.size(), QImage::Format_RGB32);
+    target.fill(Qt::black);
+    QPainter painter(&target);
+
+    *complete = renderer.paint(&painter, QRectF(QPointF(0, 0), region.size()), region, completeSize);
+
+    return target;
+}
+
+} // namespace
+
+DImgTileRendererTest::DImgTileRendererTest(QObject* const parent)
+    : QObject(parent)
+{
+}
+
+void DImgTileRendererTest::testHalfSize()
+{
+    // 3x3 image: the last column and row are reused for the odd size.
+
+    DImg image(3, 3, false, false);
+    image.setPixelColor(0, 0, DColor(0,   0,   0,   255, false));
+    image.setPixelColor(1, 0, DColor(100, 100, 100, 255, false));
+    image.setPixelColor(0, 1, DColor(200, 200, 200, 255, false));
+    image.setPixelColor(1, 1, DColor(100, 100, 100, 255, false));
+
+    DImg reduced = DImgTileRenderer::halfSize(image);
+
+    QCOMPARE(reduced.size(), QSize(1, 1));
+    QCOMPARE(reduced.getPixelColor(0, 0).red(), 100);
+
+    DImg deep    = createImage(1001, 603, true);
+    reduced      = DImgTileRenderer::halfSize(deep);
+
+    QCOMPARE(reduced.size(), QSize(500, 301));
+    QVERIFY(reduced.sixteenBit());
+
+    const DColor c00 = deep.getPixelColor(20, 30);
+    const DColor c10 = deep.getPixelColor(21, 30);
+    const DColor c01 = deep.getPixelColor(20, 31);
+    const DColor c11 = deep.getPixelColor(21, 31);
+
+    QCOMPARE(reduced.getPixelColor(10, 15).green(),
+             (c00.green() + c10.green() + c01.green() + c11.green() + 2) / 4);
+}
+
+void DImgTileRendererTest::testDirectTiles()
+{
+    // Close to the image size, the tiles are rendered at once from the image itself.
+
+    DImgTileRenderer renderer;
+    const DImg       image = createImage(1000, 700, false);
+    renderer.setImage(image);
+
+    const QSize completeSize(800, 560);
+    const QRect region(100, 50, 600, 400);
+    bool        complete   = false;
+    QImage      rendered   = render(renderer, region, completeSize, &complete);
+
+    QVERIFY(complete);
+
+    const QImage expected  = image.smoothScaleClipped(completeSize, region).copyQImage().convertToFormat(QImage::Format_RGB32);
+
+    QCOMPARE(rendered, expected);
+
+    // The second time, all tiles come from the cache.
+
+    rendered = render(renderer, region, completeSize, &complete);
+    QVERIFY(complete);
+    QCOMPARE(rendered, expected);
+}
+
+void DImgTileRendererTest::testBackgroundTiles()
+{
+    DImgTileRenderer renderer;
+    const DImg       image = createImage(4000, 3000, false);
+    renderer.setImage(image);
+
+    QSignalSpy spy(&renderer, SIGNAL(tilesReady()));
+
+    const QSize completeSize(500, 375);
+    const QRect region(0, 0, 500, 375);
+    bool        complete = false;
+
+    render(renderer, region, completeSize, &complete);
+    QVERIFY(!complete);
+
+    // The tiles arrive in the background.
+
+    QTRY_VERIFY_WITH_TIMEOUT((render(renderer, region, completeSize, &complete), complete), 10000);
+    QVERIFY(spy.count() > 0);
+
+    // A box filtered pyramid is close to the image scaled at once.
+
+    const QImage rendered = render(renderer, region, completeSize, &complete);
+    const QImage expected = image.smoothScale(completeSize).copyQImage();
+    qint64 diff           = 0;
+
+    for (int y = 0 ; y < completeSize.height() ; ++y)
+    {
+        for (int x = 0 ; x < completeSize.width() ; ++x)
+        {
+            diff += qAbs(qGray(rendered.pixel(x, y)) - qGray(expected.pixel(x, y)));
+        }
+    }
+
+    QVERIFY((diff / (completeSize.width() * completeSize.height())) < 8);
+
+    // Clearing drops all tiles.
+
+    renderer.clear();
+    render(renderer, region, completeSize, &complete);
+    QVERIFY(!complete);
+}
+
+void DImgTileRendererTest::testConverter()
+{
+    DImgTileRenderer renderer;
+    renderer.setImage(createImage(600, 400, false));
+
+    QVERIFY(!renderer.hasTileConverter());
+
+    renderer.setTileConverter([](const DImg& img)
+        {
+            QImage image(img.size(), QImage::Format_RGB32);
+            image.fill(Qt::red);
+
+            return image;
+        }
+    );
+
+    QVERIFY(renderer.hasTileConverter());
+
+    bool         complete = false;
+    const QImage rendered = render(renderer, QRect(0, 0, 600, 400), QSize(600, 400), &complete);
+
+    QVERIFY(complete);
+    QCOMPARE(rendered.pixel(300, 200), QColor(Qt::red).rgb());
+
+    renderer.clear();
+    QVERIFY(!renderer.hasTileConverter());
+}
+
+void DImgTileRendererTest::benchmarkHalfSize()
+{
+    const DImg image = createImage(6000, 4000, true);
+
+    QBENCHMARK
+    {
+        DImgTileRenderer::halfSize(image);
+    }
+}
@@ -0,0 +1,40 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : an unit-test to check and benchmark the DImg tile renderer
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_DIMG_TILE_RENDERER_UTEST_H
+#define DIGIKAM_DIMG_TILE_RENDERER_UTEST_H
+
+// Qt includes
+
+#include <QObject>
+
+class DImgTileRendererTest : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    DImgTileRendererTest(QObject* const parent = nullptr);
+
+private Q_SLOTS:
+
+    void testHalfSize();
+    void testDirectTiles();
+    void testBackgroundTiles();
+    void testConverter();
+
+    void benchmarkHalfSize();
+};
+
+#endif // DIGIKAM_DIMG_TILE_RENDERER_UTEST_H
@@ -21,6 +21,7 @@
 #include <QApplication>
 #include <QHeaderView>
 #include <QPainter>
+#include <QScrollBar>
 
 // KDE includes
 
@@ -29,6 +30,8 @@
 // Local includes
 
 #include "findduplicatesalbumitem.h"
+#include "similaritydb.h"
+#include "similaritydbaccess.h"
 #include "deletedialog.h"
 #include "dio.h"
 
@@ -42,12 +45,21 @@ public:
 
     explicit Private()
         : iconSize       (64),
+          pageSize       (200),
+          groupsCount    (0),
+          listedGroups   (0),
           thumbLoadThread(nullptr)
     {
     }
 
     const int            iconSize;
 
+    /// The number of groups listed at once.
+    const int            pageSize;
+
+    int                  groupsCount;
+    int                  listedGroups;
+
     ThumbnailLoadThread* thumbLoadThread;
 };
 
@@ -79,6 +91,9 @@ FindDuplicatesAlbum::FindDuplicatesAlbum(QWidget* const parent)
 
     connect(d->thumbLoadThread, SIGNAL(signalThumbnailLoaded(LoadingDescription,QPixmap)),
             this, SLOT(slotThumbnailLoaded(LoadingDescription,QPixmap)));
+
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(slotScrolled(int)));
 }
 
 FindDuplicatesAlbum::~FindDuplicatesAlbum()
@@ -144,17 +159,60 @@ void FindDuplicatesAlbum::slotThumbnailLoaded(const LoadingDescription& desc,
     }
 }
 
-void FindDuplicatesAlbum::updateDuplicatesAlbumItems(const QList<SAlbum*>& sAlbumsToRebuild,
-                                                     const QList<qlonglong>& deletedImages)
+void FindDuplicatesAlbum::populateGroups()
+{
+    clear();
+
+    d->groupsCount  = SimilarityDbAccess().db()->getDuplicatesGroupsCount();
+    d->listedGroups = 0;
+
+    fetchMoreGroups();
+}
+
+void FindDuplicatesAlbum::fetchMoreGroups()
+{
+    if (d->listedGroups >= d->groupsCount)
+    {
+        return;
+    }
+
+    const QList<DuplicatesGroup> groups = SimilarityDbAccess().db()->getDuplicatesGroups(d->listedGroups,
+                                                                                         d->pageSize);
+
+    Q_FOREACH (const DuplicatesGroup& group, groups)
+    {
+        new FindDuplicatesAlbumItem(this, group);
+    }
+
+    // The groups can be removed while they are listed.
+
+    d->listedGroups = groups.isEmpty() ? d->groupsCount : (d->listedGroups + d->pageSize);
+}
+
+void FindDuplicatesAlbum::slotScrolled(int value)
+{
+    if (value == verticalScrollBar()->maximum())
+    {
+        fetchMoreGroups();
+    }
+}
+
+void FindDuplicatesAlbum::updateDuplicatesGroups(const QHash<qlonglong, qlonglong>& modifiedGroups)
 {
-    Q_FOREACH (QTreeWidgetItem* const selectedItem, selectedItems())
+    QTreeWidgetItemIterator it(this);
+
+    while (*it)
     {
-        FindDuplicatesAlbumItem* const item = dynamic_cast<FindDuplicatesAlbumItem*>(selectedItem);
+        FindDuplicatesAlbumItem* const item = dynamic_cast<FindDuplicatesAlbumItem*>(*it);
 
-        if (item && sAlbumsToRebuild.contains(item->album()))
+        if (item && modifiedGroups.contains(item->reference()))
         {
-            item->calculateInfos(deletedImages);
+            // A removed group is read as a null group, which hides the item.
+
+            item->setGroup(SimilarityDbAccess().db()->getDuplicatesGroup(modifiedGroups.value(item->reference())));
         }
+
+        ++it;
     }
 }
 
@@ -174,20 +232,21 @@ void FindDuplicatesAlbum::drawRow(QPainter* p,
 
 void FindDuplicatesAlbum::removeDuplicates()
 {
-    QTreeWidgetItemIterator it(this);
+    // All groups are read from the database, not only the listed ones.
+
+    const QList<DuplicatesGroup> groups = SimilarityDbAccess().db()->getDuplicatesGroups(0, -1);
 
     QList<ItemInfo> duplicatedItems;
 
-    while (*it)
+    Q_FOREACH (const DuplicatesGroup& group, groups)
     {
-        FindDuplicatesAlbumItem* const item = dynamic_cast<FindDuplicatesAlbumItem*>(*it);
-
-        if (item)
+        Q_FOREACH (const qlonglong& imageId, group.items)
         {
-            duplicatedItems += item->duplicatedItems();
+            if (imageId != group.reference)
+            {
+                duplicatedItems << ItemInfo(imageId);
+            }
         }
-
-        ++it;
     }
 
     QList<QUrl> urlList;
@@ -19,6 +19,7 @@
 
 // Qt includes
 
+#include <QHash>
 #include <QList>
 #include <QWidget>
 #include <QPixmap>
@@ -26,7 +27,6 @@
 
 // Local includes
 
-#include "album.h"
 #include "thumbnailloadthread.h"
 
 namespace Digikam
@@ -46,8 +46,17 @@ public:
     explicit FindDuplicatesAlbum(QWidget* const parent = nullptr);
     ~FindDuplicatesAlbum()                        override;
 
-    void updateDuplicatesAlbumItems(const QList<SAlbum*>& sAlbumsToRebuild,
-                                    const QList<qlonglong>& deletedImages);
+    /**
+     * Lists the first page of the groups of the last duplicates search.
+     * The next pages are listed when the view is scrolled to the end.
+     */
+    void populateGroups();
+
+    /**
+     * Reads the groups from the database again, after images were deleted.
+     * The old references of the modified groups are mapped to the new ones.
+     */
+    void updateDuplicatesGroups(const QHash<qlonglong, qlonglong>& modifiedGroups);
 
     void selectFirstItem();
     QTreeWidgetItem* firstItem();
@@ -59,9 +68,12 @@ private:
                  const QStyleOptionViewItem& opt,
                  const QModelIndex& index) const override;
 
+    void fetchMoreGroups();
+
 private Q_SLOTS:
 
     void slotThumbnailLoaded(const LoadingDescription&, const QPixmap&);
+    void slotScrolled(int value);
 
 private:
 
@@ -25,10 +25,6 @@
 #include "digikam_debug.h"
 #include "album.h"
 #include "albummanager.h"
-#include "coredbsearchxml.h"
-#include "deletedialog.h"
-#include "itemviewutilities.h"
-#include "dio.h"
 
 namespace Digikam
 {
@@ -39,49 +35,27 @@ class Q_DECL_HIDDEN FindDuplicatesAlbumItem::Private
 public:
 
     explicit Private()
-      : hasThumb  (false),
-        album     (nullptr),
-        itemCount (0)
+      : hasThumb  (false)
     {
         collator.setNumericMode(true);
         collator.setIgnorePunctuation(false);
         collator.setCaseSensitivity(Qt::CaseSensitive);
     }
 
-    bool      hasThumb;
+    bool            hasThumb;
 
-    SAlbum*   album;
-    int       itemCount;
+    DuplicatesGroup group;
 
-    QCollator collator;
+    QCollator       collator;
 
-    ItemInfo  refImgInfo;
+    ItemInfo        refImgInfo;
 };
 
-FindDuplicatesAlbumItem::FindDuplicatesAlbumItem(QTreeWidget* const parent, SAlbum* const album)
+FindDuplicatesAlbumItem::FindDuplicatesAlbumItem(QTreeWidget* const parent, const DuplicatesGroup& group)
     : QTreeWidgetItem(parent),
       d              (new Private)
 {
-    d->album = album;
-
-    if (d->album)
-    {
-        qlonglong refImage = d->album->title().toLongLong();
-        d->refImgInfo      = ItemInfo(refImage);
-        setText(Column::REFERENCE_IMAGE, d->refImgInfo.name());
-        setText(Column::REFERENCE_DATE,  d->refImgInfo.dateTime().toString(Qt::ISODate));
-
-        PAlbum* const physicalAlbum = AlbumManager::instance()->findPAlbum(d->refImgInfo.albumId());
-        if (physicalAlbum)
-        {
-            setText(Column::REFERENCE_ALBUM, physicalAlbum->prettyUrl());
-        }
-
-        calculateInfos();
-    }
-
-    setThumb(QIcon::fromTheme(QLatin1String("view-preview")).pixmap(parent->iconSize().width(),
-                                                                    QIcon::Disabled), false);
+    setGroup(group);
 }
 
 FindDuplicatesAlbumItem::~FindDuplicatesAlbumItem()
@@ -96,93 +70,67 @@ bool FindDuplicatesAlbumItem::hasValidThumbnail() const
 
 QList<ItemInfo> FindDuplicatesAlbumItem::duplicatedItems()
 {
+    QList<ItemInfo> toRemove;
+
     if (itemCount() <= 1)
     {
-        return QList<ItemInfo>();
+        return toRemove;
     }
 
-    SearchXmlReader reader(d->album->query());
-    reader.readToFirstField();
-
-    QList<ItemInfo> toRemove;
-
-    const QList<qlonglong>& list = reader.valueToLongLongList();
-    const qlonglong refImage     = d->album->title().toLongLong();
-
-    Q_FOREACH (const qlonglong& imageId, list)
+    Q_FOREACH (const qlonglong& imageId, d->group.items)
     {
-        if (imageId == refImage)
+        if (imageId != d->group.reference)
         {
-            continue;
+            toRemove.append(ItemInfo(imageId));
         }
-
-        toRemove.append(ItemInfo(imageId));
     }
 
     return toRemove;
 }
 
-void FindDuplicatesAlbumItem::calculateInfos(const QList<qlonglong>& deletedImages)
+void FindDuplicatesAlbumItem::setGroup(const DuplicatesGroup& group)
 {
-    if (!d->album)
-    {
-        return;
-    }
-
-    qlonglong refImage = d->album->title().toLongLong();
-/*
-    qCDebug(DIGIKAM_GENERAL_LOG) << "Calculating info for album" << refImage;
-*/
-    SearchXmlReader reader(d->album->query());
-    reader.readToFirstField();
-
-    // Get the defined image ids.
-
-    const QList<qlonglong>& list = reader.valueToLongLongList();
+    // The deleted images were already removed from the group in the database.
+    // A null group has no items left, and keeps the reference image shown.
 
-    // Only images that are not removed/obsolete should be shown.
+    const bool newReference = !group.isNull() && (group.reference != d->group.reference);
 
-    QList<qlonglong> filteredList;
-    double avgSim = 0.0;
-
-    Q_FOREACH (const qlonglong& imageId, list)
+    if (group.isNull())
     {
-        ItemInfo info(imageId);
-
-        // If image is not deleted in this moment and was also not
-        // removed before.
-
-        if (!deletedImages.contains(imageId) && !info.isRemoved())
-        {
-            filteredList << imageId;
-
-            if (imageId != refImage)
-            {
-                avgSim += info.similarityTo(refImage);
-            }
-        }
+        d->group.items.clear();
     }
-
-    d->itemCount = filteredList.count();
-/*
-    qCDebug(DIGIKAM_GENERAL_LOG) << "New Item count:" << d->itemCount;
-*/
-    if (d->itemCount > 1)
+    else
     {
-        avgSim /= d->itemCount - (filteredList.contains(refImage) ? 1 : 0);
+        d->group = group;
     }
-    else
+
+    if (newReference)
     {
-        this->setHidden(true);
+        setReference();
     }
 
-    setText(Column::RESULT_COUNT,   QString::number(d->itemCount));
-    setText(Column::AVG_SIMILARITY, QString::number(avgSim, 'f', 2));
+    setHidden(itemCount() <= 1);
+
+    setText(Column::RESULT_COUNT,   QString::number(itemCount()));
+    setText(Column::AVG_SIMILARITY, QString::number(d->group.similarity, 'f', 2));
+}
+
+void FindDuplicatesAlbumItem::setReference()
+{
+    d->refImgInfo = ItemInfo(d->group.reference);
+    setText(Column::REFERENCE_IMAGE, d->refImgInfo.name());
+    setText(Column::REFERENCE_DATE,  d->refImgInfo.dateTime().toString(Qt::ISODate));
+
+    PAlbum* const physicalAlbum = AlbumManager::instance()->findPAlbum(d->refImgInfo.albumId());
+    setText(Column::REFERENCE_ALBUM, physicalAlbum ? physicalAlbum->prettyUrl() : QString());
+
+    setThumb(QIcon::fromTheme(QLatin1String("view-preview")).pixmap(treeWidget()->iconSize().width(),
+                                                                    QIcon::Disabled), false);
 }
 
 int FindDuplicatesAlbumItem::itemCount() const
 {
-    return d->itemCount;
+    return d->group.items.count();
 }
 
 void FindDuplicatesAlbumItem::setThumb(const QPixmap& pix, bool hasThumb)
@@ -210,9 +158,14 @@ void FindDuplicatesAlbumItem::setThumb(const QPixmap& pix, bool hasThumb)
     d->hasThumb = hasThumb;
 }
 
-SAlbum* FindDuplicatesAlbumItem::album() const
+DuplicatesGroup FindDuplicatesAlbumItem::group() const
+{
+    return d->group;
+}
+
+qlonglong FindDuplicatesAlbumItem::reference() const
 {
-    return d->album;
+    return d->group.reference;
 }
 
 QUrl FindDuplicatesAlbumItem::refUrl() const
@@ -23,8 +23,8 @@
 
 // Local includes
 
-#include "album.h"
 #include "iteminfo.h"
+#include "similaritydb.h"
 #include "thumbnailloadthread.h"
 
 namespace Digikam
@@ -46,23 +46,25 @@ public:
 
 public:
 
-    explicit FindDuplicatesAlbumItem(QTreeWidget* const parent, SAlbum* const album);
+    explicit FindDuplicatesAlbumItem(QTreeWidget* const parent, const DuplicatesGroup& group);
     ~FindDuplicatesAlbumItem()                        override;
 
     bool hasValidThumbnail()                     const;
 
     /**
-     * Calculates the duplicates count and average similarity.
+     * Sets the items of the group, after images were deleted.
+     * The item is hidden if the group has no duplicates anymore.
      **/
-    void calculateInfos(const QList<qlonglong>& deletedImages = QList<qlonglong>());
+    void setGroup(const DuplicatesGroup& group);
 
     /**
      * Returns the item count.
      **/
     int itemCount()                              const;
 
-    SAlbum* album()                              const;
-    QUrl    refUrl()                             const;
+    DuplicatesGroup group()                      const;
+    qlonglong       reference()                  const;
+    QUrl            refUrl()                     const;
 
     void setThumb(const QPixmap& pix,
                   bool hasThumb = true);
@@ -70,6 +72,14 @@ public:
     bool operator<(const QTreeWidgetItem& other) const override;
     QList<ItemInfo> duplicatedItems();
 
+private:
+
+    /**
+     * Shows the reference image of the group, which changes
+     * when the previous reference image is deleted.
+     **/
+    void setReference();
+
 private:
 
     class Private;
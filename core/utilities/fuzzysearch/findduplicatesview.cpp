@@ -27,8 +27,8 @@
 #include <QApplication>
 #include <QStyle>
 #include <QTimer>
-#include <QElapsedTimer>
 #include <QGroupBox>
+#include <QCheckBox>
 
 // KDE includes
 
@@ -39,6 +39,7 @@
 #include "digikam_debug.h"
 #include "album.h"
 #include "albummanager.h"
+#include "albumpointer.h"
 #include "albumselectors.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
@@ -46,6 +47,7 @@
 #include "albumtreeview.h"
 #include "findduplicatesalbum.h"
 #include "findduplicatesalbumitem.h"
+#include "coredbsearchxml.h"
 #include "duplicatesfinder.h"
 #include "fingerprintsgenerator.h"
 #include "applicationsettings.h"
@@ -70,6 +72,7 @@ public:
         searchResultRestriction(nullptr),
         albumTagRelation       (nullptr),
         refImageSelMethod      (nullptr),
+        nearDuplicatesSearch   (nullptr),
         findDuplicatesBtn      (nullptr),
         updateFingerPrtBtn     (nullptr),
         removeDuplicatesBtn    (nullptr),
@@ -92,6 +95,8 @@ public:
     SqueezedComboBox*    albumTagRelation;
     SqueezedComboBox*    refImageSelMethod;
 
+    QCheckBox*           nearDuplicatesSearch;
+
     QPushButton*         findDuplicatesBtn;
     QPushButton*         updateFingerPrtBtn;
     QPushButton*         removeDuplicatesBtn;
@@ -105,6 +110,9 @@ public:
 
     ApplicationSettings* settings;
 
+    /// The temporary duplicates search album showing the items of the selected groups.
+    AlbumPointer<SAlbum> searchAlbum;
+
     bool                 active;
 };
 
@@ -177,6 +185,13 @@ FindDuplicatesView::FindDuplicatesView(QWidget* const parent)
 
     d->searchResultRestriction->setCurrentIndex(d->searchResultRestriction->findData(restrictions));
 
+    d->nearDuplicatesSearch    = new QCheckBox(i18nc("@option:check", "Fast search of near duplicates"));
+    d->nearDuplicatesSearch->setToolTip(i18nc("@info", "Use this option to only compare the images which look "
+                                                       "almost the same, as the re-encoded or resized copies. "
+                                                       "The search is much faster, but the edited copies "
+                                                       "are not found."));
+    d->nearDuplicatesSearch->setChecked(d->settings ? d->settings->getDuplicatesNearDuplicatesSearch() : false);
+
     d->albumTagRelationLabel = new QLabel(i18nc("@label", "Restrict to:"));
     d->albumTagRelationLabel->setBuddy(d->albumTagRelation);
 
@@ -274,9 +289,10 @@ FindDuplicatesView::FindDuplicatesView(QWidget* const parent)
     mainLayout->addWidget(d->similarityRange,         4, 2, 1,  1);
     mainLayout->addWidget(d->restrictResultsLabel,    5, 0, 1,  2);
     mainLayout->addWidget(d->searchResultRestriction, 5, 2, 1, -1);
-    mainLayout->addWidget(d->updateFingerPrtBtn,      6, 0, 1, -1);
-    mainLayout->addWidget(d->findDuplicatesBtn,       7, 0, 1, -1);
-    mainLayout->addWidget(d->removeDuplicatesBtn,     8, 0, 1, -1);
+    mainLayout->addWidget(d->nearDuplicatesSearch,    6, 0, 1, -1);
+    mainLayout->addWidget(d->updateFingerPrtBtn,      7, 0, 1, -1);
+    mainLayout->addWidget(d->findDuplicatesBtn,       8, 0, 1, -1);
+    mainLayout->addWidget(d->removeDuplicatesBtn,     9, 0, 1, -1);
 
     mainLayout->setRowStretch(0, 10);
     mainLayout->setColumnStretch(2, 10);
@@ -321,20 +337,11 @@ FindDuplicatesView::~FindDuplicatesView()
 
 void FindDuplicatesView::initAlbumUpdateConnections()
 {
-    connect(AlbumManager::instance(), SIGNAL(signalAlbumAdded(Album*)),
-            this, SLOT(slotAlbumAdded(Album*)));
-
-    connect(AlbumManager::instance(), SIGNAL(signalAlbumDeleted(Album*)),
-            this, SLOT(slotAlbumDeleted(Album*)));
-
-    connect(AlbumManager::instance(), SIGNAL(signalSearchUpdated(SAlbum*)),
-            this, SLOT(slotSearchUpdated(SAlbum*)));
-
     connect(AlbumManager::instance(), SIGNAL(signalAlbumsCleared()),
             this, SLOT(slotClear()));
 
-    connect(AlbumManager::instance(), SIGNAL(signalUpdateDuplicatesAlbums(QList<SAlbum*>,QList<qlonglong>)),
-            this, SLOT(slotUpdateDuplicates(QList<SAlbum*>,QList<qlonglong>)));
+    connect(AlbumManager::instance(), SIGNAL(signalUpdateDuplicatesGroups(QHash<qlonglong,qlonglong>,QList<qlonglong>)),
+            this, SLOT(slotUpdateDuplicates(QHash<qlonglong,qlonglong>,QList<qlonglong>)));
 }
 
 void FindDuplicatesView::setActive(bool val)
@@ -352,46 +359,35 @@ void FindDuplicatesView::populateTreeView()
         return;
     }
 
-    QElapsedTimer waitCursorTimer;
-    waitCursorTimer.start();
-
-    bool waitCursor = false;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
 
-    const AlbumList& aList = AlbumManager::instance()->allSAlbums();
-
-    for (AlbumList::const_iterator it = aList.constBegin() ; it != aList.constEnd() ; ++it)
-    {
-        SAlbum* const salbum = dynamic_cast<SAlbum*>(*it);
-
-        if (salbum && salbum->isDuplicatesSearch() && !salbum->extraData(this))
-        {
-            // Adding item to listView by creating an item and passing listView as parent
-
-            FindDuplicatesAlbumItem* const item = new FindDuplicatesAlbumItem(d->listView, salbum);
-            salbum->setExtraData(this, item);
-        }
-
-        if (!waitCursor && (waitCursorTimer.elapsed() > 2000))
-        {
-            QApplication::setOverrideCursor(Qt::WaitCursor);
-            waitCursor = true;
-        }
-    }
+    // The groups are listed by decreasing similarity, page by page.
 
+    d->listView->setSortingEnabled(false);
+    d->listView->populateGroups();
     d->listView->setSortingEnabled(true);
     d->listView->resizeColumnToContents(0);
-    d->listView->sortByColumn(1, Qt::DescendingOrder);
+    d->listView->sortByColumn(FindDuplicatesAlbumItem::AVG_SIMILARITY, Qt::DescendingOrder);
 
     d->albumSelectors->loadState();
     d->refImageAlbumSelector->loadState();
 
-    if (waitCursor)
+    QApplication::restoreOverrideCursor();
+}
+
+QList<SAlbum*> FindDuplicatesView::currentFindDuplicatesAlbums() const
+{
+    QList<SAlbum*> albumList;
+
+    if (d->searchAlbum)
     {
-        QApplication::restoreOverrideCursor();
+        albumList << d->searchAlbum;
     }
+
+    return albumList;
 }
 
-QList<SAlbum*> FindDuplicatesView::currentFindDuplicatesAlbums() const
+SAlbum* FindDuplicatesView::updateDuplicatesSearchAlbum()
 {
     QList<QTreeWidgetItem*> selectedItems = d->listView->selectedItems();
 
@@ -405,79 +401,45 @@ QList<SAlbum*> FindDuplicatesView::currentFindDuplicatesAlbums() const
         }
     }
 
-    QList<SAlbum*> albumList;
+    QList<qlonglong> imageIds;
+    double           similarity = 0.0;
+    int              groups     = 0;
 
     Q_FOREACH (QTreeWidgetItem* const item, selectedItems)
     {
-        FindDuplicatesAlbumItem* const albumItem = dynamic_cast<FindDuplicatesAlbumItem*>(item);
+        FindDuplicatesAlbumItem* const groupItem = dynamic_cast<FindDuplicatesAlbumItem*>(item);
 
-        if (albumItem)
+        if (groupItem && !groupItem->isHidden())
         {
-            albumList << albumItem->album();
+            imageIds   << groupItem->group().items;
+            similarity += groupItem->group().similarity;
+            ++groups;
         }
     }
 
-    return albumList;
-}
-
-void FindDuplicatesView::slotAlbumAdded(Album* a)
-{
-    if (!a || (a->type() != Album::SEARCH))
-    {
-        return;
-    }
-
-    SAlbum* const salbum = static_cast<SAlbum*>(a);
-
-    if (!salbum->isDuplicatesSearch())
-    {
-        return;
-    }
-
-    if (!d->active)
+    if (imageIds.isEmpty())
     {
-        qCDebug(DIGIKAM_GENERAL_LOG) << "Duplicates view is not active, returning";
-        return;
+        return nullptr;
     }
 
-    if (!salbum->extraData(this))
-    {
-        FindDuplicatesAlbumItem* const item = new FindDuplicatesAlbumItem(d->listView, salbum);
-        salbum->setExtraData(this, item);
-    }
+    SearchXmlWriter writer;
+    writer.writeGroup();
+    writer.writeField(QLatin1String("imageid"), SearchXml::OneOf);
+    writer.writeValue(imageIds);
+    writer.finishField();
 
-    updateSimilarityRangeInterval();
-}
+    // Add the average similarity as field
 
-void FindDuplicatesView::slotAlbumDeleted(Album* a)
-{
-    if (!a || (a->type() != Album::SEARCH))
-    {
-        return;
-    }
-
-    SAlbum* const album = static_cast<SAlbum*>(a);
+    writer.writeField(QLatin1String("noeffect_avgsim"), SearchXml::Equal);
+    writer.writeValue(similarity / groups * 100);
+    writer.finishField();
+    writer.finishGroup();
+    writer.finish();
 
-    FindDuplicatesAlbumItem* const item = static_cast<FindDuplicatesAlbumItem*>(album->extraData(this));
+    d->searchAlbum = AlbumManager::instance()->createSAlbum(SAlbum::getTemporaryTitle(DatabaseSearch::DuplicatesSearch),
+                                                            DatabaseSearch::DuplicatesSearch, writer.xml());
 
-    if (item)
-    {
-        a->removeExtraData(this);
-        delete item;
-    }
-
-    updateSimilarityRangeInterval();
-}
-
-void FindDuplicatesView::slotSearchUpdated(SAlbum* a)
-{
-    if (!a->isDuplicatesSearch())
-    {
-        return;
-    }
-
-    slotAlbumDeleted(a);
-    slotAlbumAdded(a);
+    return d->searchAlbum;
 }
 
 void FindDuplicatesView::slotSelectItemsTimer()
@@ -492,16 +454,6 @@ void FindDuplicatesView::slotSelectItemsTimer()
 
 void FindDuplicatesView::slotClear()
 {
-    for (QTreeWidgetItemIterator it(d->listView) ; *it ; ++it)
-    {
-        SAlbum* const salbum = static_cast<FindDuplicatesAlbumItem*>(*it)->album();
-
-        if (salbum)
-        {
-            salbum->removeExtraData(this);
-        }
-    }
-
     d->listView->clear();
 }
 
@@ -515,6 +467,7 @@ void FindDuplicatesView::enableControlWidgets(bool val)
     d->similarityRange->setEnabled(val);
     d->albumSelectors->setEnabled(val);
     d->refImageSelMethod->setEnabled(val);
+    d->nearDuplicatesSearch->setEnabled(val);
 
     d->albumTagRelationLabel->setEnabled(val);
     d->restrictResultsLabel->setEnabled(val);
@@ -564,6 +517,7 @@ void FindDuplicatesView::slotFindDuplicates()
                                                           d->similarityRange->minValue(), d->similarityRange->maxValue(),
                                                           d->searchResultRestriction->itemData(d->searchResultRestriction->currentIndex()).toInt(),
                                                           referenceImageSelectionMethod, referenceImageSelector);
+    finder->setNearDuplicatesSearch(d->nearDuplicatesSearch->isChecked());
 
     connect(finder, SIGNAL(signalComplete()),
             this, SLOT(slotComplete()));
@@ -583,10 +537,10 @@ void FindDuplicatesView::slotFindDuplicates()
     finder->start();
 }
 
-void FindDuplicatesView::slotUpdateDuplicates(const QList<SAlbum*>& sAlbumsToRebuild,
-                                              const QList<qlonglong>& deletedImages)
+void FindDuplicatesView::slotUpdateDuplicates(const QHash<qlonglong, qlonglong>& modifiedGroups,
+                                              const QList<qlonglong>& /*deletedImages*/)
 {
-    d->listView->updateDuplicatesAlbumItems(sAlbumsToRebuild, deletedImages);
+    d->listView->updateDuplicatesGroups(modifiedGroups);
 }
 
 void FindDuplicatesView::slotApplicationSettingsChanged()
@@ -612,26 +566,16 @@ void FindDuplicatesView::slotComplete()
 
 void FindDuplicatesView::slotDuplicatesAlbumActived()
 {
-    if (!d->active)
+    if (!d->active || d->listView->selectedItems().isEmpty())
     {
         return;
     }
 
-    QList<Album*> albums;
+    SAlbum* const album = updateDuplicatesSearchAlbum();
 
-    Q_FOREACH (QTreeWidgetItem* const item, d->listView->selectedItems())
+    if (album)
     {
-        FindDuplicatesAlbumItem* const albumItem = dynamic_cast<FindDuplicatesAlbumItem*>(item);
-
-        if (albumItem)
-        {
-            albums << albumItem->album();
-        }
-    }
-
-    if (!albums.isEmpty())
-    {
-        AlbumManager::instance()->setCurrentAlbums(QList<Album*>() << albums);
+        AlbumManager::instance()->setCurrentAlbums(QList<Album*>() << album);
     }
 }
 
@@ -644,6 +588,11 @@ void FindDuplicatesView::slotCheckForValidSettings()
 void FindDuplicatesView::slotUpdateFingerPrints()
 {
     FingerPrintsGenerator* const tool = new FingerPrintsGenerator(false);
+
+    // The fast search of near duplicates compares the images without perceptual hash
+    // with all the others: it is worth computing the missing hashes here.
+
+    tool->setScanPerceptualHashes(d->nearDuplicatesSearch->isChecked());
     tool->start();
 }
 
@@ -22,6 +22,7 @@
 
 #include <QWidget>
 #include <QList>
+#include <QHash>
 
 // Local includes
 
@@ -54,19 +55,10 @@ public Q_SLOTS:
 private Q_SLOTS:
 
     void initAlbumUpdateConnections();
-    void slotAlbumAdded(Album* a);
-    void slotAlbumDeleted(Album* a);
-    void slotSearchUpdated(SAlbum* a);
     void slotSelectItemsTimer();
-    /*!
-     * \brief slotClear
-     * Remove extradata from every album stored in the listview
-     * This extra data is used to indicate that the album was already
-     * processed
-     */
     void slotClear();
     void slotFindDuplicates();
-    void slotUpdateDuplicates(const QList<SAlbum*>& sAlbumsToRebuild,
+    void slotUpdateDuplicates(const QHash<qlonglong, qlonglong>& modifiedGroups,
                               const QList<qlonglong>& deletedImages);
     void slotDuplicatesAlbumActived();
     void slotComplete();
@@ -83,6 +75,12 @@ private:
 
     void resetAlbumsAndTags();
 
+    /**
+     * Writes the items of the selected groups, or of the first group,
+     * to the temporary duplicates search album, which is shown in the icon view.
+     */
+    SAlbum* updateDuplicatesSearchAlbum();
+
 private:
 
     class Private;
@@ -15,262 +15,296 @@
 
 #include "track_correlator_thread.h"
 
+// C++ includes
+
+#include <algorithm>
+
 // Qt includes
 
+#include <QPair>
 #include <QTimeZone>
+#include <QVector>
 
 // Local includes
 
+#include "threadmanager.h"
 #include "track_correlator.h"
 
 namespace Digikam
 {
 
-bool TrackCorrelationLessThan(const TrackCorrelator::Correlation& a, const TrackCorrelator::Correlation& b)
+namespace
 {
-    return (a.dateTime < b.dateTime);
-}
 
-TrackCorrelatorThread::TrackCorrelatorThread(QObject* const parent)
-    : QThread (parent),
-      doCancel(false),
-      canceled(false)
+/**
+ * A point of the loaded track files, in the index of the points sorted by time.
+ */
+class Q_DECL_HIDDEN TrackPointRef
+{
+public:
+
+    qint64 time;        ///< Milliseconds since epoch.
+    int    file;
+    int    index;
+};
+
+bool TrackPointRefEarlierThan(const TrackPointRef& a, const TrackPointRef& b)
 {
+    return (a.time < b.time);
 }
 
-TrackCorrelatorThread::~TrackCorrelatorThread()
+bool TrackPointRefTimeLessThan(const TrackPointRef& a, qint64 time)
 {
+    return (a.time < time);
 }
 
-void TrackCorrelatorThread::run()
+/// The number of items correlated by a task of the thread pool, and sent together.
+const int CORRELATION_CHUNK_SIZE = 100;
+
+TrackCorrelator::Correlation correlateItem(const TrackCorrelator::Correlation& item,
+                                           const TrackCorrelator::CorrelationOptions& options,
+                                           const TrackManager::Track::List& fileList,
+                                           const QVector<TrackPointRef>& timeIndex)
 {
-    // sort the items to correlate by time:
+    // GPS device are sync in time by satellite using GMT time.
 
-    std::sort(itemsToCorrelate.begin(), itemsToCorrelate.end(), TrackCorrelationLessThan);
+    QDateTime itemDateTime = item.dateTime.addSecs(options.secondsOffset);
+    itemDateTime.setTimeZone(QTimeZone(options.timeZoneOffset));
+
+    // Find the last point before our item, and the first point at or after our item.
+    // For points with the same time, the first file and the first point in the file win.
 
-    // now perform the correlation
-    // we search all loaded gpx data files in parallel for the points with the best match
+    QDateTime       lastSmallerTime;
+    QPair<int, int> lastIndexPair;
+    QDateTime       firstBiggerTime;
+    QPair<int, int> firstIndexPair;
 
-    const int nFiles = fileList.count();
-    QList<int> currentIndices;
+    const qint64 itemTime                           = itemDateTime.toMSecsSinceEpoch();
+    QVector<TrackPointRef>::const_iterator firstRef = std::lower_bound(timeIndex.constBegin(), timeIndex.constEnd(),
+                                                                       itemTime, TrackPointRefTimeLessThan);
+
+    if (firstRef != timeIndex.constEnd())
+    {
+        firstBiggerTime = fileList.at(firstRef->file).points.at(firstRef->index).dateTime;
+        firstIndexPair  = QPair<int, int>(firstRef->file, firstRef->index);
+    }
 
-    for (int i = 0 ; i < nFiles ; ++i)
+    if (firstRef != timeIndex.constBegin())
     {
-        currentIndices << 0;
+        QVector<TrackPointRef>::const_iterator lastRef = std::lower_bound(timeIndex.constBegin(), firstRef,
+                                                                          (firstRef - 1)->time,
+                                                                          TrackPointRefTimeLessThan);
+        lastSmallerTime = fileList.at(lastRef->file).points.at(lastRef->index).dateTime;
+        lastIndexPair   = QPair<int, int>(lastRef->file, lastRef->index);
     }
 
-    for (TrackCorrelator::Correlation::List::iterator it = itemsToCorrelate.begin() ; it != itemsToCorrelate.end() ; ++it)
+    TrackCorrelator::Correlation correlatedData = item;
+
+    if (!options.interpolate)
     {
-        if (doCancel)
+        // do we have a timestamp within maxGap?
+
+        bool canUseTimeBefore = lastSmallerTime.isValid();
+        int dtimeBefore       = 0;
+
+        if (canUseTimeBefore)
         {
-            canceled = true;
-            return;
+            dtimeBefore      = qAbs(lastSmallerTime.secsTo(itemDateTime));
+            canUseTimeBefore = dtimeBefore <= options.maxGapTime;
         }
 
-        // GPS device are sync in time by satellite using GMT time.
+        bool canUseTimeAfter = firstBiggerTime.isValid();
+        int dtimeAfter       = 0;
 
-        QDateTime itemDateTime = it->dateTime.addSecs(options.secondsOffset);
-        itemDateTime.setTimeZone(QTimeZone(options.timeZoneOffset));
+        if (canUseTimeAfter)
+        {
+            dtimeAfter      = qAbs(firstBiggerTime.secsTo(itemDateTime));
+            canUseTimeAfter = dtimeAfter <= options.maxGapTime;
+        }
 
-        // find the last point before our item:
+        if (canUseTimeAfter || canUseTimeBefore)
+        {
+            QPair<int, int> indexToUse(-1, -1);
 
-        QDateTime       lastSmallerTime;
-        QPair<int, int> lastIndexPair;
-        QDateTime       firstBiggerTime;
-        QPair<int, int> firstIndexPair;
+            if      (canUseTimeAfter&&canUseTimeBefore)
+            {
+                indexToUse = (dtimeBefore < dtimeAfter) ? lastIndexPair:firstIndexPair;
+            }
+            else if (canUseTimeAfter)
+            {
+                indexToUse = firstIndexPair;
+            }
+            else if (canUseTimeBefore)
+            {
+                indexToUse = lastIndexPair;
+            }
 
-        for (int f = 0 ; f < nFiles ; ++f)
-        {
-            if (doCancel)
+            if (indexToUse.first >= 0)
             {
-                canceled = true;
-                return;
+                const TrackManager::TrackPoint& dataPoint = fileList.at(indexToUse.first).points.at(indexToUse.second);
+                correlatedData.coordinates                = dataPoint.coordinates;
+                correlatedData.flags                      = static_cast<TrackCorrelator::CorrelationFlags>(correlatedData.flags |
+                                                                        TrackCorrelator::CorrelationFlagCoordinates);
+                correlatedData.nSatellites                = dataPoint.nSatellites;
+                correlatedData.hDop                       = dataPoint.hDop;
+                correlatedData.pDop                       = dataPoint.pDop;
+                correlatedData.fixType                    = dataPoint.fixType;
+                correlatedData.speed                      = dataPoint.speed;
             }
+        }
+    }
+    else
+    {
+        bool canInterpolate = lastSmallerTime.isValid() && firstBiggerTime.isValid();
 
-            const TrackManager::Track& currentFile = fileList.at(f);
-            int index                              = currentIndices.at(f);
+        if (canInterpolate)
+        {
+            canInterpolate = qAbs(lastSmallerTime.secsTo(itemDateTime)) <= options.interpolationDstTime;
+        }
+
+        if (canInterpolate)
+        {
+            canInterpolate = qAbs(firstBiggerTime.secsTo(itemDateTime)) <= options.interpolationDstTime;
+        }
+
+        if (canInterpolate)
+        {
+            const TrackManager::TrackPoint& dataPointBefore = fileList.at(lastIndexPair.first).points.at(lastIndexPair.second);
+            const TrackManager::TrackPoint& dataPointAfter  = fileList.at(firstIndexPair.first).points.at(firstIndexPair.second);
+            const uint tBefore                              = dataPointBefore.dateTime.toSecsSinceEpoch();
+            const uint tAfter                               = dataPointAfter.dateTime.toSecsSinceEpoch();
+            const uint tCor                                 = itemDateTime.toSecsSinceEpoch();
 
-            for ( ; index < currentFile.points.count() ; ++index)
+            if (tCor-tBefore != 0)
             {
-                if (doCancel)
-                {
-                    canceled = true;
-                    return;
-                }
+                GeoCoordinates resultCoordinates;
+                const double latBefore  = dataPointBefore.coordinates.lat();
+                const double lonBefore  = dataPointBefore.coordinates.lon();
+                const double latAfter   = dataPointAfter.coordinates.lat();
+                const double lonAfter   = dataPointAfter.coordinates.lon();
+                const qreal interFactor = qreal(tCor-tBefore) / qreal(tAfter-tBefore);
 
-                const QDateTime& indexTime = currentFile.points.at(index).dateTime;
+                resultCoordinates.setLatLon(latBefore + (latAfter - latBefore) * interFactor,
+                                            lonBefore + (lonAfter - lonBefore) * interFactor);
 
-                if (indexTime < itemDateTime)
-                {
-                    bool timeIsBetter = false;
-
-                    if (lastSmallerTime.isValid())
-                    {
-                        timeIsBetter = (indexTime > lastSmallerTime);
-                    }
-                    else
-                    {
-                        timeIsBetter = true;
-                    }
-
-                    if (timeIsBetter)
-                    {
-                        lastSmallerTime = indexTime;
-                        lastIndexPair   = QPair<int, int>(f, index);
-                    }
-                }
-                else
+                const bool hasAlt = dataPointBefore.coordinates.hasAltitude() && dataPointAfter.coordinates.hasAltitude();
+
+                if (hasAlt)
                 {
-                    // is it the first time after our item?
-
-                    bool timeIsBetter = false;
-
-                    if (firstBiggerTime.isValid())
-                    {
-                        timeIsBetter = (indexTime < firstBiggerTime);
-                    }
-                    else
-                    {
-                        timeIsBetter = true;
-                    }
-
-                    if (timeIsBetter)
-                    {
-                        firstBiggerTime = indexTime;
-                        firstIndexPair  = QPair<int, int>(f, index);
-                    }
-
-                    break;
+                    const double altBefore = dataPointBefore.coordinates.alt();
+                    const double altAfter  = dataPointAfter.coordinates.alt();
+                    resultCoordinates.setAlt(altBefore + (altAfter - altBefore) * interFactor);
                 }
+
+                correlatedData.coordinates = resultCoordinates;
+                correlatedData.flags       = static_cast<TrackCorrelator::CorrelationFlags>(correlatedData.flags | TrackCorrelator::CorrelationFlagCoordinates);
             }
 
-            // Remember the last index which we searched in this file
-            // to save time when looking for matching times for the next
-            // item.
-            // However, we have to decrease the index by one:
-            // The current index should correspond to a time after the item,
-            // and index-1 should correspond to a time before the item. The next
-            // item may be before the time of the current index, and by decreasing
-            // the stored index by 1 we ensure that we start our search at an index
-            // corresponding to a time before the next item. Remember that the
-            // items are sorted by time!
-
-            currentIndices[f] = (index > 1) ? (index - 1) : 0;
         }
+    }
 
-        TrackCorrelator::Correlation correlatedData = *it;
+    return correlatedData;
+}
 
-        if (!options.interpolate)
-        {
-            // do we have a timestamp within maxGap?
+} // namespace
 
-            bool canUseTimeBefore = lastSmallerTime.isValid();
-            int dtimeBefore       = 0;
+bool TrackCorrelationLessThan(const TrackCorrelator::Correlation& a, const TrackCorrelator::Correlation& b)
+{
+    return (a.dateTime < b.dateTime);
+}
 
-            if (canUseTimeBefore)
-            {
-                dtimeBefore      = qAbs(lastSmallerTime.secsTo(itemDateTime));
-                canUseTimeBefore = dtimeBefore <= options.maxGapTime;
-            }
+TrackCorrelatorThread::TrackCorrelatorThread(QObject* const parent)
+    : QThread (parent),
+      doCancel(false),
+      canceled(false)
+{
+}
 
-            bool canUseTimeAfter = firstBiggerTime.isValid();
-            int dtimeAfter       = 0;
+TrackCorrelatorThread::~TrackCorrelatorThread()
+{
+}
 
-            if (canUseTimeAfter)
-            {
-                dtimeAfter      = qAbs(firstBiggerTime.secsTo(itemDateTime));
-                canUseTimeAfter = dtimeAfter <= options.maxGapTime;
-            }
+void TrackCorrelatorThread::run()
+{
+    // sort the items to correlate by time:
 
-            if (canUseTimeAfter || canUseTimeBefore)
-            {
-                QPair<int, int> indexToUse(-1, -1);
+    std::sort(itemsToCorrelate.begin(), itemsToCorrelate.end(), TrackCorrelationLessThan);
 
-                if      (canUseTimeAfter&&canUseTimeBefore)
-                {
-                    indexToUse = (dtimeBefore < dtimeAfter) ? lastIndexPair:firstIndexPair;
-                }
-                else if (canUseTimeAfter)
-                {
-                    indexToUse = firstIndexPair;
-                }
-                else if (canUseTimeBefore)
-                {
-                    indexToUse = lastIndexPair;
-                }
+    // index the points of all loaded gpx data files by time, the points of each item
+    // are then found by a binary search. The stable sort keeps the order of the files
+    // and of the points in the files for the points with the same time.
 
-                if (indexToUse.first >= 0)
-                {
-                    const TrackManager::TrackPoint& dataPoint = fileList.at(indexToUse.first).points.at(indexToUse.second);
-                    correlatedData.coordinates                = dataPoint.coordinates;
-                    correlatedData.flags                      = static_cast<TrackCorrelator::CorrelationFlags>(correlatedData.flags |
-                                                                            TrackCorrelator::CorrelationFlagCoordinates);
-                    correlatedData.nSatellites                = dataPoint.nSatellites;
-                    correlatedData.hDop                       = dataPoint.hDop;
-                    correlatedData.pDop                       = dataPoint.pDop;
-                    correlatedData.fixType                    = dataPoint.fixType;
-                    correlatedData.speed                      = dataPoint.speed;
-                }
-            }
-        }
-        else
-        {
-            bool canInterpolate = lastSmallerTime.isValid() && firstBiggerTime.isValid();
+    int nPoints = 0;
 
-            if (canInterpolate)
-            {
-                canInterpolate = qAbs(lastSmallerTime.secsTo(itemDateTime)) <= options.interpolationDstTime;
-            }
+    for (int f = 0 ; f < fileList.count() ; ++f)
+    {
+        nPoints += fileList.at(f).points.count();
+    }
+
+    QVector<TrackPointRef> timeIndex;
+    timeIndex.reserve(nPoints);
 
-            if (canInterpolate)
+    for (int f = 0 ; f < fileList.count() ; ++f)
+    {
+        const TrackManager::Track& currentFile = fileList.at(f);
+
+        for (int index = 0 ; index < currentFile.points.count() ; ++index)
+        {
+            if (doCancel)
             {
-                canInterpolate = qAbs(firstBiggerTime.secsTo(itemDateTime)) <= options.interpolationDstTime;
+                canceled = true;
+                return;
             }
 
-            if (canInterpolate)
-            {
-                const TrackManager::TrackPoint& dataPointBefore = fileList.at(lastIndexPair.first).points.at(lastIndexPair.second);
-                const TrackManager::TrackPoint& dataPointAfter  = fileList.at(firstIndexPair.first).points.at(firstIndexPair.second);
-                const uint tBefore                              = dataPointBefore.dateTime.toSecsSinceEpoch();
-                const uint tAfter                               = dataPointAfter.dateTime.toSecsSinceEpoch();
-                const uint tCor                                 = itemDateTime.toSecsSinceEpoch();
+            const TrackPointRef ref = { currentFile.points.at(index).dateTime.toMSecsSinceEpoch(), f, index };
+            timeIndex << ref;
+        }
+    }
+
+    std::stable_sort(timeIndex.begin(), timeIndex.end(), TrackPointRefEarlierThan);
+
+    // now perform the correlation, by chunks of items on the background job threads
+
+    QList<QPair<int, int> > chunks;
 
-                if (tCor-tBefore != 0)
+    for (int begin = 0 ; begin < itemsToCorrelate.count() ; begin += CORRELATION_CHUNK_SIZE)
+    {
+        chunks << QPair<int, int>(begin, qMin(begin + CORRELATION_CHUNK_SIZE, itemsToCorrelate.count()));
+    }
+
+    ThreadManager::instance()->parallelFor(chunks.count(),
+        [this, &timeIndex, &chunks](int c)
+        {
+            const QPair<int, int>& chunk = chunks.at(c);
+            TrackCorrelator::Correlation::List readyItems;
+
+            for (int i = chunk.first ; i < chunk.second ; ++i)
+            {
+                if (doCancel)
                 {
-                    GeoCoordinates resultCoordinates;
-                    const double latBefore  = dataPointBefore.coordinates.lat();
-                    const double lonBefore  = dataPointBefore.coordinates.lon();
-                    const double latAfter   = dataPointAfter.coordinates.lat();
-                    const double lonAfter   = dataPointAfter.coordinates.lon();
-                    const qreal interFactor = qreal(tCor-tBefore) / qreal(tAfter-tBefore);
-
-                    resultCoordinates.setLatLon(latBefore + (latAfter - latBefore) * interFactor,
-                                                lonBefore + (lonAfter - lonBefore) * interFactor);
-
-                    const bool hasAlt = dataPointBefore.coordinates.hasAltitude() && dataPointAfter.coordinates.hasAltitude();
-
-                    if (hasAlt)
-                    {
-                        const double altBefore = dataPointBefore.coordinates.alt();
-                        const double altAfter  = dataPointAfter.coordinates.alt();
-                        resultCoordinates.setAlt(altBefore + (altAfter - altBefore) * interFactor);
-                    }
-
-                    correlatedData.coordinates = resultCoordinates;
-                    correlatedData.flags       = static_cast<TrackCorrelator::CorrelationFlags>(correlatedData.flags | TrackCorrelator::CorrelationFlagCoordinates);
+                    return;
                 }
 
+                const TrackCorrelator::Correlation correlatedData = correlateItem(itemsToCorrelate.at(i),
+                                                                                  options,
+                                                                                  fileList,
+                                                                                  timeIndex);
+
+                if (correlatedData.flags & TrackCorrelator::CorrelationFlagCoordinates)
+                {
+                    readyItems << correlatedData;
+                }
             }
-        }
 
-        if (correlatedData.flags&TrackCorrelator::CorrelationFlagCoordinates)
-        {
-            TrackCorrelator::Correlation::List readyItems;
-            readyItems << correlatedData;
+            if (!readyItems.isEmpty())
+            {
+                Q_EMIT signalItemsCorrelated(readyItems);
+            }
+        },
+        ThreadManager::Background
+    );
 
-            Q_EMIT signalItemsCorrelated(readyItems);
-        }
-    }
+    canceled = doCancel;
 }
 
 } // namespace Digikam
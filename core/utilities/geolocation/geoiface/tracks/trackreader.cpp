@@ -15,6 +15,10 @@
 
 #include "trackreader.h"
 
+// C++ includes
+
+#include <algorithm>
+
 // Qt includes
 
 #include <QFile>
@@ -28,6 +32,197 @@
 namespace Digikam
 {
 
+namespace
+{
+
+/**
+ * Reads count decimal digits at pos, and advances pos. Returns -1 if they are not all digits.
+ */
+int parseDigits(const QChar* const data, int size, int& pos, int count)
+{
+    if ((pos + count) > size)
+    {
+        return -1;
+    }
+
+    int value = 0;
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        const ushort c = data[pos + i].unicode();
+
+        if ((c < '0') || (c > '9'))
+        {
+            return -1;
+        }
+
+        value = value * 10 + (c - '0');
+    }
+
+    pos += count;
+
+    return value;
+}
+
+bool parseSeparator(const QChar* const data, int size, int& pos, char separator)
+{
+    if ((pos >= size) || (data[pos] != QLatin1Char(separator)))
+    {
+        return false;
+    }
+
+    ++pos;
+
+    return true;
+}
+
+/**
+ * Parses the times written by the GPS devices, "2009-03-11T13:39:55.622Z" or
+ * "2010-01-14T09:26:02.287+02:00", without allocating strings. Returns a null
+ * QDateTime for the other formats, including the times without time zone.
+ */
+QDateTime parseUtcTime(const QChar* const data, int size)
+{
+    int begin = 0;
+    int end   = size;
+
+    while ((begin < end) && data[begin].isSpace())
+    {
+        ++begin;
+    }
+
+    while ((end > begin) && data[end - 1].isSpace())
+    {
+        --end;
+    }
+
+    int pos          = begin;
+    const int year   = parseDigits(data, end, pos, 4);
+
+    if ((year < 0) || !parseSeparator(data, end, pos, '-'))
+    {
+        return QDateTime();
+    }
+
+    const int month  = parseDigits(data, end, pos, 2);
+
+    if ((month < 0) || !parseSeparator(data, end, pos, '-'))
+    {
+        return QDateTime();
+    }
+
+    const int day    = parseDigits(data, end, pos, 2);
+
+    if ((day < 0) || !parseSeparator(data, end, pos, 'T'))
+    {
+        return QDateTime();
+    }
+
+    const int hour   = parseDigits(data, end, pos, 2);
+
+    if ((hour < 0) || !parseSeparator(data, end, pos, ':'))
+    {
+        return QDateTime();
+    }
+
+    const int minute = parseDigits(data, end, pos, 2);
+
+    if ((minute < 0) || !parseSeparator(data, end, pos, ':'))
+    {
+        return QDateTime();
+    }
+
+    const int second = parseDigits(data, end, pos, 2);
+
+    if (second < 0)
+    {
+        return QDateTime();
+    }
+
+    int msecs = 0;
+
+    if (parseSeparator(data, end, pos, '.'))
+    {
+        qint64 fraction = 0;
+        qint64 scale    = 1;
+        int    digits   = 0;
+
+        while ((pos < end) && (data[pos].unicode() >= '0') && (data[pos].unicode() <= '9'))
+        {
+            // the digits after the nanoseconds do not change the milliseconds
+
+            if (digits < 9)
+            {
+                fraction = fraction * 10 + (data[pos].unicode() - '0');
+                scale   *= 10;
+            }
+
+            ++digits;
+            ++pos;
+        }
+
+        if (digits == 0)
+        {
+            return QDateTime();
+        }
+
+        msecs = qMin(999, qRound(fraction * 1000.0 / scale));
+    }
+
+    int timeZoneOffsetSeconds = 0;
+
+    if (!parseSeparator(data, end, pos, 'Z'))
+    {
+        int timeZoneSign = 0;
+
+        if      (parseSeparator(data, end, pos, '+'))
+        {
+            timeZoneSign = +1;
+        }
+        else if (parseSeparator(data, end, pos, '-'))
+        {
+            timeZoneSign = -1;
+        }
+        else
+        {
+            return QDateTime();
+        }
+
+        const int hourOffset   = parseDigits(data, end, pos, 2);
+
+        if ((hourOffset < 0) || !parseSeparator(data, end, pos, ':'))
+        {
+            return QDateTime();
+        }
+
+        const int minuteOffset = parseDigits(data, end, pos, 2);
+
+        if (minuteOffset < 0)
+        {
+            return QDateTime();
+        }
+
+        timeZoneOffsetSeconds = timeZoneSign * (hourOffset * 3600 + minuteOffset * 60);
+    }
+
+    if (pos != end)
+    {
+        return QDateTime();
+    }
+
+    const QDate date(year, month, day);
+    const QTime time(hour, minute, second, msecs);
+
+    if (!date.isValid() || !time.isValid())
+    {
+        return QDateTime();
+    }
+
+    return QDateTime(date, time, Qt::UTC).addSecs(-timeZoneOffsetSeconds);
+}
+
+} // namespace
+
 class Q_DECL_HIDDEN TrackReader::Private
 {
 public:
@@ -38,6 +233,9 @@ public:
     }
 
     TrackReadResult* fileData;
+
+    /// The text of the current element of a track point, reused for all points.
+    QString          elementText;
 };
 
 TrackReader::TrackReader(TrackReadResult* const dataTarget)
@@ -53,6 +251,13 @@ TrackReader::~TrackReader()
 
 QDateTime TrackReader::ParseTime(const QString& tstring)
 {
+    const QDateTime utcTime = parseUtcTime(tstring.constData(), tstring.size());
+
+    if (utcTime.isValid())
+    {
+        return utcTime;
+    }
+
     QString timeString = tstring;
 
     if (timeString.isEmpty())
@@ -139,7 +344,42 @@ void TrackReader::parseTrack(QXmlStreamReader& xml)
     {
         if (xml.tokenType() == QXmlStreamReader::StartElement)
         {
-            QString eText = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+            // read the text of the element and of its children, as readElementText()
+            // with IncludeChildElements, but in the same buffer for all points.
+
+            QString& eText = d->elementText;
+            eText.resize(0);
+            int depth      = 1;
+
+            while ((depth > 0) && !xml.hasError())
+            {
+                switch (xml.readNext())
+                {
+                    case QXmlStreamReader::StartElement:
+                    {
+                        ++depth;
+                        break;
+                    }
+
+                    case QXmlStreamReader::EndElement:
+                    {
+                        --depth;
+                        break;
+                    }
+
+                    case QXmlStreamReader::Characters:
+                    case QXmlStreamReader::EntityReference:
+                    {
+                        eText.append(xml.text());
+                        break;
+                    }
+
+                    default:
+                    {
+                        break;
+                    }
+                }
+            }
 
             if      (xml.name() == QLatin1String("time"))
             {
@@ -252,7 +492,7 @@ TrackReader::TrackReadResult TrackReader::loadTrackFile(const QUrl& url)
 
         if (token == QXmlStreamReader::StartElement)
         {
-            if (XmlReader.name().toString() != QLatin1String("trkpt"))
+            if (XmlReader.name() != QLatin1String("trkpt"))
             {
                 continue;
             }
@@ -289,11 +529,17 @@ TrackReader::TrackReadResult TrackReader::loadTrackFile(const QUrl& url)
         return parsedData;
     }
 
-    // The correlation algorithm relies on sorted data, therefore sort now
+    // The correlation algorithm relies on sorted data, therefore sort now.
+    // The points of a track are recorded in order most of the time.
 
-    std::sort(parsedData.track.points.begin(),
-              parsedData.track.points.end(),
-              TrackManager::TrackPoint::EarlierThan);
+    if (!std::is_sorted(parsedData.track.points.constBegin(),
+                        parsedData.track.points.constEnd(),
+                        TrackManager::TrackPoint::EarlierThan))
+    {
+        std::sort(parsedData.track.points.begin(),
+                  parsedData.track.points.end(),
+                  TrackManager::TrackPoint::EarlierThan);
+    }
 
     return parsedData;
 }
@@ -20,7 +20,7 @@
 // Qt includes
 
 #include <QPair>
-#include <QRectF>
+#include <QSet>
 #include <QTimer>
 
 // Local includes
@@ -54,6 +54,13 @@ public:
 
     QList<qlonglong> imagesId;
 
+    /// The best marker of the tile and its group state, valid for one generation of the images states.
+    qlonglong        representativeId         = -1;
+    int              representativeSortKey    = -1;
+    int              representativeGeneration = -1;
+    GeoGroupState    groupState;
+    int              groupStateGeneration     = -1;
+
 private:
 
     ~MyTile() = delete;
@@ -63,27 +70,13 @@ class Q_DECL_HIDDEN GPSMarkerTiler::Private
 {
 public:
 
-    class Q_DECL_HIDDEN InternalJobs
-    {
-    public:
-
-        InternalJobs()
-            : level           (0),
-              jobThread       (nullptr),
-              dataFromDatabase()
-        {
-        }
-
-        int                level;
-        GPSDBJobsThread*   jobThread;
-        QList<GPSItemInfo> dataFromDatabase;
-    };
-
     explicit Private()
-        : jobs                  (),
+        : indexJob              (nullptr),
+          indexRequested        (false),
+          statesGeneration      (0),
+          changeTimer           (nullptr),
           thumbnailLoadThread   (nullptr),
           thumbnailMap          (),
-          rectList              (),
           activeState           (true),
           imagesHash            (),
           imageFilterModel      (),
@@ -94,10 +87,15 @@ public:
     {
     }
 
-    QList<InternalJobs>           jobs;
+    GPSDBJobsThread*              indexJob;
+    bool                          indexRequested;
+
+    /// The images whose position changed while the index is loaded: the job may list their old position.
+    QSet<qlonglong>               changedWhileIndexing;
+    int                           statesGeneration;
+    QTimer*                       changeTimer;
     ThumbnailLoadThread*          thumbnailLoadThread;
     QHash<qlonglong, QVariant>    thumbnailMap;
-    QList<QRectF>                 rectList;
     bool                          activeState;
     QHash<qlonglong, GPSItemInfo> imagesHash;
     ItemFilterModel*              imageFilterModel;
@@ -124,6 +122,15 @@ GPSMarkerTiler::GPSMarkerTiler(QObject* const parent,
     d->imageAlbumModel     = qobject_cast<ItemAlbumModel*>(imageFilterModel->sourceModel());
     d->selectionModel      = selectionModel;
 
+    // The markers are shown while the index is loaded, without redrawing the map for each batch.
+
+    d->changeTimer         = new QTimer(this);
+    d->changeTimer->setSingleShot(true);
+    d->changeTimer->setInterval(250);
+
+    connect(d->changeTimer, SIGNAL(timeout()),
+            this, SIGNAL(signalTilesOrSelectionChanged()));
+
     connect(d->thumbnailLoadThread, SIGNAL(signalThumbnailLoaded(LoadingDescription,QPixmap)),
             this, SLOT(slotThumbnailLoaded(LoadingDescription,QPixmap)));
 
@@ -133,6 +140,28 @@ GPSMarkerTiler::GPSMarkerTiler(QObject* const parent,
     connect(d->imageAlbumModel, SIGNAL(imageInfosAdded(QList<ItemInfo>)),
             this, SLOT(slotNewModelData(QList<ItemInfo>)));
 
+    // The cached tile states depend on the images of the models: they are dropped
+    // when images are removed, the models are cleared, reset or filtered, and when
+    // a refill of the album model is finished.
+
+    connect(d->imageAlbumModel, SIGNAL(allRefreshingFinished()),
+            this, SLOT(slotModelChanged()));
+
+    QList<QAbstractItemModel*> models;
+    models << d->imageAlbumModel << d->imageFilterModel;
+
+    Q_FOREACH (QAbstractItemModel* const model, models)
+    {
+        connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                this, SLOT(slotModelChanged()));
+
+        connect(model, SIGNAL(modelReset()),
+                this, SLOT(slotModelChanged()));
+
+        connect(model, SIGNAL(layoutChanged()),
+                this, SLOT(slotModelChanged()));
+    }
+
     connect(d->selectionModel, SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
             this, SLOT(slotSelectionChanged(QItemSelection,QItemSelection)));
 }
@@ -142,6 +171,11 @@ GPSMarkerTiler::GPSMarkerTiler(QObject* const parent,
  */
 GPSMarkerTiler::~GPSMarkerTiler()
 {
+    if (d->indexJob)
+    {
+        d->indexJob->cancel();
+    }
+
     delete d;
 }
 
@@ -150,11 +184,12 @@ void GPSMarkerTiler::regenerateTiles()
 }
 
 /**
- * @brief Requests all images inside a given rectangle from the database.
+ * @brief Loads the positions of all images from the database, the first time the map is shown.
  *
- * This function calls the database for the images found inside a rectangle
- * defined by upperLeft and lowerRight points. The images are returned from
- * the database in batches.
+ * The tiles are a spatial index of all geotagged images: each tile knows its images, and
+ * is split in child tiles when the map needs them. Once loaded, the index is kept up to date
+ * from the database changesets, and the map is served without querying the database again
+ * when the viewport changes. The positions are binned into the tiles as they arrive.
  *
  * @param upperLeft The North-West point.
  * @param lowerRight The South-East point.
@@ -162,106 +197,33 @@ void GPSMarkerTiler::regenerateTiles()
  */
 void GPSMarkerTiler::prepareTiles(const GeoCoordinates& upperLeft, const GeoCoordinates& lowerRight, int level)
 {
-    const QRectF worldRect(-90,-180,180,360);
-
-    qreal lat1         = upperLeft.lat();
-    qreal lng1         = upperLeft.lon();
-    qreal lat2         = lowerRight.lat();
-    qreal lng2         = lowerRight.lon();
-    auto requestedRect = worldRect.intersected(QRectF(lat1, lng1, lat2 - lat1, lng2 - lng1));
+    Q_UNUSED(upperLeft);
+    Q_UNUSED(lowerRight);
+    Q_UNUSED(level);
 
-    for (int i = 0 ; i < d->rectList.count() ; ++i)
+    if (d->indexRequested)
     {
-        // is there a rect that contains the requested one?
-        const QRectF& currentRect = d->rectList.at(i);
-
-        if (currentRect.contains(requestedRect))
-        {
-            return;
-        }
-
-        // and remove rects that are contained in the requested one
-
-        if (requestedRect.contains(currentRect))
-        {
-            std::swap(d->rectList[i], d->rectList.back());
-            d->rectList.removeLast();
-            // we removed one entry. we have to subtract one from the index
-            --i;
-        }
+        return;
     }
 
-    // grow the rect a bit such that we don't have to request many small ones while panning
-    qreal marginW = requestedRect.width() * 0.05;
-    qreal marginH = requestedRect.height() * 0.05;
-    requestedRect = requestedRect.marginsAdded(QMarginsF(marginW, marginH, marginW, marginH));
-    requestedRect = worldRect.intersected(requestedRect);
-    requestedRect.getCoords(&lat1, &lng1, &lat2, &lng2);
+    d->indexRequested = true;
 
-    for (int i = 0 ; i < d->rectList.count() ; ++i)
-    {
-        qreal rectLat1, rectLng1, rectLat2, rectLng2;
-        const QRectF currentRect = d->rectList.at(i);
-        currentRect.getCoords(&rectLat1, &rectLng1, &rectLat2, &rectLng2);
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Loading the positions of all images";
 
-        if      (currentRect.contains(lat1, lng1))
-        {
-            if (currentRect.contains(lat2, lng1))
-            {
-                lng1 = rectLng2;
-                break;
-            }
-        }
-        else if (currentRect.contains(lat2, lng1))
-        {
-            if (currentRect.contains(lat2, lng2))
-            {
-                lat2 = rectLat1;
-                break;
-            }
-        }
-        else if (currentRect.contains(lat2, lng2))
-        {
-            if (currentRect.contains(lat1, lng2))
-            {
-                lng2 = rectLng1;
-                break;
-            }
-        }
-        else if (currentRect.contains(lat1, lng2))
-        {
-            if (currentRect.contains(lat1, lng1))
-            {
-                lat1 = rectLat2;
-                break;
-            }
-        }
-    }
-
-    requestedRect = QRectF(lat1, lng1, lat2 - lat1, lng2 - lng1);
-    d->rectList.append(requestedRect);
-
-    qCDebug(DIGIKAM_GENERAL_LOG) << "Listing" << lat1 << lat2 << lng1 << lng2;
+    // The database compares the coordinates strictly: the bounds are beyond the world limits.
 
     GPSDBJobInfo jobInfo;
-    jobInfo.setLat1(lat1);
-    jobInfo.setLat2(lat2);
-    jobInfo.setLng1(lng1);
-    jobInfo.setLng2(lng2);
-
-    GPSDBJobsThread* const currentJob = DBJobsManager::instance()->startGPSJobThread(jobInfo);
+    jobInfo.setLat1(-91.0);
+    jobInfo.setLat2(91.0);
+    jobInfo.setLng1(-181.0);
+    jobInfo.setLng2(181.0);
 
-    Private::InternalJobs currentJobInfo;
+    d->indexJob = DBJobsManager::instance()->startGPSJobThread(jobInfo);
 
-    currentJobInfo.jobThread          = currentJob;
-    currentJobInfo.level              = level;
-
-    d->jobs.append(currentJobInfo);
-
-    connect(currentJob, SIGNAL(finished()),
+    connect(d->indexJob, SIGNAL(finished()),
             this, SLOT(slotMapImagesJobResult()));
 
-    connect(currentJob, SIGNAL(data(QList<ItemListerRecord>)),
+    connect(d->indexJob, SIGNAL(data(QList<ItemListerRecord>)),
             this, SLOT(slotMapImagesJobData(QList<ItemListerRecord>)));
 }
 
@@ -362,34 +324,83 @@ QVariant GPSMarkerTiler::getTileRepresentativeMarker(const TileIndex& tileIndex,
         return QVariant();
     }
 
-    if (tile->imagesId.isEmpty())
+    const qlonglong bestMarkerId = getTileRepresentativeId(tile, sortKey);
+
+    if (bestMarkerId == -1)
     {
         return QVariant();
     }
 
-    GPSItemInfo bestMarkerInfo         = d->imagesHash.value(tile->imagesId.first());
-    GeoGroupState bestMarkerGroupState = getImageState(bestMarkerInfo.id);
+    const QPair<TileIndex, int> returnedMarker(tileIndex, bestMarkerId);
+
+    return QVariant::fromValue(returnedMarker);
+}
 
-    for (int i = 1 ; i < tile->imagesId.count() ; ++i)
+/**
+ * @brief Returns the id of the best marker of a tile, or -1 if the tile is empty.
+ *
+ * The result is kept in the tile until its images or the images states change. When the tile
+ * is already split, the best marker is chosen among the best markers of the children.
+ */
+qlonglong GPSMarkerTiler::getTileRepresentativeId(MyTile* const tile, const int sortKey)
+{
+    if ((tile->representativeGeneration == d->statesGeneration) &&
+        (tile->representativeSortKey    == sortKey))
     {
-        const GPSItemInfo currentMarkerInfo         = d->imagesHash.value(tile->imagesId.at(i));
-        const GeoGroupState currentMarkerGroupState = getImageState(currentMarkerInfo.id);
+        return tile->representativeId;
+    }
 
-        if (GPSItemInfoSorter::fitsBetter(bestMarkerInfo,
-                                          bestMarkerGroupState,
-                                          currentMarkerInfo,
-                                          currentMarkerGroupState,
-                                          getGlobalGroupState(),
-                                          GPSItemInfoSorter::SortOptions(sortKey)))
+    QList<qlonglong> candidates;
+
+    if (tile->childrenEmpty())
+    {
+        candidates = tile->imagesId;
+    }
+    else
+    {
+        for (int i = tile->nextNonEmptyIndex(-1) ; i != -1 ; i = tile->nextNonEmptyIndex(i))
         {
-            bestMarkerInfo       = currentMarkerInfo;
-            bestMarkerGroupState = currentMarkerGroupState;
+            const qlonglong childBestId = getTileRepresentativeId(static_cast<MyTile*>(tile->getChild(i)), sortKey);
+
+            if (childBestId != -1)
+            {
+                candidates << childBestId;
+            }
         }
     }
 
-    const QPair<TileIndex, int> returnedMarker(tileIndex, bestMarkerInfo.id);
+    qlonglong bestMarkerId = -1;
 
-    return QVariant::fromValue(returnedMarker);
+    if (!candidates.isEmpty())
+    {
+        GPSItemInfo bestMarkerInfo         = d->imagesHash.value(candidates.first());
+        GeoGroupState bestMarkerGroupState = getImageState(bestMarkerInfo.id);
+
+        for (int i = 1 ; i < candidates.count() ; ++i)
+        {
+            const GPSItemInfo currentMarkerInfo         = d->imagesHash.value(candidates.at(i));
+            const GeoGroupState currentMarkerGroupState = getImageState(currentMarkerInfo.id);
+
+            if (GPSItemInfoSorter::fitsBetter(bestMarkerInfo,
+                                              bestMarkerGroupState,
+                                              currentMarkerInfo,
+                                              currentMarkerGroupState,
+                                              getGlobalGroupState(),
+                                              GPSItemInfoSorter::SortOptions(sortKey)))
+            {
+                bestMarkerInfo       = currentMarkerInfo;
+                bestMarkerGroupState = currentMarkerGroupState;
+            }
+        }
+
+        bestMarkerId = bestMarkerInfo.id;
+    }
+
+    tile->representativeId         = bestMarkerId;
+    tile->representativeSortKey    = sortKey;
+    tile->representativeGeneration = d->statesGeneration;
+
+    return bestMarkerId;
 }
 
 /**
@@ -491,55 +502,57 @@ GeoGroupState GPSMarkerTiler::getTileGroupState(const TileIndex& tileIndex)
         return SelectedNone;
     }
 
-    /// @todo Store this state in the tiles!
-
     MyTile* const tile = static_cast<MyTile*>(getTile(tileIndex, true));
-    GroupStateComputer tileStateComputer;
 
-    for (int i = 0 ; i < tile->imagesId.count() ; ++i)
+    if (!tile)
+    {
+        return SelectedNone;
+    }
+
+    if (tile->groupStateGeneration != d->statesGeneration)
     {
-        const GeoGroupState imageState = getImageState(tile->imagesId.at(i));
+        GroupStateComputer tileStateComputer;
+
+        for (int i = 0 ; i < tile->imagesId.count() ; ++i)
+        {
+            const GeoGroupState imageState = getImageState(tile->imagesId.at(i));
 
-        tileStateComputer.addState(imageState);
+            tileStateComputer.addState(imageState);
+        }
+
+        tile->groupState           = tileStateComputer.getState();
+        tile->groupStateGeneration = d->statesGeneration;
     }
 
-    return tileStateComputer.getState();
+    return tile->groupState;
 }
 
 /**
- * @brief The marker data is returned from the database in batches. This function takes and unites the batches.
+ * @brief The marker data is returned from the database in batches. Each batch is sorted into the tiles.
  */
 void GPSMarkerTiler::slotMapImagesJobData(const QList<ItemListerRecord>& records)
 {
-    if (records.isEmpty())
+    if (records.isEmpty() || (sender() != d->indexJob))
     {
         return;
     }
 
-    Private::InternalJobs* internalJob = nullptr;
+    bool added = false;
 
-    for (int i = 0 ; i < d->jobs.count() ; ++i)
+    Q_FOREACH (const ItemListerRecord &record, records)
     {
-        if (sender() == d->jobs.at(i).jobThread)
+        if (record.extraValues.count() < 2)
         {
-            /// @todo Is this really safe?
+            // skip info without coordinates
 
-            internalJob = &d->jobs[i];
-            break;
+            continue;
         }
-    }
 
-    if (!internalJob)
-    {
-        return;
-    }
+        // The images changed since the start of the job are already in the index, or were
+        // removed from it: the record can be older than the change and must not be used.
 
-    Q_FOREACH (const ItemListerRecord &record, records)
-    {
-        if (record.extraValues.count() < 2)
+        if (d->imagesHash.contains(record.imageID) || d->changedWhileIndexing.contains(record.imageID))
         {
-            // skip info without coordinates
-
             continue;
         }
 
@@ -550,36 +563,34 @@ void GPSMarkerTiler::slotMapImagesJobData(const QList<ItemListerRecord>& records
         entry.dateTime     = record.creationDate;
         entry.coordinates.setLatLon(record.extraValues.first().toDouble(), record.extraValues.last().toDouble());
 
-        internalJob->dataFromDatabase << entry;
+        d->imagesHash.insert(entry.id, entry);
+
+        const TileIndex markerTileIndex = TileIndex::fromCoordinates(entry.coordinates, TileIndex::MaxLevel);
+        addMarkerToTileAndChildren(entry.id, markerTileIndex);
+        added = true;
+    }
+
+    if (added && !d->changeTimer->isActive())
+    {
+        d->changeTimer->start();
     }
 }
 
 /**
- * @brief Now, all the marker data has been retrieved from the database. Here, the markers are sorted into tiles.
+ * @brief Now, all the marker data has been retrieved from the database and the index is complete.
  */
 void GPSMarkerTiler::slotMapImagesJobResult()
 {
-    int foundIndex = -1;
-
-    for (int i = 0 ; i < d->jobs.count() ; ++i)
-    {
-        if (sender() == d->jobs.at(i).jobThread)
-        {
-            foundIndex = i;
-            break;
-        }
-    }
-
-    if (foundIndex < 0)
+    if (!d->indexJob || (sender() != d->indexJob))
     {
         // this should not happen, but ok...
 
         return;
     }
 
-    if (d->jobs.at(foundIndex).jobThread->hasErrors())
+    if (d->indexJob->hasErrors())
     {
-        const QString& err = d->jobs.at(foundIndex).jobThread->errorsList().first();
+        const QString& err = d->indexJob->errorsList().first();
 
         qCWarning(DIGIKAM_GENERAL_LOG) << "Failed to list images in selected area: "
                                        << err;
@@ -588,52 +599,19 @@ void GPSMarkerTiler::slotMapImagesJobResult()
 
         DNotificationWrapper(QString(), err,
                              DigikamApp::instance(), DigikamApp::instance()->windowTitle());
-    }
-
-    // get the results from the job:
-
-    const QList<GPSItemInfo> returnedItemInfo = d->jobs.at(foundIndex).dataFromDatabase;
 
-    /// @todo Currently, we ignore the wanted level and just add the images
-/*
-    const int wantedLevel = d->jobs.at(foundIndex).level;
-*/
-    // remove the finished job
-
-    d->jobs[foundIndex].jobThread->cancel();
-    d->jobs[foundIndex].jobThread = nullptr;
-    d->jobs.removeAt(foundIndex);
+        // try again at the next change of the map
 
-    if (returnedItemInfo.isEmpty())
-    {
-        return;
+        d->indexRequested = false;
     }
 
-    // QElapsedTimer elapsedTimer;
-    // elapsedTimer.start();
-
-    for (int i = 0 ; i < returnedItemInfo.count() ; ++i)
-    {
-        const GPSItemInfo currentItemInfo = returnedItemInfo.at(i);
-
-        if (!currentItemInfo.coordinates.hasCoordinates())
-        {
-            continue;
-        }
-
-        if (d->imagesHash.contains(currentItemInfo.id))
-        {
-            continue;
-        }
-
-        d->imagesHash.insert(currentItemInfo.id, currentItemInfo);
+    d->indexJob->cancel();
+    d->indexJob = nullptr;
+    d->changedWhileIndexing.clear();
 
-        const TileIndex markerTileIndex = TileIndex::fromCoordinates(currentItemInfo.coordinates, TileIndex::MaxLevel);
-        addMarkerToTileAndChildren(currentItemInfo.id, markerTileIndex);
-    }
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Positions of" << d->imagesHash.count() << "images loaded";
 
-    // qCDebug(DIGIKAM_GENERAL_LOG) << "added" << returnedItemInfo.count()
-    //                              << "markers in" << elapsedTimer.nsecsElapsed() / 1e9 << "seconds";
+    d->changeTimer->stop();
 
     Q_EMIT signalTilesOrSelectionChanged();
 }
@@ -682,6 +660,11 @@ void GPSMarkerTiler::slotImageChange(const ImageChangeset& changeset)
 
     Q_FOREACH (const qlonglong& id, changeset.ids())
     {
+        if (d->indexJob)
+        {
+            d->changedWhileIndexing << id;
+        }
+
         const ItemInfo newItemInfo(id);
 
         if (!newItemInfo.hasCoordinates())
@@ -760,10 +743,19 @@ void GPSMarkerTiler::slotNewModelData(const QList<ItemInfo>& infoList)
 {
     // We do not actually store the data from the model, we just want
     // to know that something was changed.
-    /// @todo Also monitor removed, reset, etc. signals
 
     Q_UNUSED(infoList);
 
+    slotModelChanged();
+}
+
+/**
+ * @brief Drops the cached tile states when the images of the models change
+ */
+void GPSMarkerTiler::slotModelChanged()
+{
+    d->statesGeneration++;
+
     Q_EMIT signalTilesOrSelectionChanged();
 }
 
@@ -780,6 +772,11 @@ void GPSMarkerTiler::setRegionSelection(const GeoCoordinates::Pair& sel)
         d->mapGlobalGroupState &= ~RegionSelectedMask;
     }
 
+    // The album model is refilled with the images of the region afterwards:
+    // the states are dropped again by slotModelChanged() once it is done.
+
+    d->statesGeneration++;
+
     Q_EMIT signalTilesOrSelectionChanged();
 }
 
@@ -788,6 +785,7 @@ void GPSMarkerTiler::removeCurrentRegionSelection()
     d->currentRegionSelection.first.clear();
 
     d->mapGlobalGroupState &= ~RegionSelectedMask;
+    d->statesGeneration++;
 
     Q_EMIT signalTilesOrSelectionChanged();
 }
@@ -948,6 +946,8 @@ void GPSMarkerTiler::setPositiveFilterIsActive(const bool state)
         d->mapGlobalGroupState &= ~FilteredPositiveMask;
     }
 
+    d->statesGeneration++;
+
     /// @todo Somehow, a delay is necessary before emitting this signal - probably the order in which the filtering
     /// is propagated to other parts of digikam is wrong or just takes too long
 
@@ -964,6 +964,8 @@ void GPSMarkerTiler::slotSelectionChanged(const QItemSelection& selected, const
     Q_UNUSED(selected);
     Q_UNUSED(deselected);
 
+    d->statesGeneration++;
+
     Q_EMIT signalTilesOrSelectionChanged();
 }
 
@@ -975,6 +977,8 @@ void GPSMarkerTiler::removeMarkerFromTileAndChildren(const qlonglong imageId, co
     for (int level = 0 ; level <= markerTileIndex.level() ; ++level)
     {
         currentTile->imagesId.removeOne(imageId);
+        currentTile->representativeGeneration = -1;
+        currentTile->groupStateGeneration     = -1;
 
         if (currentTile->imagesId.isEmpty())
         {
@@ -1010,6 +1014,8 @@ void GPSMarkerTiler::addMarkerToTileAndChildren(const qlonglong imageId, const T
     for (int level = 0 ; level <= markerTileIndex.level() ; ++level)
     {
         currentTile->imagesId.append(imageId);
+        currentTile->representativeGeneration = -1;
+        currentTile->groupStateGeneration     = -1;
 
         if (currentTile->childrenEmpty())
         {
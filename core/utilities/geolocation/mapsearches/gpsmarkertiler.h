@@ -48,7 +48,7 @@ namespace Digikam
 
 class GPSItemInfo;
 
-class GPSMarkerTiler : public AbstractMarkerTiler
+class DIGIKAM_GUI_EXPORT GPSMarkerTiler : public AbstractMarkerTiler
 {
     Q_OBJECT
 
@@ -93,7 +93,7 @@ public Q_SLOTS:
 
 private Q_SLOTS:
 
-    /// @todo Do we monitor all signals of the source models?
+    void slotModelChanged();
     void slotMapImagesJobResult();
     void slotMapImagesJobData(const QList<ItemListerRecord>& records);
     void slotThumbnailLoaded(const LoadingDescription&, const QPixmap&);
@@ -103,6 +103,7 @@ private Q_SLOTS:
 private:
 
     QList<qlonglong> getTileMarkerIds(const TileIndex& tileIndex);
+    qlonglong getTileRepresentativeId(MyTile* const tile, const int sortKey);
     GeoGroupState getImageState(const qlonglong imageId);
     void removeMarkerFromTileAndChildren(const qlonglong imageId,
                                          const TileIndex& markerTileIndex);
@@ -19,14 +19,26 @@
 // Qt includes
 
 #include <QApplication>
-#include <QDataStream>
+#include <QAtomicInt>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
-#include <QStringList>
+#include <QFuture>
+#include <QList>
+#include <QMap>
+#include <QMessageBox>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QRect>
+#include <QSet>
+#include <QSharedPointer>
 #include <QStandardPaths>
 #include <QStorageInfo>
-#include <QMessageBox>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtConcurrent>
 
 // KDE includes
 
@@ -35,31 +47,517 @@
 // Local includes
 
 #include "digikam_debug.h"
+#include "dimgpixelconverter.h"
+#include "dmemoryinfo.h"
 
 namespace Digikam
 {
 
+namespace
+{
+
+/// Width and height of the tiles compared between two levels.
+const int UNDO_TILE_SIZE = 256;
+
+} // namespace
+
+/**
+ * A cache file holding the tiles moved out of memory at once.
+ * The file is removed when the last tile stored in it is released.
+ */
+class Q_DECL_HIDDEN UndoCacheSegment
+{
+public:
+
+    explicit UndoCacheSegment(const QString& filePath)
+        : path(filePath)
+    {
+    }
+
+    ~UndoCacheSegment()
+    {
+        QFile::remove(path);
+    }
+
+public:
+
+    const QString path;
+
+private:
+
+    Q_DISABLE_COPY(UndoCacheSegment)
+};
+
+/**
+ * The pixels of a tile, shared by all levels where the tile did not change.
+ */
+class Q_DECL_HIDDEN UndoCacheTile
+{
+public:
+
+    UndoCacheTile()
+      : compressed(false),
+        offset    (0),
+        size      (0)
+    {
+    }
+
+    bool isSpilled() const
+    {
+        return !segment.isNull();
+    }
+
+public:
+
+    bool                             compressed;     ///< False when the compression did not reduce the data.
+    QByteArray                       data;           ///< The tile data while kept in memory.
+    QSharedPointer<UndoCacheSegment> segment;        ///< The cache file holding the tile data once spilled.
+    qint64                           offset;
+    int                              size;
+};
+
+typedef QSharedPointer<UndoCacheTile> UndoCacheTilePtr;
+
+class Q_DECL_HIDDEN UndoCacheLevel
+{
+public:
+
+    UndoCacheLevel()
+      : width     (0),
+        height    (0),
+        sixteenBit(false),
+        hasAlpha  (false)
+    {
+    }
+
+    int tilesX() const
+    {
+        return ((width + UNDO_TILE_SIZE - 1) / UNDO_TILE_SIZE);
+    }
+
+    int tilesY() const
+    {
+        return ((height + UNDO_TILE_SIZE - 1) / UNDO_TILE_SIZE);
+    }
+
+    QRect tileRect(int index) const
+    {
+        const int x = (index % tilesX()) * UNDO_TILE_SIZE;
+        const int y = (index / tilesX()) * UNDO_TILE_SIZE;
+
+        return QRect(x, y, qMin(UNDO_TILE_SIZE, width - x), qMin(UNDO_TILE_SIZE, height - y));
+    }
+
+public:
+
+    int                       width;
+    int                       height;
+    bool                      sixteenBit;
+    bool                      hasAlpha;
+    QVector<UndoCacheTilePtr> tiles;
+};
+
+// ------------------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN UndoCache::Private
 {
 public:
 
     explicit Private()
-      : cacheError(false)
+      : cacheError    (false),
+        running       (false),
+        memoryFull    (false),
+        lastLevel     (-1),
+        spillError    (false),
+        segmentCounter(0),
+        memoryBudget  (512 * 1024 * 1024)
     {
+        DMemoryInfo memory;
+
+        if (!memory.isNull())
+        {
+            memoryBudget = qBound((qint64)128 * 1024 * 1024,
+                                  (qint64)(memory.totalPhysical() / 8),
+                                  (qint64)1024 * 1024 * 1024);
+        }
     }
 
-    QString cacheFile(int level) const
+    QString segmentFile(int index) const
     {
-        return QString::fromUtf8("%1-%2.bin").arg(cachePrefix).arg(level);
+        return QString::fromUtf8("%1-%2.bin").arg(cachePrefix).arg(index);
     }
 
-    QString   cacheDir;
-    QString   cachePrefix;
-    QSet<int> cachedLevels;
+    void           waitForIdle();
+    void           run();
+    UndoCacheLevel storeLevel(const DImg& img);
+    void           spill();
+    DImg           restoreLevel(const UndoCacheLevel& level) const;
+
+public:
 
-    bool      cacheError;
+    QString                  cacheDir;
+    QString                  cachePrefix;
+    QSet<int>                cachedLevels;      ///< All levels put in the cache, stored or not yet.
+
+    bool                     cacheError;
+
+    /// The shared state between the main thread and the background thread.
+
+    QMutex                   mutex;
+    QWaitCondition           idle;
+    QList<QPair<int, DImg> > jobs;              ///< The levels waiting to be stored.
+    bool                     running;
+    bool                     memoryFull;
+    int                      lastLevel;
+    DImg                     lastImage;         ///< The image of the last level stored.
+
+    /**
+     * The stored levels. Changed by the background thread while running,
+     * else by the main thread.
+     */
+
+    QMap<int, UndoCacheLevel> levels;
+    QList<int>               levelOrder;        ///< The stored levels, from the oldest to the newest.
+    QVector<UndoCacheTilePtr> lastTiles;        ///< The tiles of lastImage.
+    bool                     spillError;
+    int                      segmentCounter;
+    qint64                   memoryBudget;
 };
 
+void UndoCache::Private::waitForIdle()
+{
+    QMutexLocker lock(&mutex);
+
+    while (running)
+    {
+        idle.wait(&mutex);
+    }
+}
+
+void UndoCache::Private::run()
+{
+    Q_FOREVER
+    {
+        QPair<int, DImg> job;
+
+        {
+            QMutexLocker lock(&mutex);
+
+            if (jobs.isEmpty())
+            {
+                running = false;
+                idle.wakeAll();
+
+                return;
+            }
+
+            // The job stays queued until stored, so getData() can still return it.
+
+            job = jobs.first();
+        }
+
+        const UndoCacheLevel level = storeLevel(job.second);
+
+        {
+            QMutexLocker lock(&mutex);
+
+            jobs.removeFirst();
+            levels.insert(job.first, level);
+            levelOrder.removeAll(job.first);
+            levelOrder << job.first;
+            lastLevel = job.first;
+            lastImage = job.second;
+            lastTiles = level.tiles;
+        }
+
+        spill();
+    }
+}
+
+UndoCacheLevel UndoCache::Private::storeLevel(const DImg& img)
+{
+    UndoCacheLevel level;
+    level.width      = (int)img.width();
+    level.height     = (int)img.height();
+    level.sixteenBit = img.sixteenBit();
+    level.hasAlpha   = img.hasAlpha();
+
+    const int count  = level.tilesX() * level.tilesY();
+    level.tiles.resize(count);
+
+    // Tiles identical to the ones of the previous level are shared, not stored again.
+
+    const bool sameGeometry = (
+                               !lastImage.isNull()                       &&
+                               (lastImage.width()      == img.width())   &&
+                               (lastImage.height()     == img.height())  &&
+                               (lastImage.sixteenBit() == img.sixteenBit())
+                              );
+
+    const int                     bytesDepth   = img.bytesDepth();
+    const qint64                  bytesPerLine = (qint64)level.width * bytesDepth;
+    const uchar* const            bits         = img.bits();
+    const uchar* const            lastBits     = sameGeometry ? lastImage.bits()      : nullptr;
+    const UndoCacheTilePtr* const previous     = sameGeometry ? lastTiles.constData() : nullptr;
+    UndoCacheTilePtr* const       tiles        = level.tiles.data();
+    QAtomicInt                    changed;
+
+    DImgPixelConverter::processRows(UNDO_TILE_SIZE * UNDO_TILE_SIZE, count,
+        [&](int begin, int end)
+        {
+            for (int i = begin ; i < end ; ++i)
+            {
+                const QRect  rect     = level.tileRect(i);
+                const qint64 start    = (qint64)rect.y() * bytesPerLine + (qint64)rect.x() * bytesDepth;
+                const int    rowBytes = rect.width() * bytesDepth;
+
+                if (lastBits)
+                {
+                    bool same = true;
+
+                    for (int y = 0 ; same && (y < rect.height()) ; ++y)
+                    {
+                        const qint64 pos = start + y * bytesPerLine;
+                        same             = (memcmp(bits + pos, lastBits + pos, rowBytes) == 0);
+                    }
+
+                    if (same)
+                    {
+                        tiles[i] = previous[i];
+
+                        continue;
+                    }
+                }
+
+                QByteArray raw(rowBytes * rect.height(), Qt::Uninitialized);
+
+                for (int y = 0 ; y < rect.height() ; ++y)
+                {
+                    memcpy(raw.data() + y * rowBytes, bits + start + y * bytesPerLine, rowBytes);
+                }
+
+                UndoCacheTilePtr tile(new UndoCacheTile);
+
+                // The fastest zlib level: the tiles are written at each edit and read back rarely.
+
+                tile->data       = qCompress(raw, 1);
+                tile->compressed = (tile->data.size() < raw.size());
+
+                if (!tile->compressed)
+                {
+                    tile->data = raw;
+                }
+
+                tile->size       = tile->data.size();
+                tiles[i]         = tile;
+                changed.ref();
+            }
+        }
+    );
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Undo cache: stored" << changed.loadAcquire() << "changed tiles of" << count;
+
+    return level;
+}
+
+void UndoCache::Private::spill()
+{
+    if (spillError)
+    {
+        return;
+    }
+
+    // Keep the tiles of the newest levels in memory up to the budget, the newest level always.
+
+    QSet<const UndoCacheTile*> seen;
+    QVector<UndoCacheTilePtr>  toSpill;
+    qint64                     used = 0;
+
+    for (int i = levelOrder.size() - 1 ; i >= 0 ; --i)
+    {
+        const bool newest = (i == (levelOrder.size() - 1));
+        QMap<int, UndoCacheLevel>::const_iterator it = levels.constFind(levelOrder.at(i));
+
+        if (it == levels.constEnd())
+        {
+            continue;
+        }
+
+        Q_FOREACH (const UndoCacheTilePtr& tile, it.value().tiles)
+        {
+            if (tile->isSpilled() || seen.contains(tile.data()))
+            {
+                continue;
+            }
+
+            seen.insert(tile.data());
+
+            if (newest || ((used + tile->size) <= memoryBudget))
+            {
+                used += tile->size;
+            }
+            else
+            {
+                toSpill << tile;
+            }
+        }
+    }
+
+    {
+        QMutexLocker lock(&mutex);
+        memoryFull = !toSpill.isEmpty();
+    }
+
+    if (toSpill.isEmpty())
+    {
+        return;
+    }
+
+    QSharedPointer<UndoCacheSegment> segment(new UndoCacheSegment(segmentFile(segmentCounter++)));
+    QFile file(segment->path);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot create the undo cache file" << segment->path;
+        spillError = true;
+
+        return;
+    }
+
+    Q_FOREACH (const UndoCacheTilePtr& tile, toSpill)
+    {
+        if (file.write(tile->data) != tile->size)
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot write the undo cache file" << segment->path;
+            spillError = true;
+            file.close();
+
+            return;
+        }
+    }
+
+    file.close();
+
+    qint64 offset = 0;
+
+    Q_FOREACH (const UndoCacheTilePtr& tile, toSpill)
+    {
+        tile->segment = segment;
+        tile->offset  = offset;
+        tile->data    = QByteArray();
+        offset       += tile->size;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Undo cache: moved" << toSpill.size() << "tiles ("
+                                 << offset / 1024 / 1024 << "Mbytes) to" << segment->path;
+}
+
+DImg UndoCache::Private::restoreLevel(const UndoCacheLevel& level) const
+{
+    DImg img(level.width, level.height, level.sixteenBit, level.hasAlpha);
+
+    if (img.isNull())
+    {
+        return DImg();
+    }
+
+    // Read the spilled tiles file by file, then decompress all tiles in parallel.
+
+    const int                                     count = level.tiles.size();
+    QVector<QByteArray>                           data(count);
+    QMap<UndoCacheSegment*, QList<int> >          bySegment;
+
+    for (int i = 0 ; i < count ; ++i)
+    {
+        const UndoCacheTilePtr& tile = level.tiles.at(i);
+
+        if (tile->isSpilled())
+        {
+            bySegment[tile->segment.data()] << i;
+        }
+        else
+        {
+            data[i] = tile->data;
+        }
+    }
+
+    for (QMap<UndoCacheSegment*, QList<int> >::const_iterator it = bySegment.constBegin() ;
+         it != bySegment.constEnd() ; ++it)
+    {
+        QFile file(it.key()->path);
+
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            qCDebug(DIGIKAM_GENERAL_LOG) << "Cannot open the undo cache file" << it.key()->path;
+
+            return DImg();
+        }
+
+        Q_FOREACH (int i, it.value())
+        {
+            const UndoCacheTilePtr& tile = level.tiles.at(i);
+
+            if (!file.seek(tile->offset))
+            {
+                qCDebug(DIGIKAM_GENERAL_LOG) << "The undo cache file is corrupt";
+
+                return DImg();
+            }
+
+            data[i] = file.read(tile->size);
+
+            if (data[i].size() != tile->size)
+            {
+                qCDebug(DIGIKAM_GENERAL_LOG) << "The undo cache file is corrupt";
+
+                return DImg();
+            }
+        }
+    }
+
+    const int          bytesDepth   = img.bytesDepth();
+    const qint64       bytesPerLine = (qint64)level.width * bytesDepth;
+    uchar* const       bits         = img.bits();
+    QAtomicInt         errors;
+
+    DImgPixelConverter::processRows(UNDO_TILE_SIZE * UNDO_TILE_SIZE, count,
+        [&](int begin, int end)
+        {
+            for (int i = begin ; i < end ; ++i)
+            {
+                const QRect      rect     = level.tileRect(i);
+                const qint64     start    = (qint64)rect.y() * bytesPerLine + (qint64)rect.x() * bytesDepth;
+                const int        rowBytes = rect.width() * bytesDepth;
+                const QByteArray raw      = level.tiles.at(i)->compressed ? qUncompress(data.at(i))
+                                                                          : data.at(i);
+
+                if (raw.size() != (rowBytes * rect.height()))
+                {
+                    errors.ref();
+
+                    continue;
+                }
+
+                for (int y = 0 ; y < rect.height() ; ++y)
+                {
+                    memcpy(bits + start + y * bytesPerLine, raw.constData() + y * rowBytes, rowBytes);
+                }
+            }
+        }
+    );
+
+    if (errors.loadAcquire())
+    {
+        qCDebug(DIGIKAM_GENERAL_LOG) << "The undo cache data is corrupt";
+
+        return DImg();
+    }
+
+    return img;
+}
+
+// ------------------------------------------------------------------------------------------------
+
 UndoCache::UndoCache()
     : d(new Private)
 {
@@ -69,6 +567,10 @@ UndoCache::UndoCache()
                      .arg(d->cacheDir)
                      .arg(QCoreApplication::applicationPid());
 
+    // the cache directory may not exist yet
+
+    QDir().mkpath(d->cacheDir);
+
     // remove any remnants
 
     QDir dir(d->cacheDir);
@@ -87,139 +589,167 @@ UndoCache::~UndoCache()
 
 void UndoCache::clear()
 {
-    Q_FOREACH (int level, d->cachedLevels)
-    {
-        QFile(d->cacheFile(level)).remove();
-    }
+    d->waitForIdle();
+
+    // The cache files are removed with the last tile they hold.
 
+    d->levels.clear();
+    d->levelOrder.clear();
+    d->lastTiles.clear();
     d->cachedLevels.clear();
+
+    QMutexLocker lock(&d->mutex);
+    d->lastLevel  = -1;
+    d->lastImage  = DImg();
+    d->memoryFull = false;
 }
 
 void UndoCache::clearFrom(int fromLevel)
 {
+    d->waitForIdle();
+
     Q_FOREACH (int level, d->cachedLevels)
     {
         if (level >= fromLevel)
         {
-            QFile(d->cacheFile(level)).remove();
+            d->levels.remove(level);
+            d->levelOrder.removeAll(level);
             d->cachedLevels.remove(level);
         }
     }
+
+    // The last image is still used to find the tiles changed by the next level.
+
+    QMutexLocker lock(&d->mutex);
+
+    if (d->lastLevel >= fromLevel)
+    {
+        d->lastLevel = -1;
+    }
+}
+
+void UndoCache::setMemoryLimit(qint64 bytes)
+{
+    // The budget is read by the background thread.
+
+    d->waitForIdle();
+    d->memoryBudget = bytes;
 }
 
 bool UndoCache::putData(int level, const DImg& img) const
 {
-    if (d->cacheError)
+    if (d->cacheError || img.isNull() || d->cachedLevels.contains(level))
     {
         return false;
     }
 
-    QStorageInfo info(d->cacheDir);
+    bool memoryFull = false;
 
-    qint64 fspace = (info.bytesAvailable() / 1024 / 1024);
-    qCDebug(DIGIKAM_GENERAL_LOG) << "Free space available in Editor cache [" << d->cacheDir << "] in Mbytes:" << fspace;
+    {
+        QMutexLocker lock(&d->mutex);
+        memoryFull = d->memoryFull;
+    }
+
+    // The disk is only used when the memory budget is exceeded.
 
-    if (fspace < 2048)              // Check if free space is over 2 GiB to put data in cache.
+    if (memoryFull)
     {
-        if (!qApp->activeWindow())  // Special case for the Jenkins build server.
-        {
-            return false;
-        }
+        QStorageInfo info(d->cacheDir);
 
-        QApplication::restoreOverrideCursor();
+        qint64 fspace = (info.bytesAvailable() / 1024 / 1024);
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Free space available in Editor cache [" << d->cacheDir << "] in Mbytes:" << fspace;
 
-        QMessageBox::critical(qApp->activeWindow(), qApp->applicationName(),
-                              i18n("The free disk space in the path \"%1\" for the undo "
-                                   "cache file is less than to 2 GiB! Undo cache is now disabled!",
-                                   QDir::toNativeSeparators(d->cacheDir)));
-        d->cacheError = true;
+        if (fspace < 2048)              // Check if free space is over 2 GiB to put data in cache.
+        {
+            if (!qApp->activeWindow())  // Special case for the Jenkins build server.
+            {
+                return false;
+            }
 
-        return false;
-    }
+            QApplication::restoreOverrideCursor();
 
-    QFile file(d->cacheFile(level));
+            QMessageBox::critical(qApp->activeWindow(), qApp->applicationName(),
+                                  i18n("The free disk space in the path \"%1\" for the undo "
+                                       "cache file is less than to 2 GiB! Undo cache is now disabled!",
+                                       QDir::toNativeSeparators(d->cacheDir)));
+            d->cacheError = true;
 
-    if (file.exists() || !file.open(QIODevice::WriteOnly))
-    {
-        return false;
+            return false;
+        }
     }
 
-    QDataStream ds(&file);
-    ds << img.width();
-    ds << img.height();
-    ds << img.numBytes();
-    ds << img.hasAlpha();
-    ds << img.sixteenBit();
+    // The editor changes its image in place after this call: store a copy.
 
-    file.write((const char*)img.bits(), img.numBytes());
+    const DImg copy = img.copyImageData();
 
-    if (file.error() != QFileDevice::NoError)
     {
-        file.close();
-        file.remove();
+        QMutexLocker lock(&d->mutex);
+        d->jobs << qMakePair(level, copy);
 
-        return false;
+        if (!d->running)
+        {
+            d->running          = true;
+            Private* const priv = d;
+
+            QtConcurrent::run([priv]()
+                {
+                    priv->run();
+                }
+            );
+        }
     }
 
     d->cachedLevels << level;
 
-    file.close();
-
     return true;
 }
 
 DImg UndoCache::getData(int level) const
 {
-    uint w             = 0;
-    uint h             = 0;
-    quint64 numBytes   = 0;
-    bool    hasAlpha   = false;
-    bool    sixteenBit = false;
-
-    QFile file(d->cacheFile(level));
-
-    if (!file.open(QIODevice::ReadOnly))
+    if (!d->cachedLevels.contains(level))
     {
         return DImg();
     }
 
-    QDataStream ds(&file);
-    ds >> w;
-    ds >> h;
-    ds >> numBytes;
-    ds >> hasAlpha;
-    ds >> sixteenBit;
+    DImg img;
 
-    if (ds.status() != QDataStream::Ok || ds.atEnd())
     {
-        qCDebug(DIGIKAM_GENERAL_LOG) << "The undo cache file is corrupt";
+        // The levels not yet stored, and the last one stored, are available without decompression.
 
-        file.close();
+        QMutexLocker lock(&d->mutex);
 
-        return DImg();
-    }
+        for (int i = d->jobs.size() - 1 ; i >= 0 ; --i)
+        {
+            if (d->jobs.at(i).first == level)
+            {
+                img = d->jobs.at(i).second;
+                break;
+            }
+        }
 
-    DImg img(w, h, sixteenBit, hasAlpha);
+        if (img.isNull() && (d->lastLevel == level))
+        {
+            img = d->lastImage;
+        }
+    }
 
-    if (img.isNull() || (numBytes != img.numBytes()))
+    if (!img.isNull())
     {
-        file.close();
+        // The caller can change the returned image.
 
-        return DImg();
+        return img.copyImageData();
     }
 
-    qint64 readBytes = file.read((char*)img.bits(), numBytes);
+    d->waitForIdle();
 
-    if ((file.error() != QFileDevice::NoError) || ((quint64)readBytes != numBytes))
-    {
-        file.close();
+    QMap<int, UndoCacheLevel>::const_iterator it = d->levels.constFind(level);
 
+    if (it == d->levels.constEnd())
+    {
         return DImg();
     }
 
-    file.close();
-
-    return img;
+    return d->restoreLevel(it.value());
 }
 
 } // namespace Digikam
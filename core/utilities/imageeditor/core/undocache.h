@@ -25,6 +25,14 @@
 namespace Digikam
 {
 
+/**
+ * Stores the image data of the undo levels.
+ *
+ * The images are cut in tiles and only the tiles changed since the previous level are
+ * stored, compressed. This work is done in a background thread: putData() only takes a
+ * copy of the image. The compressed tiles of the most recent levels are kept in memory,
+ * the older ones are moved to cache files when the memory budget is exceeded.
+ */
 class DIGIKAM_EXPORT UndoCache
 {
 
@@ -34,22 +42,30 @@ public:
     ~UndoCache();
 
     /**
-     * Delete all cache files
+     * Delete all cached levels and cache files
      */
     void clear();
 
     /**
-     * Delete all cache files starting from the given level upwards
+     * Delete all cached levels starting from the given level upwards
      */
     void clearFrom(int level);
 
     /**
-     * Write the image data into a cache file
+     * Set the size in bytes of the compressed tiles kept in memory.
+     * The tiles of the older levels over this size are moved to the cache files.
+     * The default depends on the physical memory size.
+     */
+    void setMemoryLimit(qint64 bytes);
+
+    /**
+     * Queue the image data to be stored in the cache.
+     * Returns false if the level is already cached or if the cache is disabled.
      */
     bool putData(int level, const DImg& img) const;
 
     /**
-     * Get the image data from a cache file
+     * Get the image data of a level, waiting for the level to be stored if needed
      */
     DImg getData(int level)                  const;
 
@@ -20,6 +20,7 @@
 #include <QApplication>
 #include <QPainter>
 #include <QPixmap>
+#include <QSharedPointer>
 
 // Local includes
 
@@ -44,112 +45,82 @@ ImagePreviewItem::~ImagePreviewItem()
 {
 }
 
-void ImagePreviewItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+DImgTileRenderer::TileConverter ImagePreviewItem::tileConverter(QWidget* const widget) const
 {
-    Q_D(GraphicsDImgItem);
+    Q_D(const GraphicsDImgItem);
+
+    // TODO: factoring ICC settings code using ImageIface/EditorCore methods.
+
+    // Apply CM settings.
 
-    QRect   drawRect     = option->exposedRect.intersected(boundingRect()).toAlignedRect();
-    QRect   pixSourceRect;
-    QPixmap pix;
-    QSize   completeSize = boundingRect().size().toSize();
-
-    /*
-     * For high resolution ("retina") displays, Mac OS X / Qt
-     * report only half of the physical resolution in terms of
-     * pixels, i.e. every logical pixels corresponds to 2x2
-     * physical pixels. However, UI elements and fonts are
-     * nevertheless rendered at full resolution, and pixmaps
-     * as well, provided their resolution is high enough (that
-     * is, higher than the reported, logical resolution).
-     *
-     * To work around this, we render the photos not a logical
-     * resolution, but with the photo's full resolution, but
-     * at the screen's aspect ratio. When we later draw this
-     * high resolution bitmap, it is up to Qt to scale the
-     * photo to the true physical resolution.  The ratio
-     * computed below is the ratio between the photo and
-     * screen resolutions, or equivalently the factor by which
-     * we need to increase the pixel size of the rendered
-     * pixmap.
-     */
-
-    double ratio          = qApp->devicePixelRatio();
-
-    QRect  scaledDrawRect = QRectF(ratio * drawRect.x(),
-                                   ratio * drawRect.y(),
-                                   ratio * drawRect.width(),
-                                   ratio * drawRect.height()).toRect();
-
-    // scale "as if" scaling to whole image, but clip output to our exposed region
-
-    QSize scaledCompleteSize = QSizeF(ratio * completeSize.width(),
-                                      ratio * completeSize.height()).toSize();
-    DImg scaledImage         = d->image.smoothScaleClipped(scaledCompleteSize.width(),
-                                                           scaledCompleteSize.height(),
-                                                           scaledDrawRect.x(),
-                                                           scaledDrawRect.y(),
-                                                           scaledDrawRect.width(),
-                                                           scaledDrawRect.height());
-
-    if (d->cachedPixmaps.find(scaledDrawRect, &pix, &pixSourceRect))
+    bool doSoftProofing              = EditorCore::defaultInstance()->softProofingEnabled();
+    ICCSettingsContainer iccSettings = EditorCore::defaultInstance()->getICCSettings();
+    IccTransform monitorICCtrans;
+
+    if (iccSettings.enableCM && (iccSettings.useManagedView || doSoftProofing))
     {
-        if (pixSourceRect.isNull())
+        IccManager manager(d->image);
+
+        if (doSoftProofing)
         {
-            painter->drawPixmap(drawRect, pix);
+            monitorICCtrans = manager.displaySoftProofingTransform(IccProfile(iccSettings.defaultProofProfile), widget);
         }
         else
         {
-            painter->drawPixmap(drawRect, pix, pixSourceRect);
+            monitorICCtrans = manager.displayTransform(widget);
         }
     }
-    else
+
+    // The tiles are rendered in other threads: take a copy of the Over/Under exposure settings.
+
+    QSharedPointer<ExposureSettingsContainer> expoSettings;
+    ExposureSettingsContainer* const current = EditorCore::defaultInstance()->getExposureSettings();
+
+    if (current && (current->underExposureIndicator || current->overExposureIndicator))
+    {
+        expoSettings = QSharedPointer<ExposureSettingsContainer>(new ExposureSettingsContainer);
+        expoSettings->underExposureIndicator = current->underExposureIndicator;
+        expoSettings->overExposureIndicator  = current->overExposureIndicator;
+        expoSettings->exposureIndicatorMode  = current->exposureIndicatorMode;
+        expoSettings->underExposurePercent   = current->underExposurePercent;
+        expoSettings->overExposurePercent    = current->overExposurePercent;
+        expoSettings->underExposureColor     = current->underExposureColor;
+        expoSettings->overExposureColor      = current->overExposureColor;
+    }
+
+    return [monitorICCtrans, expoSettings](const DImg& scaledImage)
     {
-        // TODO: factoring ICC settings code using ImageIface/EditorCore methods.
+        // Show the Over/Under exposure pixels indicators, computed before the display transform.
 
-        // Apply CM settings.
+        QImage pureColorMask;
 
-        bool doSoftProofing              = EditorCore::defaultInstance()->softProofingEnabled();
-        ICCSettingsContainer iccSettings = EditorCore::defaultInstance()->getICCSettings();
+        if (expoSettings)
+        {
+            pureColorMask = scaledImage.pureColorMask(expoSettings.data());
+        }
+
+        QImage image;
 
-        if (iccSettings.enableCM && (iccSettings.useManagedView || doSoftProofing))
+        if (monitorICCtrans.outputProfile().isNull())
         {
-            IccManager   manager(scaledImage);
-            IccTransform monitorICCtrans;
-
-            if (doSoftProofing)
-            {
-                monitorICCtrans = manager.displaySoftProofingTransform(IccProfile(iccSettings.defaultProofProfile), widget);
-            }
-            else
-            {
-                monitorICCtrans = manager.displayTransform(widget);
-            }
-
-            pix = scaledImage.convertToPixmap(monitorICCtrans);
+            image = DImgTileRenderer::toQImage(scaledImage);
         }
         else
         {
-            pix = scaledImage.convertToPixmap();
+            DImg         img       = scaledImage.copy();
+            IccTransform transform = monitorICCtrans;
+            transform.apply(img);
+            image                  = DImgTileRenderer::toQImage(img);
         }
 
-        d->cachedPixmaps.insert(scaledDrawRect, pix);
-
-        painter->drawPixmap(drawRect, pix);
-    }
-
-    // Show the Over/Under exposure pixels indicators
-
-    ExposureSettingsContainer* const expoSettings = EditorCore::defaultInstance()->getExposureSettings();
-
-    if (expoSettings)
-    {
-        if (expoSettings->underExposureIndicator || expoSettings->overExposureIndicator)
+        if (!pureColorMask.isNull())
         {
-            QImage pureColorMask = scaledImage.pureColorMask(expoSettings);
-            QPixmap pixMask      = QPixmap::fromImage(pureColorMask);
-            painter->drawPixmap(drawRect, pixMask);
+            QPainter p(&image);
+            p.drawImage(0, 0, pureColorMask);
         }
-    }
+
+        return image;
+    };
 }
 
 } // namespace Digikam
@@ -36,9 +36,9 @@ public:
     explicit ImagePreviewItem();
     ~ImagePreviewItem()         override;
 
-    void paint(QPainter* painter,
-               const QStyleOptionGraphicsItem* option,
-               QWidget* widget) override;
+protected:
+
+    DImgTileRenderer::TileConverter tileConverter(QWidget* const widget) const override;
 
 private:
 
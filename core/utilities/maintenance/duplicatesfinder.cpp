@@ -50,6 +50,7 @@ public:
         searchResultRestriction(0),
         refSelMethod           (HaarIface::RefImageSelMethod::OlderOrLarger),
         isAlbumUpdate          (false),
+        nearDuplicatesSearch   (false),
         job                    (nullptr)
     {
     }
@@ -60,6 +61,7 @@ public:
     int                          searchResultRestriction;
     HaarIface::RefImageSelMethod refSelMethod;
     bool                         isAlbumUpdate;
+    bool                         nearDuplicatesSearch;
     QList<int>                   albumsIdList;
     QList<int>                   tagsIdList;
     QList<int>                   referenceAlbumsList;
@@ -105,6 +107,11 @@ DuplicatesFinder::~DuplicatesFinder()
     delete d;
 }
 
+void DuplicatesFinder::setNearDuplicatesSearch(bool b)
+{
+    d->nearDuplicatesSearch = b;
+}
+
 void DuplicatesFinder::slotStart()
 {
     MaintenanceTool::slotStart();
@@ -142,6 +149,7 @@ void DuplicatesFinder::slotStart()
     jobInfo.setMinThreshold(minThresh);
     jobInfo.setMaxThreshold(maxThresh);
     jobInfo.setSearchResultRestriction(d->searchResultRestriction);
+    jobInfo.setNearDuplicatesSearch(d->nearDuplicatesSearch);
 
     d->job = DBJobsManager::instance()->startSearchesJobThread(jobInfo);
 
@@ -176,6 +184,7 @@ void DuplicatesFinder::slotDone()
     ApplicationSettings::instance()->setDuplicatesSearchLastMaxSimilarity(d->maxSimilarity);
     ApplicationSettings::instance()->setDuplicatesAlbumTagRelation(d->albumTagRelation);
     ApplicationSettings::instance()->setDuplicatesSearchRestrictions(d->searchResultRestriction);
+    ApplicationSettings::instance()->setDuplicatesNearDuplicatesSearch(d->nearDuplicatesSearch);
 
     d->job = nullptr;
     MaintenanceTool::slotDone();
@@ -51,6 +51,11 @@ public:
 
     ~DuplicatesFinder() override;
 
+    /**
+     * Only compare the Haar signatures of the images with a close perceptual hash.
+     */
+    void setNearDuplicatesSearch(bool b);
+
 private Q_SLOTS:
 
     void slotStart() override;
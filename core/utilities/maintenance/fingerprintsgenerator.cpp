@@ -45,11 +45,13 @@ public:
 
     explicit Private()
       : rebuildAll(true),
-        thread(nullptr)
+        scanHashes(false),
+        thread    (nullptr)
     {
     }
 
     bool               rebuildAll;
+    bool               scanHashes;
 
     AlbumList          albumList;
 
@@ -81,6 +83,11 @@ void FingerPrintsGenerator::setUseMultiCoreCPU(bool b)
     d->thread->setUseMultiCore(b);
 }
 
+void FingerPrintsGenerator::setScanPerceptualHashes(bool b)
+{
+    d->scanHashes = b;
+}
+
 void FingerPrintsGenerator::slotCancel()
 {
     d->thread->cancel();
@@ -129,7 +136,7 @@ void FingerPrintsGenerator::slotStart()
 
     setTotalItems(itemIds.count());
 
-    d->thread->generateFingerprints(itemIds, d->rebuildAll);
+    d->thread->generateFingerprints(itemIds, d->rebuildAll, d->scanHashes);
     d->thread->start();
 }
 
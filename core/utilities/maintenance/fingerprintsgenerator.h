@@ -42,6 +42,11 @@ public:
 
     void setUseMultiCoreCPU(bool b) override;
 
+    /** Also computes the fingerprints of the images indexed without perceptual hash,
+     *  used by the near duplicates search. Disabled by default.
+     */
+    void setScanPerceptualHashes(bool b);
+
 private:
 
     void processOne();
@@ -24,7 +24,10 @@
 #include "dimg.h"
 #include "haar.h"
 #include "haariface.h"
+#include "perceptualhash.h"
 #include "previewloadthread.h"
+#include "thumbnailloadthread.h"
+#include "thumbnailsize.h"
 #include "maintenancedata.h"
 #include "similaritydb.h"
 #include "similaritydbaccess.h"
@@ -32,17 +35,33 @@
 namespace Digikam
 {
 
+/// One fingerprint computed from the thumbnail is checked against the decoded preview every SAMPLE_INTERVAL images.
+static const int SAMPLE_INTERVAL       = 100;
+
+/// Maximum Hamming distance between the perceptual hashes of the thumbnail and of the preview.
+static const int CONSISTENCY_DISTANCE  = 6;
+
+/// Number of failed checks after which the thumbnails are not used anymore by the task.
+static const int MAX_FAILED_CHECKS     = 3;
+
 class Q_DECL_HIDDEN FingerprintsTask::Private
 {
 public:
 
     explicit Private()
-        : data(nullptr)
+        : data         (nullptr),
+          useThumbnails(true),
+          processed    (0),
+          failedChecks (0)
     {
     }
 
     MaintenanceData* data;
     QImage           okImage;
+
+    bool             useThumbnails;
+    int              processed;
+    int              failedChecks;
 };
 
 // -------------------------------------------------------
@@ -91,18 +110,67 @@ void FingerprintsTask::run()
             !info.filePath().isEmpty()                                    &&
             !m_cancel                                                     &&
             (d->data->getRebuildAllFingerprints()                         ||
-             SimilarityDbAccess().db()->hasDirtyOrMissingFingerprint(info)))
+             SimilarityDbAccess().db()->hasDirtyOrMissingFingerprint(info) ||
+             (d->data->getScanPerceptualHashes()                          &&
+              SimilarityDbAccess().db()->hasMissingPerceptualHash(info))))
         {
             qCDebug(DIGIKAM_GENERAL_LOG) << "Updating fingerprints for file:" << info.filePath();
 
-            DImg dimg = PreviewLoadThread::loadFastSynchronously(info.filePath(),
-                                                                 HaarIface::preferredSize());
+            HaarIface haarIface;
+            DImg      dimg;
+
+            if (d->useThumbnails)
+            {
+                // The Haar input is only 128x128 pixels: the stored thumbnail is large enough,
+                // and avoids the decoding of RAW and large files.
+
+                ThumbnailIdentifier identifier(info.filePath());
+                identifier.id = info.id();
+                QImage thumb  = ThumbnailLoadThread::loadThumbnailSynchronously(identifier, ThumbnailSize::Huge);
+
+                if (!thumb.isNull())
+                {
+                    dimg = DImg(thumb);
+                }
+
+                if (!dimg.isNull() && ((d->processed++ % SAMPLE_INTERVAL) == 0))
+                {
+                    DImg preview = PreviewLoadThread::loadFastSynchronously(info.filePath(),
+                                                                            HaarIface::preferredSize());
+
+                    if (!preview.isNull())
+                    {
+                        const int distance = PerceptualHash::hammingDistance(haarIface.perceptualHash(dimg),
+                                                                             haarIface.perceptualHash(preview));
+
+                        if (distance > CONSISTENCY_DISTANCE)
+                        {
+                            qCWarning(DIGIKAM_GENERAL_LOG) << "Thumbnail of" << info.filePath()
+                                                           << "differs from the image, distance:" << distance;
+
+                            dimg = preview;
+
+                            if (++d->failedChecks >= MAX_FAILED_CHECKS)
+                            {
+                                qCWarning(DIGIKAM_GENERAL_LOG) << "Fingerprints are computed from the decoded images";
+
+                                d->useThumbnails = false;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (dimg.isNull())
+            {
+                dimg = PreviewLoadThread::loadFastSynchronously(info.filePath(),
+                                                                HaarIface::preferredSize());
+            }
 
             if (!dimg.isNull())
             {
                 // compute Haar fingerprint and store it to DB
 
-                HaarIface haarIface;
                 haarIface.indexImage(info.id(), dimg);
             }
 
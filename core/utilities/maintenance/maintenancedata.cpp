@@ -30,7 +30,8 @@ class Q_DECL_HIDDEN MaintenanceData::Private
 public:
 
     explicit Private()
-      : rebuildAllFingerprints(true)
+      : rebuildAllFingerprints(true),
+        scanPerceptualHashes  (false)
     {
     }
 
@@ -42,6 +43,7 @@ public:
     QList<qlonglong> similarityImageIdList;
 
     bool             rebuildAllFingerprints;
+    bool             scanPerceptualHashes;
 
     QMutex           mutex;
 };
@@ -91,6 +93,11 @@ void MaintenanceData::setRebuildAllFingerprints(bool b)
     d->rebuildAllFingerprints = b;
 }
 
+void MaintenanceData::setScanPerceptualHashes(bool b)
+{
+    d->scanPerceptualHashes = b;
+}
+
 qlonglong MaintenanceData::getImageId() const
 {
     QMutexLocker locker(&d->mutex);
@@ -180,4 +187,9 @@ bool MaintenanceData::getRebuildAllFingerprints() const
     return d->rebuildAllFingerprints;
 }
 
+bool MaintenanceData::getScanPerceptualHashes() const
+{
+    return d->scanPerceptualHashes;
+}
+
 } // namespace Digikam
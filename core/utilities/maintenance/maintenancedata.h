@@ -44,6 +44,7 @@ public:
     void      setSimilarityImageIds(const QList<qlonglong>& ids);
 
     void      setRebuildAllFingerprints(bool b);
+    void      setScanPerceptualHashes(bool b);
 
     qlonglong getImageId()                const;
     int       getThumbnailId()            const;
@@ -53,6 +54,7 @@ public:
     qlonglong getSimilarityImageId()      const;
 
     bool      getRebuildAllFingerprints() const;
+    bool      getScanPerceptualHashes()   const;
 
 private:
 
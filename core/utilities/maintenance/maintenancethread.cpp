@@ -40,6 +40,7 @@ MaintenanceThread::MaintenanceThread(QObject* const parent)
       data(new MaintenanceData)
 {
     setObjectName(QLatin1String("MaintenanceThread"));
+    setPriorityClass(ThreadManager::Maintenance);
 
     connect(this, SIGNAL(finished()),
             this, SLOT(slotThreadFinished()));
@@ -112,12 +113,13 @@ void MaintenanceThread::generateThumbs(const QStringList& paths)
     appendJobs(collection);
 }
 
-void MaintenanceThread::generateFingerprints(const QList<qlonglong>& itemIds, bool rebuildAll)
+void MaintenanceThread::generateFingerprints(const QList<qlonglong>& itemIds, bool rebuildAll, bool scanHashes)
 {
     ActionJobCollection collection;
 
     data->setImageIds(itemIds);
     data->setRebuildAllFingerprints(rebuildAll);
+    data->setScanPerceptualHashes(scanHashes);
 
     for (int i = 1 ; i <= (maximumNumberOfThreads()) ; ++i)
     {
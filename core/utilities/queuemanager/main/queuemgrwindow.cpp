@@ -248,8 +248,8 @@ void QueueMgrWindow::setupConnections()
     connect(d->thread, SIGNAL(signalFinished(Digikam::ActionData)),
             this, SLOT(slotAction(Digikam::ActionData)));
 
-    connect(d->thread, SIGNAL(signalQueueProcessed()),
-            this, SLOT(slotQueueProcessed()));
+    connect(d->thread, SIGNAL(signalQueueProcessed(int)),
+            this, SLOT(slotQueueProcessed(int)));
 
     // -- GUI connections ---------------------------------------------------
 
@@ -614,7 +614,6 @@ void QueueMgrWindow::populateToolsList()
 
 void QueueMgrWindow::slotRun()
 {
-    d->currentQueueToProcess   = d->queuePool->currentIndex();
     QueueListView* const queue = d->queuePool->currentQueue();
     QString msg;
 
@@ -658,13 +657,11 @@ void QueueMgrWindow::slotRun()
     busy(true);
 
     d->processingAllQueues = false;
-    processOneQueue();
+    processQueues(QList<int>() << d->queuePool->currentIndex());
 }
 
 void QueueMgrWindow::slotRunAll()
 {
-    d->currentQueueToProcess = 0;
-
     if (!d->queuePool->totalPendingItems())
     {
         QMessageBox::critical(this, qApp->applicationName(), i18n("There are no items to process in the queues."));
@@ -697,8 +694,22 @@ void QueueMgrWindow::slotRunAll()
     d->toolsView->showTab(ToolsView::HISTORY);
     busy(true);
 
+    // All queues with pending items are processed at the same time.
+
+    QList<int> queueIds;
+
+    for (int i = 0 ; i < d->queuePool->count() ; ++i)
+    {
+        QueueListView* const queue = d->queuePool->findQueueByIndex(i);
+
+        if (queue && queue->pendingItemsCount())
+        {
+            queueIds << i;
+        }
+    }
+
     d->processingAllQueues = true;
-    processOneQueue();
+    processQueues(queueIds);
 }
 
 void QueueMgrWindow::processingAborted()
@@ -709,37 +720,38 @@ void QueueMgrWindow::processingAborted()
     refreshStatusBar();
 }
 
-void QueueMgrWindow::processOneQueue()
+void QueueMgrWindow::processQueues(const QList<int>& queueIds)
 {
     d->assignedList->reset();
 
-    d->queuePool->setCurrentIndex(d->currentQueueToProcess);
-    QueuePoolItemsList itemsList = d->queuePool->queueItemsList(d->currentQueueToProcess);
-    QueueSettings settings       = d->queuePool->currentQueue()->settings();
+    // The target albums of all queues are checked before to start.
 
-    if (!checkTargetAlbum(d->currentQueueToProcess))
+    Q_FOREACH (int queueId, queueIds)
     {
-        processingAborted();
-        return;
+        if (!checkTargetAlbum(queueId))
+        {
+            processingAborted();
+            return;
+        }
     }
 
-    QList<AssignedBatchTools> tools4Items;
-
-    Q_FOREACH (const ItemInfoSet& item, itemsList)
+    Q_FOREACH (int queueId, queueIds)
     {
-        AssignedBatchTools one         = d->queuePool->currentQueue()->assignedTools();
-        one.m_itemUrl                  = item.info.fileUrl();
-        QueueListViewItem* const cItem = d->queuePool->currentQueue()->findItemByUrl(one.m_itemUrl);
-        one.m_destFileName             = cItem->destFileName();
-        tools4Items.append(one);
-    }
+        QueueListView* const queue   = d->queuePool->findQueueByIndex(queueId);
+        QueuePoolItemsList itemsList = d->queuePool->queueItemsList(queueId);
+        QList<AssignedBatchTools> tools4Items;
 
-    d->thread->setSettings(settings);
-    d->thread->processQueueItems(tools4Items);
+        Q_FOREACH (const ItemInfoSet& item, itemsList)
+        {
+            AssignedBatchTools one         = queue->assignedTools();
+            one.m_itemUrl                  = item.info.fileUrl();
+            QueueListViewItem* const cItem = queue->findItemByUrl(one.m_itemUrl);
+            one.m_destFileName             = cItem->destFileName();
+            tools4Items.append(one);
+        }
 
-    if (!d->thread->isRunning())
-    {
-        d->thread->start();
+        d->queuesInProgress << queueId;
+        d->thread->processQueueItems(tools4Items, queue->settings(), queueId);
     }
 }
 
@@ -890,7 +902,8 @@ void QueueMgrWindow::slotHistoryEntryClicked(int queueId, qlonglong itemId)
 
 void QueueMgrWindow::slotAction(const ActionData& ad)
 {
-    QueueListViewItem* const cItem = d->queuePool->currentQueue()->findItemByUrl(ad.fileUrl);
+    QueueListView* const queue     = d->queuePool->findQueueByIndex(ad.queueId);
+    QueueListViewItem* const cItem = queue ? queue->findItemByUrl(ad.fileUrl) : nullptr;
 
     switch (ad.status)
     {
@@ -899,10 +912,10 @@ void QueueMgrWindow::slotAction(const ActionData& ad)
             if (cItem)
             {
                 cItem->reset();
-                d->queuePool->currentQueue()->setCurrentItem(cItem);
-                d->queuePool->currentQueue()->scrollToItem(cItem);
+                queue->setCurrentItem(cItem);
+                queue->scrollToItem(cItem);
                 d->queuePool->setItemBusy(cItem->info().id());
-                addHistoryMessage(cItem, i18n("Processing..."), DHistoryView::StartingEntry);
+                addHistoryMessage(ad.queueId, cItem, i18n("Processing..."), DHistoryView::StartingEntry);
             }
 
             break;
@@ -915,7 +928,7 @@ void QueueMgrWindow::slotAction(const ActionData& ad)
             {
                 cItem->setDestFileName(ad.destUrl.fileName());
                 cItem->setDone();
-                addHistoryMessage(cItem, ad.message, DHistoryView::SuccessEntry);
+                addHistoryMessage(ad.queueId, cItem, ad.message, DHistoryView::SuccessEntry);
                 d->statusProgressBar->setProgressValue(d->statusProgressBar->progressValue() + 1);
             }
 
@@ -927,8 +940,8 @@ void QueueMgrWindow::slotAction(const ActionData& ad)
             if (cItem)
             {
                 cItem->setFailed();
-                addHistoryMessage(cItem, i18n("Failed to process item..."), DHistoryView::ErrorEntry);
-                addHistoryMessage(cItem, ad.message, DHistoryView::ErrorEntry);
+                addHistoryMessage(ad.queueId, cItem, i18n("Failed to process item..."), DHistoryView::ErrorEntry);
+                addHistoryMessage(ad.queueId, cItem, ad.message, DHistoryView::ErrorEntry);
                 d->statusProgressBar->setProgressValue(d->statusProgressBar->progressValue() + 1);
             }
 
@@ -940,7 +953,7 @@ void QueueMgrWindow::slotAction(const ActionData& ad)
             if (cItem)
             {
                 cItem->setCanceled();
-                addHistoryMessage(cItem, i18n("Process Cancelled..."), DHistoryView::CancelEntry);
+                addHistoryMessage(ad.queueId, cItem, i18n("Process Cancelled..."), DHistoryView::CancelEntry);
                 d->statusProgressBar->setProgressValue(d->statusProgressBar->progressValue() + 1);
             }
 
@@ -954,12 +967,12 @@ void QueueMgrWindow::slotAction(const ActionData& ad)
     }
 }
 
-void QueueMgrWindow::addHistoryMessage(QueueListViewItem* const cItem, const QString& msg, DHistoryView::EntryType type)
+void QueueMgrWindow::addHistoryMessage(int queueId, QueueListViewItem* const cItem,
+                                       const QString& msg, DHistoryView::EntryType type)
 {
     if (cItem)
     {
         int itemId   = cItem->info().id();
-        int queueId  = d->queuePool->currentIndex();
         QString text = i18n("Item \"%1\" from queue \"%2\": %3", cItem->info().name(),
                             d->queuePool->queueTitle(queueId), msg);
         d->toolsView->addHistoryEntry(text, type, queueId, itemId);
@@ -973,37 +986,48 @@ void QueueMgrWindow::addHistoryMessage(QueueListViewItem* const cItem, const QSt
 void QueueMgrWindow::slotStop()
 {
     d->thread->cancel();
-    d->queuePool->currentQueue()->cancelItems();
+
+    Q_FOREACH (int queueId, d->queuesInProgress)
+    {
+        QueueListView* const queue = d->queuePool->findQueueByIndex(queueId);
+
+        if (queue)
+        {
+            queue->cancelItems();
+        }
+    }
+
+    d->queuesInProgress.clear();
     processingAborted();
 }
 
-void QueueMgrWindow::slotQueueProcessed()
+void QueueMgrWindow::slotQueueProcessed(int queueId)
 {
-    if (!d->busy)
+    if (!d->busy || !d->queuesInProgress.contains(queueId))
     {
         return;
     }
 
-    d->currentQueueToProcess++;
-    QString msg;
+    d->queuesInProgress.remove(queueId);
 
-    if      (!d->processingAllQueues)
-    {
-        msg = i18n("Batch queue finished");
-    }
-    else if (d->currentQueueToProcess == d->queuePool->count())
-    {
-        msg = i18n("All batch queues finished");
-    }
-    else
-    {
-        // We will process next queue from the pool.
+    const QueueStatistics stats = d->thread->queueStatistics(queueId);
 
-        processOneQueue();
+    addHistoryMessage(queueId, nullptr,
+                      i18n("Queue \"%1\" finished: %2 items processed, %3 failed in %4 s (%5 items by minute)",
+                           d->queuePool->queueTitle(queueId),
+                           stats.processed, stats.failed,
+                           QString::number(stats.elapsed / 1000.0, 'f', 1),
+                           QString::number(stats.itemsPerMinute(), 'f', 1)),
+                      DHistoryView::SuccessEntry);
 
+    if (!d->queuesInProgress.isEmpty())
+    {
         return;
     }
 
+    QString msg = d->processingAllQueues ? i18n("All batch queues finished")
+                                         : i18n("Batch queue finished");
+
     DNotificationWrapper(QLatin1String("batchqueuecompleted"), msg, this,
                          windowTitle());
     processingAborted();
@@ -105,13 +105,14 @@ private:
     void refreshStatusBar();
     void populateToolsList();
     void setup(Setup::Page page);
-    void addHistoryMessage(QueueListViewItem* const cItem,
+    void addHistoryMessage(int queueId,
+                           QueueListViewItem* const cItem,
                            const QString& msg,
                            DHistoryView::EntryType type);
 
     bool checkTargetAlbum(int queueId);
     void busy(bool busy);
-    void processOneQueue();
+    void processQueues(const QList<int>& queueIds);
     void processingAborted();
 
     QueueMgrWindow();
@@ -127,7 +128,7 @@ private Q_SLOTS:
     void slotAssignedToolsChanged(const AssignedBatchTools&);
     void slotQueueContentsChanged();
     void slotItemSelectionChanged();
-    void slotQueueProcessed();
+    void slotQueueProcessed(int queueId);
     void slotSaveWorkflow();
 
 private:
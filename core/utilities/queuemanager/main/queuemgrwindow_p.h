@@ -34,6 +34,7 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QApplication>
+#include <QSet>
 
 // KDE includes
 
@@ -102,7 +103,6 @@ public:
     explicit Private()
         : busy                          (false),
           processingAllQueues           (false),
-          currentQueueToProcess         (0),
           statusLabel                   (nullptr),
           clearQueueAction              (nullptr),
           removeItemsSelAction          (nullptr),
@@ -140,7 +140,8 @@ public:
     bool                     busy;
     bool                     processingAllQueues;
 
-    int                      currentQueueToProcess;
+    /// The queues processed at the same time by the thread.
+    QSet<int>                queuesInProgress;
 
     QLabel*                  statusLabel;
 
@@ -46,7 +46,8 @@ public:
 
     explicit ActionData()
         : status (None),
-          noWrite(false)
+          noWrite(false),
+          queueId(-1)
     {
     }
 
@@ -58,6 +59,9 @@ public:
     QUrl         destUrl;
 
     bool         noWrite;
+
+    /// The index of the queue hosting the item in the queue pool.
+    int          queueId;
 };
 
 } // namespace Digikam
@@ -15,6 +15,18 @@
 
 #include "actionthread.h"
 
+// Qt includes
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMetaObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSharedPointer>
+
 // Local includes
 
 #include "digikam_debug.h"
@@ -22,20 +34,113 @@
 #include "collectionscanner.h"
 #include "scancontroller.h"
 #include "metadatahub.h"
+#include "dmemoryinfo.h"
+#include "queuescheduler.h"
+#include "threadmanager.h"
 #include "task.h"
 
 namespace Digikam
 {
 
+class Q_DECL_HIDDEN ActionThreadQueue
+{
+public:
+
+    QueueSettings   settings;
+    QueueStatistics statistics;
+    QElapsedTimer   timer;
+};
+
+/**
+ * The ActionThread receiving the memory estimates, reset when it is destroyed.
+ */
+class Q_DECL_HIDDEN ActionThreadReceiver
+{
+public:
+
+    QMutex        mutex;
+    ActionThread* thread = nullptr;
+};
+
+/**
+ * Estimates the memory used by a list of items on a job thread, as it queries
+ * the database for each item, and sends the estimates to the ActionThread.
+ */
+class Q_DECL_HIDDEN ActionThreadEstimate : public QRunnable
+{
+public:
+
+    ActionThreadEstimate(const QSharedPointer<ActionThreadReceiver>& receiver, int batch,
+                         const QList<AssignedBatchTools>& items, const QueueSettings& settings)
+        : m_receiver(receiver),
+          m_batch   (batch),
+          m_items   (items),
+          m_settings(settings)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        QList<qlonglong> memory;
+
+        Q_FOREACH (const AssignedBatchTools& item, m_items)
+        {
+            memory << Task::estimateMemory(item, m_settings);
+        }
+
+        QMutexLocker lock(&m_receiver->mutex);
+
+        if (m_receiver->thread)
+        {
+            QMetaObject::invokeMethod(m_receiver->thread, "slotMemoryEstimated", Qt::QueuedConnection,
+                                      Q_ARG(int, m_batch), Q_ARG(QList<qlonglong>, memory));
+        }
+    }
+
+private:
+
+    QSharedPointer<ActionThreadReceiver> m_receiver;
+    int                                  m_batch;
+    QList<AssignedBatchTools>            m_items;
+    QueueSettings                        m_settings;
+};
+
+// --------------------------------------------------------------------------------------
+
 class Q_DECL_HIDDEN ActionThread::Private
 {
 public:
 
     explicit Private()
+      : receiver (new ActionThreadReceiver),
+        lastBatch(0)
     {
+        qint64 budget = (qint64)512 * 1024 * 1024;
+        DMemoryInfo memory;
+
+        if (!memory.isNull())
+        {
+            budget = qMax(budget, (qint64)(memory.totalPhysical() / 2));
+        }
+
+        scheduler.setMemoryBudget(budget);
     }
 
-    QueueSettings settings;
+public:
+
+    QueueScheduler                       scheduler;
+    QMap<int, ActionThreadQueue>         queues;
+
+    /// The tasks not finished yet, by item of the scheduler.
+    QHash<int, Task*>                    tasks;
+    QHash<Task*, int>                    items;
+
+    QSharedPointer<ActionThreadReceiver> receiver;
+
+    /// The items of the scheduler waiting for their memory estimate, by batch.
+    QHash<int, QList<int> >              estimating;
+    int                                  lastBatch;
 };
 
 // --------------------------------------------------------------------------------------
@@ -46,13 +151,18 @@ ActionThread::ActionThread(QObject* const parent)
 {
     setObjectName(QLatin1String("QueueMngrThread"));
     qRegisterMetaType<ActionData>("ActionData");
+    qRegisterMetaType<QList<qlonglong> >("QList<qlonglong>");
 
-    connect(this, SIGNAL(finished()),
-            this, SLOT(slotThreadFinished()));
+    d->receiver->thread = this;
 }
 
 ActionThread::~ActionThread()
 {
+    {
+        QMutexLocker lock(&d->receiver->mutex);
+        d->receiver->thread = nullptr;
+    }
+
     cancel();
 
     wait();
@@ -60,29 +170,40 @@ ActionThread::~ActionThread()
     delete d;
 }
 
-void ActionThread::setSettings(const QueueSettings& settings)
+void ActionThread::setMemoryBudget(qint64 bytes)
+{
+    d->scheduler.setMemoryBudget(bytes);
+    scheduleTasks();
+}
+
+qint64 ActionThread::memoryBudget() const
 {
-    d->settings = settings;
+    return d->scheduler.memoryBudget();
+}
 
-    if (!d->settings.useMultiCoreCPU)
-    {
-        setMaximumNumberOfThreads(1);
-    }
-    else
+void ActionThread::processQueueItems(const QList<AssignedBatchTools>& items,
+                                     const QueueSettings& settings, int queueId)
+{
+    ActionThreadQueue& queue = d->queues[queueId];
+    queue.settings           = settings;
+
+    if (!d->scheduler.waitingCount(queueId) && !d->scheduler.runningCount(queueId))
     {
-        setDefaultMaximumNumberOfThreads();
+        queue.statistics = QueueStatistics();
+        queue.timer.start();
     }
-}
 
-void ActionThread::processQueueItems(const QList<AssignedBatchTools>& items)
-{
-    ActionJobCollection collection;
+    queue.statistics.total += items.size();
+    d->scheduler.setQueueMultiCore(queueId, settings.useMultiCoreCPU);
+
+    QList<int> batch;
 
     for (int i = 0 ; i < items.size() ; ++i)
     {
         Task* const t = new Task();
-        t->setSettings(d->settings);
+        t->setSettings(settings);
         t->setItem(items.at(i));
+        t->setQueueId(queueId);
 
         connect(t, SIGNAL(signalStarting(Digikam::ActionData)),
                 this, SIGNAL(signalStarting(Digikam::ActionData)));
@@ -91,14 +212,86 @@ void ActionThread::processQueueItems(const QList<AssignedBatchTools>& items)
                 this, SLOT(slotUpdateItemInfo(Digikam::ActionData)),
                 Qt::BlockingQueuedConnection);
 
+        connect(t, SIGNAL(signalDone()),
+                this, SLOT(slotTaskDone()),
+                Qt::QueuedConnection);
+
         connect(this, SIGNAL(signalCancelTask()),
                 t, SLOT(slotCancel()),
                 Qt::QueuedConnection);
 
-        collection.insert(t, 0);
+        // The items wait for their memory estimate, computed on a job thread.
+
+        const int item = d->scheduler.addItem(queueId);
+        d->tasks.insert(item, t);
+        d->items.insert(t, item);
+        batch << item;
+    }
+
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Queue" << queueId << ":" << items.size() << "items to process";
+
+    if (items.isEmpty())
+    {
+        if (!d->scheduler.runningCount(queueId))
+        {
+            QMetaObject::invokeMethod(this, "signalQueueProcessed", Qt::QueuedConnection,
+                                      Q_ARG(int, queueId));
+        }
+
+        return;
+    }
+
+    d->estimating.insert(++d->lastBatch, batch);
+
+    ThreadManager::instance()->scheduleJob(new ActionThreadEstimate(d->receiver, d->lastBatch, items, settings),
+                                           ThreadManager::Interactive);
+}
+
+QueueStatistics ActionThread::queueStatistics(int queueId) const
+{
+    QMap<int, ActionThreadQueue>::const_iterator it = d->queues.constFind(queueId);
+
+    if (it == d->queues.constEnd())
+    {
+        return QueueStatistics();
+    }
+
+    QueueStatistics stats = it.value().statistics;
+    stats.memory          = d->scheduler.usedMemory(queueId);
+
+    if (d->scheduler.waitingCount(queueId) || d->scheduler.runningCount(queueId))
+    {
+        stats.elapsed = it.value().timer.elapsed();
+    }
+
+    return stats;
+}
+
+void ActionThread::scheduleTasks()
+{
+    d->scheduler.setMaximumRunning(maximumNumberOfThreads());
+
+    const QList<int> items = d->scheduler.itemsToStart();
+
+    if (items.isEmpty())
+    {
+        return;
+    }
+
+    ActionJobCollection collection;
+
+    Q_FOREACH (int item, items)
+    {
+        collection.insert(d->tasks.value(item), 0);
     }
 
+    qCDebug(DIGIKAM_GENERAL_LOG) << "Starting" << collection.count() << "items,"
+                                 << d->scheduler.runningCount() << "running, estimated memory"
+                                 << d->scheduler.usedMemory() / (1024 * 1024) << "MB of"
+                                 << d->scheduler.memoryBudget() / (1024 * 1024) << "MB";
+
     appendJobs(collection);
+    startIfNeeded();
 }
 
 void ActionThread::cancel()
@@ -108,9 +301,36 @@ void ActionThread::cancel()
         Q_EMIT signalCancelTask();
     }
 
+    // The items not started yet are not known by the base class.
+
+    Q_FOREACH (int item, d->scheduler.waitingItems())
+    {
+        delete d->tasks.value(item);
+    }
+
+    d->scheduler.clear();
+    d->queues.clear();
+    d->tasks.clear();
+    d->items.clear();
+    d->estimating.clear();
+
     ActionThreadBase::cancel();
 }
 
+void ActionThread::slotMemoryEstimated(int batch, const QList<qlonglong>& memory)
+{
+    // The estimates of the items canceled are dropped.
+
+    const QList<int> items = d->estimating.take(batch);
+
+    for (int i = 0 ; (i < items.size()) && (i < memory.size()) ; ++i)
+    {
+        d->scheduler.setItemMemory(items.at(i), memory.at(i));
+    }
+
+    scheduleTasks();
+}
+
 void ActionThread::slotUpdateItemInfo(const Digikam::ActionData& ad)
 {
     if (ad.status == ActionData::BatchDone)
@@ -139,16 +359,66 @@ void ActionThread::slotUpdateItemInfo(const Digikam::ActionData& ad)
         }
     }
 
+    QMap<int, ActionThreadQueue>::iterator it = d->queues.find(ad.queueId);
+
+    if (it != d->queues.end())
+    {
+        switch (ad.status)
+        {
+            case ActionData::BatchDone:
+            case ActionData::BatchSkipped:
+            {
+                it.value().statistics.processed++;
+                break;
+            }
+
+            case ActionData::BatchFailed:
+            case ActionData::BatchCanceled:
+            {
+                it.value().statistics.failed++;
+                break;
+            }
+
+            default:
+            {
+                break;
+            }
+        }
+    }
+
     Q_EMIT signalFinished(ad);
 }
 
-void ActionThread::slotThreadFinished()
+void ActionThread::slotTaskDone()
 {
-    if (isEmpty())
+    Task* const t = qobject_cast<Task*>(sender());
+
+    // The items canceled are already forgotten.
+
+    if (!t || !d->items.contains(t))
     {
-        qCDebug(DIGIKAM_GENERAL_LOG) << "List of Pending Jobs is empty";
-        Q_EMIT signalQueueProcessed();
+        return;
     }
+
+    const int item    = d->items.take(t);
+    d->tasks.remove(item);
+    const int queueId = d->scheduler.itemDone(item);
+
+    if (!d->scheduler.waitingCount(queueId) && !d->scheduler.runningCount(queueId))
+    {
+        ActionThreadQueue& queue = d->queues[queueId];
+        QueueStatistics& stats   = queue.statistics;
+        stats.elapsed            = queue.timer.elapsed();
+
+        qCDebug(DIGIKAM_GENERAL_LOG) << "Queue" << queueId << "processed:" << stats.processed
+                                     << "items done," << stats.failed << "failed in"
+                                     << stats.elapsed << "ms (" << stats.itemsPerMinute()
+                                     << "items by minute)";
+
+        Q_EMIT signalQueueProcessed(queueId);
+    }
+
+    scheduleTasks();
 }
 
 } // namespace Digikam
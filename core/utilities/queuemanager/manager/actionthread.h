@@ -28,6 +28,41 @@ namespace Digikam
 class ActionData;
 class QueueSettings;
 
+/**
+ * Throughput of a queue processed by the ActionThread.
+ */
+class QueueStatistics
+{
+public:
+
+    QueueStatistics() = default;
+
+    /**
+     * Returns the number of items processed by minute.
+     */
+    double itemsPerMinute() const
+    {
+        return ((elapsed > 0) ? ((processed + failed) * 60000.0 / elapsed) : 0.0);
+    }
+
+public:
+
+    int    total     = 0;      ///< Number of items to process.
+    int    processed = 0;      ///< Number of items processed or skipped.
+    int    failed    = 0;      ///< Number of items failed or canceled.
+    qint64 elapsed   = 0;      ///< Time in milliseconds since the start of the queue.
+    qint64 memory    = 0;      ///< Estimated memory in bytes used by the items of the queue running now.
+};
+
+// ---------------------------------------------------------------------------------------------
+
+/**
+ * Processes the items of several queues at the same time.
+ *
+ * The memory used to process each item is estimated on a job thread from
+ * its dimensions, its bit depth and the tools applied. The QueueScheduler
+ * then starts the items within the memory budget and the threads available.
+ */
 class ActionThread : public ActionThreadBase
 {
     Q_OBJECT
@@ -37,9 +72,24 @@ public:
     explicit ActionThread(QObject* const parent);
     ~ActionThread() override;
 
-    void setSettings(const QueueSettings& settings);
+    /**
+     * The maximum estimated memory in bytes used by the items running at the
+     * same time. Default is half of the physical memory, and 512 MB at least.
+     */
+    void   setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget()                                   const;
 
-    void processQueueItems(const QList<AssignedBatchTools>& items);
+    /**
+     * Adds the items of a queue to process, with the settings of the queue.
+     * The queue is identified by its index in the queue pool.
+     */
+    void processQueueItems(const QList<AssignedBatchTools>& items,
+                           const QueueSettings& settings, int queueId);
+
+    /**
+     * Returns the throughput of a queue, processed or in progress.
+     */
+    QueueStatistics queueStatistics(int queueId)            const;
 
     void cancel();
 
@@ -58,7 +108,7 @@ Q_SIGNALS:
     /**
      * Emit when a queue have been fully processed (all items from queue are finished).
      */
-    void signalQueueProcessed();
+    void signalQueueProcessed(int queueId);
 
     /**
      * Signal to emit to sub-tasks to cancel processing.
@@ -68,7 +118,12 @@ Q_SIGNALS:
 private Q_SLOTS:
 
     void slotUpdateItemInfo(const Digikam::ActionData& ad);
-    void slotThreadFinished();
+    void slotTaskDone();
+    void slotMemoryEstimated(int batch, const QList<qlonglong>& memory);
+
+private:
+
+    void scheduleTasks();
 
 private:
 
@@ -35,6 +35,7 @@
 #include "digikam_debug.h"
 #include "dimgbuiltinfilter.h"
 #include "dimgloaderobserver.h"
+#include "dimgpointfilterpipeline.h"
 #include "dimgthreadedfilter.h"
 #include "filereadwritelock.h"
 #include "batchtoolutils.h"
@@ -58,19 +59,46 @@ public:
         branchHistory         (true),
         cancel                (false),
         last                  (false),
+        deferPointFilters     (false),
+        loadingSizeHint       (0),
         observer              (nullptr),
         toolGroup             (BaseTool),
         rawLoadingRule        (QueueSettings::DEMOSAICING),
-        plugin                (nullptr)
+        plugin                (nullptr),
+        pipeline              (nullptr)
     {
     }
 
+    /**
+     * Apply the filters queued in the pipeline on the image.
+     * Returns true if the image data changed.
+     */
+    bool applyPendingFilters()
+    {
+        if (!pipeline || pipeline->isEmpty())
+        {
+            return false;
+        }
+
+        if (!cancel)
+        {
+            pipeline->apply(image);
+        }
+
+        pipeline->clear();
+
+        return true;
+    }
+
     bool                          exifResetOrientation;
     bool                          exifCanEditOrientation;
     bool                          saveAsNewVersion;
     bool                          branchHistory;
     bool                          cancel;
     bool                          last;
+    bool                          deferPointFilters;
+
+    int                           loadingSizeHint;
 
     QString                       errorMessage;
     QString                       toolTitle;          ///< User friendly tool title.
@@ -98,6 +126,8 @@ public:
     QueueSettings::RawLoadingRule rawLoadingRule;
 
     DPluginBqm*                   plugin;
+
+    DImgPointFilterPipeline*      pipeline;
 };
 
 class Q_DECL_HIDDEN BatchToolObserver : public DImgLoaderObserver
@@ -371,6 +401,12 @@ bool BatchTool::getBranchHistory() const
     return d->branchHistory;
 }
 
+void BatchTool::setPointFilterPipeline(DImgPointFilterPipeline* const pipeline, bool defer)
+{
+    d->pipeline          = pipeline;
+    d->deferPointFilters = defer;
+}
+
 void BatchTool::setDRawDecoderSettings(const DRawDecoderSettings& settings)
 {
     d->rawDecodingSettings = settings;
@@ -381,6 +417,16 @@ DRawDecoderSettings BatchTool::rawDecodingSettings() const
     return d->rawDecodingSettings;
 }
 
+void BatchTool::setLoadingSizeHint(int length)
+{
+    d->loadingSizeHint = qMax(0, length);
+}
+
+int BatchTool::loadingSizeHint() const
+{
+    return d->loadingSizeHint;
+}
+
 void BatchTool::setIOFileSettings(const IOFileSettings& settings)
 {
     d->ioFileSettings = settings;
@@ -457,6 +503,11 @@ bool BatchTool::isRawFile(const QUrl& url) const
 
 bool BatchTool::loadToDImg() const
 {
+    // The hint only applies to this load: it is reset on all return paths.
+
+    const int hint     = d->loadingSizeHint;
+    d->loadingSizeHint = 0;
+
     if (!d->image.isNull())
     {
         return true;
@@ -474,11 +525,47 @@ bool BatchTool::loadToDImg() const
         return ret;
     }
 
-    return (d->image.load(inputUrl().toLocalFile(), d->observer, DRawDecoding(rawDecodingSettings())));
+    DRawDecoderSettings rawSettings = rawDecodingSettings();
+
+    if (hint > 0)
+    {
+        // The loaders supporting it decode the file reduced by 2, 4 or 8,
+        // keeping the longest side not smaller than the hint.
+
+        d->image.setAttribute(QLatin1String("scaledLoadingSize"), hint);
+
+        if (isRawFile(inputUrl()) && !rawSettings.halfSizeColorImage)
+        {
+            QScopedPointer<DMetadata> meta(new DMetadata(inputUrl().toLocalFile()));
+            QSize size = meta->getItemDimensions();
+
+            if (size.isValid() && ((qMax(size.width(), size.height()) / 2) >= hint))
+            {
+                qCDebug(DIGIKAM_GENERAL_LOG) << "Loading RAW file at half size for" << hint
+                                             << "pixels:" << inputUrl().toLocalFile();
+
+                rawSettings.halfSizeColorImage = true;
+            }
+        }
+    }
+
+    bool ret = d->image.load(inputUrl().toLocalFile(), d->observer, DRawDecoding(rawSettings));
+
+    d->image.removeAttribute(QLatin1String("scaledLoadingSize"));
+
+    return ret;
 }
 
 bool BatchTool::savefromDImg() const
 {
+    if (!d->deferPointFilters || !outputSuffix().isEmpty())
+    {
+        // While the next tool is also a colour tool, the queued filters are kept for it,
+        // and applied once with its own filter.
+
+        d->applyPendingFilters();
+    }
+
     if (!isLastChainedTool() && outputSuffix().isEmpty())
     {
         return true;
@@ -580,11 +667,44 @@ bool BatchTool::apply()
         }
     }
 
-    return toolOperations();
+    bool ret = toolOperations();
+
+    if (!d->deferPointFilters)
+    {
+        d->applyPendingFilters();
+    }
+
+    return ret;
 }
 
 void BatchTool::applyFilter(DImgThreadedFilter* const filter)
 {
+    if (d->pipeline)
+    {
+        FilterAction action = filter->filterAction();
+
+        if (d->pipeline->addFilterAction(action))
+        {
+            // Per-pixel filters are applied in a single pass with the next ones.
+
+            d->image.addFilterAction(action);
+
+            if (!d->deferPointFilters)
+            {
+                d->applyPendingFilters();
+            }
+
+            return;
+        }
+
+        if (d->applyPendingFilters())
+        {
+            // The filter was set up with the image data before the queued filters were applied.
+
+            filter->setupFilter(d->image.copyImageData());
+        }
+    }
+
     filter->startFilterDirectly();
 
     if (isCancelled())
@@ -598,6 +718,11 @@ void BatchTool::applyFilter(DImgThreadedFilter* const filter)
 
 void BatchTool::applyFilterChangedProperties(DImgThreadedFilter* const filter)
 {
+    if (d->applyPendingFilters())
+    {
+        filter->setupFilter(d->image.copyImageData());
+    }
+
     filter->startFilterDirectly();
 
     if (isCancelled())
@@ -612,6 +737,7 @@ void BatchTool::applyFilterChangedProperties(DImgThreadedFilter* const filter)
 
 void BatchTool::applyFilter(DImgBuiltinFilter* const filter)
 {
+    d->applyPendingFilters();
     filter->apply(d->image);
     d->image.addFilterAction(filter->filterAction());
 }
@@ -35,6 +35,7 @@ namespace Digikam
 {
 
 class DImgBuiltinFilter;
+class DImgPointFilterPipeline;
 class DImgThreadedFilter;
 class DPluginBqm;
 
@@ -209,6 +210,14 @@ public:
     void setBranchHistory(bool branch = true);
     bool getBranchHistory()                                 const;
 
+    /**
+     * Set the pipeline shared by the chained tools of an item, used to apply
+     * per-pixel colour filters together. If defer is true, the filter of this
+     * tool is only queued in the pipeline, to be applied with the filters of the
+     * next tools. Else all queued filters are applied when this tool runs.
+     */
+    void setPointFilterPipeline(DImgPointFilterPipeline* const pipeline, bool defer);
+
     /**
      * Set-up RAW decoding settings no use during tool operations.
      */
@@ -219,6 +228,16 @@ public:
      */
     DRawDecoderSettings rawDecodingSettings()               const;
 
+    /**
+     * Set the length of the longest side of the image needed by the tool, if the
+     * tool reduces the image. The next call to loadToDImg() can then decode the
+     * file at a reduced size not smaller than this length: DCT scaling for JPEG,
+     * half size demosaicing for RAW... The hint is dropped after the loading.
+     * Use 0 to load the image at full size.
+     */
+    void setLoadingSizeHint(int length);
+    int  loadingSizeHint()                                  const;
+
     /**
      * Set-up IOFile settings no use during tool operations.
      */
@@ -302,6 +321,7 @@ protected:
     /**
      * Use this if you have a filter ready to run.
      * Will call startFilterDirectly and apply the result to image().
+     * Per-pixel colour filters can be deferred, see setPointFilterPipeline().
      */
     void applyFilter(DImgThreadedFilter* const filter);
     void applyFilterChangedProperties(DImgThreadedFilter* const filter);
@@ -40,7 +40,7 @@ typedef QList<BatchTool*> BatchToolsList;
 /**
  * A container of associated batch tool and settings.
  */
-class BatchToolSet
+class DIGIKAM_GUI_EXPORT BatchToolSet
 {
 public:
 
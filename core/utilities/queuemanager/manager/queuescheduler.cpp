@@ -0,0 +1,287 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Choice of the queue items to start by memory and threads.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#include "queuescheduler.h"
+
+// Qt includes
+
+#include <QHash>
+#include <QMap>
+
+namespace Digikam
+{
+
+class Q_DECL_HIDDEN QueueSchedulerQueue
+{
+public:
+
+    QList<int> waiting;
+    int        running   = 0;
+    qint64     memory    = 0;
+    bool       multiCore = true;
+};
+
+class Q_DECL_HIDDEN QueueSchedulerItem
+{
+public:
+
+    int    queueId = -1;
+    qint64 memory  = -1;
+    bool   running = false;
+};
+
+// --------------------------------------------------------------------------------------
+
+class Q_DECL_HIDDEN QueueScheduler::Private
+{
+public:
+
+    explicit Private()
+      : budget    ((qint64)512 * 1024 * 1024),
+        maxRunning(1),
+        used      (0),
+        running   (0),
+        lastQueue (-1),
+        lastItem  (0)
+    {
+    }
+
+    /**
+     * Returns the queues with items waiting, in the order they take a turn,
+     * starting after the last queue which started an item.
+     */
+    QList<int> queuesInTurn() const
+    {
+        QList<int> before;
+        QList<int> after;
+
+        for (QMap<int, QueueSchedulerQueue>::const_iterator it = queues.constBegin() ;
+             it != queues.constEnd() ; ++it)
+        {
+            if (it.value().waiting.isEmpty())
+            {
+                continue;
+            }
+
+            if (it.key() > lastQueue)
+            {
+                after << it.key();
+            }
+            else
+            {
+                before << it.key();
+            }
+        }
+
+        return (after + before);
+    }
+
+public:
+
+    qint64                          budget;
+    int                             maxRunning;
+    qint64                          used;
+    int                             running;
+    int                             lastQueue;
+    int                             lastItem;
+
+    QMap<int, QueueSchedulerQueue>  queues;
+    QHash<int, QueueSchedulerItem>  items;
+};
+
+QueueScheduler::QueueScheduler()
+    : d(new Private)
+{
+}
+
+QueueScheduler::~QueueScheduler()
+{
+    delete d;
+}
+
+void QueueScheduler::setMemoryBudget(qint64 bytes)
+{
+    d->budget = bytes;
+}
+
+qint64 QueueScheduler::memoryBudget() const
+{
+    return d->budget;
+}
+
+void QueueScheduler::setMaximumRunning(int count)
+{
+    d->maxRunning = qMax(1, count);
+}
+
+int QueueScheduler::maximumRunning() const
+{
+    return d->maxRunning;
+}
+
+void QueueScheduler::setQueueMultiCore(int queueId, bool multiCore)
+{
+    d->queues[queueId].multiCore = multiCore;
+}
+
+int QueueScheduler::addItem(int queueId, qint64 memory)
+{
+    QueueSchedulerItem item;
+    item.queueId = queueId;
+    item.memory  = memory;
+
+    d->items.insert(++d->lastItem, item);
+    d->queues[queueId].waiting << d->lastItem;
+
+    return d->lastItem;
+}
+
+void QueueScheduler::setItemMemory(int item, qint64 memory)
+{
+    QHash<int, QueueSchedulerItem>::iterator it = d->items.find(item);
+
+    if ((it != d->items.end()) && !it.value().running)
+    {
+        it.value().memory = memory;
+    }
+}
+
+QList<int> QueueScheduler::itemsToStart()
+{
+    QList<int> started;
+    bool starting = true;
+
+    // Each queue with items waiting starts one item in turn, as long as threads and memory are available.
+
+    while (starting && (d->running < d->maxRunning))
+    {
+        starting = false;
+
+        Q_FOREACH (int queueId, d->queuesInTurn())
+        {
+            if (d->running >= d->maxRunning)
+            {
+                break;
+            }
+
+            QueueSchedulerQueue& queue = d->queues[queueId];
+            const int maxRunning       = queue.multiCore ? d->maxRunning : 1;
+
+            if (queue.running >= maxRunning)
+            {
+                continue;
+            }
+
+            QueueSchedulerItem& item = d->items[queue.waiting.first()];
+
+            if (item.memory < 0)
+            {
+                continue;
+            }
+
+            // A smaller item of another queue can start while this one waits for memory.
+
+            if (d->running && ((d->used + item.memory) > d->budget))
+            {
+                continue;
+            }
+
+            started << queue.waiting.takeFirst();
+            item.running  = true;
+            queue.running++;
+            queue.memory += item.memory;
+            d->running++;
+            d->used      += item.memory;
+            d->lastQueue  = queueId;
+            starting      = true;
+        }
+    }
+
+    return started;
+}
+
+int QueueScheduler::itemDone(int item)
+{
+    QHash<int, QueueSchedulerItem>::iterator it = d->items.find(item);
+
+    if ((it == d->items.end()) || !it.value().running)
+    {
+        return -1;
+    }
+
+    const QueueSchedulerItem done = it.value();
+    QueueSchedulerQueue& queue    = d->queues[done.queueId];
+    d->items.erase(it);
+
+    queue.running--;
+    queue.memory -= done.memory;
+    d->running--;
+    d->used      -= done.memory;
+
+    return done.queueId;
+}
+
+int QueueScheduler::queueOf(int item) const
+{
+    return d->items.value(item).queueId;
+}
+
+int QueueScheduler::waitingCount(int queueId) const
+{
+    return d->queues.value(queueId).waiting.count();
+}
+
+int QueueScheduler::runningCount(int queueId) const
+{
+    return d->queues.value(queueId).running;
+}
+
+qint64 QueueScheduler::usedMemory(int queueId) const
+{
+    return d->queues.value(queueId).memory;
+}
+
+QList<int> QueueScheduler::waitingItems() const
+{
+    QList<int> waiting;
+
+    for (QMap<int, QueueSchedulerQueue>::const_iterator it = d->queues.constBegin() ;
+         it != d->queues.constEnd() ; ++it)
+    {
+        waiting << it.value().waiting;
+    }
+
+    return waiting;
+}
+
+int QueueScheduler::runningCount() const
+{
+    return d->running;
+}
+
+qint64 QueueScheduler::usedMemory() const
+{
+    return d->used;
+}
+
+void QueueScheduler::clear()
+{
+    d->queues.clear();
+    d->items.clear();
+    d->used      = 0;
+    d->running   = 0;
+    d->lastQueue = -1;
+}
+
+} // namespace Digikam
@@ -0,0 +1,120 @@
+/* ============================================================
+ *
+ * This file is a part of digiKam project
+ * https://www.digikam.org
+ *
+ * Date        : 2026-10-19
+ * Description : Choice of the queue items to start by memory and threads.
+ *
+ * SPDX-FileCopyrightText: 2026 by agent <agent at local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ============================================================ */
+
+#ifndef DIGIKAM_BQM_QUEUE_SCHEDULER_H
+#define DIGIKAM_BQM_QUEUE_SCHEDULER_H
+
+// Qt includes
+
+#include <QList>
+
+// Local includes
+
+#include "digikam_export.h"
+
+namespace Digikam
+{
+
+/**
+ * Chooses the items of several queues to start, from the threads available
+ * and the memory estimated for each item.
+ *
+ * An item only starts if the estimated memory of the items running does not
+ * exceed the budget. An item larger than the budget is started alone. The
+ * queues start an item in turn, a queue not set to use all the cores running
+ * one item at once. The items of a queue start in the order they were added,
+ * and an item with a memory not estimated yet holds its queue.
+ *
+ * The items are identified by the numbers returned by addItem().
+ */
+class DIGIKAM_GUI_EXPORT QueueScheduler
+{
+public:
+
+    QueueScheduler();
+    ~QueueScheduler();
+
+    /**
+     * The maximum estimated memory in bytes used by the items running at the same time.
+     */
+    void   setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget()                                   const;
+
+    /**
+     * The maximum number of items running at the same time.
+     */
+    void   setMaximumRunning(int count);
+    int    maximumRunning()                                 const;
+
+    /**
+     * Sets if the queue runs several items at once.
+     */
+    void   setQueueMultiCore(int queueId, bool multiCore);
+
+    /**
+     * Adds an item waiting in the queue, with its estimated memory in bytes,
+     * or -1 if it is not known yet. Returns the number of the item.
+     */
+    int    addItem(int queueId, qint64 memory = -1);
+
+    /**
+     * Sets the estimated memory in bytes of an item added without it.
+     */
+    void   setItemMemory(int item, qint64 memory);
+
+    /**
+     * Returns the items to start now, in the order to start them.
+     * They are counted as running until itemDone() is called.
+     */
+    QList<int> itemsToStart();
+
+    /**
+     * Releases the memory and the thread of an item started.
+     * Returns the queue of the item, or -1 if the item is not known.
+     */
+    int    itemDone(int item);
+
+    int    queueOf(int item)                                const;
+    int    waitingCount(int queueId)                        const;
+    int    runningCount(int queueId)                        const;
+    qint64 usedMemory(int queueId)                          const;
+
+    /**
+     * Returns the waiting items of all queues.
+     */
+    QList<int> waitingItems()                               const;
+
+    int    runningCount()                                   const;
+    qint64 usedMemory()                                     const;
+
+    /**
+     * Forgets all the items, waiting or running.
+     */
+    void   clear();
+
+private:
+
+    // Disable
+    QueueScheduler(const QueueScheduler&)            = delete;
+    QueueScheduler& operator=(const QueueScheduler&) = delete;
+
+private:
+
+    class Private;
+    Private* const d;
+};
+
+} // namespace Digikam
+
+#endif // DIGIKAM_BQM_QUEUE_SCHEDULER_H
@@ -18,6 +18,7 @@
 // Qt includes
 
 #include <QFileInfo>
+#include <QStringList>
 
 // KDE includes
 
@@ -30,8 +31,10 @@
 #include "dimg.h"
 #include "dmetadata.h"
 #include "iteminfo.h"
+#include "coredbinfocontainers.h"
 #include "batchtool.h"
 #include "batchtoolsfactory.h"
+#include "dimgpointfilterpipeline.h"
 #include "dfileoperations.h"
 
 namespace Digikam
@@ -42,12 +45,14 @@ class Q_DECL_HIDDEN Task::Private
 public:
 
     explicit Private()
-      : cancel(false),
-        tool  (nullptr)
+      : cancel (false),
+        queueId(-1),
+        tool   (nullptr)
     {
     }
 
     bool               cancel;
+    int                queueId;
 
     BatchTool*         tool;
 
@@ -79,6 +84,64 @@ void Task::setItem(const AssignedBatchTools& tools)
     d->tools = tools;
 }
 
+void Task::setQueueId(int queueId)
+{
+    d->queueId = queueId;
+}
+
+int Task::queueId() const
+{
+    return d->queueId;
+}
+
+qint64 Task::estimateMemory(const AssignedBatchTools& item, const QueueSettings& settings)
+{
+    ItemInfo info                    = ItemInfo::fromUrl(item.m_itemUrl);
+    const ImageCommonContainer image = info.imageCommonContainer();
+
+    // RAW files are demosaiced to 16 bits images if the queue settings ask for.
+
+    bool sixteenBit = (image.colorDepth > 8);
+
+    if (image.format.startsWith(QLatin1String("RAW"))                    &&
+        (settings.rawLoadingRule == QueueSettings::DEMOSAICING)          &&
+        settings.rawDecodingSettings.sixteenBitsImage)
+    {
+        sixteenBit = true;
+    }
+
+    return estimateMemory(QSize(image.width, image.height), sixteenBit, item.m_toolsList);
+}
+
+qint64 Task::estimateMemory(const QSize& size, bool sixteenBit, const BatchSetList& tools)
+{
+    const qint64 pixels = size.isValid() && !size.isEmpty() ? (qint64)size.width() * size.height()
+                                                            : (qint64)6000 * 4000;
+
+    // The metadata tools work on the file without loading the image.
+
+    bool loadImage   = false;
+    bool workBuffers = false;
+
+    Q_FOREACH (const BatchToolSet& set, tools)
+    {
+        loadImage   |= (set.group != BatchTool::MetadataTool);
+        workBuffers |= ((set.group == BatchTool::EnhanceTool) || (set.group == BatchTool::FiltersTool));
+    }
+
+    if (!loadImage)
+    {
+        return (qint64)16 * 1024 * 1024;
+    }
+
+    // A tool holds the loaded image and its result at the same time,
+    // the enhance and filters tools also a temporary image.
+
+    const int buffers = workBuffers ? 3 : 2;
+
+    return (pixels * (sixteenBit ? 8 : 4) * buffers);
+}
+
 void Task::slotCancel()
 {
     if (d->tool)
@@ -116,10 +179,31 @@ void Task::emitActionData(ActionData::ActionStatus st,
     ad.message = mess;
     ad.destUrl = dest;
     ad.noWrite = noWrite;
+    ad.queueId = d->queueId;
 
     Q_EMIT signalFinished(ad);
 }
 
+/**
+ * The tools only applying a per-pixel colour filter, which can be chained
+ * and applied in a single pass over the image.
+ */
+static bool isPointFilterTool(const BatchToolSet& set)
+{
+    static const QStringList tools =
+    {
+        QLatin1String("BCGCorrection"),
+        QLatin1String("BWConvert"),
+        QLatin1String("ChannelMixer"),
+        QLatin1String("ColorBalance"),
+        QLatin1String("CurvesAdjust"),
+        QLatin1String("HSLCorrection"),
+        QLatin1String("WhiteBalance")
+    };
+
+    return ((set.group == BatchTool::ColorTool) && tools.contains(set.name));
+}
+
 void Task::run()
 {
     if (d->cancel)
@@ -148,6 +232,10 @@ void Task::run()
     bool isMetadataTool = false;
     bool timeAdjust     = false;
 
+    // Consecutive colour filters are applied together, when the last one runs.
+
+    DImgPointFilterPipeline pipeline;
+
     Q_FOREACH (const BatchToolSet& set, d->tools.m_toolsList)
     {
         BatchTool* const tool = BatchToolsFactory::instance()->findTool(set.name, set.group);
@@ -192,6 +280,7 @@ void Task::run()
         if      (index == d->tools.m_toolsList.count())
         {
             d->tool->setLastChainedTool(true);
+            d->tool->setPointFilterPipeline(&pipeline, false);
         }
         else if (d->tools.m_toolsList[index].group == BatchTool::CustomTool)
         {
@@ -199,10 +288,14 @@ void Task::run()
             // treat as the last chained tool, i.e. save image to file
 
             d->tool->setLastChainedTool(true);
+            d->tool->setPointFilterPipeline(&pipeline, false);
         }
         else
         {
             d->tool->setLastChainedTool(false);
+            d->tool->setPointFilterPipeline(&pipeline,
+                                            isPointFilterTool(set) &&
+                                            isPointFilterTool(d->tools.m_toolsList[index]));
         }
 
         d->tool->setSaveAsNewVersion(d->settings.saveAsNewVersion);
@@ -18,6 +18,7 @@
 
 // Qt includes
 
+#include <QSize>
 #include <QUrl>
 
 // Local includes
@@ -26,11 +27,12 @@
 #include "queuesettings.h"
 #include "batchtoolutils.h"
 #include "actionthreadbase.h"
+#include "digikam_export.h"
 
 namespace Digikam
 {
 
-class Task : public ActionJob
+class DIGIKAM_GUI_EXPORT Task : public ActionJob
 {
     Q_OBJECT
 
@@ -42,6 +44,28 @@ public:
     void setSettings(const QueueSettings& settings);
     void setItem(const AssignedBatchTools& tools);
 
+    /**
+     * The index of the queue hosting the item, reported in the ActionData.
+     */
+    void setQueueId(int queueId);
+    int  queueId()                                      const;
+
+    /**
+     * Returns the estimated size in bytes of the memory used to process
+     * the item with the settings of the queue, from its dimensions and bit
+     * depth recorded in the database. Do not call it from the GUI thread,
+     * as it queries the database.
+     */
+    static qint64 estimateMemory(const AssignedBatchTools& item,
+                                 const QueueSettings& settings);
+
+    /**
+     * Returns the estimated size in bytes of the memory used to apply the tools
+     * on an image of this size. If the size is unknown, a 24 megapixels image is assumed.
+     */
+    static qint64 estimateMemory(const QSize& size, bool sixteenBit,
+                                 const BatchSetList& tools);
+
 Q_SIGNALS:
 
     void signalStarting(const Digikam::ActionData& ad);